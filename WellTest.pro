@@ -58,6 +58,7 @@ HEADERS += \
            datacolumndialog.h \
            dataimportdialog.h \
            datasinglesheet.h \
+           fittingcore.h \
            fittingdatadialog.h \
            fittingmultiples.h \
            fittingnewdialog.h \
@@ -70,6 +71,31 @@ HEADERS += \
            mousezoom.h \
            newprojectdialog.h \
            paramselectdialog.h \
+           perfcounters.h \
+           tracerecorder.h \
+           fitreplaylog.h \
+           startupprofiler.h \
+           fittingreportjob.h \
+           datavalidator.h \
+           timeparser.h \
+           flowsegmenter.h \
+           timeseriesmerge.h \
+           datamergedialog.h \
+           modelcurvecache.h \
+           fittinguncertainty.h \
+           uncertaintydialog.h \
+           fittingmcmc.h \
+           mcmcdialog.h \
+           fittinglandscape.h \
+           landscapedialog.h \
+           fittingjoint.h \
+           jointfitdialog.h \
+           fracturehmatrix.h \
+           fracturetabledialog.h \
+           fittingresidualkernel.h \
+           fittingsampler.h \
+           fittingwarmstart.h \
+           plothitindex.h \
            mainwindow.h \
            monitorbtn.h \
            monitostatew.h \
@@ -130,6 +156,7 @@ SOURCES += \
            datacolumndialog.cpp \
            dataimportdialog.cpp \
            datasinglesheet.cpp \
+           fittingcore.cpp \
            fittingdatadialog.cpp \
            fittingmultiples.cpp \
            fittingnewdialog.cpp \
@@ -142,6 +169,31 @@ SOURCES += \
            mousezoom.cpp \
            newprojectdialog.cpp \
            paramselectdialog.cpp \
+           perfcounters.cpp \
+           tracerecorder.cpp \
+           fitreplaylog.cpp \
+           startupprofiler.cpp \
+           fittingreportjob.cpp \
+           datavalidator.cpp \
+           timeparser.cpp \
+           flowsegmenter.cpp \
+           timeseriesmerge.cpp \
+           datamergedialog.cpp \
+           modelcurvecache.cpp \
+           fittinguncertainty.cpp \
+           uncertaintydialog.cpp \
+           fittingmcmc.cpp \
+           mcmcdialog.cpp \
+           fittinglandscape.cpp \
+           landscapedialog.cpp \
+           fittingjoint.cpp \
+           jointfitdialog.cpp \
+           fracturehmatrix.cpp \
+           fracturetabledialog.cpp \
+           fittingresidualkernel.cpp \
+           fittingsampler.cpp \
+           fittingwarmstart.cpp \
+           plothitindex.cpp \
            main.cpp \
            mainwindow.cpp \
            monitorbtn.cpp \
@@ -0,0 +1,52 @@
+# ----------------------------------------------------
+# Project: WellTestBench
+# Description: 试井分析软件性能基准测试工程
+# 说明:
+# 1. 与主工程 WellTest.pro 使用同一套源码 (除 main.cpp 外全部编译)，保证测得的是发布代码。
+# 2. 覆盖模型求解、Bourdet 导数、平滑、抽样、数据导入和完整 LM 拟合。
+# 3. 运行结果输出为 JSON，便于不同版本之间对比性能回归。
+# ----------------------------------------------------
+
+QT += core gui axcontainer svg printsupport core5compat concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TEMPLATE = app
+TARGET = WellTestBench
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 编译优化选项 (与主工程保持一致，否则测量结果无参考意义)
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+unix: LIBS += -lm
+win32: LIBS += -lm
+
+# ----------------------------------------------------
+# 第三方库路径配置 (与主工程一致)
+# ----------------------------------------------------
+
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
+INCLUDEPATH += D:/08YYYXXX/boost_1_89_0
+include(D:/08YYYXXX/QXlsx-master/QXlsx/QXlsx.pri)
+
+# ----------------------------------------------------
+# 源码配置：直接引用主工程目录下的全部源文件
+# ----------------------------------------------------
+
+WT_SRC_DIR = $$PWD/..
+INCLUDEPATH += $$WT_SRC_DIR
+
+HEADERS += $$files($$WT_SRC_DIR/*.h)
+FORMS += $$files($$WT_SRC_DIR/*.ui)
+SOURCES += $$files($$WT_SRC_DIR/*.cpp)
+SOURCES -= $$WT_SRC_DIR/main.cpp
+
+RESOURCES += $$WT_SRC_DIR/resource.qrc
+
+SOURCES += \
+           benchmain.cpp
+
+QMAKE_CXXFLAGS_WARN_ON += -Wno-unused-parameter
@@ -0,0 +1,1289 @@
+/*
+ * 文件名: benchmain.cpp
+ * 文件作用: 试井分析软件性能基准测试程序入口
+ * 功能描述:
+ * 1. 提供简单的基准测试框架：按名称注册用例，自动重复运行直到达到最短测量时间，统计均值/最小/最大/标准差。
+ * 2. 模型求解用例：Model_1 ~ Model_6 × 裂缝条数 nf ∈ {1,4,8,16} × Stehfest 阶数 N ∈ {4,8,12}。
+ * 3. 数据处理用例：Bourdet 导数、移动平均平滑 (10^3 ~ 10^7 点)、拟合抽样 getLogSampledData。
+ * 4. 数据导入用例：文本 (.csv) 与 Excel (.xlsx) 文件经 DataSingleSheet::loadData 导入的吞吐量。
+ * 5. 拟合用例：对固定的合成数据执行完整 Levenberg-Marquardt 拟合，记录迭代次数与模型调用次数。
+ * 6. 结果以 JSON 格式输出 (--output)，便于不同版本之间比较性能回归。
+ * 7. 回放模式 (--replay)：读取界面记录的拟合回放日志 (.wtfr)，以相同输入重新拟合，
+ *    比对迭代轨迹、最终参数与耗时，任一日志结果不一致时返回非零退出码；
+ *    与界面拟合一样设置批量曲线回调，雅可比走同一条批量计算路径。
+ * 8. 多参数组用例：Model_1 下 M ∈ {16,64,256} 组参数 (只改井储/表皮的扫描、随机参数群体)，
+ *    对比逐组调用与 calculateTheoreticalCurves (共享储层解 + 线程并行，无跨组向量化) 的每秒曲线数，
+ *    并检查两者结果逐位一致。
+ * 9. 裂缝表用例：nf ∈ {16,32,64,128} 条随机间距与半长的裂缝，考察 H-矩阵求解随裂缝条数的耗时增长。
+ * 10. 反演网格用例：对数均匀网格与反演节点共享网格 (串行/节点并行) 对比，附带每条曲线的拉普拉斯调用数与去重节省数。
+ * 11. 抽样拟合用例：2000 点带噪合成数据 (固定随机种子)，默认对数均匀抽样 200 点与自适应抽样 30/60 点分别拟合，
+ *     记录残差点数、迭代次数、模型调用次数与拟合参数相对真值的误差；自适应用例附带各分箱的抽样密度。
+ * 12. [修改] 拟合用例覆盖迭代步策略 (阻尼 LM / 狗腿信赖域 / 测地加速 LM) × 上下限处理 (截断 / log-logit 变换)，
+ *     附带拒绝步数、雅可比计算次数与截断次数；回放模式按日志记录的策略重新拟合。
+ * 13. [新增] 再次拟合用例：首次拟合收敛后，参数按 5 位有效数字取整并新勾选 lambda1 再次拟合，
+ *     对比冷启动与热启动 (复用上次的雅可比与阻尼系数) 的模型调用次数；回放模式按日志复用热启动状态。
+ * 14. [新增] 命中测试用例：双对数图上 10^4 ~ 10^6 点的带噪曲线，对比 QCPGraph::selectTest 逐点扫描、
+ *     命中索引重建后查询 (首次点击) 与只查询 (悬停)，并记录两者距离的最大偏差。
+ * 15. [新增] 沿裂缝积分用例：N ∈ {4,8,12} 下每个影响矩阵元素的被积函数取值次数，
+ *     并在默认 4 条裂缝、z ∈ [1e-8, 1e3] 上与原 gauss15 二分递归 (绝对容限 1e-5) 对比取值次数与误差。
+ * 16. [新增] 时间解析用例：10^4 ~ 10^6 行定宽日期时刻文本的格式检测与解析吞吐量，
+ *     并检查不存在的日期 (2月31日、平年2月29日) 与“日期 + 只有时”在定宽、分组两种解析下都返回失败。
+ *
+ * 命令行参数:
+ *   --output <file>     结果 JSON 文件路径 (默认 bench_results.json)
+ *   --filter <text>     仅运行名称包含该文本的用例
+ *   --min-time <ms>     每个用例的最短测量时间 (默认 500 ms)
+ *   --max-points <n>    数据处理用例的最大点数 (默认 10000000)
+ *   --budget <s>        同一组用例中单次运行超过该时长后跳过更大规模 (默认 60 s)
+ *   --list              仅列出用例名称
+ *   --trace <file>      记录操作时间线并在结束时导出 Chrome Trace JSON
+ *   --replay <path>     回放模式：回放单个 .wtfr 文件或目录下全部 .wtfr 文件
+ *   --replay-tol <tol>  回放比对的相对容差 (默认 1e-6)
+ *   --replay-repeat <n> 每个日志回放次数，耗时取最小值 (默认 1)
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QThread>
+#include <QSet>
+#include <QDebug>
+
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <random>
+
+#include "modelsolver01-06.h"
+#include "pressurederivativecalculator.h"
+#include "pressurederivativecalculator1.h"
+#include "fittingcore.h"
+#include "fittingsampler.h"
+#include "datasinglesheet.h"
+#include "dataimportdialog.h"
+#include "tracerecorder.h"
+#include "perfcounters.h"
+#include "fitreplaylog.h"
+#include "mousezoom.h"
+#include "timeparser.h"
+
+#include "xlsxdocument.h"
+
+#include <boost/math/special_functions/bessel.hpp>
+
+// ============================================================================
+// 基准测试框架
+// ============================================================================
+
+// 单个用例的运行配置
+struct BenchOptions {
+    QString filter;
+    qint64 minTimeMs = 500;
+    qint64 maxPoints = 10000000;
+    double budgetSec = 60.0;
+    bool listOnly = false;
+};
+
+// 单个用例的定义
+struct BenchCase {
+    QString name;                       // 用例名称 (分组/参数)
+    QString group;                      // 分组名，用于超时跳过
+    qint64 items = 0;                   // 每次运行处理的条目数 (点数/行数)，用于吞吐量计算
+    std::function<void()> setup;        // 准备数据 (不计时)
+    std::function<void()> body;         // 被测代码
+    std::function<QJsonObject()> extra; // 附加统计信息 (可选)
+};
+
+class BenchRunner
+{
+public:
+    explicit BenchRunner(const BenchOptions& opt) : m_opt(opt) {}
+
+    void add(const BenchCase& c) { m_cases.append(c); }
+
+    // 依次运行全部用例，返回结果数组
+    QJsonArray runAll()
+    {
+        QJsonArray results;
+        QSet<QString> skippedGroups;
+
+        for (const BenchCase& c : m_cases) {
+            if (!m_opt.filter.isEmpty() && !c.name.contains(m_opt.filter)) continue;
+            if (m_opt.listOnly) { QTextStream(stdout) << c.name << "\n"; continue; }
+
+            QJsonObject r;
+            r["name"] = c.name;
+            r["group"] = c.group;
+            r["items"] = c.items;
+
+            // 同组较小规模已超出时间预算时，跳过更大规模
+            if (skippedGroups.contains(c.group)) {
+                r["skipped"] = "budget";
+                results.append(r);
+                QTextStream(stdout) << QString("%1  skipped (budget)\n").arg(c.name, -48);
+                continue;
+            }
+
+            if (c.setup) c.setup();
+
+            QVector<double> samplesMs;
+            QElapsedTimer total;
+            total.start();
+            while (true) {
+                QElapsedTimer t;
+                t.start();
+                c.body();
+                samplesMs.append(t.nsecsElapsed() / 1e6);
+                if (total.elapsed() >= m_opt.minTimeMs) break;
+                if (samplesMs.size() >= 100000) break;
+            }
+
+            double sum = 0, mn = samplesMs.first(), mx = samplesMs.first();
+            for (double v : samplesMs) { sum += v; mn = std::min(mn, v); mx = std::max(mx, v); }
+            double mean = sum / samplesMs.size();
+            double var = 0;
+            for (double v : samplesMs) var += (v - mean) * (v - mean);
+            double stddev = samplesMs.size() > 1 ? std::sqrt(var / (samplesMs.size() - 1)) : 0.0;
+
+            r["iterations"] = samplesMs.size();
+            r["totalMs"] = sum;
+            r["meanMs"] = mean;
+            r["minMs"] = mn;
+            r["maxMs"] = mx;
+            r["stddevMs"] = stddev;
+            if (c.items > 0 && mean > 0) r["itemsPerSecond"] = c.items / (mean / 1000.0);
+            if (c.extra) r["extra"] = c.extra();
+            results.append(r);
+
+            QTextStream(stdout) << QString("%1  %2 ms  (n=%3)\n")
+                                   .arg(c.name, -48).arg(mean, 12, 'f', 3).arg(samplesMs.size());
+
+            if (mn / 1000.0 > m_opt.budgetSec) skippedGroups.insert(c.group);
+        }
+        return results;
+    }
+
+private:
+    BenchOptions m_opt;
+    QVector<BenchCase> m_cases;
+};
+
+// ============================================================================
+// 合成数据生成
+// ============================================================================
+
+// 默认模型参数 (与 ModelManager::getDefaultParameters 的数值一致，不依赖项目参数单例)
+static QMap<QString, double> defaultParams(ModelSolver01_06::ModelType type, int nf, int N)
+{
+    QMap<QString, double> p;
+    p.insert("phi", 0.05); p.insert("h", 20.0); p.insert("mu", 0.5);
+    p.insert("B", 1.05); p.insert("Ct", 5e-4); p.insert("q", 5.0);
+
+    p.insert("nf", nf);
+    p.insert("N", N);
+    p.insert("kf", 1e-3);
+    p.insert("km", 1e-4);
+    p.insert("L", 1000.0);
+    p.insert("Lf", 100.0);
+    p.insert("LfD", 0.1);
+    p.insert("rmD", 4.0);
+    p.insert("omega1", 0.4);
+    p.insert("omega2", 0.08);
+    p.insert("lambda1", 1e-3);
+    p.insert("gamaD", 0.02);
+
+    bool hasStorage = (type == ModelSolver01_06::Model_1 || type == ModelSolver01_06::Model_3 || type == ModelSolver01_06::Model_5);
+    p.insert("cD", hasStorage ? 0.01 : 0.0);
+    p.insert("S", hasStorage ? 1.0 : 0.0);
+    if (type != ModelSolver01_06::Model_1 && type != ModelSolver01_06::Model_2) p.insert("reD", 10.0);
+    return p;
+}
+
+// 生成对数均匀时间 + 带噪声的压差数据 (固定随机种子，保证每次运行数据一致)
+static void makeSyntheticSeries(int n, QVector<double>& t, QVector<double>& dp)
+{
+    t.resize(n); dp.resize(n);
+    std::mt19937_64 rng(20260126);
+    std::normal_distribution<double> noise(0.0, 0.002);
+    double logMin = -3.0, logMax = 3.0;
+    for (int i = 0; i < n; ++i) {
+        double lt = (n > 1) ? logMin + (logMax - logMin) * i / (n - 1) : 0.0;
+        t[i] = std::pow(10.0, lt);
+        dp[i] = 2.0 * std::log(1.0 + t[i]) * (1.0 + noise(rng)) + 0.1;
+    }
+}
+
+// 写入 n 行 4 列的测试文本文件
+static void writeCsvFile(const QString& path, int n)
+{
+    QVector<double> t, dp;
+    makeSyntheticSeries(n, t, dp);
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) return;
+    QTextStream out(&f);
+    out << "时间(h),压力(MPa),温度(C),产量(m3/d)\n";
+    for (int i = 0; i < n; ++i) {
+        out << QString::number(t[i], 'g', 10) << ',' << QString::number(30.0 - dp[i], 'f', 5) << ','
+            << "85.2" << ',' << "12.5" << '\n';
+    }
+}
+
+// 写入 n 行 4 列的测试 xlsx 文件
+static void writeXlsxFile(const QString& path, int n)
+{
+    QVector<double> t, dp;
+    makeSyntheticSeries(n, t, dp);
+    QXlsx::Document xlsx;
+    xlsx.write(1, 1, "时间(h)"); xlsx.write(1, 2, "压力(MPa)");
+    xlsx.write(1, 3, "温度(C)"); xlsx.write(1, 4, "产量(m3/d)");
+    for (int i = 0; i < n; ++i) {
+        xlsx.write(i + 2, 1, t[i]);
+        xlsx.write(i + 2, 2, 30.0 - dp[i]);
+        xlsx.write(i + 2, 3, 85.2);
+        xlsx.write(i + 2, 4, 12.5);
+    }
+    xlsx.saveAs(path);
+}
+
+// ============================================================================
+// 用例注册
+// ============================================================================
+
+static QString modelTag(int m) { return QString("Model_%1").arg(m + 1); }
+
+// 模型求解：6 个模型 × nf × N
+static void registerSolverCases(BenchRunner& runner)
+{
+    const int nfList[] = {1, 4, 8, 16};
+    const int nList[] = {4, 8, 12};
+    QVector<double> tGrid = ModelSolver01_06::generateLogTimeSteps(100, -3.0, 3.0);
+
+    for (int m = 0; m < 6; ++m) {
+        ModelSolver01_06::ModelType type = static_cast<ModelSolver01_06::ModelType>(m);
+        for (int nf : nfList) {
+            for (int N : nList) {
+                auto solver = std::make_shared<ModelSolver01_06>(type);
+                solver->setHighPrecision(true);
+                QMap<QString, double> params = defaultParams(type, nf, N);
+
+                BenchCase c;
+                c.name = QString("solver/%1/nf=%2/N=%3").arg(modelTag(m)).arg(nf).arg(N);
+                c.group = QString("solver/%1/nf=%2").arg(modelTag(m)).arg(nf);
+                c.items = tGrid.size();
+                c.body = [solver, params, tGrid]() {
+                    ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+                    Q_UNUSED(res);
+                };
+                runner.add(c);
+            }
+        }
+    }
+}
+
+// 多参数组曲线计算：逐组调用与 calculateTheoreticalCurves (共享储层解 + 线程并行) 对比
+// (items 为曲线条数，吞吐量即每秒曲线数)
+// sweep: 只改变 S/cD (共用储层解)；population: 储层与井参数均随机扰动 (固定随机种子)
+static void registerBatchCases(BenchRunner& runner)
+{
+    const int setCounts[] = {16, 64, 256};
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+    QVector<double> tGrid = ModelSolver01_06::generateLogTimeSteps(100, -3.0, 3.0);
+    QMap<QString, double> base = defaultParams(type, 4, 8);
+
+    for (const QString& scenario : {QString("sweep"), QString("population")}) {
+        for (int M : setCounts) {
+            auto sets = std::make_shared<QVector<QMap<QString, double>>>();
+            std::mt19937_64 rng(20260126 + M);
+            std::uniform_real_distribution<double> u(-1.0, 1.0);
+            for (int s = 0; s < M; ++s) {
+                QMap<QString, double> p = base;
+                double frac = (M > 1) ? double(s) / (M - 1) : 0.0;
+                if (scenario == "sweep") {
+                    p["S"] = std::pow(10.0, -1.0 + 2.0 * frac);
+                    p["cD"] = std::pow(10.0, -3.0 + 2.0 * std::fmod(frac * 7.0, 1.0));
+                } else {
+                    p["km"] *= std::pow(10.0, 0.5 * u(rng));
+                    p["omega1"] *= 1.0 + 0.3 * u(rng);
+                    p["lambda1"] *= std::pow(10.0, u(rng));
+                    p["S"] *= std::pow(10.0, u(rng));
+                    p["cD"] *= std::pow(10.0, u(rng));
+                }
+                sets->append(p);
+            }
+
+            auto solver = std::make_shared<ModelSolver01_06>(type);
+            solver->setHighPrecision(true);
+            QString prefix = QString("multiset/%1/%2/M=%3").arg(modelTag(type), scenario).arg(M);
+
+            BenchCase serial;
+            serial.name = prefix + "/per-set";
+            serial.group = QString("multiset/%1/per-set").arg(scenario);
+            serial.items = M;
+            serial.body = [solver, sets, tGrid]() {
+                for (const QMap<QString, double>& p : *sets) {
+                    ModelCurveData res = solver->calculateTheoreticalCurve(p, tGrid);
+                    Q_UNUSED(res);
+                }
+            };
+            runner.add(serial);
+
+            BenchCase batch;
+            batch.name = prefix + "/shared-threaded";
+            batch.group = QString("multiset/%1/shared-threaded").arg(scenario);
+            batch.items = M;
+            batch.body = [solver, sets, tGrid]() {
+                QVector<ModelCurveData> res = solver->calculateTheoreticalCurves(*sets, tGrid);
+                Q_UNUSED(res);
+            };
+            // 批量结果应与逐组计算逐位一致
+            batch.extra = [solver, sets, tGrid]() {
+                QVector<ModelCurveData> curves = solver->calculateTheoreticalCurves(*sets, tGrid);
+                bool identical = curves.size() == sets->size();
+                for (int s = 0; identical && s < sets->size(); ++s) {
+                    ModelCurveData single = solver->calculateTheoreticalCurve(sets->at(s), tGrid);
+                    identical = std::get<1>(single) == std::get<1>(curves[s]) && std::get<2>(single) == std::get<2>(curves[s]);
+                }
+                QJsonObject o;
+                o["identicalToSerial"] = identical;
+                o["threads"] = QThread::idealThreadCount();
+                return o;
+            };
+            runner.add(batch);
+        }
+    }
+}
+
+// 非均匀裂缝表：nf ∈ {16,32,64,128}，间距与半长随机 (固定随机种子)；nf >= 32 时走 H-矩阵 + GMRES
+static void registerFractureTableCases(BenchRunner& runner)
+{
+    const int nfList[] = {16, 32, 64, 128};
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+    QVector<double> tGrid = ModelSolver01_06::generateLogTimeSteps(100, -3.0, 3.0);
+
+    for (int nf : nfList) {
+        QMap<QString, double> params = defaultParams(type, nf, 4);
+        const double L = params.value("L");
+        std::mt19937_64 rng(20260126 + nf);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        params.insert(ModelSolver01_06::FractureCountKey, nf);
+        for (int i = 1; i <= nf; ++i) {
+            double base = (nf == 1) ? 0.0 : -0.9 + 1.8 * (i - 1) / (nf - 1);
+            double jitter = (nf == 1) ? 0.0 : 0.3 * (u(rng) - 0.5) * 1.8 / (nf - 1);
+            params.insert(ModelSolver01_06::fractureXKey(i), (base + jitter) * L);
+            params.insert(ModelSolver01_06::fractureLfKey(i), params.value("Lf") * (0.5 + u(rng)));
+        }
+
+        auto solver = std::make_shared<ModelSolver01_06>(type);
+        solver->setHighPrecision(true);
+        BenchCase c;
+        c.name = QString("fracture-table/%1/nf=%2").arg(modelTag(type)).arg(nf);
+        c.group = "fracture-table";
+        c.items = tGrid.size();
+        c.body = [solver, params, tGrid]() {
+            ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+            Q_UNUSED(res);
+        };
+        runner.add(c);
+    }
+}
+
+// 反演时间网格：100 点对数均匀网格 vs 反演节点共享网格 (Model_1, nf = 4, N ∈ {4,8})
+static void registerInversionGridCases(BenchRunner& runner)
+{
+    const int nList[] = {4, 8};
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+
+    for (int N : nList) {
+        QMap<QString, double> params = defaultParams(type, 4, N);
+        for (const QString& grid : {QString("log"), QString("shared"), QString("shared-parallel")}) {
+            QVector<double> tGrid = (grid == "log") ? ModelSolver01_06::generateLogTimeSteps(100, -3.0, 3.0)
+                                                    : ModelSolver01_06::generateInversionSharedTimeSteps(100, -3.0, 3.0);
+            auto solver = std::make_shared<ModelSolver01_06>(type);
+            solver->setHighPrecision(true);
+            solver->setParallelInversion(grid == "shared-parallel");
+
+            BenchCase c;
+            c.name = QString("inversion-grid/%1/N=%2/%3").arg(modelTag(type)).arg(N).arg(grid);
+            c.group = QString("inversion-grid/N=%1").arg(N);
+            c.items = tGrid.size();
+            c.body = [solver, params, tGrid]() {
+                ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+                Q_UNUSED(res);
+            };
+            // 单条曲线的拉普拉斯调用数与去重节省数 (临时开启性能计数)
+            c.extra = [solver, params, tGrid]() {
+                bool wasEnabled = PerfCounters::isEnabled();
+                PerfCounters::setEnabled(true);
+                PerfSnapshot before = PerfCounters::snapshot();
+                ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+                Q_UNUSED(res);
+                PerfSnapshot delta = PerfCounters::snapshot() - before;
+                PerfCounters::setEnabled(wasEnabled);
+                QJsonObject o;
+                o["points"] = tGrid.size();
+                o["laplaceEvaluations"] = double(delta.counters[PerfCounters::LaplaceEvaluations]);
+                o["laplaceNodesShared"] = double(delta.counters[PerfCounters::LaplaceNodesShared]);
+                return o;
+            };
+            runner.add(c);
+        }
+    }
+}
+
+// 原 gauss15 二分递归 (G7K15 之前的沿裂缝积分，仅作对比)：每层 3 次 15 点求积，父层结果丢弃
+static double legacyGauss15(const std::function<double(double)>& f, double a, double b)
+{
+    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
+    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
+    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
+    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
+    return s * h;
+}
+
+static double legacyAdaptiveGauss(const std::function<double(double)>& f, double a, double b, double eps, int depth)
+{
+    double c = (a + b) / 2.0; double v1 = legacyGauss15(f, a, b); double v2 = legacyGauss15(f, a, c) + legacyGauss15(f, c, b);
+    if (depth >= 10 || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
+    return legacyAdaptiveGauss(f, a, c, eps / 2, depth + 1) + legacyAdaptiveGauss(f, c, b, eps / 2, depth + 1);
+}
+
+// 沿裂缝积分：N ∈ {4,8,12}，Model_1、nf = 4
+// extra 记录求解器中每个影响矩阵元素的被积函数取值次数 (15 × G7K15 区间数 / 元素数)，
+// 并在同一裂缝布置、z ∈ [1e-8, 1e3] 上对 K0 核分别用原 gauss15 二分递归与 G7K15 求积，
+// 以容限 1e-14 的 G7K15 结果为参考值，比较平均取值次数与最大绝对误差
+static void registerQuadratureCases(BenchRunner& runner)
+{
+    const int nList[] = {4, 8, 12};
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+    QVector<double> tGrid = ModelSolver01_06::generateLogTimeSteps(100, -3.0, 3.0);
+
+    for (int N : nList) {
+        QMap<QString, double> params = defaultParams(type, 4, N);
+        auto solver = std::make_shared<ModelSolver01_06>(type);
+        solver->setHighPrecision(true);
+
+        BenchCase c;
+        c.name = QString("quadrature/%1/nf=4/N=%2").arg(modelTag(type)).arg(N);
+        c.group = "quadrature";
+        c.items = tGrid.size();
+        c.body = [solver, params, tGrid]() {
+            ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+            Q_UNUSED(res);
+        };
+        c.extra = [solver, params, tGrid, N]() {
+            bool wasEnabled = PerfCounters::isEnabled();
+            PerfCounters::setEnabled(true);
+            PerfSnapshot before = PerfCounters::snapshot();
+            ModelCurveData res = solver->calculateTheoreticalCurve(params, tGrid);
+            Q_UNUSED(res);
+            PerfSnapshot delta = PerfCounters::snapshot() - before;
+            PerfCounters::setEnabled(wasEnabled);
+            const double entries = double(delta.counters[PerfCounters::InfluenceEntries]);
+
+            // 独立对比：默认布置 xwD = -0.9 + 0.6·i，半长 LfD = Lf / L，核函数 K0(γ|Δx - a|)，γ = sqrt(z·omega1)
+            const int nf = 4;
+            const double LfD = params.value("Lf") / params.value("L");
+            const double absTol = ModelSolver01_06::quadratureTolerance(N);
+            quint64 legacyEvals = 0, kronrodEvals = 0;
+            double legacyError = 0.0, kronrodError = 0.0;
+            int comparisons = 0;
+            for (int e = -8; e <= 3; ++e) {
+                const double gama = std::sqrt(std::pow(10.0, e) * params.value("omega1"));
+                for (int i = 0; i < nf; ++i) {
+                    for (int j = 0; j < nf; ++j) {
+                        const double dx = 0.6 * (i - j);
+                        quint64* counter = nullptr;
+                        auto kernel = [&](double a) -> double {
+                            if (counter) ++*counter;
+                            return boost::math::cyl_bessel_k(0, std::max(gama * std::abs(dx - a), 1e-10));
+                        };
+                        QVector<double> breakpoints;
+                        breakpoints << -LfD;
+                        if (dx > -LfD && dx < LfD) breakpoints << dx;
+                        breakpoints << LfD;
+
+                        double reference = ModelSolver01_06::adaptiveGaussKronrod(kernel, breakpoints, 1e-14, 2000);
+                        counter = &legacyEvals;
+                        double legacy = legacyAdaptiveGauss(kernel, -LfD, LfD, 1e-5, 0);
+                        counter = &kronrodEvals;
+                        double kronrod = ModelSolver01_06::adaptiveGaussKronrod(kernel, breakpoints, absTol, 200);
+                        legacyError = std::max(legacyError, std::abs(legacy - reference));
+                        kronrodError = std::max(kronrodError, std::abs(kronrod - reference));
+                        ++comparisons;
+                    }
+                }
+            }
+
+            QJsonObject o;
+            o["absTol"] = absTol;
+            o["influenceEntries"] = entries;
+            o["evaluationsPerEntry"] = entries > 0 ? 15.0 * delta.counters[PerfCounters::GaussPanels] / entries : 0.0;
+            QJsonObject kernel;
+            kernel["entries"] = comparisons;
+            kernel["legacyEvaluationsPerEntry"] = double(legacyEvals) / comparisons;
+            kernel["kronrodEvaluationsPerEntry"] = double(kronrodEvals) / comparisons;
+            kernel["reduction"] = kronrodEvals > 0 ? double(legacyEvals) / kronrodEvals : 0.0;
+            kernel["legacyMaxError"] = legacyError;
+            kernel["kronrodMaxError"] = kronrodError;
+            o["kernelComparison"] = kernel;
+            return o;
+        };
+        runner.add(c);
+    }
+}
+
+// Bourdet 导数、平滑与抽样：10^3 ~ 10^7 点
+static void registerDataCases(BenchRunner& runner, const BenchOptions& opt)
+{
+    for (qint64 n = 1000; n <= opt.maxPoints; n *= 10) {
+        auto t = std::make_shared<QVector<double>>();
+        auto dp = std::make_shared<QVector<double>>();
+        auto deriv = std::make_shared<QVector<double>>();
+        int count = static_cast<int>(n);
+
+        auto prepare = [t, dp, count]() {
+            if (t->size() != count) makeSyntheticSeries(count, *t, *dp);
+        };
+
+        BenchCase bourdet;
+        bourdet.name = QString("bourdet/n=%1").arg(n);
+        bourdet.group = "bourdet";
+        bourdet.items = n;
+        bourdet.setup = prepare;
+        bourdet.body = [t, dp]() {
+            QVector<double> d = PressureDerivativeCalculator::calculateBourdetDerivative(*t, *dp, 0.15);
+            Q_UNUSED(d);
+        };
+        runner.add(bourdet);
+
+        BenchCase smooth;
+        smooth.name = QString("smooth/n=%1/span=21").arg(n);
+        smooth.group = "smooth";
+        smooth.items = n;
+        smooth.setup = prepare;
+        smooth.body = [dp]() {
+            QVector<double> s = PressureDerivativeCalculator1::smoothData(*dp, 21);
+            Q_UNUSED(s);
+        };
+        runner.add(smooth);
+
+        BenchCase sampling;
+        sampling.name = QString("sampling/default/n=%1").arg(n);
+        sampling.group = "sampling/default";
+        sampling.items = n;
+        sampling.setup = [prepare, t, deriv]() {
+            prepare();
+            if (deriv->size() != t->size()) deriv->fill(1.0, t->size());
+        };
+        sampling.body = [t, dp, deriv]() {
+            QVector<double> ot, op, od;
+            FittingCore::getLogSampledData(*t, *dp, *deriv, false, QList<SamplingInterval>(), ot, op, od);
+        };
+        runner.add(sampling);
+
+        BenchCase custom;
+        custom.name = QString("sampling/custom/n=%1").arg(n);
+        custom.group = "sampling/custom";
+        custom.items = n;
+        custom.setup = sampling.setup;
+        custom.body = [t, dp, deriv]() {
+            QList<SamplingInterval> intervals;
+            intervals.append({1e-3, 1e-1, 60});
+            intervals.append({1e-1, 1e1, 80});
+            intervals.append({1e1, 1e3, 60});
+            QVector<double> ot, op, od;
+            FittingCore::getLogSampledData(*t, *dp, *deriv, true, intervals, ot, op, od);
+        };
+        runner.add(custom);
+    }
+}
+
+// 文本与 xlsx 导入吞吐量
+static void registerImportCases(BenchRunner& runner, const BenchOptions& opt, const QString& tmpDir)
+{
+    const qint64 sizes[] = {10000, 100000, 1000000};
+    for (qint64 n : sizes) {
+        if (n > opt.maxPoints) continue;
+
+        QString csvPath = QString("%1/import_%2.csv").arg(tmpDir).arg(n);
+        BenchCase csv;
+        csv.name = QString("import/csv/rows=%1").arg(n);
+        csv.group = "import/csv";
+        csv.items = n;
+        csv.setup = [csvPath, n]() { if (!QFile::exists(csvPath)) writeCsvFile(csvPath, static_cast<int>(n)); };
+        csv.body = [csvPath]() {
+            DataImportSettings s;
+            s.filePath = csvPath; s.encoding = "UTF-8"; s.separator = "Comma (,)";
+            s.startRow = 2; s.headerRow = 1; s.useHeader = true; s.isExcel = false;
+            DataSingleSheet sheet;
+            sheet.loadData(csvPath, s);
+        };
+        runner.add(csv);
+
+        QString xlsxPath = QString("%1/import_%2.xlsx").arg(tmpDir).arg(n);
+        BenchCase xl;
+        xl.name = QString("import/xlsx/rows=%1").arg(n);
+        xl.group = "import/xlsx";
+        xl.items = n;
+        xl.setup = [xlsxPath, n]() { if (!QFile::exists(xlsxPath)) writeXlsxFile(xlsxPath, static_cast<int>(n)); };
+        xl.body = [xlsxPath]() {
+            DataImportSettings s;
+            s.filePath = xlsxPath; s.encoding = "UTF-8"; s.separator = "Auto";
+            s.startRow = 2; s.headerRow = 1; s.useHeader = true; s.isExcel = true;
+            DataSingleSheet sheet;
+            sheet.loadData(xlsxPath, s);
+        };
+        runner.add(xl);
+    }
+}
+
+// 时间解析吞吐量与校验：定宽 "yyyy-MM-dd hh:mm:ss" 文本，每行递增 1 秒
+static void registerTimeParseCases(BenchRunner& runner, const BenchOptions& opt)
+{
+    for (qint64 n = 10000; n <= std::min<qint64>(opt.maxPoints, 1000000); n *= 10) {
+        auto column = std::make_shared<QVector<QString>>();
+        int count = static_cast<int>(n);
+
+        BenchCase c;
+        c.name = QString("timeparse/fixed/rows=%1").arg(n);
+        c.group = "timeparse/fixed";
+        c.items = n;
+        c.setup = [column, count]() {
+            if (column->size() == count) return;
+            column->resize(count);
+            const QDate base(2024, 1, 1);
+            for (int i = 0; i < count; ++i) {
+                int s = i % 86400;
+                (*column)[i] = base.addDays(i / 86400).toString("yyyy-MM-dd")
+                               + QString::asprintf(" %02d:%02d:%02d", s / 3600, s / 60 % 60, s % 60);
+            }
+        };
+        c.body = [column]() {
+            TimeTextFormat f = FastTimeParser::detect(*column);
+            double sum = 0.0;
+            for (const QString& s : *column) sum += FastTimeParser::toSeconds(s, f);
+            Q_UNUSED(sum);
+        };
+        // 不存在的日期与“日期 + 只有时”在两种解析下都应失败
+        c.extra = []() {
+            TimeTextFormat fixed = FastTimeParser::detect({QString("2024-01-05 10:30:00")});
+            TimeTextFormat generic = fixed;
+            generic.fixedWidth = false;
+            auto rejected = [&](const QString& text) {
+                return std::isnan(FastTimeParser::toSeconds(text, fixed))
+                       && std::isnan(FastTimeParser::toSeconds(text, generic));
+            };
+            bool invalidDay = fixed.fixedWidth && rejected("2024-02-31 10:30:00") && rejected("2023-02-29 10:30:00")
+                              && rejected("2024-04-31 10:30:00") && rejected("2024-2-31 10:30:00");
+            bool leapDay = FastTimeParser::toSeconds("2024-02-29 10:30:00", fixed)
+                           == FastTimeParser::toSeconds("2024-02-29 10:30:00", generic)
+                           && !std::isnan(FastTimeParser::toSeconds("2024-02-29 10:30:00", fixed));
+
+            // 定宽布局本身为“日期 + 只有时”时与分组解析一致 (失败)
+            TimeTextFormat hourOnly;
+            hourOnly.valid = hourOnly.hasDate = hourOnly.hasTime = hourOnly.fixedWidth = true;
+            hourOnly.length = 13;
+            const int pos[] = {0, 5, 8, 11};
+            const int len[] = {4, 2, 2, 2};
+            for (int i = 0; i < 4; ++i) { hourOnly.fieldPos[i] = pos[i]; hourOnly.fieldLen[i] = len[i]; }
+            TimeTextFormat hourOnlyGeneric = hourOnly;
+            hourOnlyGeneric.fixedWidth = false;
+            bool hourOnlyRejected = rejected("2024-01-05 10")
+                                    && std::isnan(FastTimeParser::toSeconds("2024-01-05 10", hourOnly))
+                                    && std::isnan(FastTimeParser::toSeconds("2024-01-05 10", hourOnlyGeneric));
+
+            if (!invalidDay || !leapDay || !hourOnlyRejected)
+                qWarning() << "时间解析校验失败: invalidDay" << invalidDay << "leapDay" << leapDay
+                           << "hourOnly" << hourOnlyRejected;
+            QJsonObject o;
+            o["invalidDayRejected"] = invalidDay;
+            o["leapDayAccepted"] = leapDay;
+            o["hourOnlyRejected"] = hourOnlyRejected;
+            return o;
+        };
+        runner.add(c);
+    }
+}
+
+// 拟合用例共用的参数表：默认参数中 kf/km/Lf/omega1 偏离真值作为初值，上下限取初值的 1e-3 ~ 1e3 倍
+// values 非空时以其中的值作为初值 (上下限不变)，fitNames 为参与拟合的参数
+static QList<FitParameter> makeBenchFitParams(ModelSolver01_06::ModelType type,
+                                              const QStringList& fitNames = {"kf", "km", "Lf", "omega1"},
+                                              const QMap<QString, double>& values = QMap<QString, double>())
+{
+    QMap<QString, double> start = defaultParams(type, 4, 8);
+    start["kf"] = 3e-3; start["km"] = 3e-5; start["Lf"] = 60.0; start["omega1"] = 0.2;
+
+    QList<FitParameter> params;
+    for (auto it = start.begin(); it != start.end(); ++it) {
+        FitParameter fp;
+        fp.name = it.key();
+        fp.value = values.value(it.key(), it.value());
+        fp.isFit = fitNames.contains(it.key());
+        fp.min = it.value() > 0 ? it.value() * 1e-3 : -100.0;
+        fp.max = it.value() > 0 ? it.value() * 1e3 : 100.0;
+        params.append(fp);
+    }
+    return params;
+}
+
+// 完整 LM 拟合：以 Model_2 默认参数生成“观测”数据，从偏离的初值开始拟合
+static void registerFitCases(BenchRunner& runner)
+{
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_2;
+
+    // 迭代步策略 × 上下限处理；第一项与旧版本用例同名
+    struct FitVariant { QString tag; FittingCore::StepStrategy strategy; FittingCore::BoundHandling bounds; };
+    const QVector<FitVariant> variants = {
+        {"lm", FittingCore::Step_LevenbergMarquardt, FittingCore::Bound_Clamp},
+        {"lm-logit", FittingCore::Step_LevenbergMarquardt, FittingCore::Bound_Transform},
+        {"dogleg", FittingCore::Step_Dogleg, FittingCore::Bound_Clamp},
+        {"dogleg-logit", FittingCore::Step_Dogleg, FittingCore::Bound_Transform},
+        {"geodesic", FittingCore::Step_GeodesicLM, FittingCore::Bound_Clamp},
+        {"geodesic-logit", FittingCore::Step_GeodesicLM, FittingCore::Bound_Transform},
+    };
+
+    for (const FitVariant& variant : variants) {
+        auto solver = std::make_shared<ModelSolver01_06>(type);
+        auto evalCount = std::make_shared<std::atomic<qint64>>(0);
+        auto lastResult = std::make_shared<FittingResult>();
+
+        auto obsT = std::make_shared<QVector<double>>();
+        auto obsP = std::make_shared<QVector<double>>();
+        auto obsD = std::make_shared<QVector<double>>();
+
+        BenchCase c;
+        c.name = QString("fit/%1/Model_2/synthetic").arg(variant.tag);
+        c.group = "fit";
+        c.setup = [solver, obsT, obsP, obsD]() {
+            solver->setHighPrecision(true);
+            QMap<QString, double> truth = defaultParams(type, 4, 8);
+            QVector<double> t = ModelSolver01_06::generateLogTimeSteps(400, -2.0, 3.0);
+            ModelCurveData res = solver->calculateTheoreticalCurve(truth, t);
+            *obsT = std::get<0>(res); *obsP = std::get<1>(res); *obsD = std::get<2>(res);
+        };
+        c.body = [solver, evalCount, lastResult, obsT, obsP, obsD, variant]() {
+            // 与界面拟合一致：拟合期间使用低精度
+            solver->setHighPrecision(false);
+
+            const QList<FitParameter> params = makeBenchFitParams(type);
+
+            FittingCore core([solver, evalCount](ModelSolver01_06::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+                evalCount->fetch_add(1);
+                return solver->calculateTheoreticalCurve(p, t);
+            });
+
+            QVector<double> fitT, fitP, fitD;
+            FittingCore::getLogSampledData(*obsT, *obsP, *obsD, false, QList<SamplingInterval>(), fitT, fitP, fitD);
+
+            core.setStepStrategy(variant.strategy);
+            core.setBoundHandling(variant.bounds);
+            evalCount->store(0);
+            *lastResult = core.runLevenbergMarquardt(type, params, 0.5, fitT, fitP, fitD);
+            solver->setHighPrecision(true);
+        };
+        c.extra = [evalCount, lastResult]() {
+            QJsonObject o;
+            o["modelEvaluations"] = static_cast<double>(evalCount->load());
+            o["lmIterations"] = lastResult->iterations;
+            o["finalMse"] = lastResult->mse;
+            o["rejectedSteps"] = lastResult->rejectedSteps;
+            o["jacobianEvaluations"] = lastResult->jacobianEvaluations;
+            o["boundHits"] = lastResult->boundHits;
+            QJsonObject p;
+            for (const QString& k : {QString("kf"), QString("km"), QString("Lf"), QString("omega1")})
+                p[k] = lastResult->params.value(k);
+            o["finalParams"] = p;
+            return o;
+        };
+        runner.add(c);
+    }
+}
+
+// 抽样策略对拟合的影响：相同带噪数据、相同初值，比较残差点数与参数精度
+static void registerSamplingCases(BenchRunner& runner)
+{
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_2;
+    const QStringList fitNames = {"kf", "km", "Lf", "omega1"};
+    auto obsT = std::make_shared<QVector<double>>();
+    auto obsP = std::make_shared<QVector<double>>();
+    auto obsD = std::make_shared<QVector<double>>();
+
+    // 合成数据只生成一次，各用例共享
+    auto makeData = [obsT, obsP, obsD]() {
+        if (!obsT->isEmpty()) return;
+        ModelSolver01_06 solver(type);
+        solver.setHighPrecision(true);
+        QVector<double> t = ModelSolver01_06::generateLogTimeSteps(2000, -2.0, 3.0);
+        ModelCurveData res = solver.calculateTheoreticalCurve(defaultParams(type, 4, 8), t);
+        *obsT = std::get<0>(res); *obsP = std::get<1>(res); *obsD = std::get<2>(res);
+
+        // 乘性噪声：压差 1%，导数 3%
+        std::mt19937 rng(20260126);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        for (int i = 0; i < obsT->size(); ++i) {
+            (*obsP)[i] *= 1.0 + 0.01 * noise(rng);
+            (*obsD)[i] *= std::max(0.05, 1.0 + 0.03 * noise(rng));
+        }
+    };
+
+    for (int adaptiveCount : {0, 30, 60}) {
+        auto solver = std::make_shared<ModelSolver01_06>(type);
+        auto evalCount = std::make_shared<std::atomic<qint64>>(0);
+        auto lastResult = std::make_shared<FittingResult>();
+        auto pointCount = std::make_shared<int>(0);
+
+        BenchCase c;
+        c.name = QString("sampling-fit/%1/%2").arg(modelTag(type))
+                     .arg(adaptiveCount > 0 ? QString("adaptive-%1").arg(adaptiveCount) : QString("log-uniform-200"));
+        c.group = "sampling-fit";
+        c.setup = makeData;
+        c.body = [solver, evalCount, lastResult, pointCount, obsT, obsP, obsD, adaptiveCount]() {
+            solver->setHighPrecision(false);
+
+            const QList<FitParameter> params = makeBenchFitParams(type);
+
+            FittingCore core([solver, evalCount](ModelSolver01_06::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+                evalCount->fetch_add(1);
+                return solver->calculateTheoreticalCurve(p, t);
+            });
+
+            QVector<double> fitT, fitP, fitD;
+            FittingCore::getLogSampledData(*obsT, *obsP, *obsD, false, QList<SamplingInterval>(), fitT, fitP, fitD,
+                                           adaptiveCount);
+            *pointCount = fitT.size();
+
+            evalCount->store(0);
+            *lastResult = core.runLevenbergMarquardt(type, params, 0.5, fitT, fitP, fitD);
+            solver->setHighPrecision(true);
+        };
+        c.extra = [evalCount, lastResult, pointCount, fitNames, obsT, obsP, obsD, adaptiveCount]() {
+            QMap<QString, double> truth = defaultParams(type, 4, 8);
+            QJsonObject o;
+            o["sampledPoints"] = *pointCount;
+            o["modelEvaluations"] = static_cast<double>(evalCount->load());
+            o["lmIterations"] = lastResult->iterations;
+            o["finalMse"] = lastResult->mse;
+            QJsonObject err;
+            double maxErr = 0.0;
+            for (const QString& k : fitNames) {
+                double ref = truth.value(k);
+                double e = ref != 0.0 ? std::abs(lastResult->params.value(k) - ref) / std::abs(ref) : 0.0;
+                err[k] = e;
+                maxErr = std::max(maxErr, e);
+            }
+            o["paramRelError"] = err;
+            o["maxParamRelError"] = maxErr;
+
+            // 自适应抽样的密度分布 (均值为 1)，对照导数曲线检查转换段是否分到更多点
+            if (adaptiveCount > 0) {
+                AdaptiveSamplingOptions options;
+                options.targetCount = adaptiveCount;
+                double logMin = 0.0, logMax = 0.0;
+                QVector<double> density = AdaptiveSampler::densityProfile(*obsT, *obsP, *obsD, options, logMin, logMax);
+                QJsonArray arr;
+                for (double v : density) arr.append(v);
+                QJsonObject profile;
+                profile["log10TimeMin"] = logMin;
+                profile["log10TimeMax"] = logMax;
+                profile["density"] = arr;
+                o["densityProfile"] = profile;
+            }
+            return o;
+        };
+        runner.add(c);
+    }
+}
+
+// 微调后再次拟合：首次拟合的最终状态作为热启动输入，与冷启动对比模型调用次数
+static void registerRefitCases(BenchRunner& runner)
+{
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_2;
+    auto obsT = std::make_shared<QVector<double>>();
+    auto obsP = std::make_shared<QVector<double>>();
+    auto obsD = std::make_shared<QVector<double>>();
+    auto firstParams = std::make_shared<QMap<QString, double>>();
+    auto firstState = std::make_shared<FitWarmStart>();
+
+    // 首次拟合只做一次，冷/热两个用例共享
+    auto firstFit = [obsT, obsP, obsD, firstParams, firstState]() {
+        if (firstState->isValid()) return;
+        ModelSolver01_06 solver(type);
+        solver.setHighPrecision(true);
+        QVector<double> t = ModelSolver01_06::generateLogTimeSteps(400, -2.0, 3.0);
+        ModelCurveData res = solver.calculateTheoreticalCurve(defaultParams(type, 4, 8), t);
+        *obsT = std::get<0>(res); *obsP = std::get<1>(res); *obsD = std::get<2>(res);
+
+        solver.setHighPrecision(false);
+        FittingCore core([&solver](ModelSolver01_06::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(p, t);
+        });
+        QVector<double> fitT, fitP, fitD;
+        FittingCore::getLogSampledData(*obsT, *obsP, *obsD, false, QList<SamplingInterval>(), fitT, fitP, fitD);
+        FittingResult first = core.runLevenbergMarquardt(type, makeBenchFitParams(type), 0.5, fitT, fitP, fitD);
+        *firstParams = first.params;
+        *firstState = first.finalState;
+    };
+
+    for (bool warm : {false, true}) {
+        auto solver = std::make_shared<ModelSolver01_06>(type);
+        auto evalCount = std::make_shared<std::atomic<qint64>>(0);
+        auto lastResult = std::make_shared<FittingResult>();
+
+        BenchCase c;
+        c.name = QString("refit/%1/%2").arg(modelTag(type)).arg(warm ? "warm" : "cold");
+        c.group = "refit";
+        c.setup = firstFit;
+        c.body = [solver, evalCount, lastResult, obsT, obsP, obsD, firstParams, firstState, warm]() {
+            solver->setHighPrecision(false);
+
+            // 参数表显示精度取整后再次拟合，并新勾选 lambda1
+            QMap<QString, double> start = *firstParams;
+            for (auto it = start.begin(); it != start.end(); ++it) it.value() = QString::number(it.value(), 'g', 5).toDouble();
+
+            FittingCore core([solver, evalCount](ModelSolver01_06::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+                evalCount->fetch_add(1);
+                return solver->calculateTheoreticalCurve(p, t);
+            });
+            if (warm) core.setWarmStart(*firstState);
+
+            QVector<double> fitT, fitP, fitD;
+            FittingCore::getLogSampledData(*obsT, *obsP, *obsD, false, QList<SamplingInterval>(), fitT, fitP, fitD);
+
+            evalCount->store(0);
+            *lastResult = core.runLevenbergMarquardt(type, makeBenchFitParams(type, {"kf", "km", "Lf", "omega1", "lambda1"}, start),
+                                                     0.5, fitT, fitP, fitD);
+            solver->setHighPrecision(true);
+        };
+        c.extra = [evalCount, lastResult]() {
+            QJsonObject o;
+            o["modelEvaluations"] = static_cast<double>(evalCount->load());
+            o["lmIterations"] = lastResult->iterations;
+            o["finalMse"] = lastResult->mse;
+            o["warmStarted"] = lastResult->warmStarted;
+            o["warmStartColumns"] = lastResult->warmStartColumns;
+            o["jacobianEvaluations"] = lastResult->jacobianEvaluations;
+            return o;
+        };
+        runner.add(c);
+    }
+}
+
+// 曲线点击/悬停的命中测试：QCustomPlot 逐点扫描与命中索引对比
+static void registerHitTestCases(BenchRunner& runner, const BenchOptions& opt)
+{
+    for (qint64 n = 10000; n <= std::min<qint64>(opt.maxPoints, 1000000); n *= 10) {
+        auto plot = std::make_shared<std::unique_ptr<MouseZoom>>();
+        auto positions = std::make_shared<QVector<QPointF>>();
+        int count = static_cast<int>(n);
+
+        // 1000x700 双对数图，查询点取曲线上 9 个数据点旁 (3, 2) 像素处
+        auto prepare = [plot, positions, count]() {
+            if (*plot) return;
+            QVector<double> t, dp;
+            makeSyntheticSeries(count, t, dp);
+            plot->reset(new MouseZoom());
+            MouseZoom* p = plot->get();
+            p->resize(1000, 700);
+            p->xAxis->setScaleType(QCPAxis::stLogarithmic);
+            p->yAxis->setScaleType(QCPAxis::stLogarithmic);
+            QCPGraph* graph = p->addGraph();
+            graph->setData(t, dp, true);
+            graph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, 3));
+            p->rescaleAxes();
+            p->replot();
+            positions->clear();
+            for (int k = 1; k <= 9; ++k) {
+                int i = static_cast<int>(qint64(count - 1) * k / 10);
+                positions->append(graph->coordsToPixels(t[i], dp[i]) + QPointF(3.0, 2.0));
+            }
+        };
+
+        BenchCase scan;
+        scan.name = QString("hit-test/selectTest/n=%1").arg(n);
+        scan.group = "hit-test/selectTest";
+        scan.items = n;
+        scan.setup = prepare;
+        scan.body = [plot, positions]() {
+            QCPGraph* graph = (*plot)->graph(0);
+            for (const QPointF& pos : *positions) graph->selectTest(pos, false);
+        };
+        runner.add(scan);
+
+        auto maxDiff = [plot, positions]() {
+            QCPGraph* graph = (*plot)->graph(0);
+            double diff = 0.0;
+            for (const QPointF& pos : *positions) {
+                double ref = graph->selectTest(pos, false);
+                double d = (*plot)->hitIndex()->graphDistance(graph, pos, (*plot)->selectionTolerance());
+                if (ref >= 0 && ref < (*plot)->selectionTolerance()) diff = std::max(diff, d >= 0 ? std::abs(d - ref) : ref);
+            }
+            QJsonObject o;
+            o["maxDistanceDiff"] = diff;
+            return o;
+        };
+
+        BenchCase cold;
+        cold.name = QString("hit-test/index-build/n=%1").arg(n);
+        cold.group = "hit-test/index-build";
+        cold.items = n;
+        cold.setup = prepare;
+        cold.body = [plot, positions]() {
+            QCPGraph* graph = (*plot)->graph(0);
+            (*plot)->hitIndex()->invalidate();
+            for (const QPointF& pos : *positions) (*plot)->hitIndex()->graphDistance(graph, pos, 8.0);
+        };
+        cold.extra = maxDiff;
+        runner.add(cold);
+
+        BenchCase warm;
+        warm.name = QString("hit-test/index-query/n=%1").arg(n);
+        warm.group = "hit-test/index-query";
+        warm.items = n;
+        warm.setup = prepare;
+        warm.body = [plot, positions]() {
+            QCPGraph* graph = (*plot)->graph(0);
+            for (const QPointF& pos : *positions) (*plot)->hitIndex()->graphDistance(graph, pos, 8.0);
+        };
+        warm.extra = maxDiff;
+        runner.add(warm);
+    }
+}
+
+// ============================================================================
+// 回放模式
+// ============================================================================
+
+// 以日志中的输入重新拟合一次 (雅可比与界面拟合一样经批量回调计算)
+static FittingResult replayFit(const FitReplayRecord& rec)
+{
+    auto type = static_cast<ModelSolver01_06::ModelType>(rec.modelType);
+    ModelSolver01_06 solver(type);
+    solver.setHighPrecision(rec.highPrecision);
+    FittingCore core([&solver](ModelSolver01_06::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+        return solver.calculateTheoreticalCurve(p, t);
+    });
+    core.setBatchEvaluator([&solver](ModelSolver01_06::ModelType, const QVector<QMap<QString, double>>& sets, const QVector<double>& t) {
+        return solver.calculateTheoreticalCurves(sets, t);
+    });
+    core.setPointWeights(rec.pointWeights);
+    core.setStepStrategy(static_cast<FittingCore::StepStrategy>(rec.stepStrategy));
+    core.setBoundHandling(static_cast<FittingCore::BoundHandling>(rec.boundHandling));
+    core.setWarmStart(rec.warmStart);
+    return core.runLevenbergMarquardt(type, rec.initialParams, rec.weight, rec.fitT, rec.fitP, rec.fitD);
+}
+
+/**
+ * @brief 回放一个文件或目录下的全部拟合日志
+ * @return 0 全部一致；1 读取失败；2 存在最终参数不一致的日志
+ */
+static int runReplayMode(const QString& path, double tolerance, int repeats, const QString& outputPath)
+{
+    QStringList files;
+    QFileInfo info(path);
+    if (info.isDir()) {
+        QDir dir(path);
+        for (const QString& name : dir.entryList({"*.wtfr"}, QDir::Files, QDir::Name))
+            files << dir.filePath(name);
+    } else {
+        files << path;
+    }
+    if (files.isEmpty()) {
+        qWarning() << "未找到拟合回放日志:" << path;
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    QJsonArray results;
+    int readFailures = 0, mismatches = 0;
+    double totalRecordedMs = 0.0, totalReplayedMs = 0.0;
+
+    for (const QString& file : files) {
+        FitReplayRecord rec;
+        QString error;
+        if (!FitReplayLog::read(file, rec, &error)) {
+            qWarning() << "读取失败:" << file << error;
+            ++readFailures;
+            continue;
+        }
+
+        FittingResult best;
+        for (int r = 0; r < qMax(1, repeats); ++r) {
+            FittingResult res = replayFit(rec);
+            if (r == 0 || res.elapsedMs < best.elapsedMs) best = res;
+        }
+
+        FitReplayComparison cmp = FitReplayLog::compare(rec, best, tolerance);
+        if (!cmp.sameAnswer) ++mismatches;
+        totalRecordedMs += cmp.recordedMs;
+        totalReplayedMs += cmp.replayedMs;
+
+        QJsonObject o;
+        o["file"] = QFileInfo(file).fileName();
+        o["source"] = rec.source;
+        o["modelType"] = rec.modelType + 1;
+        o["points"] = rec.fitT.size();
+        o["recordedSteps"] = cmp.recordedSteps;
+        o["replayedSteps"] = cmp.replayedSteps;
+        o["trajectoryMaxRelDiff"] = cmp.trajectoryMaxRelDiff;
+        o["finalMaxRelDiff"] = cmp.finalMaxRelDiff;
+        o["worstParam"] = cmp.worstParam;
+        o["sseRelDiff"] = cmp.sseRelDiff;
+        o["recordedMs"] = cmp.recordedMs;
+        o["replayedMs"] = cmp.replayedMs;
+        o["speedup"] = cmp.replayedMs > 0 ? cmp.recordedMs / cmp.replayedMs : 0.0;
+        o["recordedEvaluations"] = cmp.recordedEvaluations;
+        o["replayedEvaluations"] = cmp.replayedEvaluations;
+        o["sameTrajectory"] = cmp.sameTrajectory;
+        o["sameAnswer"] = cmp.sameAnswer;
+        results.append(o);
+
+        out << QString("%1  步数 %2/%3  参数偏差 %4 (%5)  耗时 %6 -> %7 ms  %8\n")
+                   .arg(QFileInfo(file).fileName())
+                   .arg(cmp.recordedSteps).arg(cmp.replayedSteps)
+                   .arg(cmp.finalMaxRelDiff, 0, 'g', 3).arg(cmp.worstParam)
+                   .arg(cmp.recordedMs, 0, 'f', 1).arg(cmp.replayedMs, 0, 'f', 1)
+                   .arg(cmp.sameAnswer ? (cmp.sameTrajectory ? "一致" : "结果一致/轨迹不同") : "不一致");
+        out.flush();
+    }
+
+    QJsonObject root;
+    root["suite"] = "WellTestReplay";
+    root["formatVersion"] = 1;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["tolerance"] = tolerance;
+    root["repeats"] = repeats;
+    root["logs"] = files.size();
+    root["readFailures"] = readFailures;
+    root["mismatches"] = mismatches;
+    root["totalRecordedMs"] = totalRecordedMs;
+    root["totalReplayedMs"] = totalReplayedMs;
+    root["results"] = results;
+
+    QFile f(outputPath);
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+        out << "结果已写入: " << f.fileName() << "\n";
+    } else {
+        qWarning() << "无法写入结果文件:" << f.fileName();
+    }
+
+    out << QString("共 %1 个日志，不一致 %2 个，读取失败 %3 个；总耗时 %4 -> %5 ms\n")
+               .arg(files.size()).arg(mismatches).arg(readFailures)
+               .arg(totalRecordedMs, 0, 'f', 1).arg(totalReplayedMs, 0, 'f', 1);
+
+    if (readFailures > 0) return 1;
+    return mismatches > 0 ? 2 : 0;
+}
+
+// ============================================================================
+// 程序入口
+// ============================================================================
+
+int main(int argc, char *argv[])
+{
+    // 导入用例需要构造 QWidget，无显示环境时默认使用 offscreen 平台
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("WellTestBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("试井分析软件性能基准测试");
+    parser.addHelpOption();
+    QCommandLineOption optOutput("output", "结果 JSON 文件路径", "file", "bench_results.json");
+    QCommandLineOption optFilter("filter", "仅运行名称包含该文本的用例", "text");
+    QCommandLineOption optMinTime("min-time", "每个用例最短测量时间 (ms)", "ms", "500");
+    QCommandLineOption optMaxPoints("max-points", "数据处理用例最大点数", "n", "10000000");
+    QCommandLineOption optBudget("budget", "单次运行超时阈值 (s)，超过后跳过同组更大规模", "s", "60");
+    QCommandLineOption optList("list", "仅列出用例名称");
+    QCommandLineOption optTrace("trace", "导出 Chrome Trace 时间线文件", "file");
+    QCommandLineOption optReplay("replay", "回放拟合日志 (.wtfr 文件或目录)", "path");
+    QCommandLineOption optReplayTol("replay-tol", "回放比对相对容差", "tol", "1e-6");
+    QCommandLineOption optReplayRepeat("replay-repeat", "每个日志回放次数 (耗时取最小值)", "n", "1");
+    parser.addOptions({optOutput, optFilter, optMinTime, optMaxPoints, optBudget, optList, optTrace,
+                       optReplay, optReplayTol, optReplayRepeat});
+    parser.process(app);
+
+    if (parser.isSet(optTrace)) TraceRecorder::setEnabled(true);
+
+    if (parser.isSet(optReplay)) {
+        int ret = runReplayMode(parser.value(optReplay), parser.value(optReplayTol).toDouble(),
+                                parser.value(optReplayRepeat).toInt(), parser.value(optOutput));
+        if (parser.isSet(optTrace)) TraceRecorder::exportChromeTrace(parser.value(optTrace));
+        return ret;
+    }
+
+    BenchOptions opt;
+    opt.filter = parser.value(optFilter);
+    opt.minTimeMs = parser.value(optMinTime).toLongLong();
+    opt.maxPoints = parser.value(optMaxPoints).toLongLong();
+    opt.budgetSec = parser.value(optBudget).toDouble();
+    opt.listOnly = parser.isSet(optList);
+
+    QTemporaryDir tmpDir;
+    if (!tmpDir.isValid()) {
+        qWarning() << "无法创建临时目录";
+        return 1;
+    }
+
+    BenchRunner runner(opt);
+    registerSolverCases(runner);
+    registerBatchCases(runner);
+    registerFractureTableCases(runner);
+    registerInversionGridCases(runner);
+    registerQuadratureCases(runner);
+    registerDataCases(runner, opt);
+    registerImportCases(runner, opt, tmpDir.path());
+    registerTimeParseCases(runner, opt);
+    registerFitCases(runner);
+    registerSamplingCases(runner);
+    registerRefitCases(runner);
+    registerHitTestCases(runner, opt);
+
+    QJsonArray results = runner.runAll();
+    if (opt.listOnly) return 0;
+
+    if (parser.isSet(optTrace)) {
+        QString error;
+        if (TraceRecorder::exportChromeTrace(parser.value(optTrace), &error))
+            QTextStream(stdout) << "时间线已写入: " << parser.value(optTrace) << "\n";
+        else
+            qWarning() << "时间线导出失败:" << error;
+    }
+
+    QJsonObject root;
+    root["suite"] = "WellTestBench";
+    root["formatVersion"] = 1;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["qtVersion"] = QString(qVersion());
+    root["cpu"] = QSysInfo::currentCpuArchitecture();
+    root["os"] = QSysInfo::prettyProductName();
+    root["threads"] = QThread::idealThreadCount();
+#ifdef QT_DEBUG
+    root["buildType"] = "debug";
+#else
+    root["buildType"] = "release";
+#endif
+    root["minTimeMs"] = static_cast<double>(opt.minTimeMs);
+    root["results"] = results;
+
+    QFile f(parser.value(optOutput));
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入结果文件:" << f.fileName();
+        return 1;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    QTextStream(stdout) << "结果已写入: " << f.fileName() << "\n";
+    return 0;
+}
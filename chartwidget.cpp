@@ -9,6 +9,10 @@
  * 5. [新增] 支持开/关井事件线（红/绿虚线），在双坐标模式下贯穿显示（从底至顶）。
  * 6. 实现鼠标交互：缩放、拖拽、移动数据、编辑标注、右键菜单等。
  * 7. [修复] 修正 QCPItemLine 坐标轴设置方式，解决编译错误。
+ * 8. [新增] 图元点击/双击只对命中索引 (PlotHitIndex) 给出的附近图元做精确判断；
+ *    鼠标悬停在曲线数据点附近时以提示框显示曲线名与该点坐标。
+ * 9. [修改] 数据移动模式不再在每次鼠标移动时改写全部数据点：拖动期间曲线挂到隐藏的影子坐标轴上，
+ *    只更新影子轴范围 (线性轴为偏移、对数轴为缩放)；松开时一次性就地写回并发出变换，ESC 撤销进行中的拖动。
  */
 
 #include "chartwidget.h"
@@ -29,6 +33,7 @@
 #include <QColorDialog>
 #include <QSpinBox>
 #include <QComboBox>
+#include <QToolTip>
 
 // ============================================================================
 // 构造与析构
@@ -46,7 +51,9 @@ ChartWidget::ChartWidget(QWidget *parent) :
     m_activeLine(nullptr),
     m_activeText(nullptr),
     m_activeArrow(nullptr),
-    m_movingGraph(nullptr)
+    m_movingGraph(nullptr),
+    m_moveSourceAxis(nullptr),
+    m_moveShadowAxis(nullptr)
 {
     ui->setupUi(this);
     m_plot = ui->chart;
@@ -198,10 +205,10 @@ MouseZoom *ChartWidget::getPlot() { return m_plot; }
 void ChartWidget::setDataModel(QStandardItemModel *model) { m_dataModel = model; }
 
 void ChartWidget::clearGraphs() {
+    exitMoveDataMode();
     m_plot->clearGraphs();
     clearEventLines();
     m_plot->replot();
-    exitMoveDataMode();
     setZoomDragMode(Qt::Horizontal | Qt::Vertical);
 }
 
@@ -522,7 +529,9 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
     // --- 右键菜单处理 ---
     if (event->button() == Qt::RightButton) {
         // 1. 优先检查是否击中事件线
+        const QList<QCPAbstractItem*> nearby = m_plot->hitIndex()->itemCandidates(event->pos(), 10.0);
         for (auto line : m_eventLines) {
+            if (!nearby.contains(line)) continue;
             double dist = line->selectTest(event->pos(), false);
             if (dist >= 0 && dist < 10.0) {
                 m_activeLine = line; // 临时标记为活动线用于菜单上下文
@@ -551,15 +560,11 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
 
     // 1. 数据移动模式
     if (m_interMode == Mode_Moving_Data_X || m_interMode == Mode_Moving_Data_Y) {
+        finishDataMove(true);
         QCPAxisRect* clickedRect = m_plot->axisRectAt(event->pos());
         if (clickedRect) {
             QList<QCPGraph*> graphs = clickedRect->graphs();
-            if (!graphs.isEmpty()) {
-                m_movingGraph = graphs.first();
-                m_lastMoveDataPos = event->pos();
-            } else {
-                m_movingGraph = nullptr;
-            }
+            if (!graphs.isEmpty()) beginDataMove(graphs.first(), event->pos());
         }
         return;
     }
@@ -567,10 +572,11 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
     // 重置交互状态
     m_interMode = Mode_None; m_activeLine = nullptr; m_activeText = nullptr; m_activeArrow = nullptr; m_lastMousePos = event->pos();
     double tolerance = 8.0;
+    const QList<QCPAbstractItem*> nearby = m_plot->hitIndex()->itemCandidates(event->pos(), tolerance);
 
     // 2. 检查文本选中
-    for (int i = 0; i < m_plot->itemCount(); ++i) {
-        if (auto text = qobject_cast<QCPItemText*>(m_plot->item(i))) {
+    for (QCPAbstractItem* item : nearby) {
+        if (auto text = qobject_cast<QCPItemText*>(item)) {
             if (text->selectTest(event->pos(), false) < tolerance) {
                 m_interMode = Mode_Dragging_Text; m_activeText = text;
                 m_plot->deselectAll(); text->setSelected(true); m_plot->setInteractions(QCP::Interaction(0));
@@ -581,6 +587,7 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
 
     // 3. 检查事件线选中
     for (auto line : m_eventLines) {
+        if (!nearby.contains(line)) continue;
         if (line->selectTest(event->pos(), false) < tolerance) {
             m_plot->deselectAll();
             line->setSelected(true);
@@ -599,8 +606,8 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
     }
 
     // 4. 检查普通线段和箭头选中
-    for (int i = 0; i < m_plot->itemCount(); ++i) {
-        auto line = qobject_cast<QCPItemLine*>(m_plot->item(i));
+    for (QCPAbstractItem* item : nearby) {
+        auto line = qobject_cast<QCPItemLine*>(item);
         // 排除事件线
         if (line && !line->property("isCharacteristic").isValid() && !line->property("isEventLine").isValid()) {
             double x1 = m_plot->xAxis->coordToPixel(line->start->coords().x()), y1 = m_plot->yAxis->coordToPixel(line->start->coords().y());
@@ -612,8 +619,8 @@ void ChartWidget::onPlotMousePress(QMouseEvent* event) {
     }
 
     // 5. 检查特征线选中
-    for (int i = 0; i < m_plot->itemCount(); ++i) {
-        QCPItemLine* line = qobject_cast<QCPItemLine*>(m_plot->item(i));
+    for (QCPAbstractItem* item : nearby) {
+        QCPItemLine* line = qobject_cast<QCPItemLine*>(item);
         if (!line || !line->property("isCharacteristic").isValid()) continue;
         double x1 = m_plot->xAxis->coordToPixel(line->start->coords().x()), y1 = m_plot->yAxis->coordToPixel(line->start->coords().y());
         double x2 = m_plot->xAxis->coordToPixel(line->end->coords().x()), y2 = m_plot->yAxis->coordToPixel(line->end->coords().y());
@@ -659,39 +666,7 @@ void ChartWidget::onPlotMouseMove(QMouseEvent* event) {
 
         // 处理数据移动
         if ((m_interMode == Mode_Moving_Data_X || m_interMode == Mode_Moving_Data_Y) && m_movingGraph) {
-            QCPAxis *xAxis = m_movingGraph->keyAxis();
-            QCPAxis *yAxis = m_movingGraph->valueAxis();
-
-            double dx = 0;
-            double dy = 0;
-
-            if (m_interMode == Mode_Moving_Data_X) {
-                dx = xAxis->pixelToCoord(event->pos().x()) - xAxis->pixelToCoord(m_lastMoveDataPos.x());
-            } else {
-                dy = yAxis->pixelToCoord(event->pos().y()) - yAxis->pixelToCoord(m_lastMoveDataPos.y());
-            }
-
-            QSharedPointer<QCPGraphDataContainer> data = m_movingGraph->data();
-            for (auto it = data->begin(); it != data->end(); ++it) {
-                if (m_interMode == Mode_Moving_Data_X) it->key += dx;
-                else it->value += dy;
-            }
-
-            // [同步移动开/关井线]
-            // 如果是在堆叠模式下移动产量曲线(bottomRect)，则同步移动事件线
-            if (m_interMode == Mode_Moving_Data_X && !m_eventLines.isEmpty()) {
-                if (m_chartMode == Mode_Stacked && m_movingGraph->keyAxis()->axisRect() == m_bottomRect) {
-                    for(auto line : m_eventLines) {
-                        double currentX = line->start->coords().x();
-                        double newX = currentX + dx;
-                        line->start->setCoords(newX, line->start->coords().y());
-                        line->end->setCoords(newX, line->end->coords().y());
-                    }
-                }
-            }
-
-            m_plot->replot();
-            m_lastMoveDataPos = event->pos();
+            updateDataMove(event->pos());
             return;
         }
 
@@ -731,16 +706,26 @@ void ChartWidget::onPlotMouseMove(QMouseEvent* event) {
         }
 
         m_lastMousePos = currentPos; m_plot->replot();
+    } else if (event->buttons() == Qt::NoButton && m_interMode == Mode_None) {
+        // 悬停读数：附近数据点所属曲线与坐标
+        PlotHitIndex::GraphHit hit = m_plot->hitIndex()->nearestDataPoint(event->pos(), 8.0);
+        if (hit.graph) {
+            QString name = hit.graph->name().isEmpty() ? QString("曲线") : hit.graph->name();
+            QToolTip::showText(event->globalPosition().toPoint(),
+                               QString("%1\nX: %2\nY: %3").arg(name)
+                                   .arg(hit.graph->dataMainKey(hit.dataIndex), 0, 'g', 6)
+                                   .arg(hit.graph->dataMainValue(hit.dataIndex), 0, 'g', 6),
+                               m_plot);
+        } else if (QToolTip::isVisible()) {
+            QToolTip::hideText();
+        }
     }
 }
 
 void ChartWidget::onPlotMouseRelease(QMouseEvent* event) {
     Q_UNUSED(event);
     if (m_interMode == Mode_Moving_Data_X || m_interMode == Mode_Moving_Data_Y) {
-        if (m_movingGraph) {
-            emit graphDataModified(m_movingGraph);
-        }
-        m_movingGraph = nullptr;
+        finishDataMove(true);
     } else {
         if (m_interMode != Mode_None) {
             setZoomDragMode(Qt::Horizontal | Qt::Vertical);
@@ -751,8 +736,8 @@ void ChartWidget::onPlotMouseRelease(QMouseEvent* event) {
 
 void ChartWidget::onPlotMouseDoubleClick(QMouseEvent* event) {
     if (event->button() != Qt::LeftButton) return;
-    for (int i = 0; i < m_plot->itemCount(); ++i) {
-        if (auto text = qobject_cast<QCPItemText*>(m_plot->item(i))) {
+    for (QCPAbstractItem* item : m_plot->hitIndex()->itemCandidates(event->pos(), 10.0)) {
+        if (auto text = qobject_cast<QCPItemText*>(item)) {
             if (text->selectTest(event->pos(), false) < 10.0) { onEditItemRequested(text); return; }
         }
     }
@@ -812,13 +797,101 @@ void ChartWidget::keyPressEvent(QKeyEvent *event) {
 
 void ChartWidget::exitMoveDataMode() {
     if (m_interMode == Mode_Moving_Data_X || m_interMode == Mode_Moving_Data_Y) {
+        finishDataMove(false);
         m_interMode = Mode_None;
-        m_movingGraph = nullptr;
         m_plot->setCursor(Qt::ArrowCursor);
         setZoomDragMode(Qt::Horizontal | Qt::Vertical);
     }
 }
 
+void ChartWidget::beginDataMove(QCPGraph* graph, const QPoint& pos) {
+    const bool moveKey = (m_interMode == Mode_Moving_Data_X);
+    QCPAxis* source = moveKey ? graph->keyAxis() : graph->valueAxis();
+    if (!source) return;
+
+    // 影子轴与原坐标轴同类型同刻度，不可见 (不占边距、不画网格)
+    QCPAxis* shadow = source->axisRect()->addAxis(source->axisType());
+    shadow->setVisible(false);
+    shadow->setScaleType(source->scaleType());
+    shadow->setRangeReversed(source->rangeReversed());
+    shadow->setRange(source->range());
+    if (moveKey) graph->setKeyAxis(shadow);
+    else graph->setValueAxis(shadow);
+
+    m_movingGraph = graph;
+    m_moveSourceAxis = source;
+    m_moveShadowAxis = shadow;
+    m_moveDataStartPos = pos;
+    m_moveTransform = DataTransform();
+
+    // [同步移动开/关井线] 堆叠模式下横向移动产量曲线 (bottomRect) 时事件线随之移动
+    m_moveEventLineX.clear();
+    if (moveKey && m_chartMode == Mode_Stacked && source->axisRect() == m_bottomRect) {
+        for (auto line : m_eventLines) m_moveEventLineX.append(line->start->coords().x());
+    }
+}
+
+void ChartWidget::updateDataMove(const QPoint& pos) {
+    if (!m_movingGraph || !m_moveShadowAxis) return;
+
+    QCPAxis* axis = m_moveSourceAxis;
+    const bool horizontal = (axis->orientation() == Qt::Horizontal);
+    const double from = axis->pixelToCoord(horizontal ? m_moveDataStartPos.x() : m_moveDataStartPos.y());
+    const double to = axis->pixelToCoord(horizontal ? pos.x() : pos.y());
+
+    DataTransform t;
+    if (axis->scaleType() == QCPAxis::stLogarithmic && from * to > 0) t.scale = to / from;
+    else t.offset = to - from;
+    m_moveTransform = t;
+
+    // 影子轴范围取原范围的逆变换：原数据画在影子轴上，与变换后的数据画在原坐标轴上位置相同
+    const QCPRange range = axis->range();
+    m_moveShadowAxis->setRange(t.inverted(range.lower), t.inverted(range.upper));
+
+    for (int i = 0; i < m_moveEventLineX.size() && i < m_eventLines.size(); ++i) {
+        QCPItemLine* line = m_eventLines[i];
+        const double x = t.map(m_moveEventLineX[i]);
+        line->start->setCoords(x, line->start->coords().y());
+        line->end->setCoords(x, line->end->coords().y());
+    }
+
+    m_plot->replot();
+}
+
+void ChartWidget::finishDataMove(bool commit) {
+    if (!m_movingGraph) return;
+
+    QCPGraph* graph = m_movingGraph;
+    const bool movedKey = (graph->keyAxis() == m_moveShadowAxis);
+    if (movedKey) graph->setKeyAxis(m_moveSourceAxis);
+    else graph->setValueAxis(m_moveSourceAxis);
+    m_moveSourceAxis->axisRect()->removeAxis(m_moveShadowAxis);
+
+    const DataTransform t = m_moveTransform;
+    m_movingGraph = nullptr;
+    m_moveSourceAxis = nullptr;
+    m_moveShadowAxis = nullptr;
+    m_moveTransform = DataTransform();
+
+    if (commit && !t.isIdentity()) {
+        // 一次性就地写回；变换单调递增，数据容器无需重新排序
+        QSharedPointer<QCPGraphDataContainer> data = graph->data();
+        for (auto it = data->begin(); it != data->end(); ++it) {
+            if (movedKey) it->key = t.map(it->key);
+            else it->value = t.map(it->value);
+        }
+        emit graphDataMoved(graph, movedKey ? Qt::Horizontal : Qt::Vertical, t);
+    } else if (!commit) {
+        for (int i = 0; i < m_moveEventLineX.size() && i < m_eventLines.size(); ++i) {
+            QCPItemLine* line = m_eventLines[i];
+            line->start->setCoords(m_moveEventLineX[i], line->start->coords().y());
+            line->end->setCoords(m_moveEventLineX[i], line->end->coords().y());
+        }
+    }
+    m_moveEventLineX.clear();
+    m_plot->replot();
+}
+
 void ChartWidget::constrainLinePoint(QCPItemLine* line, bool isMovingStart, double mouseX, double mouseY) {
     double k = line->property("fixedSlope").toDouble();
     bool isLogLog = line->property("isLogLog").toBool();
@@ -6,6 +6,8 @@
  * 2. 管理图表标题 (QCPTextElement)。
  * 3. [新增] 支持开/关井事件线的绘制，且在双坐标系下同时显示。
  * 4. [新增] 支持事件线跟随产量数据横向移动。
+ * 5. [修改] 数据移动以 DataTransform (偏移/缩放) 表示：拖动时曲线挂到一根隐藏的影子坐标轴上，
+ *    由影子轴的范围在绘制时体现移动量，松开鼠标时才一次性写回曲线数据并发出 graphDataMoved。
  */
 
 #ifndef CHARTWIDGET_H
@@ -29,6 +31,28 @@ struct ChartAnnotation {
     QCPItemLine* arrowItem = nullptr;
 };
 
+// 单个坐标方向上的数据变换 v' = v * scale + offset
+// 线性坐标轴上的拖动为偏移，对数坐标轴上的拖动为缩放 (屏幕上平移相同像素)
+struct DataTransform {
+    double scale = 1.0;
+    double offset = 0.0;
+
+    bool isIdentity() const { return scale == 1.0 && offset == 0.0; }
+    double map(double v) const { return v * scale + offset; }
+    double inverted(double v) const { return (v - offset) / scale; }
+    // 先应用本变换、再应用 next 的复合变换
+    DataTransform then(const DataTransform& next) const {
+        DataTransform t;
+        t.scale = scale * next.scale;
+        t.offset = offset * next.scale + next.offset;
+        return t;
+    }
+    void applyTo(QVector<double>& values) const {
+        if (isIdentity()) return;
+        for (double& v : values) v = map(v);
+    }
+};
+
 class ChartWidget : public QWidget
 {
     Q_OBJECT
@@ -68,7 +92,8 @@ protected:
 
 signals:
     void exportDataTriggered();
-    void graphDataModified(QCPGraph* graph);
+    // 数据移动结束：orientation 为移动方向 (Horizontal 为键/时间)，曲线数据已按 transform 更新
+    void graphDataMoved(QCPGraph* graph, Qt::Orientation orientation, const DataTransform& transform);
     void titleChanged(const QString& newTitle);
     void graphsChanged();
 
@@ -115,6 +140,10 @@ private:
     void updateAnnotationArrow(QCPItemLine* line);
     void refreshTitleElement();
     void exitMoveDataMode();
+    // 数据移动：开始 (曲线挂到影子轴)、更新影子轴范围、结束 (commit 为 false 时撤销本次拖动)
+    void beginDataMove(QCPGraph* graph, const QPoint& pos);
+    void updateDataMove(const QPoint& pos);
+    void finishDataMove(bool commit);
     void setZoomDragMode(Qt::Orientations orientations);
 
 private:
@@ -152,7 +181,11 @@ private:
     QPointF m_lastMousePos;
 
     QCPGraph* m_movingGraph;
-    QPoint m_lastMoveDataPos;
+    QPoint m_moveDataStartPos;          // 本次拖动的起点
+    QCPAxis* m_moveSourceAxis;          // 被移动方向上曲线原来的坐标轴
+    QCPAxis* m_moveShadowAxis;          // 拖动期间承载曲线的隐藏坐标轴
+    DataTransform m_moveTransform;      // 本次拖动累计的变换
+    QVector<double> m_moveEventLineX;   // 拖动开始时各事件线的横坐标 (跟随产量横向移动时)
 };
 
 #endif // CHARTWIDGET_H
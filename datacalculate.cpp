@@ -3,7 +3,7 @@
  * 文件作用: 数据计算处理类实现文件
  * 功能描述:
  * 1. 实现时间转换弹窗的UI构建和交互。
- * 2. 实现核心的时间数据解析和转换算法。
+ * 2. 实现核心的时间数据解析和转换算法 (格式检测一次、分块并行解析，解析器见 timeparser.h)。
  * 3. 实现基于压力列的压降计算算法。
  * 4. 实现井底流压计算弹窗及核心算法 (基于 MATLAB 逻辑)。
  */
@@ -15,8 +15,10 @@
 #include <QGroupBox>
 #include <QPushButton>
 #include <QDebug>
-#include <QDateTime>
+#include <QtConcurrent>
 #include <cmath>
+#include <limits>
+#include "timeparser.h"
 
 // ============================================================================
 // TimeConversionDialog 实现
@@ -280,6 +282,13 @@ PwfCalculationConfig PwfCalculationDialog::getConfig() const
 
 DataCalculate::DataCalculate(QObject* parent) : QObject(parent) {}
 
+/**
+ * @brief 时间列转换
+ * 1. 界面线程只做两件事：快照文本列 (QString 隐式共享，不复制字符数据) 与一次性插入结果列。
+ * 2. 由样本检测一次格式，之后按行分块并行解析 (FastTimeParser，不构造 QDateTime)。
+ * 3. 仅时刻模式：时刻倒退超过 12 小时视为跨天，可连续跨越多天。
+ * 4. 结果以 double 写入 DisplayRole (数值型列)，单元格在工作线程中创建后整列插入模型。
+ */
 TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
                                                       QList<ColumnDefinition>& definitions,
                                                       const TimeConversionConfig& config)
@@ -299,9 +308,104 @@ TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
         return result;
     }
 
-    // 在末尾插入新列
+    int primaryCol = config.useDateAndTime ? config.dateColumnIndex : config.sourceTimeColumnIndex;
+    int secondaryCol = config.useDateAndTime ? config.timeColumnIndex : -1;
+    if (primaryCol < 0 || primaryCol >= model->columnCount() || secondaryCol >= model->columnCount()) {
+        result.errorMessage = "所选列无效";
+        return result;
+    }
+    // 日期列与时刻列相同时，按单列“日期 时刻”处理
+    if (secondaryCol == primaryCol) secondaryCol = -1;
+
+    // 1. 快照文本列
+    auto snapshot = [model, rowCount](int col) {
+        QVector<QString> texts(rowCount);
+        for (int i = 0; i < rowCount; ++i) {
+            if (QStandardItem* item = model->item(i, col)) texts[i] = item->text().trimmed();
+        }
+        return texts;
+    };
+    QVector<QString> primary = snapshot(primaryCol);
+    QVector<QString> secondary = secondaryCol >= 0 ? snapshot(secondaryCol) : QVector<QString>();
+
+    // 2. 检测格式
+    TimeTextFormat primaryFmt = FastTimeParser::detect(primary);
+    TimeTextFormat secondaryFmt = FastTimeParser::detect(secondary);
+    if (!primaryFmt.valid || (config.useDateAndTime && !primaryFmt.hasDate) || (!config.useDateAndTime && !primaryFmt.hasTime)) {
+        result.errorMessage = "无法识别时间格式。\n支持 yyyy-MM-dd / yyyy/MM/dd 日期与 hh:mm[:ss[.zzz]] 时刻。";
+        return result;
+    }
+    if (secondaryCol >= 0 && (!secondaryFmt.valid || !secondaryFmt.hasTime)) {
+        result.errorMessage = "无法识别时刻列格式。\n支持 hh:mm[:ss[.zzz]]。";
+        return result;
+    }
+
+    // 3. 分块并行解析为秒
+    QVector<double> seconds(rowCount);
+    QVector<QPair<int, int>> chunks;
+    const int chunkRows = 65536;
+    for (int begin = 0; begin < rowCount; begin += chunkRows)
+        chunks.append(qMakePair(begin, qMin(begin + chunkRows, rowCount)));
+
+    QtConcurrent::blockingMap(chunks, [&](const QPair<int, int>& range) {
+        for (int i = range.first; i < range.second; ++i) {
+            if (secondaryCol < 0) {
+                seconds[i] = FastTimeParser::toSeconds(primary[i], primaryFmt);
+            } else if (secondaryFmt.hasDate) {
+                // 时刻列本身含日期时以其为准
+                seconds[i] = FastTimeParser::toSeconds(secondary[i], secondaryFmt);
+            } else {
+                seconds[i] = FastTimeParser::toSeconds(primary[i], primaryFmt, true)
+                             + FastTimeParser::toSeconds(secondary[i], secondaryFmt);
+            }
+        }
+    });
+
+    // 4. 仅时刻：跨天修正 (串行，只需一次遍历)
+    bool timeOfDayOnly = !primaryFmt.hasDate && secondaryCol < 0;
+    if (timeOfDayOnly) {
+        double dayOffset = 0.0;
+        double prev = std::numeric_limits<double>::quiet_NaN();
+        for (int i = 0; i < rowCount; ++i) {
+            double t = seconds[i];
+            if (std::isnan(t)) continue;
+            if (!std::isnan(prev) && t < prev - 12 * 3600.0) dayOffset += 86400.0;
+            prev = t;
+            seconds[i] = t + dayOffset;
+        }
+    }
+
+    // 5. 以首个有效值为基准
+    double base = std::numeric_limits<double>::quiet_NaN();
+    for (double s : seconds) {
+        if (!std::isnan(s)) { base = s; break; }
+    }
+    if (std::isnan(base)) {
+        result.errorMessage = "没有可解析的时间数据";
+        return result;
+    }
+
+    // 6. 并行创建数值型单元格
+    QList<QStandardItem*> items(rowCount, nullptr);
+    QAtomicInt processed(0);
+    QtConcurrent::blockingMap(chunks, [&](const QPair<int, int>& range) {
+        int valid = 0;
+        for (int i = range.first; i < range.second; ++i) {
+            QStandardItem* item = new QStandardItem;
+            if (!std::isnan(seconds[i])) {
+                item->setData(convertTimeToUnit(seconds[i] - base, config.outputUnit), Qt::DisplayRole);
+                ++valid;
+            } else {
+                item->setText("");
+            }
+            items[i] = item;
+        }
+        processed.fetchAndAddRelaxed(valid);
+    });
+
+    // 整列插入，只触发一次结构变化通知
     int newColIdx = model->columnCount();
-    model->insertColumn(newColIdx);
+    model->insertColumn(newColIdx, items);
 
     // 更新列定义
     ColumnDefinition newDef;
@@ -314,58 +418,10 @@ TimeConversionResult DataCalculate::convertTimeColumn(QStandardItemModel* model,
     // 设置表头
     model->setHorizontalHeaderItem(newColIdx, new QStandardItem(newDef.name));
 
-    // 计算逻辑
-    QDateTime baseTime;
-    bool baseSet = false;
-
-    for (int i = 0; i < rowCount; ++i) {
-        double val = 0.0;
-        bool valid = false;
-
-        if (config.useDateAndTime) {
-            // 日期+时刻模式
-            QString dStr = model->item(i, config.dateColumnIndex)->text();
-            QString tStr = model->item(i, config.timeColumnIndex)->text();
-            QDate d = parseDateString(dStr);
-            QTime t = parseTimeString(tStr);
-            if (d.isValid() && t.isValid()) {
-                QDateTime dt = combineDateAndTime(d, t);
-                if (!baseSet) { baseTime = dt; baseSet = true; }
-                double seconds = baseTime.secsTo(dt);
-                val = convertTimeToUnit(seconds, config.outputUnit);
-                valid = true;
-            }
-        } else {
-            // 仅时间模式
-            QString tStr = model->item(i, config.sourceTimeColumnIndex)->text();
-            QTime t = parseTimeString(tStr);
-            if (t.isValid()) {
-                // 如果没有日期，取当前日期与该时间组合
-                if (!baseSet) {
-                    baseTime = QDateTime(QDate::currentDate(), t);
-                    baseSet = true;
-                }
-                QDateTime dt(QDate::currentDate(), t);
-                // 处理跨天情况(简单处理: 如果时间比基准小很多，假设是第二天)
-                if (dt < baseTime) dt = dt.addDays(1);
-
-                double seconds = baseTime.secsTo(dt);
-                val = convertTimeToUnit(seconds, config.outputUnit);
-                valid = true;
-            }
-        }
-
-        if (valid) {
-            model->setItem(i, newColIdx, new QStandardItem(QString::number(val, 'f', 3)));
-            result.processedRows++;
-        } else {
-            model->setItem(i, newColIdx, new QStandardItem(""));
-        }
-    }
-
     result.success = true;
     result.addedColumnIndex = newColIdx;
     result.columnName = newDef.name;
+    result.processedRows = processed.loadRelaxed();
     return result;
 }
 
@@ -511,28 +567,6 @@ PwfCalculationResult DataCalculate::calculateBottomHolePressure(QStandardItemMod
 }
 
 // 辅助函数实现
-QTime DataCalculate::parseTimeString(const QString& timeStr) const {
-    QStringList fmts = {"hh:mm:ss", "h:mm:ss", "hh:mm"};
-    for(const auto& f : fmts) {
-        QTime t = QTime::fromString(timeStr, f);
-        if(t.isValid()) return t;
-    }
-    return QTime();
-}
-
-QDate DataCalculate::parseDateString(const QString& dateStr) const {
-    QStringList fmts = {"yyyy-MM-dd", "yyyy/MM/dd"};
-    for(const auto& f : fmts) {
-        QDate d = QDate::fromString(dateStr, f);
-        if(d.isValid()) return d;
-    }
-    return QDate();
-}
-
-QDateTime DataCalculate::combineDateAndTime(const QDate& date, const QTime& time) const {
-    return QDateTime(date, time);
-}
-
 double DataCalculate::convertTimeToUnit(double seconds, const QString& unit) const {
     if (unit == "h") return seconds / 3600.0;
     if (unit == "min") return seconds / 60.0;
@@ -6,6 +6,7 @@
  * 2. 包含井底流压计算配置对话框类 PwfCalculationDialog (新增)。
  * 3. 提供 DataCalculate 类，用于执行时间格式转换、压降计算和井底流压计算逻辑。
  * 4. 所有的计算操作都直接修改传入的 QStandardItemModel。
+ * 5. [修改] 时间转换改为“样本检测一次格式 + 分块并行解析”，结果写为数值型列。
  */
 
 #ifndef DATACALCULATE_H
@@ -144,10 +145,7 @@ public:
                                                      const PwfCalculationConfig& config);
 
 private:
-    // 辅助函数：时间解析
-    QTime parseTimeString(const QString& timeStr) const;
-    QDate parseDateString(const QString& dateStr) const;
-    QDateTime combineDateAndTime(const QDate& date, const QTime& time) const;
+    // 辅助函数：秒换算为输出单位 (文本解析由 FastTimeParser 完成)
     double convertTimeToUnit(double seconds, const QString& unit) const;
 
     // 辅助函数：查找压力列
@@ -0,0 +1,306 @@
+/*
+ * 文件名: datamergedialog.cpp
+ * 文件作用: 多文件按时间合并配置对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建：列用途表、合并参数、确定/取消按钮。
+ * 2. 时间列优先按数值读取；多数单元格不是数值时按日期时间文本检测格式后批量解析 (FastTimeParser)，
+ *    文本时间统一换算为以所有文件最早时刻为零点的小时数，保证不同文件的时间可比。
+ * 3. 数值列空单元格与非数值记为 NaN，由归并引擎按缺失处理。
+ */
+
+#include "datamergedialog.h"
+#include "timeparser.h"
+
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDoubleSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QMessageBox>
+#include <QMap>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+bool isTimeType(WellTestColumnType type)
+{
+    return type == WellTestColumnType::Time || type == WellTestColumnType::Date || type == WellTestColumnType::TimeOfDay;
+}
+
+bool isPressureLike(WellTestColumnType type)
+{
+    return type == WellTestColumnType::Pressure || type == WellTestColumnType::CasingPressure
+           || type == WellTestColumnType::BottomHolePressure || type == WellTestColumnType::Temperature
+           || type == WellTestColumnType::PressureDrop;
+}
+
+} // namespace
+
+DataMergeDialog::DataMergeDialog(const QList<DataMergeSheetInfo>& sheets, QWidget* parent)
+    : QDialog(parent), m_sheets(sheets)
+{
+    initUI();
+}
+
+void DataMergeDialog::initUI()
+{
+    setWindowTitle("多文件按时间合并");
+    resize(640, 520);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("为每个文件指定一个时间列，并选择参与合并的数值列及其对齐方式：\n"
+                                 "产量类建议“阶梯保持”，压力、温度类建议“线性插值”。", this));
+
+    m_table = new QTableWidget(0, 3, this);
+    m_table->setHorizontalHeaderLabels({"文件", "列名", "用途"});
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    const QStringList usages = {"不参与", "时间", TimeSeriesMerger::modeName(MergeAlignMode::StepHold),
+                                TimeSeriesMerger::modeName(MergeAlignMode::Linear),
+                                TimeSeriesMerger::modeName(MergeAlignMode::Nearest)};
+    for (int s = 0; s < m_sheets.size(); ++s) {
+        const DataMergeSheetInfo& sheet = m_sheets[s];
+        if (!sheet.model) continue;
+        bool timeTaken = false;
+        for (int c = 0; c < sheet.model->columnCount(); ++c) {
+            const QString header = sheet.model->headerData(c, Qt::Horizontal).toString();
+            const ColumnDefinition def = c < sheet.definitions.size() ? sheet.definitions[c] : ColumnDefinition();
+
+            int row = m_table->rowCount();
+            m_table->insertRow(row);
+            m_table->setItem(row, 0, new QTableWidgetItem(sheet.title));
+            m_table->setItem(row, 1, new QTableWidgetItem(header.isEmpty() ? QString("列%1").arg(c + 1) : header));
+            QComboBox* combo = new QComboBox(m_table);
+            combo->addItems(usages);
+            combo->setCurrentIndex(defaultUsage(def, header, timeTaken));
+            m_table->setCellWidget(row, 2, combo);
+            m_rows.append({s, c});
+        }
+    }
+    layout->addWidget(m_table, 1);
+
+    QFormLayout* form = new QFormLayout;
+    m_tolerance = new QDoubleSpinBox(this);
+    m_tolerance->setDecimals(6);
+    m_tolerance->setRange(0.0, 1e6);
+    m_tolerance->setValue(0.0);
+    m_tolerance->setToolTip("相距不超过该值的时间合并为一行 (与时间列同单位，文本时间为小时)");
+    form->addRow("时间合并容差:", m_tolerance);
+
+    m_maxGap = new QDoubleSpinBox(this);
+    m_maxGap->setDecimals(6);
+    m_maxGap->setRange(0.0, 1e9);
+    m_maxGap->setValue(0.0);
+    m_maxGap->setSpecialValueText("不限制");
+    m_maxGap->setToolTip("插值或保持跨越的最大时间间隔，超出时该单元格留空");
+    form->addRow("最大对齐间隔:", m_maxGap);
+
+    m_axis = new QComboBox(this);
+    m_axis->addItem("所有文件时间的并集");
+    for (const DataMergeSheetInfo& sheet : m_sheets) m_axis->addItem("以 " + sheet.title + " 的时间为准");
+    form->addRow("输出时间轴:", m_axis);
+
+    m_extrapolate = new QCheckBox("文件时间范围之外沿用首/末值", this);
+    form->addRow("", m_extrapolate);
+    layout->addLayout(form);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    btnLayout->addStretch();
+    QPushButton* btnOk = new QPushButton("合并", this);
+    QPushButton* btnCancel = new QPushButton("取消", this);
+    btnLayout->addWidget(btnOk);
+    btnLayout->addWidget(btnCancel);
+    layout->addLayout(btnLayout);
+
+    connect(btnOk, &QPushButton::clicked, this, &DataMergeDialog::onAccept);
+    connect(btnCancel, &QPushButton::clicked, this, &QDialog::reject);
+}
+
+DataMergeDialog::ColumnUsage DataMergeDialog::defaultUsage(const ColumnDefinition& def, const QString& header, bool& timeTaken) const
+{
+    const QString h = header.toLower();
+    const bool typedTime = isTimeType(def.type);
+    const bool namedTime = h.contains("时间") || h.contains("time");
+    if ((typedTime || (def.type == WellTestColumnType::Custom && namedTime)) && !timeTaken) {
+        timeTaken = true;
+        return TimeColumn;
+    }
+    if (typedTime || def.type == WellTestColumnType::SerialNumber) return Unused;
+    if (def.type == WellTestColumnType::FlowRate || h.contains("产量") || h.contains("流量") || h.contains("rate"))
+        return StepHold;
+    if (isPressureLike(def.type) || h.contains("压") || h.contains("温") || h.contains("pressure"))
+        return Linear;
+    return Unused;
+}
+
+void DataMergeDialog::onAccept()
+{
+    // 只校验设置完整性，数据提取在 buildRequest 中进行
+    QVector<int> timeCount(m_sheets.size(), 0);
+    QVector<int> valueCount(m_sheets.size(), 0);
+    for (int r = 0; r < m_rows.size(); ++r) {
+        int usage = qobject_cast<QComboBox*>(m_table->cellWidget(r, 2))->currentIndex();
+        if (usage == TimeColumn) ++timeCount[m_rows[r].sheet];
+        else if (usage != Unused) ++valueCount[m_rows[r].sheet];
+    }
+
+    int usedSheets = 0;
+    for (int s = 0; s < m_sheets.size(); ++s) {
+        if (valueCount[s] == 0) continue;
+        ++usedSheets;
+        if (timeCount[s] != 1) {
+            QMessageBox::warning(this, "提示", QString("文件 %1 需要且只能指定一个时间列。").arg(m_sheets[s].title));
+            return;
+        }
+    }
+    if (usedSheets == 0) {
+        QMessageBox::warning(this, "提示", "请至少选择一个参与合并的数值列。");
+        return;
+    }
+    int axis = m_axis->currentIndex() - 1;
+    if (axis >= 0 && valueCount[axis] == 0) {
+        QMessageBox::warning(this, "提示", "作为输出时间轴的文件没有参与合并的数值列。");
+        return;
+    }
+    accept();
+}
+
+bool DataMergeDialog::extractTime(QStandardItemModel* model, int column, QVector<double>& hours, bool& isText)
+{
+    const int rows = model->rowCount();
+    hours.fill(kNaN, rows);
+    QVector<QString> texts(rows);
+    int numeric = 0, nonEmpty = 0;
+    for (int r = 0; r < rows; ++r) {
+        QStandardItem* item = model->item(r, column);
+        if (!item) continue;
+        QVariant v = item->data(Qt::DisplayRole);
+        texts[r] = v.toString().trimmed();
+        if (texts[r].isEmpty()) continue;
+        ++nonEmpty;
+        bool ok = false;
+        double d = v.toDouble(&ok);
+        if (ok) { hours[r] = d; ++numeric; }
+    }
+    isText = false;
+    if (nonEmpty == 0) return false;
+    if (numeric * 2 >= nonEmpty) return true;
+
+    // 日期时间文本：一次检测格式后逐行解析
+    TimeTextFormat fmt = FastTimeParser::detect(texts);
+    if (!fmt.valid) return false;
+    isText = true;
+    for (int r = 0; r < rows; ++r) hours[r] = FastTimeParser::toSeconds(texts[r], fmt) / 3600.0;
+    return true;
+}
+
+QVector<double> DataMergeDialog::extractValues(QStandardItemModel* model, int column)
+{
+    const int rows = model->rowCount();
+    QVector<double> values(rows, kNaN);
+    for (int r = 0; r < rows; ++r) {
+        QStandardItem* item = model->item(r, column);
+        if (!item) continue;
+        bool ok = false;
+        double d = item->data(Qt::DisplayRole).toDouble(&ok);
+        if (ok) values[r] = d;
+    }
+    return values;
+}
+
+bool DataMergeDialog::buildRequest(DataMergeRequest& request, QString& error) const
+{
+    request = DataMergeRequest();
+
+    // 1. 收集每个文件的时间列与数值列
+    QVector<int> timeColumn(m_sheets.size(), -1);
+    QVector<QList<QPair<int, MergeAlignMode>>> channels(m_sheets.size());
+    QMap<QString, int> nameCount;
+    for (int r = 0; r < m_rows.size(); ++r) {
+        int usage = qobject_cast<QComboBox*>(m_table->cellWidget(r, 2))->currentIndex();
+        const RowRef& ref = m_rows[r];
+        if (usage == TimeColumn) timeColumn[ref.sheet] = ref.column;
+        else if (usage != Unused) {
+            MergeAlignMode mode = usage == StepHold ? MergeAlignMode::StepHold
+                                : usage == Linear ? MergeAlignMode::Linear : MergeAlignMode::Nearest;
+            channels[ref.sheet].append(qMakePair(ref.column, mode));
+            nameCount[m_table->item(r, 1)->text()]++;
+        }
+    }
+
+    // 2. 提取数据，文本时间与数值时间不能混用
+    int textSources = 0;
+    QVector<int> sourceSheet;
+    for (int s = 0; s < m_sheets.size(); ++s) {
+        if (channels[s].isEmpty()) continue;
+        const DataMergeSheetInfo& sheet = m_sheets[s];
+        MergeSource src;
+        src.name = sheet.title;
+        bool isText = false;
+        if (!extractTime(sheet.model, timeColumn[s], src.time, isText)) {
+            error = QString("文件 %1 的时间列无法解析为数值或日期时间。").arg(sheet.title);
+            return false;
+        }
+        if (isText) ++textSources;
+        for (int k = 1; k < src.time.size(); ++k) {
+            if (src.time[k] < src.time[k - 1]) {
+                error = QString("文件 %1 的时间列不是升序排列，请先排序。").arg(sheet.title);
+                return false;
+            }
+        }
+
+        for (const auto& ch : channels[s]) {
+            QString header = sheet.model->headerData(ch.first, Qt::Horizontal).toString();
+            if (header.isEmpty()) header = QString("列%1").arg(ch.first + 1);
+            MergeChannel channel;
+            channel.name = nameCount.value(header) > 1 ? QString("%1 (%2)").arg(header, sheet.title) : header;
+            channel.mode = ch.second;
+            channel.values = extractValues(sheet.model, ch.first);
+            src.channels.append(channel);
+
+            ColumnDefinition def = ch.first < sheet.definitions.size() ? sheet.definitions[ch.first] : ColumnDefinition();
+            def.name = channel.name;
+            request.channelDefinitions.append(def);
+        }
+        request.sources.append(src);
+        sourceSheet.append(s);
+    }
+    if (textSources != 0 && textSources != request.sources.size()) {
+        error = "各文件的时间列必须同为数值或同为日期时间文本。";
+        return false;
+    }
+
+    // 3. 文本时间以最早时刻为零点
+    request.timeDefinition.type = WellTestColumnType::Time;
+    request.timeDefinition.unit = "h";
+    if (textSources > 0) {
+        double origin = std::numeric_limits<double>::infinity();
+        for (const MergeSource& src : request.sources)
+            for (double t : src.time) if (!std::isnan(t)) origin = qMin(origin, t);
+        for (MergeSource& src : request.sources)
+            for (double& t : src.time) t -= origin;
+        request.timeDefinition.name = "时间\\h";
+    } else {
+        const int s = sourceSheet.first();
+        request.timeDefinition.name = m_sheets[s].model->headerData(timeColumn[s], Qt::Horizontal).toString();
+        if (request.timeDefinition.name.isEmpty()) request.timeDefinition.name = "时间";
+    }
+
+    // 4. 合并参数
+    request.options.timeTolerance = m_tolerance->value();
+    if (m_maxGap->value() > 0.0) request.options.maxGap = m_maxGap->value();
+    request.options.extrapolate = m_extrapolate->isChecked();
+    request.options.referenceSource = m_axis->currentIndex() > 0 ? sourceSheet.indexOf(m_axis->currentIndex() - 1) : -1;
+    return true;
+}
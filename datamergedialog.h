@@ -0,0 +1,82 @@
+/*
+ * 文件名: datamergedialog.h
+ * 文件作用: 多文件按时间合并配置对话框头文件
+ * 功能描述:
+ * 1. 列出所有已打开数据页签的全部列，逐列指定用途：时间列，或数值列的对齐方式 (阶梯保持/线性插值/最近点)。
+ * 2. 按列定义类型与列名给出默认用途：产量阶梯保持，压力/温度线性插值。
+ * 3. 设置时间合并容差、最大插值间隔、范围外是否沿用首末值、输出时间轴 (并集或以某文件为准)。
+ * 4. 确认后从各模型提取为 MergeSource (数值与日期时间文本两种时间列均支持)，交给 TimeSeriesMerger 执行。
+ */
+
+#ifndef DATAMERGEDIALOG_H
+#define DATAMERGEDIALOG_H
+
+#include <QDialog>
+#include <QList>
+#include <QStandardItemModel>
+#include "datasinglesheet.h"
+#include "timeseriesmerge.h"
+
+class QTableWidget;
+class QDoubleSpinBox;
+class QComboBox;
+class QCheckBox;
+
+// 参与合并的一个数据页签
+struct DataMergeSheetInfo {
+    QString title;
+    QStandardItemModel* model = nullptr;
+    QList<ColumnDefinition> definitions;
+};
+
+// 提取结果：归并输入与结果表的列定义
+struct DataMergeRequest {
+    QVector<MergeSource> sources;
+    MergeOptions options;
+    ColumnDefinition timeDefinition;            // 结果时间列
+    QList<ColumnDefinition> channelDefinitions; // 结果数值列，与归并输出列顺序一致
+};
+
+class DataMergeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DataMergeDialog(const QList<DataMergeSheetInfo>& sheets, QWidget* parent = nullptr);
+
+    /**
+     * @brief 按对话框设置从各模型提取数据
+     * @param error 失败时的说明
+     * @return 设置不完整或数据无法解析时返回 false
+     */
+    bool buildRequest(DataMergeRequest& request, QString& error) const;
+
+private slots:
+    void onAccept();
+
+private:
+    // 列用途下拉框的选项
+    enum ColumnUsage { Unused = 0, TimeColumn, StepHold, Linear, Nearest };
+
+    struct RowRef {
+        int sheet;
+        int column;
+    };
+
+    void initUI();
+    ColumnUsage defaultUsage(const ColumnDefinition& def, const QString& header, bool& timeTaken) const;
+    // 提取时间列为小时；isText 返回是否按日期时间文本解析 (此时为自 1970 年起的小时数)
+    static bool extractTime(QStandardItemModel* model, int column, QVector<double>& hours, bool& isText);
+    static QVector<double> extractValues(QStandardItemModel* model, int column);
+
+    QList<DataMergeSheetInfo> m_sheets;
+    QList<RowRef> m_rows;
+
+    QTableWidget* m_table = nullptr;
+    QDoubleSpinBox* m_tolerance = nullptr;
+    QDoubleSpinBox* m_maxGap = nullptr;
+    QComboBox* m_axis = nullptr;
+    QCheckBox* m_extrapolate = nullptr;
+};
+
+#endif // DATAMERGEDIALOG_H
@@ -14,8 +14,9 @@
  * - 时间转换 (onTimeConvert)。
  * - 压降计算 (onPressureDropCalc)。
  * - 井底流压计算 (onCalcPwf)。
- * - 错误高亮检查 (onHighlightErrors)。
+ * - 数据质量校验 (onHighlightErrors)：DataValidator 后台并行校验，DataIssueProxyModel 按索引高亮。
  * 5. 实现数据的导出 (Excel) 和 序列化保存 (JSON)。
+ * - loadFromTable: 由多文件合并的按列结果建表，各列单元格并行创建后整列插入。
  * 6. 强制应用统一的 UI 样式，确保弹窗按钮清晰可见。
  */
 
@@ -52,6 +53,9 @@
 #include <QGroupBox>
 #include <QPushButton>
 #include <QWheelEvent>
+#include <QtConcurrent>
+#include <cmath>
+#include <limits>
 
 // ============================================================================
 // [辅助函数] 强制应用“灰底黑字”的按钮样式
@@ -188,7 +192,7 @@ DataSingleSheet::DataSingleSheet(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::DataSingleSheet),
     m_dataModel(new QStandardItemModel(this)),
-    m_proxyModel(new QSortFilterProxyModel(this)),
+    m_proxyModel(new DataIssueProxyModel(this)),
     m_undoStack(new QUndoStack(this))
 {
     ui->setupUi(this);
@@ -199,6 +203,19 @@ DataSingleSheet::DataSingleSheet(QWidget *parent) :
     connect(ui->dataTableView, &QTableView::customContextMenuRequested, this, &DataSingleSheet::onCustomContextMenu);
     // 连接模型数据变更信号
     connect(m_dataModel, &QStandardItemModel::itemChanged, this, &DataSingleSheet::onModelDataChanged);
+    // [新增] 结构变化使问题索引失效
+    connect(m_dataModel, &QStandardItemModel::rowsInserted, this, &DataSingleSheet::onModelStructureChanged);
+    connect(m_dataModel, &QStandardItemModel::rowsRemoved, this, &DataSingleSheet::onModelStructureChanged);
+    connect(m_dataModel, &QStandardItemModel::columnsInserted, this, &DataSingleSheet::onModelStructureChanged);
+    connect(m_dataModel, &QStandardItemModel::columnsRemoved, this, &DataSingleSheet::onModelStructureChanged);
+    connect(m_dataModel, &QStandardItemModel::modelReset, this, &DataSingleSheet::onModelStructureChanged);
+
+    // [新增] 校验启用后，编辑停止 1.5 秒再重新校验，连续编辑只触发一次
+    m_revalidateTimer = new QTimer(this);
+    m_revalidateTimer->setSingleShot(true);
+    m_revalidateTimer->setInterval(1500);
+    connect(m_revalidateTimer, &QTimer::timeout, this, [this]() { startValidation(false); });
+    connect(&m_validationWatcher, &QFutureWatcher<DataIssueIndex>::finished, this, &DataSingleSheet::onValidationFinished);
 
     // 安装事件过滤器以捕获表格视图的滚轮事件（用于缩放）
     ui->dataTableView->viewport()->installEventFilter(this);
@@ -206,6 +223,9 @@ DataSingleSheet::DataSingleSheet(QWidget *parent) :
 
 DataSingleSheet::~DataSingleSheet()
 {
+    // 后台校验持有取消标志的指针，析构前须等待其结束
+    m_validationCancel = true;
+    m_validationWatcher.waitForFinished();
     delete ui;
 }
 
@@ -776,6 +796,8 @@ void DataSingleSheet::onDefineColumns() {
         for(int i=0; i<m_columnDefinitions.size(); ++i)
             if(i < m_dataModel->columnCount())
                 m_dataModel->setHeaderData(i, Qt::Horizontal, m_columnDefinitions[i].name);
+        // 列属性决定校验规则，需重新校验
+        if (m_validationActive) m_revalidateTimer->start();
         emit dataChanged();
     }
 }
@@ -827,33 +849,187 @@ void DataSingleSheet::onCalcPwf() {
     }
 }
 
-// 错误高亮检查
+// ============================================================================
+// [新增] 数据质量校验
+// ============================================================================
+
+// 界面线程每次事件循环提取的行数
+static const int kValidationRowsPerTick = 50000;
+
+// 单元格文本转数值：时间列兼容日期时间文本 (换算为小时)
+static double parseValidationValue(const QString& text, bool isTime, bool& invalid)
+{
+    invalid = false;
+    if (text.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+    bool ok = false;
+    double v = text.toDouble(&ok);
+    if (ok) return v;
+    if (isTime) {
+        QDateTime dt = QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss");
+        if (!dt.isValid()) dt = QDateTime::fromString(text, Qt::ISODate);
+        if (dt.isValid()) return dt.toSecsSinceEpoch() / 3600.0;
+    }
+    invalid = true;
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+void DataIssueProxyModel::setIssueIndex(const DataIssueIndex& index)
+{
+    m_issues = index;
+    if (rowCount() > 0 && columnCount() > 0)
+        emit dataChanged(this->index(0, 0), this->index(rowCount() - 1, columnCount() - 1),
+                         {Qt::BackgroundRole, Qt::ToolTipRole});
+}
+
+void DataIssueProxyModel::clearIssues()
+{
+    if (m_issues.isEmpty()) return;
+    setIssueIndex(DataIssueIndex());
+}
+
+QVariant DataIssueProxyModel::data(const QModelIndex &index, int role) const
+{
+    if ((role == Qt::BackgroundRole || role == Qt::ToolTipRole) && !m_issues.isEmpty() && index.isValid()) {
+        QModelIndex src = mapToSource(index);
+        quint16 mask = m_issues.mask(src.row(), src.column());
+        if (mask) {
+            if (role == Qt::ToolTipRole) return DataIssueIndex::describe(mask);
+            // 时间类问题用黄色，数值类问题用红色
+            const quint16 timeBits = (1u << static_cast<int>(DataIssueType::NonMonotonicTime))
+                                   | (1u << static_cast<int>(DataIssueType::DuplicateTime))
+                                   | (1u << static_cast<int>(DataIssueType::TimeGap));
+            return (mask & ~timeBits) ? QColor(255, 200, 200) : QColor(255, 240, 180);
+        }
+    }
+    return QSortFilterProxyModel::data(index, role);
+}
+
+// 数据质量校验入口 (工具栏“错误检查”)
 void DataSingleSheet::onHighlightErrors() {
-    // 清除原有背景色
-    for(int r=0; r<m_dataModel->rowCount(); ++r)
-        for(int c=0; c<m_dataModel->columnCount(); ++c)
-            if(auto it = m_dataModel->item(r,c)) it->setBackground(Qt::NoBrush);
-
-    // 查找压力列
-    int pIdx = -1;
-    for(int i=0; i<m_columnDefinitions.size(); ++i)
-        if(m_columnDefinitions[i].type == WellTestColumnType::Pressure) pIdx = i;
-
-    int err = 0;
-    if(pIdx != -1) {
-        for(int r=0; r<m_dataModel->rowCount(); ++r) {
-            auto item = m_dataModel->item(r, pIdx);
-            // 简单的逻辑检查：压力不能为负
-            if(item && item->text().toDouble() < 0) {
-                item->setBackground(QColor(255, 200, 200));
-                err++;
-            }
+    m_validationActive = true;
+    startValidation(true);
+}
+
+/**
+ * @brief 启动一次校验
+ * * 按列属性选取时间、压力、产量、温度列；提取分片在事件循环中进行，编辑不受影响。
+ * * 后台校验进行中再次调用时，取消当前校验并在其结束后重新开始。
+ */
+void DataSingleSheet::startValidation(bool interactive)
+{
+    if (interactive) m_validationInteractive = true;
+    if (m_validationWatcher.isRunning()) {
+        m_validationRestart = true;
+        m_validationCancel = true;
+        return;
+    }
+
+    m_validationInput = DataValidationInput();
+    m_validationInput.rowCount = m_dataModel->rowCount();
+    for (int i = 0; i < m_columnDefinitions.size() && i < m_dataModel->columnCount(); ++i) {
+        DataValidationColumn col;
+        col.modelColumn = i;
+        switch (m_columnDefinitions[i].type) {
+        case WellTestColumnType::Time: col.role = ValidationColumnRole::Time; break;
+        case WellTestColumnType::Pressure:
+        case WellTestColumnType::CasingPressure:
+        case WellTestColumnType::BottomHolePressure: col.role = ValidationColumnRole::Pressure; break;
+        case WellTestColumnType::FlowRate: col.role = ValidationColumnRole::Rate; break;
+        case WellTestColumnType::Temperature: col.role = ValidationColumnRole::Temperature; break;
+        default: continue;
         }
+        col.values.resize(m_validationInput.rowCount);
+        m_validationInput.columns.append(col);
     }
-    showStyledMessage(this, QMessageBox::Information, "检查完成", QString("发现 %1 个错误。").arg(err));
+
+    if (m_validationInput.columns.isEmpty()) {
+        m_proxyModel->clearIssues();
+        if (m_validationInteractive) {
+            m_validationInteractive = false;
+            showStyledMessage(this, QMessageBox::Information, "检查完成",
+                              "未找到可校验的列。\n请先通过“定义列属性”指定时间、压力、产量或温度列。");
+        }
+        return;
+    }
+
+    bool extracting = m_extractRow >= 0;
+    m_extractRow = 0;
+    m_validationGeneration = m_structureGeneration;
+    if (!extracting) QTimer::singleShot(0, this, &DataSingleSheet::extractValidationChunk);
 }
 
-void DataSingleSheet::onModelDataChanged() { emit dataChanged(); }
+void DataSingleSheet::extractValidationChunk()
+{
+    if (m_extractRow < 0) return;
+
+    // 提取期间行列发生增删：按新结构重新开始
+    if (m_validationGeneration != m_structureGeneration) {
+        m_extractRow = -1;
+        startValidation(false);
+        return;
+    }
+
+    int end = qMin(m_validationInput.rowCount, m_extractRow + kValidationRowsPerTick);
+    for (DataValidationColumn& col : m_validationInput.columns) {
+        bool isTime = (col.role == ValidationColumnRole::Time);
+        for (int r = m_extractRow; r < end; ++r) {
+            QStandardItem* item = m_dataModel->item(r, col.modelColumn);
+            bool invalid = false;
+            col.values[r] = parseValidationValue(item ? item->text().trimmed() : QString(), isTime, invalid);
+            if (invalid) col.invalidRows.append(r);
+        }
+    }
+    m_extractRow = end;
+    if (end < m_validationInput.rowCount) {
+        QTimer::singleShot(0, this, &DataSingleSheet::extractValidationChunk);
+        return;
+    }
+
+    m_extractRow = -1;
+    m_validationCancel = false;
+    m_validationWatcher.setFuture(QtConcurrent::run(&DataValidator::validate, std::move(m_validationInput),
+                                                    DataValidationRules(), &m_validationCancel));
+    m_validationInput = DataValidationInput();
+}
+
+void DataSingleSheet::onValidationFinished()
+{
+    if (m_validationRestart) {
+        m_validationRestart = false;
+        startValidation(false);
+        return;
+    }
+    if (m_validationGeneration != m_structureGeneration) {
+        startValidation(false);
+        return;
+    }
+
+    DataIssueIndex index = m_validationWatcher.result();
+    m_proxyModel->setIssueIndex(index);
+
+    if (m_validationInteractive) {
+        m_validationInteractive = false;
+        if (index.isEmpty()) {
+            showStyledMessage(this, QMessageBox::Information, "检查完成", "未发现数据问题。");
+        } else {
+            showStyledMessage(this, QMessageBox::Information, "检查完成",
+                              QString("发现 %1 个问题单元格 (已高亮，悬停查看原因)：\n\n%2")
+                                  .arg(index.cellCount()).arg(index.summary()));
+        }
+    }
+}
+
+void DataSingleSheet::onModelDataChanged() {
+    if (m_validationActive) m_revalidateTimer->start();
+    emit dataChanged();
+}
+
+void DataSingleSheet::onModelStructureChanged()
+{
+    ++m_structureGeneration;
+    m_proxyModel->clearIssues();
+    if (m_validationActive) m_revalidateTimer->start();
+}
 
 // 序列化保存数据到 JSON 对象
 QJsonObject DataSingleSheet::saveToJson() const {
@@ -890,6 +1066,41 @@ void DataSingleSheet::loadFromJson(const QJsonObject& jsonSheet) {
     deserializeRows(rows);
 }
 
+// [新增] 由按列存储的合并结果建表
+void DataSingleSheet::loadFromTable(const QString& title, const ColumnarTable& table,
+                                    const ColumnDefinition& timeDefinition, const QList<ColumnDefinition>& definitions)
+{
+    m_dataModel->clear();
+    m_columnDefinitions.clear();
+    m_filePath = title;
+
+    const int rowCount = table.rowCount();
+    QVector<QPair<int, int>> chunks;
+    const int chunkRows = 65536;
+    for (int begin = 0; begin < rowCount; begin += chunkRows)
+        chunks.append(qMakePair(begin, qMin(begin + chunkRows, rowCount)));
+
+    // 每列并行创建数值型单元格 (缺失值为空单元格)，整列插入只触发一次结构变化通知
+    auto appendColumn = [&](const QVector<double>& values, const ColumnDefinition& def) {
+        QList<QStandardItem*> items(rowCount, nullptr);
+        QtConcurrent::blockingMap(chunks, [&](const QPair<int, int>& range) {
+            for (int i = range.first; i < range.second; ++i) {
+                QStandardItem* item = new QStandardItem;
+                if (!std::isnan(values[i])) item->setData(values[i], Qt::DisplayRole);
+                items[i] = item;
+            }
+        });
+        const int col = m_dataModel->columnCount();
+        m_dataModel->insertColumn(col, items);
+        m_dataModel->setHorizontalHeaderItem(col, new QStandardItem(def.name));
+        m_columnDefinitions.append(def);
+    };
+
+    appendColumn(table.time, timeDefinition);
+    for (int c = 0; c < table.columnCount(); ++c)
+        appendColumn(table.columns[c], c < definitions.size() ? definitions[c] : ColumnDefinition());
+}
+
 // 辅助：序列化所有行数据
 QJsonArray DataSingleSheet::serializeRows() const {
     QJsonArray a;
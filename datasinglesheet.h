@@ -6,6 +6,8 @@
  * 2. 处理该页签内的数据加载、计算、列属性定义、右键菜单操作。
  * 3. [新增] 支持 Ctrl+滚轮 缩放表格。
  * 4. 提供数据的序列化(JSON)和反序列化接口。
+ * 5. [新增] 数据质量校验：DataValidator 后台并行校验，问题索引由 DataIssueProxyModel 在 data() 中
+ *    以背景色与提示返回，不再逐个修改单元格背景；校验启用后编辑数据会自动延时重新校验。
  */
 
 #ifndef DATASINGLESHEET_H
@@ -19,7 +21,12 @@
 #include <QMenu>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <atomic>
 #include "dataimportdialog.h"
+#include "datavalidator.h"
+#include "timeseriesmerge.h"
 
 enum class WellTestColumnType {
     SerialNumber, Date, Time, TimeOfDay, Pressure, CasingPressure, BottomHolePressure,
@@ -50,6 +57,23 @@ public:
                           const QModelIndex &index) const override;
 };
 
+// [新增] 表格代理模型：按问题索引返回高亮背景与提示，单元格本身不被修改
+class DataIssueProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit DataIssueProxyModel(QObject *parent = nullptr) : QSortFilterProxyModel(parent) {}
+
+    void setIssueIndex(const DataIssueIndex& index);
+    void clearIssues();
+    const DataIssueIndex& issueIndex() const { return m_issues; }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    DataIssueIndex m_issues;
+};
+
 class DataSingleSheet : public QWidget
 {
     Q_OBJECT
@@ -60,11 +84,15 @@ public:
 
     bool loadData(const QString& filePath, const DataImportSettings& settings);
     void loadFromJson(const QJsonObject& jsonSheet);
+    // [新增] 由按列存储的合并结果建表 (时间列在前)，各列单元格并行创建后整列插入
+    void loadFromTable(const QString& title, const ColumnarTable& table,
+                       const ColumnDefinition& timeDefinition, const QList<ColumnDefinition>& definitions);
     QJsonObject saveToJson() const;
 
     QString getFilePath() const { return m_filePath; }
     void setFilePath(const QString& path) { m_filePath = path; }
     QStandardItemModel* getDataModel() const { return m_dataModel; }
+    const QList<ColumnDefinition>& getColumnDefinitions() const { return m_columnDefinitions; }
     void setFilterText(const QString& text);
 
 protected:
@@ -100,14 +128,33 @@ signals:
 
 private slots:
     void onModelDataChanged();
+    // [新增] 行列增删或模型重置：旧问题索引失效
+    void onModelStructureChanged();
+    // [新增] 校验流水线：界面线程分片提取列数据，完成后交给后台校验
+    void extractValidationChunk();
+    void onValidationFinished();
 
 private:
     Ui::DataSingleSheet *ui;
 
     QStandardItemModel* m_dataModel;
-    QSortFilterProxyModel* m_proxyModel;
+    DataIssueProxyModel* m_proxyModel;
     QUndoStack* m_undoStack;
 
+    // [新增] 数据质量校验状态
+    QFutureWatcher<DataIssueIndex> m_validationWatcher;
+    std::atomic<bool> m_validationCancel{false};
+    DataValidationInput m_validationInput;  // 正在提取的列数据
+    int m_extractRow = -1;                  // 下一个待提取行，-1 表示未在提取
+    int m_structureGeneration = 0;          // 模型结构版本 (行列增删时递增)
+    int m_validationGeneration = 0;         // 本次校验开始时的结构版本
+    bool m_validationActive = false;        // 用户执行过校验，编辑后自动重新校验
+    bool m_validationInteractive = false;   // 完成后弹出结果汇总
+    bool m_validationRestart = false;       // 后台校验期间数据又有变化
+    QTimer* m_revalidateTimer = nullptr;    // 编辑后的延时重新校验
+
+    void startValidation(bool interactive);
+
     QString m_filePath;
     QList<ColumnDefinition> m_columnDefinitions;
 
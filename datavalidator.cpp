@@ -0,0 +1,352 @@
+/*
+ * 文件名: datavalidator.cpp
+ * 文件作用: 数据质量校验引擎实现文件
+ * 功能描述:
+ * 1. 全局统计量 (典型时间间隔、最大产量、漂移基准) 先由抽样或首块串行求出，各分块共享只读。
+ * 2. 各分块由 QtConcurrent 并行处理，只对本块内的行产生问题，窗口读取可越过块边界。
+ * 3. 规则说明：
+ *    - 时间：与上一行比较，倒序、重复、间隔超过 gapFactor 倍典型间隔；
+ *    - 尖峰：Hampel 滤波，|x - 窗口中位数| > max(sigma * 1.4826 * MAD, 最小偏差)；
+ *    - 漂移：前两个压力列逐行作差，按块取中位数，与首块相比偏移超过容差的块整块标记；
+ *    - 错位：产量变化行附近压力变化最大的行与之相差超过容差行数；
+ *    - 范围：压力、产量、温度超出设定上下限。
+ */
+
+#include "datavalidator.h"
+
+#include <QtConcurrent>
+#include <QPair>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+inline quint64 makeKey(int row, int column)
+{
+    return (static_cast<quint64>(row) << 24) | static_cast<quint64>(column & 0xFFFFFF);
+}
+
+// 小数组中位数 (会打乱输入顺序)
+double medianOf(std::vector<double>& v)
+{
+    if (v.empty()) return kNaN;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    double m = v[mid];
+    if (v.size() % 2 == 0) {
+        double lower = *std::max_element(v.begin(), v.begin() + mid);
+        m = 0.5 * (m + lower);
+    }
+    return m;
+}
+
+// 各分块共享的只读上下文
+struct ValidationContext {
+    const DataValidationInput* input = nullptr;
+    const DataValidationRules* rules = nullptr;
+    int timeCol = -1;               // input.columns 下标
+    QVector<int> pressureCols;
+    QVector<int> temperatureCols;
+    int rateCol = -1;
+    double typicalDt = 0.0;         // 典型时间间隔 (正间隔的中位数)
+    double rateScale = 0.0;         // 最大产量绝对值
+    double driftReference = kNaN;   // 首块双压力计差值中位数
+};
+
+void addIssue(std::vector<DataIssue>& out, int row, int column, DataIssueType type)
+{
+    DataIssue issue;
+    issue.row = row;
+    issue.column = column;
+    issue.type = type;
+    out.push_back(issue);
+}
+
+void checkTime(const ValidationContext& ctx, int begin, int end, std::vector<DataIssue>& out)
+{
+    const DataValidationColumn& col = ctx.input->columns[ctx.timeCol];
+    const QVector<double>& t = col.values;
+    for (int i = qMax(begin, 1); i < end; ++i) {
+        double a = t[i - 1], b = t[i];
+        if (std::isnan(a) || std::isnan(b)) continue;
+        double dt = b - a;
+        if (dt < 0) addIssue(out, i, col.modelColumn, DataIssueType::NonMonotonicTime);
+        else if (dt == 0) addIssue(out, i, col.modelColumn, DataIssueType::DuplicateTime);
+        else if (ctx.typicalDt > 0 && dt > ctx.rules->gapFactor * ctx.typicalDt)
+            addIssue(out, i, col.modelColumn, DataIssueType::TimeGap);
+    }
+}
+
+void checkSpikes(const ValidationContext& ctx, const DataValidationColumn& col, int begin, int end, std::vector<DataIssue>& out)
+{
+    const QVector<double>& x = col.values;
+    const int n = x.size();
+    const int h = ctx.rules->hampelHalfWindow;
+    std::vector<double> window, deviations;
+    window.reserve(2 * h + 1);
+    deviations.reserve(2 * h + 1);
+
+    for (int i = begin; i < end; ++i) {
+        if (std::isnan(x[i])) continue;
+        window.clear();
+        for (int k = qMax(0, i - h); k <= qMin(n - 1, i + h); ++k) {
+            if (!std::isnan(x[k])) window.push_back(x[k]);
+        }
+        if (static_cast<int>(window.size()) < h + 1) continue; // 有效邻点太少不判定
+
+        double m = medianOf(window);
+        deviations.clear();
+        for (double v : window) deviations.push_back(std::abs(v - m));
+        double mad = medianOf(deviations);
+
+        double limit = std::max(ctx.rules->hampelSigma * 1.4826 * mad, ctx.rules->hampelMinDeviation);
+        if (std::abs(x[i] - m) > limit) addIssue(out, i, col.modelColumn, DataIssueType::Spike);
+    }
+}
+
+// 块 [s, s+B) 内双压力计差值的中位数
+double driftBlockMedian(const ValidationContext& ctx, int s)
+{
+    const QVector<double>& a = ctx.input->columns[ctx.pressureCols[0]].values;
+    const QVector<double>& b = ctx.input->columns[ctx.pressureCols[1]].values;
+    int e = qMin(s + ctx.rules->driftBlockRows, ctx.input->rowCount);
+    std::vector<double> diff;
+    diff.reserve(e - s);
+    for (int i = s; i < e; ++i) {
+        double d = a[i] - b[i];
+        if (!std::isnan(d)) diff.push_back(d);
+    }
+    return medianOf(diff);
+}
+
+void checkDrift(const ValidationContext& ctx, int begin, int end, std::vector<DataIssue>& out)
+{
+    if (std::isnan(ctx.driftReference)) return;
+    const int B = ctx.rules->driftBlockRows;
+    const int column = ctx.input->columns[ctx.pressureCols[1]].modelColumn;
+
+    // 本分块负责起点落在 [begin, end) 内的块
+    int first = (begin + B - 1) / B * B;
+    for (int s = first; s < end; s += B) {
+        double m = driftBlockMedian(ctx, s);
+        if (std::isnan(m) || std::abs(m - ctx.driftReference) <= ctx.rules->driftTolerance) continue;
+        int e = qMin(s + B, ctx.input->rowCount);
+        for (int i = s; i < e; ++i) addIssue(out, i, column, DataIssueType::GaugeDrift);
+    }
+}
+
+void checkRateAlignment(const ValidationContext& ctx, int begin, int end, std::vector<DataIssue>& out)
+{
+    if (ctx.rateCol < 0 || ctx.pressureCols.isEmpty() || ctx.rateScale <= 0) return;
+    const DataValidationColumn& rateCol = ctx.input->columns[ctx.rateCol];
+    const DataValidationColumn& pCol = ctx.input->columns[ctx.pressureCols[0]];
+    const QVector<double>& q = rateCol.values;
+    const QVector<double>& p = pCol.values;
+    const int n = ctx.input->rowCount;
+    const int W = ctx.rules->alignWindow;
+    std::vector<double> steps;
+
+    for (int i = qMax(begin, 1); i < end; ++i) {
+        double dq = q[i] - q[i - 1];
+        if (std::isnan(dq) || std::abs(dq) <= ctx.rules->rateChangeRatio * ctx.rateScale) continue;
+
+        // 窗口内压力变化最大的行
+        int bestRow = -1;
+        double bestStep = 0.0;
+        steps.clear();
+        for (int j = qMax(1, i - W); j <= qMin(n - 1, i + W); ++j) {
+            double dp = std::abs(p[j] - p[j - 1]);
+            if (std::isnan(dp)) continue;
+            steps.push_back(dp);
+            if (dp > bestStep) { bestStep = dp; bestRow = j; }
+        }
+        if (bestRow < 0) continue;
+
+        // 最大变化须明显高于窗口内的一般波动，才视为产量变化引起的响应
+        double typicalStep = medianOf(steps);
+        if (bestStep <= 5.0 * typicalStep) continue;
+
+        if (std::abs(bestRow - i) > ctx.rules->alignTolerance) {
+            addIssue(out, i, rateCol.modelColumn, DataIssueType::RateMisaligned);
+            addIssue(out, bestRow, pCol.modelColumn, DataIssueType::RateMisaligned);
+        }
+    }
+}
+
+void checkRange(const DataValidationColumn& col, double lo, double hi, int begin, int end, std::vector<DataIssue>& out)
+{
+    const QVector<double>& x = col.values;
+    for (int i = begin; i < end; ++i) {
+        double v = x[i];
+        if (!std::isnan(v) && (v < lo || v > hi)) addIssue(out, i, col.modelColumn, DataIssueType::OutOfRange);
+    }
+}
+
+std::vector<DataIssue> validateChunk(const ValidationContext& ctx, int begin, int end)
+{
+    std::vector<DataIssue> out;
+    const DataValidationInput& in = *ctx.input;
+    const DataValidationRules& rules = *ctx.rules;
+
+    if (ctx.timeCol >= 0) checkTime(ctx, begin, end, out);
+
+    for (int c : ctx.pressureCols) {
+        checkSpikes(ctx, in.columns[c], begin, end, out);
+        checkRange(in.columns[c], rules.pressureMin, rules.pressureMax, begin, end, out);
+    }
+    for (int c : ctx.temperatureCols) {
+        checkSpikes(ctx, in.columns[c], begin, end, out);
+        checkRange(in.columns[c], rules.temperatureMin, rules.temperatureMax, begin, end, out);
+    }
+    if (ctx.rateCol >= 0)
+        checkRange(in.columns[ctx.rateCol], rules.rateMin, std::numeric_limits<double>::infinity(), begin, end, out);
+
+    if (ctx.pressureCols.size() >= 2) checkDrift(ctx, begin, end, out);
+    checkRateAlignment(ctx, begin, end, out);
+    return out;
+}
+
+// 典型时间间隔：等距抽取至多 4096 个正间隔求中位数
+double estimateTypicalDt(const QVector<double>& t)
+{
+    const int n = t.size();
+    if (n < 2) return 0.0;
+    int stride = qMax(1, (n - 1) / 4096);
+    std::vector<double> dts;
+    for (int i = 1; i < n; i += stride) {
+        double dt = t[i] - t[i - 1];
+        if (!std::isnan(dt) && dt > 0) dts.push_back(dt);
+    }
+    double m = medianOf(dts);
+    return std::isnan(m) ? 0.0 : m;
+}
+
+} // namespace
+
+// ============================================================================
+// DataIssueIndex
+// ============================================================================
+
+DataIssueIndex DataIssueIndex::build(std::vector<DataIssue>& issues)
+{
+    DataIssueIndex index;
+    std::sort(issues.begin(), issues.end(), [](const DataIssue& a, const DataIssue& b) {
+        return makeKey(a.row, a.column) < makeKey(b.row, b.column);
+    });
+
+    index.m_keys.reserve(issues.size());
+    index.m_masks.reserve(issues.size());
+    for (const DataIssue& issue : issues) {
+        quint64 key = makeKey(issue.row, issue.column);
+        quint16 bit = static_cast<quint16>(1u << static_cast<int>(issue.type));
+        if (!index.m_keys.empty() && index.m_keys.back() == key) {
+            if (index.m_masks.back() & bit) continue;
+            index.m_masks.back() |= bit;
+        } else {
+            index.m_keys.push_back(key);
+            index.m_masks.push_back(bit);
+        }
+        index.m_counts[static_cast<int>(issue.type)]++;
+    }
+    return index;
+}
+
+quint16 DataIssueIndex::mask(int row, int column) const
+{
+    if (m_keys.empty()) return 0;
+    quint64 key = makeKey(row, column);
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+    if (it == m_keys.end() || *it != key) return 0;
+    return m_masks[it - m_keys.begin()];
+}
+
+QString DataIssueIndex::typeName(DataIssueType type)
+{
+    switch (type) {
+    case DataIssueType::NonMonotonicTime: return "时间倒序";
+    case DataIssueType::DuplicateTime: return "时间重复";
+    case DataIssueType::TimeGap: return "时间断点";
+    case DataIssueType::Spike: return "尖峰";
+    case DataIssueType::GaugeDrift: return "压力计漂移";
+    case DataIssueType::RateMisaligned: return "产量与压力错位";
+    case DataIssueType::OutOfRange: return "超出范围";
+    case DataIssueType::InvalidNumber: return "非数值";
+    default: return "未知";
+    }
+}
+
+QString DataIssueIndex::describe(quint16 mask)
+{
+    QStringList names;
+    for (int i = 0; i < static_cast<int>(DataIssueType::Count); ++i) {
+        if (mask & (1u << i)) names << typeName(static_cast<DataIssueType>(i));
+    }
+    return names.join("、");
+}
+
+QString DataIssueIndex::summary() const
+{
+    QStringList lines;
+    for (int i = 0; i < static_cast<int>(DataIssueType::Count); ++i) {
+        if (m_counts[i] > 0) lines << QString("%1：%2 处").arg(typeName(static_cast<DataIssueType>(i))).arg(m_counts[i]);
+    }
+    return lines.join("\n");
+}
+
+// ============================================================================
+// DataValidator
+// ============================================================================
+
+DataIssueIndex DataValidator::validate(const DataValidationInput& input, const DataValidationRules& rules,
+                                       const std::atomic<bool>* cancel)
+{
+    ValidationContext ctx;
+    ctx.input = &input;
+    ctx.rules = &rules;
+    for (int c = 0; c < input.columns.size(); ++c) {
+        switch (input.columns[c].role) {
+        case ValidationColumnRole::Time: if (ctx.timeCol < 0) ctx.timeCol = c; break;
+        case ValidationColumnRole::Pressure: ctx.pressureCols.append(c); break;
+        case ValidationColumnRole::Rate: if (ctx.rateCol < 0) ctx.rateCol = c; break;
+        case ValidationColumnRole::Temperature: ctx.temperatureCols.append(c); break;
+        }
+    }
+
+    // 全局统计量
+    if (ctx.timeCol >= 0) ctx.typicalDt = estimateTypicalDt(input.columns[ctx.timeCol].values);
+    if (ctx.rateCol >= 0) {
+        for (double v : input.columns[ctx.rateCol].values)
+            if (!std::isnan(v)) ctx.rateScale = std::max(ctx.rateScale, std::abs(v));
+    }
+    if (ctx.pressureCols.size() >= 2 && input.rowCount > 0) ctx.driftReference = driftBlockMedian(ctx, 0);
+
+    // 分块并行
+    QVector<QPair<int, int>> chunks;
+    const int chunkRows = qMax(1, rules.chunkRows);
+    for (int begin = 0; begin < input.rowCount; begin += chunkRows)
+        chunks.append(qMakePair(begin, qMin(begin + chunkRows, input.rowCount)));
+
+    QList<std::vector<DataIssue>> parts = QtConcurrent::blockingMapped<QList<std::vector<DataIssue>>>(
+        chunks, [&ctx, cancel](const QPair<int, int>& range) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) return std::vector<DataIssue>();
+            return validateChunk(ctx, range.first, range.second);
+        });
+    if (cancel && cancel->load(std::memory_order_relaxed)) return DataIssueIndex();
+
+    std::vector<DataIssue> issues;
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    for (const DataValidationColumn& col : input.columns) total += col.invalidRows.size();
+    issues.reserve(total);
+    for (const auto& part : parts) issues.insert(issues.end(), part.begin(), part.end());
+
+    // 非数值在提取时已确定
+    for (const DataValidationColumn& col : input.columns) {
+        for (int row : col.invalidRows) addIssue(issues, row, col.modelColumn, DataIssueType::InvalidNumber);
+    }
+    return DataIssueIndex::build(issues);
+}
@@ -0,0 +1,116 @@
+/*
+ * 文件名: datavalidator.h
+ * 文件作用: 数据质量校验引擎头文件
+ * 功能描述:
+ * 1. 定义校验问题类型 (时间倒序/重复、时间断点、尖峰、压力计漂移、产量与压力错位、超出范围、非数值)。
+ * 2. 定义 DataValidationInput：按列提取的只读数据 (时间、压力、产量、温度)，可在工作线程中使用。
+ * 3. 定义 DataIssueIndex：紧凑的问题索引 (按 行/列 排序的键 + 类型位掩码)，供表格按需查询高亮。
+ * 4. 声明 DataValidator：按行分块并行执行全部规则，窗口类规则读取块边界外的相邻行，结果与串行一致。
+ */
+
+#ifndef DATAVALIDATOR_H
+#define DATAVALIDATOR_H
+
+#include <QVector>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+// 问题类型 (位掩码中的位序号)
+enum class DataIssueType : quint8 {
+    NonMonotonicTime = 0,   // 时间倒序
+    DuplicateTime,          // 时间重复
+    TimeGap,                // 时间断点 (间隔过大)
+    Spike,                  // 尖峰 (Hampel 滤波判定)
+    GaugeDrift,             // 压力计漂移 (双压力计差值缓慢偏移)
+    RateMisaligned,         // 产量变化与压力响应错位
+    OutOfRange,             // 超出合理范围
+    InvalidNumber,          // 非数值
+    Count
+};
+
+// 校验列的物理含义
+enum class ValidationColumnRole {
+    Time,           // 时间 (小时)
+    Pressure,       // 压力类 (压力、套压、井底流压)
+    Rate,           // 产量
+    Temperature     // 温度
+};
+
+// 一列校验数据 (在界面线程从模型提取，之后只读)
+struct DataValidationColumn {
+    int modelColumn = -1;
+    ValidationColumnRole role = ValidationColumnRole::Pressure;
+    QVector<double> values;     // 空单元格与非数值为 NaN
+    QVector<int> invalidRows;   // 非空但无法解析为数值的行
+};
+
+struct DataValidationInput {
+    int rowCount = 0;
+    QVector<DataValidationColumn> columns;
+};
+
+// 校验规则阈值
+struct DataValidationRules {
+    double gapFactor = 10.0;            // 时间间隔超过典型间隔 (中位数) 的倍数视为断点
+    int hampelHalfWindow = 3;           // Hampel 窗口半宽 (行)
+    double hampelSigma = 3.0;           // 超过 sigma 倍稳健标准差视为尖峰
+    double hampelMinDeviation = 0.01;   // 尖峰的最小绝对偏差 (MPa)，避免量化台阶误报
+    int driftBlockRows = 200;           // 漂移检测分块行数
+    double driftTolerance = 0.05;       // 双压力计差值相对首块的允许偏移 (MPa)
+    double rateChangeRatio = 0.05;      // 产量变化超过最大产量的该比例视为一次产量变化
+    int alignWindow = 20;               // 在产量变化前后该行数内寻找压力响应
+    int alignTolerance = 2;             // 压力响应与产量变化允许相差的行数
+    double pressureMin = 0.0;           // 压力下限 (MPa)
+    double pressureMax = 200.0;         // 压力上限 (MPa)
+    double rateMin = 0.0;               // 产量下限
+    double temperatureMin = -50.0;      // 温度下限 (°C)
+    double temperatureMax = 300.0;      // 温度上限 (°C)
+    int chunkRows = 65536;              // 并行分块行数
+};
+
+// 单个问题 (校验过程中的中间结果)
+struct DataIssue {
+    int row = 0;
+    int column = 0;     // 模型列号
+    DataIssueType type = DataIssueType::OutOfRange;
+};
+
+// 紧凑问题索引：每个问题单元格一个键 (行<<24 | 列) 与类型位掩码，查询为二分查找
+class DataIssueIndex
+{
+public:
+    static DataIssueIndex build(std::vector<DataIssue>& issues);
+
+    bool isEmpty() const { return m_keys.empty(); }
+    int cellCount() const { return static_cast<int>(m_keys.size()); }
+    int count(DataIssueType type) const { return m_counts[static_cast<int>(type)]; }
+
+    // 单元格的问题类型位掩码，0 表示无问题
+    quint16 mask(int row, int column) const;
+
+    static QString typeName(DataIssueType type);
+    // 位掩码对应的说明文字 (用于提示)
+    static QString describe(quint16 mask);
+    // 各类问题数量汇总
+    QString summary() const;
+
+private:
+    std::vector<quint64> m_keys;
+    std::vector<quint16> m_masks;
+    int m_counts[static_cast<int>(DataIssueType::Count)] = {};
+};
+
+class DataValidator
+{
+public:
+    /**
+     * @brief 执行全部校验规则
+     * @param cancel 非空时每个分块开始前检查，置位则提前返回空索引
+     */
+    static DataIssueIndex validate(const DataValidationInput& input,
+                                   const DataValidationRules& rules = DataValidationRules(),
+                                   const std::atomic<bool>* cancel = nullptr);
+};
+
+#endif // DATAVALIDATOR_H
@@ -0,0 +1,271 @@
+/*
+ * 文件名: fitreplaylog.cpp
+ * 文件作用: 拟合回放日志实现文件
+ * 功能描述:
+ * 1. 日志格式：文件头 (魔数 "WTFR" + 格式版本) + qCompress 压缩的 QDataStream 数据块，双精度按原值保存，
+ *    保证回放时输入逐位一致。
+ * 2. 记录开关与目录为进程级全局状态，拟合线程只读。
+ * 3. 比对规则：相对偏差 |a-b| / max(|a|,|b|)，两者均为 0 时偏差为 0。
+ */
+
+#include "fitreplaylog.h"
+
+#include <QFile>
+#include <QDir>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QMutexLocker>
+#include <cmath>
+#include <algorithm>
+
+std::atomic<bool> FitReplayLog::s_enabled(false);
+
+namespace {
+
+const quint32 kReplayMagic = 0x57544652; // "WTFR"
+const quint16 kReplayVersion = 4;
+
+QMutex& dirMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QString& replayDir()
+{
+    static QString dir;
+    return dir;
+}
+
+double relDiff(double a, double b)
+{
+    double scale = std::max(std::abs(a), std::abs(b));
+    if (scale == 0.0) return 0.0;
+    return std::abs(a - b) / scale;
+}
+
+// 两组参数的最大相对偏差 (以 a 的键为准)
+double maxRelDiff(const QMap<QString, double>& a, const QMap<QString, double>& b, QString* worst = nullptr)
+{
+    double maxDiff = 0.0;
+    for (auto it = a.constBegin(); it != a.constEnd(); ++it) {
+        double d = b.contains(it.key()) ? relDiff(it.value(), b.value(it.key())) : 1.0;
+        if (d > maxDiff) {
+            maxDiff = d;
+            if (worst) *worst = it.key();
+        }
+    }
+    return maxDiff;
+}
+
+void writeStep(QDataStream& out, const LmAcceptedStep& s)
+{
+    out << qint32(s.iteration) << s.lambda << s.sse << s.params;
+}
+
+void readStep(QDataStream& in, LmAcceptedStep& s)
+{
+    qint32 iteration;
+    in >> iteration >> s.lambda >> s.sse >> s.params;
+    s.iteration = iteration;
+}
+
+} // namespace
+
+void FitReplayLog::setDirectory(const QString& dir)
+{
+    QMutexLocker locker(&dirMutex());
+    replayDir() = dir;
+}
+
+QString FitReplayLog::directory()
+{
+    QMutexLocker locker(&dirMutex());
+    return replayDir();
+}
+
+FitReplayRecord FitReplayLog::makeRecord(int modelType, const QList<FitParameter>& params, double weight, bool highPrecision,
+                                         const QVector<double>& fitT, const QVector<double>& fitP, const QVector<double>& fitD,
+                                         const FittingResult& result, const QString& source)
+{
+    FitReplayRecord r;
+    r.timestamp = QDateTime::currentDateTime();
+    r.source = source;
+    r.modelType = modelType;
+    r.weight = weight;
+    r.highPrecision = highPrecision;
+    r.initialParams = params;
+    r.fitT = fitT;
+    r.fitP = fitP;
+    r.fitD = fitD;
+    r.stepStrategy = result.stepStrategy;
+    r.boundHandling = result.boundHandling;
+    r.trajectory = result.trajectory;
+    r.finalParams = result.params;
+    r.sse = result.sse;
+    r.iterations = result.iterations;
+    r.residualEvaluations = result.residualEvaluations;
+    // 回放时没有界面回调，记录的耗时扣除回调部分才可比
+    r.elapsedMs = result.elapsedMs - result.callbackMs;
+    return r;
+}
+
+QString FitReplayLog::writeToDirectory(const FitReplayRecord& record, QString* errorMessage)
+{
+    QString dirPath = directory();
+    if (dirPath.isEmpty()) {
+        if (errorMessage) *errorMessage = "未设置回放日志目录";
+        return QString();
+    }
+    QDir dir(dirPath);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        if (errorMessage) *errorMessage = "无法创建目录: " + dirPath;
+        return QString();
+    }
+
+    QString fileName = QString("fit_%1_model%2.wtfr")
+                           .arg(record.timestamp.toString("yyyyMMdd_HHmmss_zzz"))
+                           .arg(record.modelType + 1);
+    QString filePath = dir.filePath(fileName);
+    return write(filePath, record, errorMessage) ? filePath : QString();
+}
+
+bool FitReplayLog::write(const QString& filePath, const FitReplayRecord& record, QString* errorMessage)
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+        out << record.timestamp << record.source << qint32(record.modelType) << record.weight << record.highPrecision;
+
+        out << qint32(record.initialParams.size());
+        for (const FitParameter& p : record.initialParams)
+            out << p.name << p.value << p.min << p.max << p.isFit;
+
+        out << record.fitT << record.fitP << record.fitD;
+
+        out << qint32(record.trajectory.size());
+        for (const LmAcceptedStep& s : record.trajectory) writeStep(out, s);
+
+        out << record.finalParams << record.sse << qint32(record.iterations)
+            << qint32(record.residualEvaluations) << record.elapsedMs;
+        out << record.pointWeights;
+        out << qint32(record.stepStrategy) << qint32(record.boundHandling);
+        out << (record.warmStart.isValid() ? QJsonDocument(record.warmStart.toJson()).toJson(QJsonDocument::Compact)
+                                           : QByteArray());
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = "无法写入文件: " + file.errorString();
+        return false;
+    }
+    QDataStream header(&file);
+    header << kReplayMagic << kReplayVersion;
+    header << qCompress(payload);
+    return header.status() == QDataStream::Ok;
+}
+
+bool FitReplayLog::read(const QString& filePath, FitReplayRecord& record, QString* errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = "无法打开文件: " + file.errorString();
+        return false;
+    }
+
+    QDataStream header(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    QByteArray compressed;
+    header >> magic >> version;
+    if (magic != kReplayMagic) {
+        if (errorMessage) *errorMessage = "不是拟合回放日志文件";
+        return false;
+    }
+    if (version > kReplayVersion) {
+        if (errorMessage) *errorMessage = QString("不支持的日志版本: %1").arg(version);
+        return false;
+    }
+    header >> compressed;
+    QByteArray payload = qUncompress(compressed);
+    if (payload.isEmpty()) {
+        if (errorMessage) *errorMessage = "日志数据损坏";
+        return false;
+    }
+
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    qint32 modelType = 0, paramCount = 0, stepCount = 0, iterations = 0, evaluations = 0;
+    in >> record.timestamp >> record.source >> modelType >> record.weight >> record.highPrecision;
+    record.modelType = modelType;
+
+    in >> paramCount;
+    record.initialParams.clear();
+    for (int i = 0; i < paramCount && in.status() == QDataStream::Ok; ++i) {
+        FitParameter p;
+        in >> p.name >> p.value >> p.min >> p.max >> p.isFit;
+        record.initialParams.append(p);
+    }
+
+    in >> record.fitT >> record.fitP >> record.fitD;
+
+    in >> stepCount;
+    record.trajectory.clear();
+    for (int i = 0; i < stepCount && in.status() == QDataStream::Ok; ++i) {
+        LmAcceptedStep s;
+        readStep(in, s);
+        record.trajectory.append(s);
+    }
+
+    in >> record.finalParams >> record.sse >> iterations >> evaluations >> record.elapsedMs;
+    record.iterations = iterations;
+    record.residualEvaluations = evaluations;
+    record.pointWeights.clear();
+    if (version >= 2) in >> record.pointWeights;
+    qint32 stepStrategy = 0, boundHandling = 0;
+    if (version >= 3) in >> stepStrategy >> boundHandling;
+    record.stepStrategy = stepStrategy;
+    record.boundHandling = boundHandling;
+    record.warmStart = FitWarmStart();
+    if (version >= 4) {
+        QByteArray warmStart;
+        in >> warmStart;
+        if (!warmStart.isEmpty()) record.warmStart = FitWarmStart::fromJson(QJsonDocument::fromJson(warmStart).object());
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        if (errorMessage) *errorMessage = "日志数据不完整";
+        return false;
+    }
+    return true;
+}
+
+FitReplayComparison FitReplayLog::compare(const FitReplayRecord& record, const FittingResult& replay, double tolerance)
+{
+    FitReplayComparison c;
+    c.recordedSteps = record.trajectory.size();
+    c.replayedSteps = replay.trajectory.size();
+
+    int common = qMin(c.recordedSteps, c.replayedSteps);
+    for (int i = 0; i < common; ++i) {
+        double d = maxRelDiff(record.trajectory[i].params, replay.trajectory[i].params);
+        c.trajectoryMaxRelDiff = std::max(c.trajectoryMaxRelDiff, d);
+    }
+
+    c.finalMaxRelDiff = maxRelDiff(record.finalParams, replay.params, &c.worstParam);
+    c.sseRelDiff = relDiff(record.sse, replay.sse);
+    c.recordedMs = record.elapsedMs;
+    c.replayedMs = replay.elapsedMs;
+    c.recordedEvaluations = record.residualEvaluations;
+    c.replayedEvaluations = replay.residualEvaluations;
+
+    c.sameTrajectory = (c.recordedSteps == c.replayedSteps) && c.trajectoryMaxRelDiff <= tolerance;
+    c.sameAnswer = c.finalMaxRelDiff <= tolerance;
+    return c;
+}
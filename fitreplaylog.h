@@ -0,0 +1,97 @@
+/*
+ * 文件名: fitreplaylog.h
+ * 文件作用: 拟合回放日志头文件
+ * 功能描述:
+ * 1. 定义 FitReplayRecord：一次 LM 拟合的完整输入 (抽样数据、模型类型、初始参数与上下限、权重、精度设置)
+ *    以及输出 (被接受的迭代步轨迹、最终参数、残差、耗时)。
+ * 2. 声明 FitReplayLog：二进制日志 (.wtfr) 的读写，全局记录开关与日志目录。
+ * 3. 定义 FitReplayComparison：回放结果与日志记录的比对 (轨迹偏差、最终参数偏差、耗时对比)，
+ *    供基准测试程序 (benchmarks/) 的回放模式在求解器改动后验证“结果一致、速度更快”。
+ * 4. [新增] 日志版本 2 记录抽样点逐点权重 (按抽样密度加权时)；版本 1 日志读入后为等权。
+ * 5. [新增] 日志版本 3 记录迭代步策略与上下限处理方式；旧版本日志读入后为阻尼 LM + 截断。
+ * 6. [新增] 日志版本 4 记录热启动所用的优化器状态 (未热启动时为空)；旧版本日志读入后为冷启动。
+ */
+
+#ifndef FITREPLAYLOG_H
+#define FITREPLAYLOG_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <QDateTime>
+#include <atomic>
+
+#include "fittingcore.h"
+
+// 一次拟合的回放记录
+struct FitReplayRecord {
+    QDateTime timestamp;                // 拟合时间
+    QString source;                     // 来源说明 (如项目文件名)
+    int modelType = 0;                  // 模型类型 (ModelSolver01_06::ModelType)
+    double weight = 0.5;                // 压差权重
+    bool highPrecision = false;         // 拟合期间求解器是否为高精度
+    QList<FitParameter> initialParams;  // 初始参数 (含上下限与是否拟合)
+    QVector<double> fitT, fitP, fitD;   // 抽样后的观测数据
+    QVector<double> pointWeights;       // 逐点权重 (为空表示等权)
+    int stepStrategy = 0;               // 迭代步策略 (FittingCore::StepStrategy)
+    int boundHandling = 0;              // 上下限处理方式 (FittingCore::BoundHandling)
+    FitWarmStart warmStart;             // 热启动状态 (未热启动时无效)
+
+    // 拟合输出
+    QVector<LmAcceptedStep> trajectory; // 被接受的迭代步
+    QMap<QString, double> finalParams;  // 最终参数
+    double sse = 0.0;                   // 最终残差平方和
+    int iterations = 0;                 // 迭代次数
+    int residualEvaluations = 0;        // 残差计算次数
+    double elapsedMs = 0.0;             // 拟合耗时 (不含界面回调)
+};
+
+// 回放与记录的比对结果
+struct FitReplayComparison {
+    int recordedSteps = 0;              // 日志中的接受步数
+    int replayedSteps = 0;              // 回放的接受步数
+    double trajectoryMaxRelDiff = 0.0;  // 公共步数内参数的最大相对偏差
+    double finalMaxRelDiff = 0.0;       // 最终参数的最大相对偏差
+    QString worstParam;                 // 最终偏差最大的参数
+    double sseRelDiff = 0.0;            // 最终残差平方和相对偏差
+    double recordedMs = 0.0;            // 记录时耗时
+    double replayedMs = 0.0;            // 回放耗时
+    int recordedEvaluations = 0;        // 记录时残差计算次数
+    int replayedEvaluations = 0;        // 回放残差计算次数
+    bool sameTrajectory = false;        // 步数相同且轨迹偏差在容差内
+    bool sameAnswer = false;            // 最终参数偏差在容差内
+};
+
+class FitReplayLog
+{
+public:
+    // 全局记录开关与日志目录 (由系统设置写入)
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static void setDirectory(const QString& dir);
+    static QString directory();
+
+    // 由拟合输入与结果组装记录
+    static FitReplayRecord makeRecord(int modelType, const QList<FitParameter>& params, double weight, bool highPrecision,
+                                      const QVector<double>& fitT, const QVector<double>& fitP, const QVector<double>& fitD,
+                                      const FittingResult& result, const QString& source = QString());
+
+    /**
+     * @brief 写入日志目录，文件名按时间与模型自动生成
+     * @return 成功时返回文件路径，失败返回空串
+     */
+    static QString writeToDirectory(const FitReplayRecord& record, QString* errorMessage = nullptr);
+
+    // 二进制读写 (QDataStream + qCompress)
+    static bool write(const QString& filePath, const FitReplayRecord& record, QString* errorMessage = nullptr);
+    static bool read(const QString& filePath, FitReplayRecord& record, QString* errorMessage = nullptr);
+
+    // 以同样的输入重新拟合后，与记录比对
+    static FitReplayComparison compare(const FitReplayRecord& record, const FittingResult& replay, double tolerance);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+#endif // FITREPLAYLOG_H
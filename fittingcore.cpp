@@ -0,0 +1,882 @@
+/*
+ * 文件名: fittingcore.cpp
+ * 文件作用: 试井拟合算法核心类实现文件
+ * 功能描述:
+ * 1. 实现 Levenberg-Marquardt 非线性最小二乘拟合 (对数空间参数更新 + 边界截断)。
+ * 2. 实现残差向量、中心差分雅可比矩阵、法方程求解 (Eigen LDLT)。
+ * 3. 实现默认对数均匀抽样和自定义区间抽样。
+ * 4. 算法逻辑与原 FittingWidget 内部实现保持一致，仅将界面交互改为回调。
+ * 5. 统计每次迭代的模型调用次数与耗时，并向 PerfCounters 上报残差/雅可比/求解阶段计数。
+ * 6. 为每次 LM 迭代和每个雅可比列记录时间线区间 (TraceRecorder)。
+ * 7. [新增] 设置批量曲线回调时，雅可比矩阵的 2 × 参数个数 条扰动曲线合并为一次批量计算；
+ *    批量结果数量不符时退回逐列计算。
+ * 8. [修改] LM 拟合只构造一次残差核 (FittingResidualKernel)，残差、试探步与雅可比各列复用缓冲区，
+ *    SSE 随残差一并算出；公开的 calculateResiduals / computeJacobian 每次调用临时构造残差核。
+ * 9. [新增] getLogSampledData 的自适应模式委托给 AdaptiveSampler。
+ * 10. [新增] 迭代坐标 (StepCoordinate)：截断模式沿用 log10/线性更新后截断；变换模式在 logit 空间更新，
+ *     雅可比列按链式法则换算。狗腿法与测地加速 LM 共用同一套线性化，拒绝步不重新计算雅可比。
+ * 11. [新增] 热启动：输入兼容时首次线性化复用保存的雅可比列；结束时雅可比若停留在上一线性化点，
+ *     以 Broyden 秩一更新移到最终参数后写入 finalState。
+ * 12. [新增] LM 拟合期间在当前线程挂接 PerfAccumulator，结束时写入 FittingResult::perf。
+ * 13. [修复] 测地加速度的探测点不经截断：越过上下限或被物理约束修正时该次迭代不加速。
+ */
+
+#include "fittingcore.h"
+#include "perfcounters.h"
+#include "tracerecorder.h"
+#include "fittingsampler.h"
+
+#include <QElapsedTimer>
+#include <Eigen/Dense>
+#include <cmath>
+#include <algorithm>
+
+FittingCore::FittingCore(ModelEvaluator evaluator)
+    : m_evaluator(evaluator)
+{
+}
+
+/**
+ * @brief 物理约束修正
+ * * 内区渗透率 kf 必须大于外区 km，内区储容比 omega1 必须大于外区 omega2；
+ * * 同时根据 Lf 与 L 重新计算无因次缝长 LfD。
+ */
+void FittingCore::applyParamConstraints(QMap<QString, double>& params)
+{
+    if(params.contains("kf") && params.contains("km")) {
+        if(params["kf"] <= params["km"]) params["kf"] = params["km"] * 1.01;
+    }
+    if(params.contains("omega1") && params.contains("omega2")) {
+        if(params["omega1"] <= params["omega2"]) params["omega1"] = params["omega2"] * 1.01;
+    }
+    if(params.contains("L") && params.contains("Lf") && params["L"] > 1e-9)
+        params["LfD"] = params["Lf"] / params["L"];
+}
+
+namespace {
+
+const double kLogitEps = 1e-6;          // logit 变换中归一化位置的夹取范围，避免端点处导数为零
+const double kDoglegInitialRadius = 1.0; // 初始信赖域半径下限 (对数参数约为一个数量级)，初值取首个高斯-牛顿步长
+const double kDoglegMaxRadius = 100.0;
+const double kGeodesicProbe = 0.1;      // 测地加速度有限差分步长 (相对速度步)
+const double kGeodesicAlpha = 0.75;     // 加速度与速度之比的上限 (2|a|/|v|)，超过则拒绝
+const double kStepTolerance = 1e-10;    // 狗腿法/测地加速：迭代步各分量均小于该值视为收敛
+const double kWarmStartTolerance = 1e-3; // 热启动：参数与线性化点的差分坐标偏差上限 (覆盖参数表 5 位有效数字的舍入)
+
+// 单个拟合参数的迭代坐标：x 为迭代变量，迭代步 delta 作用于 x
+struct StepCoordinate {
+    QString name;
+    double value = 0.0;         // 当前参数值
+    double min = 0.0, max = 0.0;
+    bool jacobianLog = false;   // computeJacobian 的差分坐标为 log10(value)
+    bool transformed = false;   // logit 变换 (否则 x 即差分坐标，更新后截断)
+    bool logScale = false;      // logit 变换前先取 log10
+    double lo = 0.0, hi = 0.0;  // 变换区间 (logScale 时为 log10 上下限)
+    double x = 0.0;             // 当前迭代变量 (仅变换模式使用)
+    double columnScale = 1.0;   // 雅可比列换算因子：d(差分坐标)/dx
+
+    // 由迭代步得到参数值；被截断时 clamped 置为 true
+    double valueAt(double delta, bool& clamped) const
+    {
+        double newVal;
+        if (transformed) {
+            double s = 1.0 / (1.0 + std::exp(-(x + delta)));
+            double u = lo + (hi - lo) * s;
+            newVal = logScale ? pow(10.0, u) : u;
+        } else if (jacobianLog) {
+            newVal = pow(10.0, log10(value) + delta);
+        } else {
+            newVal = value + delta;
+        }
+        double bounded = qMax(min, qMin(newVal, max));
+        clamped = !transformed && bounded != newVal;
+        return bounded;
+    }
+};
+
+StepCoordinate makeCoordinate(const FitParameter& fp, double value, FittingCore::BoundHandling handling)
+{
+    StepCoordinate c;
+    c.name = fp.name;
+    c.value = value;
+    c.min = fp.min;
+    c.max = fp.max;
+    c.jacobianLog = (value > 1e-12 && fp.name != "S" && fp.name != "nf");
+
+    if (handling != FittingCore::Bound_Transform || !std::isfinite(fp.min) || !std::isfinite(fp.max) || !(fp.max > fp.min))
+        return c;
+
+    c.transformed = true;
+    c.logScale = c.jacobianLog && fp.min > 0.0;
+    c.lo = c.logScale ? log10(fp.min) : fp.min;
+    c.hi = c.logScale ? log10(fp.max) : fp.max;
+    double u = c.logScale ? log10(value) : value;
+    double s = std::min(1.0 - kLogitEps, std::max(kLogitEps, (u - c.lo) / (c.hi - c.lo)));
+    c.x = std::log(s / (1.0 - s));
+
+    // du/dx = (hi - lo)·s·(1 - s)；差分坐标为 log10(value) 而变换为线性时再乘 d(log10 v)/dv
+    c.columnScale = (c.hi - c.lo) * s * (1.0 - s);
+    if (c.jacobianLog && !c.logScale) c.columnScale /= (value * std::log(10.0));
+    return c;
+}
+
+double dot(const QVector<double>& a, const QVector<double>& b)
+{
+    double s = 0.0;
+    for (int i = 0; i < a.size(); ++i) s += a[i] * b[i];
+    return s;
+}
+
+QVector<double> multiply(const QVector<QVector<double>>& A, const QVector<double>& v)
+{
+    QVector<double> out(A.size(), 0.0);
+    for (int i = 0; i < A.size(); ++i)
+        for (int j = 0; j < v.size(); ++j) out[i] += A[i][j] * v[j];
+    return out;
+}
+
+// Powell 狗腿步：gn 为高斯-牛顿步，sd 为柯西点 (模型沿负梯度的极小点)，g 为梯度
+QVector<double> doglegStep(const QVector<double>& gn, const QVector<double>& sd, const QVector<double>& g, double radius)
+{
+    if (std::sqrt(dot(gn, gn)) <= radius) return gn;
+
+    const int n = g.size();
+    double sdNorm = std::sqrt(dot(sd, sd));
+    QVector<double> step(n);
+    if (sdNorm >= radius) {
+        double gNorm = std::sqrt(dot(g, g));
+        for (int i = 0; i < n; ++i) step[i] = gNorm > 0.0 ? -radius * g[i] / gNorm : 0.0;
+        return step;
+    }
+
+    // 在 sd → gn 的折线上取与信赖域边界的交点
+    QVector<double> d(n);
+    for (int i = 0; i < n; ++i) d[i] = gn[i] - sd[i];
+    double a = dot(d, d);
+    double b = 2.0 * dot(sd, d);
+    double c = sdNorm * sdNorm - radius * radius;
+    double beta = a > 0.0 ? (-b + std::sqrt(std::max(0.0, b * b - 4.0 * a * c))) / (2.0 * a) : 0.0;
+    for (int i = 0; i < n; ++i) step[i] = sd[i] + beta * d[i];
+    return step;
+}
+
+// 热启动状态是否适用于本次拟合：输入摘要与残差长度相同，全部参数 (LfD 除外) 与线性化点一致
+bool warmStartMatches(const FitWarmStart& state, const QString& dataKey, int nRes, const QMap<QString, double>& params)
+{
+    if (!state.isValid() || state.dataKey != dataKey || state.residualCount != nRes) return false;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        if (it.key() == "LfD") continue;
+        if (!state.params.contains(it.key())) return false;
+        double a = it.value();
+        double b = state.params.value(it.key());
+        bool logScale = a > 1e-12 && b > 1e-12;
+        double diff = logScale ? std::abs(log10(a) - log10(b)) : std::abs(a - b) / std::max(1.0, std::abs(b));
+        if (!(diff <= kWarmStartTolerance)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+QString FittingCore::stepStrategyName(int strategy)
+{
+    switch (strategy) {
+    case Step_Dogleg: return "狗腿信赖域";
+    case Step_GeodesicLM: return "测地加速 LM";
+    default: return "阻尼 LM";
+    }
+}
+
+QString FittingCore::boundHandlingName(int handling)
+{
+    return handling == Bound_Transform ? "log/logit 变换" : "截断";
+}
+
+/**
+ * @brief Levenberg-Marquardt 拟合算法核心实现
+ * * 参数为正且非 S/nf 时在 log10 空间更新；截断模式更新后截断到 [min, max]，
+ *   变换模式在 logit 空间更新 (对数参数先取 log10)，参数值不会越界，也不会停滞在边界上。
+ * * 阻尼 LM：每次迭代最多尝试 5 次阻尼调节，接受则 lambda/10，拒绝则 lambda*10。
+ * * 狗腿法：lambda 位置记录信赖域半径，按实际/预测下降比调整半径，拒绝时只重新组合步长，不重新求解。
+ * * 测地加速 LM：每次试探多计算一条曲线估计二阶方向导数，加速度过大时拒绝；阻尼按 ×2 / ÷3 调节。
+ * * 未接受任何步时参数不变，下一次迭代复用雅可比矩阵、Hessian 近似与梯度。
+ * * 热启动：首次线性化复用保存的雅可比列与阻尼系数；该线性化下没有被接受的步时改为重新计算雅可比。
+ */
+FittingResult FittingCore::runLevenbergMarquardt(ModelType modelType, const QList<FitParameter>& params, double weight,
+                                                 const QVector<double>& fitT, const QVector<double>& fitP, const QVector<double>& fitD)
+{
+    FittingResult result;
+    result.stepStrategy = m_stepStrategy;
+    result.boundHandling = m_boundHandling;
+
+    // 本次拟合的性能计数：模型回调与批量求值的线程池任务均挂接到该累加器
+    PerfAccumulator perf;
+    PerfAccumulatorScope perfScope(&perf);
+
+    QVector<int> fitIndices;
+    for(int i=0; i<params.size(); ++i) {
+        if(params[i].isFit && params[i].name != "LfD") fitIndices.append(i);
+    }
+    int nParams = fitIndices.size();
+
+    QMap<QString, double> currentParamMap;
+    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
+
+    if(nParams == 0) {
+        result.errorMessage = "未选择拟合参数";
+        result.params = currentParamMap;
+        return result;
+    }
+
+    const bool dogleg = (m_stepStrategy == Step_Dogleg);
+    const bool geodesic = (m_stepStrategy == Step_GeodesicLM);
+    double lambda = dogleg ? kDoglegInitialRadius : 0.01;
+    int maxIter = m_maxIterations;
+
+    QElapsedTimer fitTimer;
+    fitTimer.start();
+    m_residualEvalCount = 0;
+
+    // [约束] 初始参数物理约束修正 (内区 > 外区) 及关联参数计算
+    applyParamConstraints(currentParamMap);
+
+    // 残差核：观测值对数、有效性与权重在整个拟合中只计算一次
+    const FittingResidualKernel kernel(weight, fitP, fitD, m_pointWeights);
+
+    // 计算初始残差
+    QVector<double> residuals;
+    double currentSSE = evaluateResiduals(kernel, currentParamMap, modelType, fitT, residuals);
+    QVector<double> newRes; // 试探步残差缓冲区 (接受时与 residuals 交换)
+    QVector<double> probeRes; // 测地加速度探测残差
+
+    // 热启动：输入兼容时记录各拟合参数在保存的雅可比中的列号
+    const QString dataKey = FitWarmStart::makeDataKey(modelType, weight, fitT, fitP, fitD, m_pointWeights);
+    const bool warmCompatible = warmStartMatches(m_warmStart, dataKey, residuals.size(), currentParamMap);
+    QVector<int> warmColumn(nParams, -1);
+    if (warmCompatible) {
+        for(int i=0; i<nParams; ++i) warmColumn[i] = m_warmStart.names.indexOf(params[fitIndices[i]].name);
+        if (m_warmStart.stepStrategy == m_stepStrategy && m_warmStart.lambda > 0.0)
+            lambda = dogleg ? std::min(kDoglegMaxRadius, std::max(1e-6, m_warmStart.lambda))
+                            : std::min(1.0, std::max(1e-7, m_warmStart.lambda));
+    }
+    const bool warmLambda = warmCompatible && m_warmStart.stepStrategy == m_stepStrategy && m_warmStart.lambda > 0.0;
+    result.warmStarted = warmCompatible;
+
+    QElapsedTimer callbackTimer;
+    if(m_iterationCallback && !residuals.isEmpty()) {
+        callbackTimer.start();
+        m_iterationCallback(currentSSE/residuals.size(), currentParamMap);
+        result.callbackMs += callbackTimer.nsecsElapsed() / 1e6;
+    }
+
+    // 当前参数处的线性化 (参数变化后才重新计算)
+    bool needJacobian = true;
+    QVector<StepCoordinate> coords(nParams);
+    QVector<QVector<double>> J;
+    QVector<QVector<double>> Jnat; // 差分坐标下的雅可比 (未按变换换算)，用于保存热启动状态
+    bool warmLinearization = false;
+    QVector<QVector<double>> H;
+    QVector<double> g;
+    QVector<double> gnStep, sdStep; // 狗腿法的高斯-牛顿步与柯西点
+
+    // 按迭代步生成试探参数，返回被截断的参数个数
+    auto makeTrial = [&](const QVector<double>& delta, QMap<QString, double>& trialMap) {
+        trialMap = currentParamMap;
+        int clampedCount = 0;
+        for(int i=0; i<nParams; ++i) {
+            bool clamped = false;
+            trialMap[coords[i].name] = coords[i].valueAt(delta[i], clamped);
+            if (clamped) clampedCount++;
+        }
+        // [约束] 试探步的物理约束修正
+        applyParamConstraints(trialMap);
+        return clampedCount;
+    };
+
+    int iter = 0;
+    for(; iter < maxIter; ++iter) {
+        if(m_stopChecker && m_stopChecker()) break;
+        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < m_targetMse) break; // 精度满足则退出
+
+        if(m_progressCallback) m_progressCallback(iter * 100 / maxIter);
+
+        PerfCounters::add(PerfCounters::LmIterations);
+        TraceSpan iterSpan("FittingCore::LM iteration", "fit", iter + 1);
+        QElapsedTimer iterTimer;
+        iterTimer.start();
+        LmIterationStats stats;
+        stats.iteration = iter + 1;
+        int evalsBefore = m_residualEvalCount;
+        int nRes = residuals.size();
+
+        if (needJacobian) {
+            for(int i=0; i<nParams; ++i) {
+                const FitParameter& fp = params[fitIndices[i]];
+                coords[i] = makeCoordinate(fp, currentParamMap[fp.name], m_boundHandling);
+            }
+
+            // 计算雅可比矩阵 (变换模式下换算到迭代变量)；热启动首次只计算保存状态中没有的列
+            if (iter == 0 && warmCompatible) {
+                J = QVector<QVector<double>>(nRes, QVector<double>(nParams, 0.0));
+                QVector<int> missingIndices, missingColumns;
+                for(int i=0; i<nParams; ++i) {
+                    int col = warmColumn[i];
+                    if (col >= 0 && m_warmStart.logColumn[col] == coords[i].jacobianLog) {
+                        for(int k=0; k<nRes; ++k) J[k][i] = m_warmStart.entry(k, col);
+                        result.warmStartColumns++;
+                    } else {
+                        missingIndices.append(fitIndices[i]);
+                        missingColumns.append(i);
+                    }
+                }
+                if (!missingIndices.isEmpty()) {
+                    QVector<QVector<double>> Jm = computeJacobian(kernel, currentParamMap, nRes, missingIndices, modelType, params, fitT);
+                    stats.jacobianEvaluations++;
+                    for(int m=0; m<missingColumns.size(); ++m)
+                        for(int k=0; k<nRes; ++k) J[k][missingColumns[m]] = Jm[k][m];
+                }
+                warmLinearization = true;
+            } else {
+                J = computeJacobian(kernel, currentParamMap, nRes, fitIndices, modelType, params, fitT);
+                stats.jacobianEvaluations++;
+                warmLinearization = false;
+            }
+            Jnat = J;
+            for(int i=0; i<nParams; ++i) {
+                if (!coords[i].transformed) continue;
+                for(int k=0; k<nRes; ++k) J[k][i] *= coords[i].columnScale;
+            }
+
+            // 计算 Hessian 近似矩阵和梯度向量
+            H = QVector<QVector<double>>(nParams, QVector<double>(nParams, 0.0));
+            g = QVector<double>(nParams, 0.0);
+
+            for(int k=0; k<nRes; ++k) {
+                for(int i=0; i<nParams; ++i) {
+                    g[i] += J[k][i] * residuals[k];
+                    for(int j=0; j<=i; ++j) {
+                        H[i][j] += J[k][i] * J[k][j];
+                    }
+                }
+            }
+            for(int i=0; i<nParams; ++i) {
+                for(int j=i+1; j<nParams; ++j) {
+                    H[i][j] = H[j][i];
+                }
+            }
+
+            if (dogleg) {
+                // 高斯-牛顿步 (加极小正则避免奇异) 与柯西点
+                QVector<QVector<double>> H_reg = H;
+                QVector<double> negG(nParams);
+                for(int i=0; i<nParams; ++i) {
+                    H_reg[i][i] += 1e-10 * (1.0 + std::abs(H[i][i]));
+                    negG[i] = -g[i];
+                }
+                gnStep = solveLinearSystem(H_reg, negG);
+                double gHg = dot(g, multiply(H, g));
+                double alpha = gHg > 0.0 ? dot(g, g) / gHg : 0.0;
+                sdStep = QVector<double>(nParams);
+                for(int i=0; i<nParams; ++i) sdStep[i] = -alpha * g[i];
+                if (iter == 0 && !warmLambda)
+                    lambda = std::min(kDoglegMaxRadius, std::max(kDoglegInitialRadius, std::sqrt(dot(gnStep, gnStep))));
+            }
+            needJacobian = false;
+        }
+
+        bool stepAccepted = false;
+        bool converged = false;
+        // 阻尼 (或信赖域半径) 调节循环
+        for(int tryIter=0; tryIter<5; ++tryIter) {
+            QVector<double> delta;
+            if (dogleg) {
+                // 高斯-牛顿步已可忽略时收敛，不再为缩小信赖域反复试探
+                double gnMax = 0.0;
+                for(double v : gnStep) gnMax = std::max(gnMax, std::abs(v));
+                if (gnMax < kStepTolerance) { converged = true; break; }
+                delta = doglegStep(gnStep, sdStep, g, lambda);
+            } else {
+                QVector<QVector<double>> H_lm = H;
+                for(int i=0; i<nParams; ++i) {
+                    H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
+                }
+
+                QVector<double> negG(nParams);
+                for(int i=0;i<nParams;++i) negG[i] = -g[i];
+
+                delta = solveLinearSystem(H_lm, negG);
+
+                if (geodesic) {
+                    double vMax = 0.0;
+                    for(double v : delta) vMax = std::max(vMax, std::abs(v));
+                    if (vMax < kStepTolerance) { converged = true; break; }
+
+                    // 二阶方向导数 r'' ≈ 2/h·[(r(x + h·v) - r(x))/h - J·v]，加速度 a = -(H + λD)⁻¹·Jᵀr''
+                    // 探测点须严格位于 x + h·v：越过上下限 (被截断) 或被物理约束修正时差分失真，本次不加速
+                    QMap<QString, double> probeMap = currentParamMap;
+                    bool probeExact = true;
+                    for(int i=0; i<nParams; ++i) {
+                        bool clamped = false;
+                        probeMap[coords[i].name] = coords[i].valueAt(kGeodesicProbe * delta[i], clamped);
+                        if (clamped) probeExact = false;
+                    }
+                    if (probeExact) {
+                        QMap<QString, double> constrained = probeMap;
+                        applyParamConstraints(constrained);
+                        for(int i=0; i<nParams; ++i) {
+                            if (constrained.value(coords[i].name) != probeMap.value(coords[i].name)) probeExact = false;
+                        }
+                        probeMap = constrained;
+                    }
+                    if (probeExact) evaluateResiduals(kernel, probeMap, modelType, fitT, probeRes);
+                    if (probeExact && probeRes.size() == nRes) {
+                        QVector<double> Jv = multiply(J, delta);
+                        QVector<double> b(nParams, 0.0);
+                        for(int k=0; k<nRes; ++k) {
+                            double rpp = 2.0 / kGeodesicProbe * ((probeRes[k] - residuals[k]) / kGeodesicProbe - Jv[k]);
+                            for(int i=0; i<nParams; ++i) b[i] -= J[k][i] * rpp;
+                        }
+                        QVector<double> acc = solveLinearSystem(H_lm, b);
+                        double vNorm = std::sqrt(dot(delta, delta));
+                        if (vNorm > 0.0 && 2.0 * std::sqrt(dot(acc, acc)) / vNorm > kGeodesicAlpha) {
+                            lambda *= 2.0;
+                            stats.rejectedSteps++;
+                            continue;
+                        }
+                        for(int i=0; i<nParams; ++i) delta[i] += 0.5 * acc[i];
+                    }
+                }
+            }
+
+            QMap<QString, double> trialMap;
+            int clampedCount = makeTrial(delta, trialMap);
+
+            // 评估新位置
+            double newSSE = evaluateResiduals(kernel, trialMap, modelType, fitT, newRes);
+
+            // 狗腿法：按实际下降与二次模型预测下降之比判断并调整信赖域
+            double rho = 1.0;
+            double stepNorm = 0.0;
+            if (dogleg) {
+                stepNorm = std::sqrt(dot(delta, delta));
+                double predicted = -2.0 * dot(g, delta) - dot(delta, multiply(H, delta));
+                rho = predicted > 0.0 ? (currentSSE - newSSE) / predicted : -1.0;
+            }
+
+            if(newSSE < currentSSE && (!dogleg || rho > 1e-4)) {
+                currentSSE = newSSE;
+                currentParamMap = trialMap;
+                residuals.swap(newRes);
+                if (dogleg) {
+                    if (rho < 0.25) lambda = 0.25 * stepNorm;
+                    else if (rho > 0.75 && stepNorm > 0.99 * lambda) lambda = std::min(2.0 * lambda, kDoglegMaxRadius);
+                } else {
+                    lambda /= geodesic ? 3.0 : 10.0;
+                }
+                stepAccepted = true;
+                needJacobian = true;
+                result.boundHits += clampedCount;
+
+                LmAcceptedStep step;
+                step.iteration = iter + 1;
+                step.lambda = lambda;
+                step.sse = currentSSE;
+                step.params = currentParamMap;
+                result.trajectory.append(step);
+
+                if(m_iterationCallback) {
+                    callbackTimer.start();
+                    m_iterationCallback(currentSSE/nRes, currentParamMap);
+                    result.callbackMs += callbackTimer.nsecsElapsed() / 1e6;
+                }
+                break;
+            } else {
+                if (dogleg) lambda = 0.25 * std::min(lambda, stepNorm);
+                else lambda *= geodesic ? 2.0 : 10.0;
+                stats.rejectedSteps++;
+            }
+        }
+
+        // 保存的雅可比只是近似：在其线性化下没有被接受的步时，下一次迭代改用实际计算的雅可比
+        if (!stepAccepted && warmLinearization) {
+            needJacobian = true;
+            converged = false;
+        }
+
+        stats.residualEvaluations = m_residualEvalCount - evalsBefore;
+        stats.lambda = lambda;
+        stats.mse = nRes > 0 ? currentSSE / nRes : 0.0;
+        stats.elapsedMs = iterTimer.nsecsElapsed() / 1e6;
+        result.iterationStats.append(stats);
+        result.jacobianEvaluations += stats.jacobianEvaluations;
+        result.rejectedSteps += stats.rejectedSteps;
+
+        if(converged || (!stepAccepted && (dogleg ? lambda < 1e-8 : lambda > 1e10))) break;
+    }
+
+    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
+        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+
+    // 结束时的优化器状态
+    const int nRes = residuals.size();
+    if (!Jnat.isEmpty() && Jnat.size() == nRes) {
+        // 最后一步被接受后没有再线性化：以 Broyden 秩一更新把雅可比移到最终参数
+        // J += (Δr - J·s)·sᵀ / (sᵀs)，s 为差分坐标下的参数变化，Δr 为残差变化 (newRes 为接受前的残差)
+        if (needJacobian && newRes.size() == nRes) {
+            QVector<double> s(nParams, 0.0);
+            bool valid = true;
+            for(int i=0; i<nParams; ++i) {
+                double v = currentParamMap.value(coords[i].name);
+                if (coords[i].jacobianLog) {
+                    valid = valid && v > 1e-12;
+                    if (valid) s[i] = log10(v) - log10(coords[i].value);
+                } else {
+                    s[i] = v - coords[i].value;
+                }
+            }
+            double ss = dot(s, s);
+            if (valid && ss > 0.0) {
+                QVector<double> Js = multiply(Jnat, s);
+                for(int k=0; k<nRes; ++k) {
+                    double coef = (residuals[k] - newRes[k] - Js[k]) / ss;
+                    for(int i=0; i<nParams; ++i) Jnat[k][i] += coef * s[i];
+                }
+            }
+        }
+
+        FitWarmStart& state = result.finalState;
+        state.dataKey = dataKey;
+        state.stepStrategy = m_stepStrategy;
+        state.lambda = result.trajectory.isEmpty() ? (warmLambda ? m_warmStart.lambda : 0.0) : result.trajectory.last().lambda;
+        state.params = currentParamMap;
+        state.residualCount = nRes;
+        state.jacobian.reserve(nRes * nParams);
+        for(int i=0; i<nParams; ++i) {
+            state.names.append(coords[i].name);
+            state.logColumn.append(coords[i].jacobianLog);
+        }
+        for(int k=0; k<nRes; ++k)
+            for(int i=0; i<nParams; ++i) state.jacobian.append(Jnat[k][i]);
+    } else if (warmCompatible) {
+        // 没有任何迭代 (如初始误差已满足要求)：参数未变，沿用输入的状态
+        result.finalState = m_warmStart;
+    }
+
+    result.success = true;
+    result.params = currentParamMap;
+    result.sse = currentSSE;
+    result.residualCount = residuals.size();
+    result.mse = residuals.isEmpty() ? 0.0 : currentSSE / residuals.size();
+    result.iterations = iter;
+    result.residualEvaluations = m_residualEvalCount;
+    result.elapsedMs = fitTimer.nsecsElapsed() / 1e6;
+    result.perf = perf.snapshot();
+    return result;
+}
+
+/**
+ * @brief 计算残差向量
+ * * 计算理论值与抽样观测值在对数空间的差异。
+ * * 考虑了压差和导数的权重。
+ */
+QVector<double> FittingCore::calculateResiduals(const QMap<QString, double>& params, ModelType modelType, double weight,
+                                                const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD)
+{
+    if(!m_evaluator || t.isEmpty()) return QVector<double>();
+
+    QVector<double> r;
+    evaluateResiduals(FittingResidualKernel(weight, obsP, obsD, m_pointWeights), params, modelType, t, r);
+    return r;
+}
+
+double FittingCore::evaluateResiduals(const FittingResidualKernel& kernel, const QMap<QString, double>& params,
+                                      ModelType modelType, const QVector<double>& t, QVector<double>& out)
+{
+    if(!m_evaluator || t.isEmpty()) { out.clear(); return 0.0; }
+
+    PerfStageTimer perfTimer(PerfCounters::Stage_Residual);
+    PerfCounters::add(PerfCounters::ResidualEvaluations);
+    m_residualEvalCount++;
+
+    return kernel.evaluate(m_evaluator(modelType, params, t), out);
+}
+
+/**
+ * @brief 计算雅可比矩阵
+ * * 使用有限差分法计算每个拟合参数对残差的偏导数。
+ */
+QVector<QVector<double>> FittingCore::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals,
+                                                      const QVector<int>& fitIndices, ModelType modelType,
+                                                      const QList<FitParameter>& currentFitParams, double weight,
+                                                      const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD)
+{
+    return computeJacobian(FittingResidualKernel(weight, obsP, obsD, m_pointWeights), params, baseResiduals.size(),
+                           fitIndices, modelType, currentFitParams, t);
+}
+
+QVector<QVector<double>> FittingCore::computeJacobian(const FittingResidualKernel& kernel, const QMap<QString, double>& params,
+                                                      int nRes, const QVector<int>& fitIndices, ModelType modelType,
+                                                      const QList<FitParameter>& currentFitParams, const QVector<double>& t)
+{
+    PerfStageTimer perfTimer(PerfCounters::Stage_Jacobian);
+    PerfCounters::add(PerfCounters::JacobianEvaluations);
+
+    int nParams = fitIndices.size();
+    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+
+    // 先生成全部扰动参数组：perturbed[2j] 为 +h，perturbed[2j+1] 为 -h
+    QVector<QMap<QString, double>> perturbed;
+    QVector<double> steps(nParams);
+    perturbed.reserve(2 * nParams);
+
+    for(int j = 0; j < nParams; ++j) {
+        int idx = fitIndices[j];
+        QString pName = currentFitParams[idx].name;
+        double val = params.value(pName);
+        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
+
+        double h;
+        QMap<QString, double> pPlus = params;
+        QMap<QString, double> pMinus = params;
+
+        if(isLog) {
+            h = 0.01;
+            double valLog = log10(val);
+            pPlus[pName] = pow(10.0, valLog + h);
+            pMinus[pName] = pow(10.0, valLog - h);
+        } else {
+            h = 1e-4;
+            pPlus[pName] = val + h;
+            pMinus[pName] = val - h;
+        }
+
+        auto updateDeps = [](QMap<QString,double>& map) {
+            if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9)
+                map["LfD"] = map["Lf"] / map["L"];
+        };
+
+        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
+
+        steps[j] = h;
+        perturbed.append(pPlus);
+        perturbed.append(pMinus);
+    }
+
+    auto fillColumn = [&](int j, const QVector<double>& rPlus, const QVector<double>& rMinus) {
+        if(rPlus.size() == nRes && rMinus.size() == nRes) {
+            for(int i=0; i<nRes; ++i) {
+                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * steps[j]);
+            }
+        }
+    };
+
+    QVector<double> rPlus, rMinus; // 各列复用的残差缓冲区
+
+    // 批量路径：全部扰动曲线一次计算
+    if (m_batchEvaluator && !t.isEmpty() && nParams > 0) {
+        TraceSpan batchSpan("FittingCore::computeJacobian batch", "fit", perturbed.size());
+        QVector<ModelCurveData> curves;
+        {
+            PerfStageTimer residualTimer(PerfCounters::Stage_Residual);
+            curves = m_batchEvaluator(modelType, perturbed, t);
+        }
+        if (curves.size() == perturbed.size()) {
+            PerfCounters::add(PerfCounters::ResidualEvaluations, perturbed.size());
+            m_residualEvalCount += perturbed.size();
+            for(int j = 0; j < nParams; ++j) {
+                kernel.evaluate(curves[2 * j], rPlus);
+                kernel.evaluate(curves[2 * j + 1], rMinus);
+                fillColumn(j, rPlus, rMinus);
+            }
+            return J;
+        }
+    }
+
+    for(int j = 0; j < nParams; ++j) {
+        TraceSpan columnSpan("FittingCore::computeJacobian column", "fit", j);
+        evaluateResiduals(kernel, perturbed[2 * j], modelType, t, rPlus);
+        evaluateResiduals(kernel, perturbed[2 * j + 1], modelType, t, rMinus);
+        fillColumn(j, rPlus, rMinus);
+    }
+    return J;
+}
+
+/**
+ * @brief 求解线性方程组
+ * * 使用 Eigen 库求解 (H + lambda*I) * delta = -g。
+ */
+QVector<double> FittingCore::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b)
+{
+    int n = b.size();
+    if (n == 0) return QVector<double>();
+
+    PerfStageTimer perfTimer(PerfCounters::Stage_LinearSolve);
+    Eigen::MatrixXd matA(n, n);
+    Eigen::VectorXd vecB(n);
+
+    for (int i = 0; i < n; ++i) {
+        vecB(i) = b[i];
+        for (int j = 0; j < n; ++j) {
+            matA(i, j) = A[i][j];
+        }
+    }
+
+    Eigen::VectorXd x = matA.ldlt().solve(vecB);
+
+    QVector<double> res(n);
+    for (int i = 0; i < n; ++i) res[i] = x(i);
+    return res;
+}
+
+/**
+ * @brief 计算残差平方和 (SSE)
+ */
+double FittingCore::calculateSumSquaredError(const QVector<double>& residuals)
+{
+    double sse = 0.0;
+    for(double v : residuals) sse += v*v;
+    return sse;
+}
+
+/**
+ * @brief 获取用于拟合计算的抽样数据
+ * * 默认策略：数据量>200时，在对数空间均匀抽取200个点。
+ * * 自定义策略：在用户指定的每个区间内抽取指定数量的点。
+ * * 自适应策略 (未启用自定义且 adaptiveCount > 0)：按导数曲率与噪声分配 adaptiveCount 个点。
+ */
+void FittingCore::getLogSampledData(const QVector<double>& srcT, const QVector<double>& srcP, const QVector<double>& srcD,
+                                    bool useCustom, const QList<SamplingInterval>& intervals,
+                                    QVector<double>& outT, QVector<double>& outP, QVector<double>& outD,
+                                    int adaptiveCount)
+{
+    outT.clear(); outP.clear(); outD.clear();
+    if (srcT.isEmpty()) return;
+
+    if (!useCustom && adaptiveCount > 0) {
+        AdaptiveSamplingOptions options;
+        options.targetCount = adaptiveCount;
+        AdaptiveSampler::sample(srcT, srcP, srcD, options, outT, outP, outD);
+        return;
+    }
+
+    PerfStageTimer perfTimer(PerfCounters::Stage_Sampling);
+
+    // 辅助结构体用于排序去重
+    struct DataPoint {
+        double t, p, d;
+        bool operator<(const DataPoint& other) const { return t < other.t; }
+        bool operator==(const DataPoint& other) const { return std::abs(t - other.t) < 1e-9; }
+    };
+    QVector<DataPoint> points;
+
+    // 模式1：默认策略
+    if (!useCustom) {
+        int targetCount = 200;
+        // 如果数据量很少，直接全量使用
+        if (srcT.size() <= targetCount) {
+            outT = srcT; outP = srcP; outD = srcD;
+            return;
+        }
+
+        // 对数空间均匀抽样
+        double tMin = srcT.first() <= 1e-10 ? 1e-4 : srcT.first();
+        double tMax = srcT.last();
+        double logMin = log10(tMin);
+        double logMax = log10(tMax);
+        double step = (logMax - logMin) / (targetCount - 1);
+
+        int currentIndex = 0;
+        for (int i = 0; i < targetCount; ++i) {
+            double targetT = pow(10, logMin + i * step);
+
+            // 查找最近点
+            double minDiff = 1e30;
+            int bestIdx = currentIndex;
+            while (currentIndex < srcT.size()) {
+                double diff = std::abs(srcT[currentIndex] - targetT);
+                if (diff < minDiff) { minDiff = diff; bestIdx = currentIndex; }
+                else break;
+                currentIndex++;
+            }
+            currentIndex = bestIdx;
+
+            points.append({srcT[bestIdx],
+                           (bestIdx<srcP.size()?srcP[bestIdx]:0.0),
+                           (bestIdx<srcD.size()?srcD[bestIdx]:0.0)});
+        }
+    }
+    // 模式2：自定义区间策略
+    else {
+        if (intervals.isEmpty()) {
+            outT = srcT; outP = srcP; outD = srcD;
+            return;
+        }
+
+        for (const auto& interval : intervals) {
+            double tStart = interval.tStart;
+            double tEnd = interval.tEnd;
+            int count = interval.count;
+
+            if (count <= 0) continue;
+
+            // 定位区间索引范围
+            auto itStart = std::lower_bound(srcT.begin(), srcT.end(), tStart);
+            auto itEnd = std::upper_bound(srcT.begin(), srcT.end(), tEnd);
+
+            int idxStart = std::distance(srcT.begin(), itStart);
+            int idxEnd = std::distance(srcT.begin(), itEnd);
+
+            if (idxStart >= srcT.size() || idxStart >= idxEnd) continue;
+
+            // 区间内对数抽样
+            double subMin = srcT[idxStart];
+            double subMax = srcT[idxEnd - 1];
+            if (subMin <= 1e-10) subMin = 1e-4;
+
+            double logMin = log10(subMin);
+            double logMax = log10(subMax);
+            double step = (count > 1) ? (logMax - logMin) / (count - 1) : 0;
+
+            int subCurrentIdx = idxStart;
+            for (int i = 0; i < count; ++i) {
+                double targetT = (count == 1) ? subMin : pow(10, logMin + i * step);
+
+                double minDiff = 1e30;
+                int bestIdx = subCurrentIdx;
+
+                while (subCurrentIdx < idxEnd) {
+                    double diff = std::abs(srcT[subCurrentIdx] - targetT);
+                    if (diff < minDiff) { minDiff = diff; bestIdx = subCurrentIdx; }
+                    else break;
+                    subCurrentIdx++;
+                }
+                subCurrentIdx = bestIdx;
+
+                if (bestIdx < srcT.size()) {
+                    points.append({srcT[bestIdx],
+                                   (bestIdx<srcP.size()?srcP[bestIdx]:0.0),
+                                   (bestIdx<srcD.size()?srcD[bestIdx]:0.0)});
+                }
+            }
+        }
+    }
+
+    // 整理：排序并去重
+    std::sort(points.begin(), points.end());
+    auto last = std::unique(points.begin(), points.end());
+    points.erase(last, points.end());
+
+    for (const auto& p : points) {
+        outT.append(p.t);
+        outP.append(p.p);
+        outD.append(p.d);
+    }
+}
+
+QVector<double> FittingCore::samplingPointWeights(const QVector<double>& sampledT, bool useCustom, int adaptiveCount,
+                                                  bool densityWeighting)
+{
+    const bool nonUniform = useCustom || adaptiveCount > 0;
+    if (!nonUniform || !densityWeighting) return QVector<double>();
+    return FittingResidualKernel::samplingDensityWeights(sampledT);
+}
@@ -0,0 +1,206 @@
+/*
+ * 文件名: fittingcore.h
+ * 文件作用: 试井拟合算法核心类头文件
+ * 功能描述:
+ * 1. 定义抽样区间结构体 SamplingInterval（原定义于 wt_fittingwidget.h）。
+ * 2. 声明 FittingCore 类，封装 Levenberg-Marquardt 拟合、残差与雅可比矩阵计算、数据抽样。
+ * 3. 不依赖任何 UI 控件，理论曲线通过 ModelEvaluator 回调获取，
+ *    可同时服务于拟合界面 (FittingWidget) 与基准测试程序 (benchmarks/)。
+ * 4. 记录每次 LM 迭代的残差/雅可比计算次数、拒绝步数与耗时 (LmIterationStats)，用于拟合报告的性能统计。
+ * 5. 记录被接受的迭代步参数轨迹 (LmAcceptedStep)，供拟合回放日志 (fitreplaylog.h) 做回归比对。
+ * 6. [新增] 可设置最大迭代次数与提前结束的 MSE 阈值 (参数不确定性分析的重复拟合需关闭提前结束)。
+ * 7. [新增] 可选的批量曲线回调 (BatchModelEvaluator)：设置后雅可比矩阵的全部 ± 扰动参数组一次提交计算。
+ * 8. [修改] 残差由 FittingResidualKernel 计算：LM 拟合开始时构造一次 (观测值对数、掩码、权重)，
+ *    迭代中残差与 SSE 一次向量化算出并写入复用的缓冲区；可设置逐点权重 (setPointWeights)。
+ * 9. [新增] 抽样可选信息密度自适应策略 (fittingsampler.h)：按导数曲率与噪声分配点数。
+ * 10. [新增] 可选迭代步策略 (阻尼 LM / Powell 狗腿信赖域 / 测地加速 LM) 与参数上下限处理方式
+ *     (截断 / log-logit 重参数化)；未接受任何步时参数不变，下一次迭代复用雅可比矩阵。
+ * 11. [新增] 热启动 (fittingwarmstart.h)：结果附带结束时的优化器状态，再次拟合时输入兼容则复用雅可比与阻尼系数。
+ * 12. [新增] samplingPointWeights：由抽样设置得到逐点权重，拟合、曲线缓存误差与拟合报告共用同一规则。
+ * 13. [新增] FittingResult::perf：本次拟合的性能计数，由挂接到拟合线程 (及其线程池任务) 的累加器统计。
+ */
+
+#ifndef FITTINGCORE_H
+#define FITTINGCORE_H
+
+#include <QMap>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <functional>
+#include <atomic>
+
+#include "modelsolver01-06.h"
+#include "fittingparameterchart.h"
+#include "fittingresidualkernel.h"
+#include "fittingwarmstart.h"
+#include "perfcounters.h"
+
+// 抽样区间结构体
+struct SamplingInterval {
+    double tStart; // 起始时间
+    double tEnd;   // 结束时间
+    int count;     // 该区间内的抽样点数
+};
+
+// LM 单次迭代统计
+struct LmIterationStats {
+    int iteration = 0;              // 迭代序号 (从 1 开始)
+    int residualEvaluations = 0;    // 本次迭代的残差计算次数 (含雅可比内部调用)
+    int jacobianEvaluations = 0;    // 本次迭代的雅可比矩阵计算次数
+    int rejectedSteps = 0;          // 被拒绝的试探步数
+    double lambda = 0.0;            // 迭代结束时的阻尼系数 (狗腿法为信赖域半径)
+    double mse = 0.0;               // 迭代结束时的均方误差
+    double elapsedMs = 0.0;         // 本次迭代耗时
+};
+
+// LM 被接受的迭代步 (参数轨迹)
+struct LmAcceptedStep {
+    int iteration = 0;              // 迭代序号 (从 1 开始)
+    double lambda = 0.0;            // 接受后的阻尼系数 (狗腿法为信赖域半径)
+    double sse = 0.0;               // 接受后的残差平方和
+    QMap<QString, double> params;   // 接受后的参数
+};
+
+// 拟合结果结构体
+struct FittingResult {
+    bool success = false;           // 是否成功执行
+    QString errorMessage;           // 错误信息
+    QMap<QString, double> params;   // 最终参数 (含 LfD)
+    double sse = 0.0;               // 残差平方和
+    double mse = 0.0;               // 均方误差
+    int iterations = 0;             // 实际迭代次数
+    int residualCount = 0;          // 残差向量长度
+    int residualEvaluations = 0;    // 总残差计算次数 (每次对应一条理论曲线)
+    int jacobianEvaluations = 0;    // 总雅可比矩阵计算次数
+    int rejectedSteps = 0;          // 总拒绝步数 (每次拒绝浪费一条理论曲线)
+    int boundHits = 0;              // 被接受的步中参数被截断到上下限的次数 (仅截断模式)
+    int stepStrategy = 0;           // 迭代步策略 (FittingCore::StepStrategy)
+    int boundHandling = 0;          // 上下限处理方式 (FittingCore::BoundHandling)
+    bool warmStarted = false;       // 是否由热启动状态开始
+    int warmStartColumns = 0;       // 热启动复用的雅可比列数
+    FitWarmStart finalState;        // 结束时的优化器状态 (供下一次拟合热启动)
+    double elapsedMs = 0.0;         // 拟合总耗时
+    double callbackMs = 0.0;        // 其中迭代回调 (界面刷新) 耗时
+    QVector<LmIterationStats> iterationStats; // 逐次迭代统计
+    QVector<LmAcceptedStep> trajectory;       // 被接受的迭代步
+    PerfSnapshot perf;              // 本次拟合的性能计数 (不含其他线程上的并发计算；计数器未启用时为空)
+};
+
+class FittingCore
+{
+public:
+    using ModelType = ModelSolver01_06::ModelType;
+
+    // 理论曲线计算回调：(模型类型, 参数, 时间序列) -> 曲线
+    using ModelEvaluator = std::function<ModelCurveData(ModelType, const QMap<QString, double>&, const QVector<double>&)>;
+    // 批量理论曲线回调：(模型类型, 多组参数, 时间序列) -> 与参数组一一对应的曲线
+    using BatchModelEvaluator = std::function<QVector<ModelCurveData>(ModelType, const QVector<QMap<QString, double>>&, const QVector<double>&)>;
+    // 迭代回调：(当前均方误差, 当前参数)，用于界面刷新
+    using IterationCallback = std::function<void(double, const QMap<QString, double>&)>;
+    // 进度回调：百分比
+    using ProgressCallback = std::function<void(int)>;
+    // 停止检查回调：返回 true 时中断迭代
+    using StopChecker = std::function<bool()>;
+
+    // 迭代步策略
+    enum StepStrategy {
+        Step_LevenbergMarquardt = 0,    // 阻尼 LM：拒绝则 lambda×10 重试 (默认，与旧版本一致)
+        Step_Dogleg = 1,                // Powell 狗腿法：高斯-牛顿步与最速下降步按信赖域半径组合
+        Step_GeodesicLM = 2             // 测地加速 LM：沿速度步的二阶方向导数修正步长
+    };
+    // 参数上下限处理方式
+    enum BoundHandling {
+        Bound_Clamp = 0,                // 更新后截断到 [min, max] (默认)
+        Bound_Transform = 1             // log/logit 重参数化：迭代变量无约束，参数值始终在上下限内
+    };
+    static QString stepStrategyName(int strategy);
+    static QString boundHandlingName(int handling);
+
+    explicit FittingCore(ModelEvaluator evaluator);
+
+    void setIterationCallback(IterationCallback cb) { m_iterationCallback = cb; }
+    void setProgressCallback(ProgressCallback cb) { m_progressCallback = cb; }
+    void setStopChecker(StopChecker checker) { m_stopChecker = checker; }
+    // 批量曲线回调 (可选)：未设置时雅可比矩阵逐列调用 ModelEvaluator
+    void setBatchEvaluator(BatchModelEvaluator evaluator) { m_batchEvaluator = evaluator; }
+    // 最大迭代次数 (默认 50)
+    void setMaxIterations(int count) { m_maxIterations = count; }
+    // MSE 低于该值时提前结束 (默认 3e-3，设为 0 则只在收敛或达到最大迭代次数时结束)
+    void setTargetMse(double mse) { m_targetMse = mse; }
+    // 逐点权重 (作用于残差平方，长度须与抽样点数相同；为空表示等权)，见 FittingResidualKernel::samplingDensityWeights
+    void setPointWeights(const QVector<double>& weights) { m_pointWeights = weights; }
+    // 迭代步策略与上下限处理方式 (默认阻尼 LM + 截断)
+    void setStepStrategy(StepStrategy strategy) { m_stepStrategy = strategy; }
+    void setBoundHandling(BoundHandling handling) { m_boundHandling = handling; }
+    // 热启动状态 (通常为上一次拟合的 FittingResult::finalState)；与本次输入不兼容时自动忽略
+    void setWarmStart(const FitWarmStart& state) { m_warmStart = state; }
+
+    /**
+     * @brief Levenberg-Marquardt 拟合主流程
+     * @param modelType 模型类型
+     * @param params 全部参数 (仅 isFit 且非 LfD 的参与拟合)
+     * @param weight 压差权重 (导数权重为 1-weight)
+     * @param fitT/fitP/fitD 抽样后的观测数据
+     */
+    FittingResult runLevenbergMarquardt(ModelType modelType, const QList<FitParameter>& params, double weight,
+                                        const QVector<double>& fitT, const QVector<double>& fitP, const QVector<double>& fitD);
+
+    // 计算残差向量 (对数空间，压差与导数加权)
+    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelType modelType, double weight,
+                                       const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD);
+
+    // 计算雅可比矩阵 (中心差分)
+    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals,
+                                             const QVector<int>& fitIndices, ModelType modelType,
+                                             const QList<FitParameter>& currentFitParams, double weight,
+                                             const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD);
+
+    // 静态工具函数
+    static QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
+    static double calculateSumSquaredError(const QVector<double>& residuals);
+
+    // 物理约束修正 (内区 > 外区) 及 LfD 关联计算
+    static void applyParamConstraints(QMap<QString, double>& params);
+
+    /**
+     * @brief 获取用于拟合计算的抽样数据
+     * @param useCustom 是否启用自定义区间抽样
+     * @param intervals 自定义区间列表
+     * @param adaptiveCount 未启用自定义区间时，大于 0 表示改用自适应抽样 (目标点数)，0 为默认对数均匀 200 点
+     */
+    static void getLogSampledData(const QVector<double>& srcT, const QVector<double>& srcP, const QVector<double>& srcD,
+                                  bool useCustom, const QList<SamplingInterval>& intervals,
+                                  QVector<double>& outT, QVector<double>& outP, QVector<double>& outD,
+                                  int adaptiveCount = 0);
+
+    /**
+     * @brief 抽样点的逐点残差权重 (与 getLogSampledData 的抽样设置配套)
+     * * 仅在自定义区间或自适应抽样且启用按密度加权时返回 FittingResidualKernel::samplingDensityWeights，否则为空 (等权)。
+     */
+    static QVector<double> samplingPointWeights(const QVector<double>& sampledT, bool useCustom, int adaptiveCount,
+                                                bool densityWeighting);
+
+private:
+    // 用已构造的残差核计算一条理论曲线的残差 (写入 out)，返回 SSE
+    double evaluateResiduals(const FittingResidualKernel& kernel, const QMap<QString, double>& params, ModelType modelType,
+                             const QVector<double>& t, QVector<double>& out);
+    QVector<QVector<double>> computeJacobian(const FittingResidualKernel& kernel, const QMap<QString, double>& params,
+                                             int nRes, const QVector<int>& fitIndices, ModelType modelType,
+                                             const QList<FitParameter>& currentFitParams, const QVector<double>& t);
+
+    ModelEvaluator m_evaluator;
+    BatchModelEvaluator m_batchEvaluator;
+    IterationCallback m_iterationCallback;
+    ProgressCallback m_progressCallback;
+    StopChecker m_stopChecker;
+    int m_maxIterations = 50;
+    double m_targetMse = 3e-3;
+    QVector<double> m_pointWeights;
+    StepStrategy m_stepStrategy = Step_LevenbergMarquardt;
+    BoundHandling m_boundHandling = Bound_Clamp;
+    FitWarmStart m_warmStart;
+    std::atomic<int> m_residualEvalCount{0}; // 残差计算次数 (线程安全)
+};
+
+#endif // FITTINGCORE_H
@@ -0,0 +1,319 @@
+/*
+ * 文件名: fittingjoint.cpp
+ * 文件作用: 多分析联合拟合算法实现文件
+ * 功能描述:
+ * 1. 每个分析一个块：私有求解器与 FittingCore，列顺序为“本分析出现的共享参数，本分析的独立参数”。
+ * 2. 法方程 [A B; Bᵀ D] 中 A 为共享参数块 (各分析累加)，D 为各分析独立参数块 (块对角)，
+ *    B 为两者的耦合块；按 S = A - Σ B D⁻¹ Bᵀ 求共享增量后逐块回代，从不组装整体稠密矩阵。
+ * 3. 共享参数在任一分析中勾选拟合即参与联合拟合，初值与上下限取第一个勾选它的分析；
+ *    某分析的模型不含该参数时，该分析的块不含对应列。
+ * 4. [修改] 各分析的残差按其输入的逐点权重加权。
+ */
+
+#include "fittingjoint.h"
+#include "perfcounters.h"
+#include "tracerecorder.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <Eigen/Dense>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+bool isLogParam(const QString& name, double value)
+{
+    return value > 1e-12 && name != "S" && name != "nf";
+}
+
+double stepValue(const QString& name, double oldVal, double delta, double lo, double hi)
+{
+    double v = isLogParam(name, oldVal) ? std::pow(10.0, std::log10(oldVal) + delta) : oldVal + delta;
+    return qMax(lo, qMin(v, hi));
+}
+
+// 单个分析的计算块
+struct Block {
+    const JointFitDataset* data = nullptr;
+    QVector<int> sharedCols;        // 本分析出现的共享参数在共享列表中的序号
+    QVector<int> fitIndices;        // 参数表下标：先共享参数，后独立参数
+    int localCount = 0;
+    std::unique_ptr<ModelSolver01_06> solver;
+    std::unique_ptr<FittingCore> core;
+    QMap<QString, double> params;   // 当前参数
+    QVector<double> residuals;      // 当前残差
+    double sse = 0.0;
+};
+
+} // namespace
+
+QStringList JointFitting::defaultLocalParams()
+{
+    return QStringList{"S", "cD", "Lf", "L", "nf", "rmD"};
+}
+
+JointFitResult JointFitting::run(const QVector<JointFitDataset>& datasets, const JointFitOptions& options,
+                                 const std::atomic<bool>* cancel, const ProgressCallback& progress)
+{
+    TraceSpan span("JointFitting::run", "fit", datasets.size());
+    QElapsedTimer timer;
+    timer.start();
+
+    JointFitResult result;
+    const int K = datasets.size();
+    if (K < 2) {
+        result.errorMessage = "联合拟合至少需要两个分析。";
+        return result;
+    }
+
+    // 1. 共享参数
+    QStringList sharedNames;
+    QVector<double> sharedValue, sharedMin, sharedMax;
+    for (const QString& name : options.sharedParams) {
+        if (name == "LfD" || sharedNames.contains(name)) continue;
+        bool found = false;
+        for (const JointFitDataset& ds : datasets) {
+            for (const FitParameter& p : ds.input.params) {
+                if (p.name == name && p.isFit) {
+                    sharedNames.append(name);
+                    sharedValue.append(p.value);
+                    sharedMin.append(p.min);
+                    sharedMax.append(p.max);
+                    found = true;
+                    break;
+                }
+            }
+            if (found) break;
+        }
+    }
+    const int G = sharedNames.size();
+
+    // 2. 各分析的计算块
+    std::vector<Block> blocks(K);
+    int unknowns = G;
+    result.localNames.resize(K);
+    for (int k = 0; k < K; ++k) {
+        Block& b = blocks[k];
+        b.data = &datasets[k];
+        const UncertaintyInput& in = datasets[k].input;
+        result.datasetNames.append(datasets[k].name);
+        if (in.fitT.isEmpty()) {
+            result.errorMessage = QString("分析“%1”没有观测数据。").arg(datasets[k].name);
+            return result;
+        }
+        for (int s = 0; s < G; ++s) {
+            for (int i = 0; i < in.params.size(); ++i) {
+                if (in.params[i].name == sharedNames[s]) {
+                    b.sharedCols.append(s);
+                    b.fitIndices.append(i);
+                    break;
+                }
+            }
+        }
+        for (int i = 0; i < in.params.size(); ++i) {
+            const FitParameter& p = in.params[i];
+            if (p.isFit && p.name != "LfD" && !sharedNames.contains(p.name)) {
+                b.fitIndices.append(i);
+                result.localNames[k].append(p.name);
+                b.localCount++;
+            }
+        }
+        unknowns += b.localCount;
+
+        for (const FitParameter& p : in.params) b.params.insert(p.name, p.value);
+        for (int a = 0; a < b.sharedCols.size(); ++a) b.params[sharedNames[b.sharedCols[a]]] = sharedValue[b.sharedCols[a]];
+        FittingCore::applyParamConstraints(b.params);
+
+        b.solver.reset(new ModelSolver01_06(in.modelType));
+        b.solver->setHighPrecision(options.highPrecision);
+        ModelSolver01_06* solver = b.solver.get();
+        b.core.reset(new FittingCore([solver](FittingCore::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+            return solver->calculateTheoreticalCurve(p, t);
+        }));
+        b.core->setPointWeights(in.fitWeights);
+    }
+    result.sharedNames = sharedNames;
+    result.unknownCount = unknowns;
+    if (unknowns == 0) {
+        result.errorMessage = "未选择拟合参数。";
+        return result;
+    }
+
+    std::atomic<int> evalCount{0};
+    QVector<int> blockIndices(K);
+    std::iota(blockIndices.begin(), blockIndices.end(), 0);
+
+    // 各分析残差并行计算
+    auto evaluateAll = [&](const std::vector<QMap<QString, double>>& maps, std::vector<QVector<double>>& out) {
+        out.assign(K, QVector<double>());
+        QtConcurrent::blockingMap(blockIndices, [&](const int& k) {
+            const UncertaintyInput& in = blocks[k].data->input;
+            out[k] = blocks[k].core->calculateResiduals(maps[k], in.modelType, in.weight, in.fitT, in.fitP, in.fitD);
+        });
+        evalCount += K;
+    };
+
+    {
+        std::vector<QMap<QString, double>> maps(K);
+        std::vector<QVector<double>> res;
+        for (int k = 0; k < K; ++k) maps[k] = blocks[k].params;
+        evaluateAll(maps, res);
+        for (int k = 0; k < K; ++k) {
+            blocks[k].residuals = res[k];
+            blocks[k].sse = FittingCore::calculateSumSquaredError(res[k]);
+        }
+    }
+    auto totalSse = [&]() {
+        double s = 0.0;
+        for (const Block& b : blocks) s += b.sse;
+        return s;
+    };
+    int nRes = 0;
+    for (const Block& b : blocks) nRes += b.residuals.size();
+    double currentSSE = totalSse();
+
+    double lambda = 0.01;
+    int iter = 0;
+    for (; iter < options.maxIterations; ++iter) {
+        if (cancel && cancel->load()) break;
+        if (nRes > 0 && currentSSE / nRes < options.targetMse) break;
+
+        PerfCounters::add(PerfCounters::LmIterations);
+        TraceSpan iterSpan("JointFitting iteration", "fit", iter + 1);
+
+        // 3. 各分析的雅可比块并行计算 (只含本分析的列)
+        std::vector<Eigen::MatrixXd> J(K);
+        QtConcurrent::blockingMap(blockIndices, [&](const int& k) {
+            const Block& b = blocks[k];
+            const UncertaintyInput& in = b.data->input;
+            QVector<QVector<double>> jac = b.core->computeJacobian(b.params, b.residuals, b.fitIndices, in.modelType,
+                                                                   in.params, in.weight, in.fitT, in.fitP, in.fitD);
+            const int rows = b.residuals.size(), cols = b.fitIndices.size();
+            J[k].resize(rows, cols);
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) J[k](i, j) = jac[i][j];
+            }
+            evalCount += 2 * cols;
+        });
+
+        // 4. 组装箭头形法方程的各块
+        Eigen::MatrixXd A = Eigen::MatrixXd::Zero(G, G);
+        Eigen::VectorXd gG = Eigen::VectorXd::Zero(G);
+        std::vector<Eigen::MatrixXd> B(K), D(K);
+        std::vector<Eigen::VectorXd> gL(K);
+        for (int k = 0; k < K; ++k) {
+            const Block& b = blocks[k];
+            const int gs = b.sharedCols.size(), l = b.localCount;
+            Eigen::Map<const Eigen::VectorXd> r(b.residuals.constData(), b.residuals.size());
+            Eigen::MatrixXd Jg = J[k].leftCols(gs);
+            Eigen::MatrixXd Jl = J[k].rightCols(l);
+
+            Eigen::MatrixXd Ak = Jg.transpose() * Jg;
+            Eigen::VectorXd gk = Jg.transpose() * r;
+            Eigen::MatrixXd Bk = Jg.transpose() * Jl;
+            B[k] = Eigen::MatrixXd::Zero(G, l);
+            for (int a = 0; a < gs; ++a) {
+                gG(b.sharedCols[a]) += gk(a);
+                B[k].row(b.sharedCols[a]) = Bk.row(a);
+                for (int c = 0; c < gs; ++c) A(b.sharedCols[a], b.sharedCols[c]) += Ak(a, c);
+            }
+            D[k] = Jl.transpose() * Jl;
+            gL[k] = Jl.transpose() * r;
+        }
+
+        bool stepAccepted = false;
+        for (int tryIter = 0; tryIter < 5; ++tryIter) {
+            // 5. Schur 补消去各分析的独立参数，求共享参数增量后回代
+            Eigen::VectorXd dg;
+            std::vector<Eigen::VectorXd> dl(K);
+            {
+                PerfStageTimer perfTimer(PerfCounters::Stage_LinearSolve);
+                Eigen::MatrixXd S = A;
+                Eigen::VectorXd rhs = -gG;
+                for (int i = 0; i < G; ++i) S(i, i) += lambda * (1.0 + std::abs(A(i, i)));
+
+                std::vector<Eigen::LDLT<Eigen::MatrixXd>> Dfac(K);
+                for (int k = 0; k < K; ++k) {
+                    if (blocks[k].localCount == 0) continue;
+                    Eigen::MatrixXd Dk = D[k];
+                    for (int i = 0; i < Dk.rows(); ++i) Dk(i, i) += lambda * (1.0 + std::abs(D[k](i, i)));
+                    Dfac[k].compute(Dk);
+                    if (G > 0) {
+                        S -= B[k] * Dfac[k].solve(B[k].transpose());
+                        rhs += B[k] * Dfac[k].solve(gL[k]);
+                    }
+                }
+                dg = G > 0 ? Eigen::VectorXd(S.ldlt().solve(rhs)) : Eigen::VectorXd();
+                for (int k = 0; k < K; ++k) {
+                    if (blocks[k].localCount == 0) continue;
+                    Eigen::VectorXd r = -gL[k];
+                    if (G > 0) r -= B[k].transpose() * dg;
+                    dl[k] = Dfac[k].solve(r);
+                }
+            }
+
+            // 6. 试探步
+            QVector<double> trialShared = sharedValue;
+            for (int s = 0; s < G; ++s) {
+                trialShared[s] = stepValue(sharedNames[s], sharedValue[s], dg(s), sharedMin[s], sharedMax[s]);
+            }
+            std::vector<QMap<QString, double>> trialMaps(K);
+            for (int k = 0; k < K; ++k) {
+                const Block& b = blocks[k];
+                const QList<FitParameter>& ps = b.data->input.params;
+                QMap<QString, double> map = b.params;
+                const int gs = b.sharedCols.size();
+                for (int a = 0; a < gs; ++a) map[sharedNames[b.sharedCols[a]]] = trialShared[b.sharedCols[a]];
+                for (int j = 0; j < b.localCount; ++j) {
+                    const FitParameter& p = ps[b.fitIndices[gs + j]];
+                    map[p.name] = stepValue(p.name, b.params.value(p.name), dl[k](j), p.min, p.max);
+                }
+                FittingCore::applyParamConstraints(map);
+                trialMaps[k] = map;
+            }
+
+            std::vector<QVector<double>> newRes;
+            evaluateAll(trialMaps, newRes);
+            double newSSE = 0.0;
+            bool valid = true;
+            for (int k = 0; k < K; ++k) {
+                if (newRes[k].size() != blocks[k].residuals.size()) valid = false;
+                newSSE += FittingCore::calculateSumSquaredError(newRes[k]);
+            }
+
+            if (valid && newSSE < currentSSE) {
+                currentSSE = newSSE;
+                sharedValue = trialShared;
+                for (int k = 0; k < K; ++k) {
+                    blocks[k].params = trialMaps[k];
+                    blocks[k].residuals = newRes[k];
+                    blocks[k].sse = FittingCore::calculateSumSquaredError(newRes[k]);
+                }
+                lambda /= 10.0;
+                stepAccepted = true;
+                break;
+            }
+            lambda *= 10.0;
+        }
+
+        if (progress) progress(iter + 1, options.maxIterations, nRes > 0 ? currentSSE / nRes : 0.0);
+        if (!stepAccepted && lambda > 1e10) break;
+    }
+
+    result.success = true;
+    for (int s = 0; s < G; ++s) result.sharedValues.insert(sharedNames[s], sharedValue[s]);
+    for (int k = 0; k < K; ++k) {
+        result.datasetParams.append(blocks[k].params);
+        result.datasetMse.append(blocks[k].residuals.isEmpty() ? 0.0 : blocks[k].sse / blocks[k].residuals.size());
+    }
+    result.sse = currentSSE;
+    result.residualCount = nRes;
+    result.mse = nRes > 0 ? currentSSE / nRes : 0.0;
+    result.iterations = iter;
+    result.residualEvaluations = evalCount;
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
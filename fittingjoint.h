@@ -0,0 +1,76 @@
+/*
+ * 文件名: fittingjoint.h
+ * 文件作用: 多分析联合拟合 (共享参数) 算法头文件
+ * 功能描述:
+ * 1. 将多个单分析 (同一井的压降/压恢，或同一平台的多口井) 放在一起拟合：
+ *    储层参数 (如 km、omega、lambda) 在各分析间共享，井相关参数 (如 S、cD、Lf) 各自独立。
+ * 2. 雅可比矩阵按分析分块：每个分析只对“出现在该分析中的共享参数 + 本分析的独立参数”求差分，
+ *    不对其他分析的独立参数求导 (这些列恒为零)，各分析的残差与雅可比在线程池中并行计算。
+ * 3. 法方程为箭头形块稀疏结构，先逐块消去独立参数 (Schur 补)，求解共享参数增量，再回代各分析的独立参数增量。
+ * 4. 阻尼、对数空间更新、边界截断与物理约束与单分析 LM (FittingCore) 保持一致。
+ */
+
+#ifndef FITTINGJOINT_H
+#define FITTINGJOINT_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+
+#include "fittinguncertainty.h"
+
+// 参与联合拟合的单个分析
+struct JointFitDataset {
+    QString name;                   // 分析名称 (页签名)
+    UncertaintyInput input;         // 参数表与拟合抽样数据快照
+};
+
+// 联合拟合设置
+struct JointFitOptions {
+    QStringList sharedParams;       // 共享参数名；其余勾选拟合的参数在各分析内独立拟合
+    int maxIterations = 50;         // 最大迭代次数
+    double targetMse = 3e-3;        // 总体 MSE 低于该值时提前结束
+    bool highPrecision = false;     // 模型计算精度 (与拟合界面设置一致)
+};
+
+// 联合拟合结果
+struct JointFitResult {
+    bool success = false;
+    QString errorMessage;
+    QStringList datasetNames;                   // 与 datasets 顺序一致
+    QStringList sharedNames;                    // 实际参与拟合的共享参数
+    QMap<QString, double> sharedValues;         // 共享参数最终值
+    QVector<QMap<QString, double>> datasetParams; // 各分析的最终全部参数 (含 LfD)
+    QVector<QStringList> localNames;            // 各分析独立拟合的参数
+    QVector<double> datasetMse;                 // 各分析的均方误差
+    double sse = 0.0;                           // 总残差平方和
+    double mse = 0.0;                           // 总均方误差
+    int iterations = 0;
+    int residualCount = 0;                      // 总残差长度
+    int unknownCount = 0;                       // 未知数总数 (共享 + 全部独立)
+    int residualEvaluations = 0;                // 理论曲线计算次数 (各分析合计)
+    double elapsedMs = 0.0;
+};
+
+class JointFitting
+{
+public:
+    // 进度回调：(已完成迭代, 最大迭代, 当前总 MSE)，在工作线程中调用
+    using ProgressCallback = std::function<void(int, int, double)>;
+
+    // 默认作为独立参数的井相关参数 (表皮、井储、缝长、井长、裂缝条数、复合半径)
+    static QStringList defaultLocalParams();
+
+    /**
+     * @brief 执行联合拟合 (阻塞，应在工作线程中调用)
+     * @param cancel 置位后在当前迭代结束时返回当前最优结果
+     */
+    static JointFitResult run(const QVector<JointFitDataset>& datasets, const JointFitOptions& options,
+                              const std::atomic<bool>* cancel = nullptr,
+                              const ProgressCallback& progress = ProgressCallback());
+};
+
+#endif // FITTINGJOINT_H
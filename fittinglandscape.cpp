@@ -0,0 +1,249 @@
+/*
+ * 文件名: fittinglandscape.cpp
+ * 文件作用: 双参数目标函数地形计算引擎实现文件
+ * 功能描述:
+ * 1. 单元以节点下标区间 [i0, i1] × [j0, j1] 表示，细分时取中点下标，任意分辨率均可细分到相邻节点。
+ * 2. 每层先按细化判据选出单元，再汇总其子单元中尚未计算的节点统一去重后并行计算。
+ * 3. 快照：已计算节点取计算值，其余节点在所属单元 (已完成的叶单元或本层正在细分的父单元) 内双线性插值。
+ * 4. 模型计算使用私有低精度求解器，与拟合时精度一致；残差按输入的逐点权重加权。
+ */
+
+#include "fittinglandscape.h"
+#include "tracerecorder.h"
+
+#include <QtConcurrent>
+#include <QThread>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <set>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+struct Cell {
+    int i0, i1, j0, j1;
+};
+
+// 按单元角点对未计算节点做双线性插值
+void fillCell(LandscapeGrid& g, const Cell& c)
+{
+    const int n = g.n;
+    double v00 = g.values[c.j0 * n + c.i0], v10 = g.values[c.j0 * n + c.i1];
+    double v01 = g.values[c.j1 * n + c.i0], v11 = g.values[c.j1 * n + c.i1];
+    for (int j = c.j0; j <= c.j1; ++j) {
+        double ty = c.j1 > c.j0 ? double(j - c.j0) / (c.j1 - c.j0) : 0.0;
+        for (int i = c.i0; i <= c.i1; ++i) {
+            int idx = j * n + i;
+            if (g.evaluated[idx]) continue;
+            double tx = c.i1 > c.i0 ? double(i - c.i0) / (c.i1 - c.i0) : 0.0;
+            g.values[idx] = (1 - tx) * (1 - ty) * v00 + tx * (1 - ty) * v10 + (1 - tx) * ty * v01 + tx * ty * v11;
+        }
+    }
+}
+
+} // namespace
+
+double ObjectiveLandscape::axisValue(double lo, double hi, bool logScale, int n, int i)
+{
+    if (n <= 1) return lo;
+    double t = double(i) / (n - 1);
+    if (logScale && lo > 0.0 && hi > 0.0) return std::pow(10.0, std::log10(lo) + t * (std::log10(hi) - std::log10(lo)));
+    return lo + t * (hi - lo);
+}
+
+LandscapeGrid ObjectiveLandscape::compute(const UncertaintyInput& input, const LandscapeOptions& options,
+                                          const std::atomic<bool>* cancel, const UpdateCallback& update)
+{
+    TraceSpan span("ObjectiveLandscape::compute", "fit");
+
+    LandscapeGrid grid;
+    const int n = qMax(2, options.resolution);
+    grid.n = n;
+    grid.xs.resize(n);
+    grid.ys.resize(n);
+    for (int i = 0; i < n; ++i) {
+        grid.xs[i] = axisValue(options.xMin, options.xMax, options.logX, n, i);
+        grid.ys[i] = axisValue(options.yMin, options.yMax, options.logY, n, i);
+    }
+    grid.values = QVector<double>(n * n, kNaN);
+    grid.evaluated = QVector<char>(n * n, 0);
+
+    QMap<QString, double> baseMap;
+    for (const FitParameter& p : input.params) baseMap.insert(p.name, p.value);
+
+    // 剖面模式：两个地形参数固定，其余勾选拟合的参数参与优化
+    QList<FitParameter> profileParams = input.params;
+    bool hasProfileParams = false;
+    for (FitParameter& p : profileParams) {
+        if (p.name == options.paramX || p.name == options.paramY) p.isFit = false;
+        else if (p.isFit && p.name != "LfD") hasProfileParams = true;
+    }
+    const bool profile = options.profile && hasProfileParams;
+
+    // 单个节点：返回 log10(MSE)，无效为 NaN
+    std::function<double(int)> evaluateNode = [&](int idx) -> double {
+        const double x = grid.xs[idx % n];
+        const double y = grid.ys[idx / n];
+
+        ModelSolver01_06 solver(input.modelType);
+        solver.setHighPrecision(false);
+        FittingCore core([&solver](FittingCore::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(p, t);
+        });
+        core.setPointWeights(input.fitWeights);
+
+        double mse = kNaN;
+        if (profile) {
+            QList<FitParameter> params = profileParams;
+            for (FitParameter& p : params) {
+                if (p.name == options.paramX) p.value = x;
+                else if (p.name == options.paramY) p.value = y;
+            }
+            core.setMaxIterations(options.profileIterations);
+            if (cancel) core.setStopChecker([cancel]() { return cancel->load(); });
+            FittingResult fit = core.runLevenbergMarquardt(input.modelType, params, input.weight, input.fitT, input.fitP, input.fitD);
+            if (fit.success && fit.residualCount > 0) mse = fit.mse;
+        } else {
+            QMap<QString, double> params = baseMap;
+            params[options.paramX] = x;
+            params[options.paramY] = y;
+            FittingCore::applyParamConstraints(params);
+            QVector<double> res = core.calculateResiduals(params, input.modelType, input.weight, input.fitT, input.fitP, input.fitD);
+            if (!res.isEmpty()) mse = FittingCore::calculateSumSquaredError(res) / res.size();
+        }
+        if (!std::isfinite(mse) || mse < 0.0) return kNaN;
+        return std::log10(qMax(mse, 1e-300));
+    };
+
+    // 节点分块并行计算，每块完成后回调快照
+    std::vector<Cell> leaves;       // 已确定不再细分的单元
+    std::vector<Cell> active;       // 本层待细分的单元
+    auto snapshot = [&]() {
+        LandscapeGrid s = grid;
+        for (const Cell& c : leaves) fillCell(s, c);
+        for (const Cell& c : active) fillCell(s, c);
+        return s;
+    };
+    auto recordMinimum = [&](int idx) {
+        double v = grid.values[idx];
+        if (std::isnan(v)) return;
+        if (!grid.hasMinimum || v < grid.minValue) {
+            grid.hasMinimum = true;
+            grid.minValue = v;
+            grid.minX = grid.xs[idx % n];
+            grid.minY = grid.ys[idx / n];
+        }
+    };
+    auto evaluateNodes = [&](const QVector<int>& nodes) -> bool {
+        const int chunk = qMax(8, QThread::idealThreadCount() * 2);
+        for (int start = 0; start < nodes.size(); start += chunk) {
+            if (cancel && cancel->load()) return false;
+            QVector<int> part = nodes.mid(start, chunk);
+            QVector<double> values = QtConcurrent::blockingMapped<QVector<double>>(part, evaluateNode);
+            for (int k = 0; k < part.size(); ++k) {
+                grid.values[part[k]] = values[k];
+                grid.evaluated[part[k]] = 1;
+                recordMinimum(part[k]);
+            }
+            grid.evaluations += part.size();
+            if (update) update(snapshot());
+        }
+        return !(cancel && cancel->load());
+    };
+
+    // 1. 粗网格
+    QVector<int> coarse;
+    {
+        const int cells = qBound(1, options.coarseCells, n - 1);
+        QVector<int> ticks;
+        for (int k = 0; k <= cells; ++k) {
+            int t = qRound(double(k) * (n - 1) / cells);
+            if (ticks.isEmpty() || ticks.last() != t) ticks.append(t);
+        }
+        for (int b = 0; b + 1 < ticks.size(); ++b) {
+            for (int a = 0; a + 1 < ticks.size(); ++a) active.push_back({ticks[a], ticks[a + 1], ticks[b], ticks[b + 1]});
+        }
+        for (int tj : ticks) for (int ti : ticks) coarse.append(tj * n + ti);
+    }
+    if (!evaluateNodes(coarse)) return snapshot();
+
+    // 当前参数点所在的节点位置 (用于强制细化包含该点的单元)
+    auto nodePosition = [&](const QVector<double>& axis, double v, bool logScale) {
+        double lo = axis.first(), hi = axis.last();
+        if (logScale && v > 0.0 && lo > 0.0 && hi > 0.0) {
+            v = std::log10(v); lo = std::log10(lo); hi = std::log10(hi);
+        }
+        return hi > lo ? (v - lo) / (hi - lo) * (n - 1) : -1.0;
+    };
+    const double currentI = nodePosition(grid.xs, baseMap.value(options.paramX), options.logX);
+    const double currentJ = nodePosition(grid.ys, baseMap.value(options.paramY), options.logY);
+
+    // 2. 逐层细化
+    while (!active.empty()) {
+        grid.level++;
+        double gMin = std::numeric_limits<double>::infinity(), gMax = -gMin;
+        for (int k = 0; k < grid.values.size(); ++k) {
+            if (grid.evaluated[k] && !std::isnan(grid.values[k])) {
+                gMin = qMin(gMin, grid.values[k]);
+                gMax = qMax(gMax, grid.values[k]);
+            }
+        }
+        const double range = gMax > gMin ? gMax - gMin : 1.0;
+
+        std::vector<Cell> next;
+        std::vector<Cell> parents;  // 本层被细分的单元；新节点计算期间快照按其角点插值
+        std::set<int> newNodes;
+        for (const Cell& c : active) {
+            const bool splitI = c.i1 - c.i0 > 1;
+            const bool splitJ = c.j1 - c.j0 > 1;
+            if (!splitI && !splitJ) {
+                leaves.push_back(c);
+                continue;
+            }
+
+            double corners[4] = {grid.values[c.j0 * n + c.i0], grid.values[c.j0 * n + c.i1],
+                                 grid.values[c.j1 * n + c.i0], grid.values[c.j1 * n + c.i1]};
+            bool anyNaN = false;
+            double cMin = std::numeric_limits<double>::infinity(), cMax = -cMin;
+            for (double v : corners) {
+                if (std::isnan(v)) { anyNaN = true; continue; }
+                cMin = qMin(cMin, v);
+                cMax = qMax(cMax, v);
+            }
+            bool containsCurrent = currentI >= c.i0 && currentI <= c.i1 && currentJ >= c.j0 && currentJ <= c.j1;
+            bool nearMin = !anyNaN && cMin <= gMin + options.nearBand * range;
+            bool steep = !anyNaN && (cMax - cMin) > options.steepFraction * range;
+            if (anyNaN || !(containsCurrent || nearMin || steep)) {
+                leaves.push_back(c);
+                continue;
+            }
+
+            parents.push_back(c);
+            const int mi = splitI ? (c.i0 + c.i1) / 2 : c.i1;
+            const int mj = splitJ ? (c.j0 + c.j1) / 2 : c.j1;
+            QVector<Cell> children;
+            children.append({c.i0, mi, c.j0, mj});
+            if (splitI) children.append({mi, c.i1, c.j0, mj});
+            if (splitJ) children.append({c.i0, mi, mj, c.j1});
+            if (splitI && splitJ) children.append({mi, c.i1, mj, c.j1});
+            for (const Cell& ch : children) {
+                next.push_back(ch);
+                for (int idx : {ch.j0 * n + ch.i0, ch.j0 * n + ch.i1, ch.j1 * n + ch.i0, ch.j1 * n + ch.i1}) {
+                    if (!grid.evaluated[idx]) newNodes.insert(idx);
+                }
+            }
+        }
+
+        active = parents;
+        QVector<int> nodes(newNodes.begin(), newNodes.end());
+        if (!evaluateNodes(nodes)) return snapshot();
+        active = next;
+    }
+
+    grid.finished = true;
+    LandscapeGrid result = snapshot();
+    if (update) update(result);
+    return result;
+}
@@ -0,0 +1,71 @@
+/*
+ * 文件名: fittinglandscape.h
+ * 文件作用: 双参数目标函数地形 (MSE 热力图) 计算引擎头文件
+ * 功能描述:
+ * 1. 在两个选定参数的二维网格 (可分别取对数刻度) 上计算 log10(MSE)，残差与拟合一致 (FittingCore::calculateResiduals)。
+ * 2. 其余参数可固定在当前值，或逐点对其余拟合参数做短程 LM 优化 (剖面目标函数)。
+ * 3. 四叉树渐进细化：先算粗网格，只细分靠近最小值、落差大或包含当前参数点的单元，
+ *    未细分的单元按角点双线性插值，直至达到目标分辨率。
+ * 4. 每一层的新节点分块在线程池中并行计算，每完成一块即回调一次当前网格快照，供界面逐步刷新。
+ */
+
+#ifndef FITTINGLANDSCAPE_H
+#define FITTINGLANDSCAPE_H
+
+#include <QVector>
+#include <QString>
+#include <atomic>
+#include <functional>
+
+#include "fittinguncertainty.h"
+
+// 地形计算设置
+struct LandscapeOptions {
+    QString paramX, paramY;         // 横轴与纵轴参数
+    double xMin = 0.0, xMax = 1.0;  // 参数范围 (物理值)
+    double yMin = 0.0, yMax = 1.0;
+    bool logX = true, logY = true;  // 是否按对数等分
+    int resolution = 100;           // 目标分辨率 (每轴节点数)
+    int coarseCells = 8;            // 初始粗网格每轴单元数
+    bool profile = false;           // true：其余拟合参数逐点优化；false：固定在当前值
+    int profileIterations = 8;      // 剖面模式下每点的 LM 迭代上限
+    double nearBand = 0.2;          // 角点最小值距全局最小值不超过 (全局落差 × nearBand) 的单元细化
+    double steepFraction = 0.1;     // 单元内落差超过 (全局落差 × steepFraction) 的单元细化
+};
+
+// 地形网格 (节点 (i, j) 的下标为 j * n + i)
+struct LandscapeGrid {
+    int n = 0;
+    QVector<double> xs, ys;         // 节点的物理参数值
+    QVector<double> values;         // log10(MSE)：已计算或插值，无效为 NaN
+    QVector<char> evaluated;        // 节点是否实际计算
+    int evaluations = 0;            // 已计算的节点数
+    int level = 0;                  // 当前细化层 (0 为粗网格)
+    bool finished = false;          // 细化全部完成
+    bool hasMinimum = false;
+    double minValue = 0.0;          // 已计算节点中的最小 log10(MSE)
+    double minX = 0.0, minY = 0.0;
+
+    double value(int i, int j) const { return values[j * n + i]; }
+};
+
+class ObjectiveLandscape
+{
+public:
+    // 网格更新回调，在工作线程中调用
+    using UpdateCallback = std::function<void(const LandscapeGrid&)>;
+
+    /**
+     * @brief 计算目标函数地形 (阻塞，应在工作线程中调用；内部在全局线程池中并行)
+     * @param input 参数表与拟合抽样数据快照；两个地形参数以外的参数取其中的值
+     * @param cancel 置位后在当前块结束时返回 (finished 为 false)
+     */
+    static LandscapeGrid compute(const UncertaintyInput& input, const LandscapeOptions& options,
+                                 const std::atomic<bool>* cancel = nullptr,
+                                 const UpdateCallback& update = UpdateCallback());
+
+    // 第 i 个节点的参数值 (共 n 个节点，对数或线性等分)
+    static double axisValue(double lo, double hi, bool logScale, int n, int i);
+};
+
+#endif // FITTINGLANDSCAPE_H
@@ -0,0 +1,523 @@
+/*
+ * 文件名: fittingmcmc.cpp
+ * 文件作用: 拟合参数后验分布 MCMC 采样器实现文件
+ * 功能描述:
+ * 1. 对数后验 = 先验范围检查 + (-SSE / 2σ²)，SSE 与 LM 拟合使用同一残差定义 (FittingCore::calculateResiduals)，
+ *    σ² 取起始参数处的 SSE/(n-k)；模型计算使用私有低精度求解器，与拟合时精度一致。
+ * 2. walker 在起始参数附近的小球内初始化，每步分红蓝两组并行执行 stretch move。
+ * 3. 自相关时间按 walker 平均的自相关函数计算，窗口取满足 M ≥ 5τ 的最小滞后。
+ * 4. 检查点中的链以 Base64 编码的二进制双精度数组保存，减小项目文件体积。
+ * 5. [修改] 残差按输入的逐点权重加权；权重非空时参与输入指纹 (等权输入的指纹不变，旧检查点仍可继续)。
+ */
+
+#include "fittingmcmc.h"
+#include "tracerecorder.h"
+
+#include <QtConcurrent>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <algorithm>
+
+namespace {
+
+const double kNegInf = -std::numeric_limits<double>::infinity();
+
+// 一次模型评估
+struct Evaluation {
+    double sse = -1.0;      // 负值表示曲线无效
+    int count = 0;          // 残差点数
+};
+
+// 一个 walker 的一次移动
+struct WalkerMove {
+    QVector<double> x;
+    double logProb = kNegInf;
+    bool accepted = false;
+};
+
+QJsonArray toArray(const QVector<double>& v)
+{
+    QJsonArray arr;
+    for (double x : v) arr.append(std::isfinite(x) ? x : -1e300);
+    return arr;
+}
+
+QVector<double> fromArray(const QJsonArray& arr)
+{
+    QVector<double> v;
+    v.reserve(arr.size());
+    for (const QJsonValue& x : arr) v.append(x.toDouble());
+    return v;
+}
+
+double physicalValue(const McmcState& state, int p, double x)
+{
+    return state.logScale[p] ? std::pow(10.0, x) : x;
+}
+
+} // namespace
+
+// ============================================================================
+// McmcState 序列化
+// ============================================================================
+
+QJsonObject McmcState::toJson() const
+{
+    QJsonObject obj;
+    obj["inputKey"] = inputKey;
+    obj["names"] = QJsonArray::fromStringList(names);
+    obj["displayNames"] = QJsonArray::fromStringList(displayNames);
+    QJsonArray logArr;
+    for (bool b : logScale) logArr.append(b);
+    obj["logScale"] = logArr;
+    obj["lower"] = toArray(lower);
+    obj["upper"] = toArray(upper);
+    obj["start"] = toArray(start);
+    obj["sigma2"] = sigma2;
+    obj["seed"] = QString::number(seed);
+    obj["walkers"] = walkers;
+    obj["step"] = step;
+    QJsonArray posArr;
+    for (const QVector<double>& x : positions) posArr.append(toArray(x));
+    obj["positions"] = posArr;
+    obj["logProb"] = toArray(logProb);
+    QJsonArray accArr;
+    for (int a : accepted) accArr.append(a);
+    obj["accepted"] = accArr;
+    obj["lastTau"] = lastTau;
+    QByteArray raw(reinterpret_cast<const char*>(chain.constData()), chain.size() * sizeof(double));
+    obj["chain"] = QString::fromLatin1(raw.toBase64());
+    return obj;
+}
+
+McmcState McmcState::fromJson(const QJsonObject& json)
+{
+    McmcState s;
+    if (json.isEmpty()) return s;
+    s.inputKey = json["inputKey"].toString();
+    for (const QJsonValue& v : json["names"].toArray()) s.names.append(v.toString());
+    for (const QJsonValue& v : json["displayNames"].toArray()) s.displayNames.append(v.toString());
+    for (const QJsonValue& v : json["logScale"].toArray()) s.logScale.append(v.toBool());
+    s.lower = fromArray(json["lower"].toArray());
+    s.upper = fromArray(json["upper"].toArray());
+    s.start = fromArray(json["start"].toArray());
+    s.sigma2 = json["sigma2"].toDouble(1.0);
+    s.seed = json["seed"].toString().toULongLong();
+    s.step = json["step"].toInt();
+    for (const QJsonValue& v : json["positions"].toArray()) s.positions.append(fromArray(v.toArray()));
+    s.logProb = fromArray(json["logProb"].toArray());
+    for (const QJsonValue& v : json["accepted"].toArray()) s.accepted.append(v.toInt());
+    s.lastTau = json["lastTau"].toDouble();
+    QByteArray raw = QByteArray::fromBase64(json["chain"].toString().toLatin1());
+    s.chain.resize(raw.size() / sizeof(double));
+    if (!s.chain.isEmpty()) memcpy(s.chain.data(), raw.constData(), s.chain.size() * sizeof(double));
+
+    // 各部分尺寸一致才视为有效检查点
+    int walkers = json["walkers"].toInt();
+    int d = s.names.size();
+    bool consistent = walkers > 0 && d > 0 && s.positions.size() == walkers && s.logProb.size() == walkers
+                      && s.accepted.size() == walkers && s.logScale.size() == d && s.lower.size() == d
+                      && s.upper.size() == d && s.start.size() == d
+                      && s.chain.size() == static_cast<qsizetype>(s.step) * walkers * d;
+    for (const QVector<double>& x : s.positions) consistent = consistent && x.size() == d;
+    if (s.displayNames.size() != d) s.displayNames = s.names;
+    if (consistent) s.walkers = walkers;
+    return s;
+}
+
+// ============================================================================
+// McmcSampler
+// ============================================================================
+
+QString McmcSampler::inputKey(const UncertaintyInput& input)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QByteArray header = QByteArray::number(static_cast<int>(input.modelType)) + ";" + QByteArray::number(input.weight, 'g', 17) + ";";
+    hash.addData(header);
+    for (const FitParameter& p : input.params) {
+        // 拟合参数的取值只是起点，不影响后验；固定参数的取值影响似然
+        QByteArray item = p.name.toUtf8() + ":" + (p.isFit ? QByteArray("fit") : QByteArray::number(p.value, 'g', 17))
+                          + ":" + QByteArray::number(p.min, 'g', 17) + ":" + QByteArray::number(p.max, 'g', 17) + ";";
+        hash.addData(item);
+    }
+    for (const QVector<double>* v : {&input.fitT, &input.fitP, &input.fitD}) {
+        hash.addData(QByteArray::number(v->size()));
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(v->constData()), v->size() * sizeof(double)));
+    }
+    if (!input.fitWeights.isEmpty()) {
+        hash.addData(QByteArray("weights:") + QByteArray::number(input.fitWeights.size()));
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(input.fitWeights.constData()), input.fitWeights.size() * sizeof(double)));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QVector<double> McmcSampler::autocorrelationTime(const McmcState& state, int firstStep)
+{
+    const int d = state.dim();
+    const int W = state.walkers;
+    const int n = state.step - firstStep;
+    QVector<double> tau(d, 1.0);
+    if (n < 4 || W == 0) return tau;
+
+    QVector<double> series(W * n);
+    for (int p = 0; p < d; ++p) {
+        // 每个 walker 去均值后连续存放
+        double c0 = 0.0;
+        for (int w = 0; w < W; ++w) {
+            double* x = series.data() + w * n;
+            double mean = 0.0;
+            for (int t = 0; t < n; ++t) {
+                x[t] = state.chainValue(firstStep + t, w, p);
+                mean += x[t];
+            }
+            mean /= n;
+            for (int t = 0; t < n; ++t) {
+                x[t] -= mean;
+                c0 += x[t] * x[t];
+            }
+        }
+        if (c0 <= 0.0) continue;
+
+        double t = 1.0;
+        for (int lag = 1; lag < n; ++lag) {
+            double c = 0.0;
+            for (int w = 0; w < W; ++w) {
+                const double* x = series.constData() + w * n;
+                for (int i = 0; i + lag < n; ++i) c += x[i] * x[i + lag];
+            }
+            t += 2.0 * c / c0;
+            if (lag >= 5.0 * t) break;
+        }
+        tau[p] = qMax(1.0, t);
+    }
+    return tau;
+}
+
+McmcResult McmcSampler::summarize(const McmcState& state)
+{
+    McmcResult r;
+    r.state = state;
+    const int d = state.dim();
+    const int W = state.walkers;
+    if (!state.isValid() || state.step < 4) {
+        r.message = "采样步数过少，无法统计";
+        return r;
+    }
+
+    r.tau = autocorrelationTime(state);
+    double tauMax = *std::max_element(r.tau.begin(), r.tau.end());
+    r.burnIn = qMin(static_cast<int>(std::ceil(2.0 * tauMax)), state.step / 2);
+    r.thin = qMax(1, static_cast<int>(tauMax / 2.0));
+
+    long long acc = std::accumulate(state.accepted.begin(), state.accepted.end(), 0LL);
+    r.acceptance = static_cast<double>(acc) / (static_cast<double>(W) * state.step);
+
+    // 后验样本
+    QVector<QVector<double>> raw;   // 采样空间
+    for (int s = r.burnIn; s < state.step; s += r.thin) {
+        for (int w = 0; w < W; ++w) {
+            QVector<double> x(d), phys(d);
+            for (int p = 0; p < d; ++p) {
+                x[p] = state.chainValue(s, w, p);
+                phys[p] = physicalValue(state, p, x[p]);
+            }
+            raw.append(x);
+            r.samples.append(phys);
+        }
+    }
+    if (r.samples.size() < 2) {
+        r.message = "有效后验样本过少";
+        return r;
+    }
+
+    const int m = r.samples.size();
+    for (int p = 0; p < d; ++p) {
+        QVector<double> col(m);
+        for (int k = 0; k < m; ++k) col[k] = r.samples[k][p];
+        ParameterInterval iv;
+        iv.name = state.names[p];
+        iv.displayName = state.displayNames.value(p);
+        iv.fitted = physicalValue(state, p, state.start[p]);
+        iv.mean = std::accumulate(col.begin(), col.end(), 0.0) / m;
+        double ss = 0.0;
+        for (double v : col) ss += (v - iv.mean) * (v - iv.mean);
+        iv.stdDev = std::sqrt(ss / (m - 1));
+        std::sort(col.begin(), col.end());
+        iv.p10 = ParameterUncertainty::percentile(col, 0.10);
+        iv.p50 = ParameterUncertainty::percentile(col, 0.50);
+        iv.p90 = ParameterUncertainty::percentile(col, 0.90);
+        r.intervals.append(iv);
+    }
+
+    // 相关系数 (采样空间)
+    QVector<double> mean(d, 0.0), sd(d, 0.0);
+    for (const QVector<double>& x : raw) for (int p = 0; p < d; ++p) mean[p] += x[p];
+    for (int p = 0; p < d; ++p) mean[p] /= m;
+    for (const QVector<double>& x : raw) for (int p = 0; p < d; ++p) sd[p] += (x[p] - mean[p]) * (x[p] - mean[p]);
+    for (int p = 0; p < d; ++p) sd[p] = std::sqrt(sd[p] / (m - 1));
+    r.correlation = QVector<QVector<double>>(d, QVector<double>(d, 0.0));
+    for (int a = 0; a < d; ++a) {
+        r.correlation[a][a] = 1.0;
+        for (int b = 0; b < a; ++b) {
+            double v = 0.0;
+            if (sd[a] > 0.0 && sd[b] > 0.0) {
+                double cov = 0.0;
+                for (const QVector<double>& x : raw) cov += (x[a] - mean[a]) * (x[b] - mean[b]);
+                v = cov / (m - 1) / (sd[a] * sd[b]);
+            }
+            r.correlation[a][b] = v;
+            r.correlation[b][a] = v;
+        }
+    }
+
+    // R-hat：每个 walker 的预热后部分视为一条链
+    const int n = state.step - r.burnIn;
+    r.rhat = QVector<double>(d, 1.0);
+    if (n >= 2 && W >= 2) {
+        for (int p = 0; p < d; ++p) {
+            QVector<double> chainMean(W, 0.0);
+            double within = 0.0;
+            for (int w = 0; w < W; ++w) {
+                for (int s = r.burnIn; s < state.step; ++s) chainMean[w] += state.chainValue(s, w, p);
+                chainMean[w] /= n;
+                double var = 0.0;
+                for (int s = r.burnIn; s < state.step; ++s) {
+                    double dv = state.chainValue(s, w, p) - chainMean[w];
+                    var += dv * dv;
+                }
+                within += var / (n - 1);
+            }
+            within /= W;
+            double grand = std::accumulate(chainMean.begin(), chainMean.end(), 0.0) / W;
+            double between = 0.0;
+            for (double cm : chainMean) between += (cm - grand) * (cm - grand);
+            between = between * n / (W - 1);
+            if (within > 0.0) {
+                double varHat = (n - 1.0) / n * within + between / n;
+                r.rhat[p] = std::sqrt(varHat / within);
+            }
+        }
+    }
+
+    r.ok = true;
+    return r;
+}
+
+McmcResult McmcSampler::run(const UncertaintyInput& input, const McmcOptions& options, const McmcState* resume,
+                            const std::atomic<bool>* cancel, const ProgressCallback& progress,
+                            const CheckpointCallback& checkpoint)
+{
+    TraceSpan span("McmcSampler::run", "fit");
+    QElapsedTimer timer;
+    timer.start();
+
+    McmcResult failure;
+
+    // 1. 采样维度与先验范围 (对数更新的参数在 log10 空间)
+    QStringList names, displayNames;
+    QVector<bool> logScale;
+    QVector<double> lower, upper, x0;
+    for (const FitParameter& p : input.params) {
+        if (!p.isFit || p.name == "LfD") continue;
+        bool isLog = p.value > 1e-12 && p.min > 0.0 && p.name != "S" && p.name != "nf";
+        double lo = isLog ? std::log10(p.min) : p.min;
+        double hi = isLog ? std::log10(p.max) : p.max;
+        double x = isLog ? std::log10(p.value) : p.value;
+        names << p.name;
+        displayNames << (p.displayName.isEmpty() ? p.name : p.displayName);
+        logScale << isLog;
+        lower << lo;
+        upper << hi;
+        x0 << qBound(lo, x, hi);
+    }
+    const int d = names.size();
+    if (d == 0) {
+        failure.message = "未选择拟合参数";
+        return failure;
+    }
+    if (input.fitT.isEmpty()) {
+        failure.message = "没有可用的拟合数据";
+        return failure;
+    }
+
+    QMap<QString, double> baseMap;
+    for (const FitParameter& p : input.params) baseMap.insert(p.name, p.value);
+
+    auto evaluate = [&](const QVector<double>& x) -> Evaluation {
+        QMap<QString, double> params = baseMap;
+        for (int j = 0; j < d; ++j) params[names[j]] = logScale[j] ? std::pow(10.0, x[j]) : x[j];
+        FittingCore::applyParamConstraints(params);
+
+        ModelSolver01_06 solver(input.modelType);
+        solver.setHighPrecision(false);
+        FittingCore core([&solver](FittingCore::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(p, t);
+        });
+        core.setPointWeights(input.fitWeights);
+        QVector<double> res = core.calculateResiduals(params, input.modelType, input.weight, input.fitT, input.fitP, input.fitD);
+        Evaluation e;
+        if (res.isEmpty()) return e;
+        double sse = FittingCore::calculateSumSquaredError(res);
+        if (std::isfinite(sse)) {
+            e.sse = sse;
+            e.count = res.size();
+        }
+        return e;
+    };
+
+    auto logPosterior = [&](const QVector<double>& x, double sigma2) -> double {
+        for (int j = 0; j < d; ++j) {
+            if (x[j] < lower[j] || x[j] > upper[j]) return kNegInf;
+        }
+        Evaluation e = evaluate(x);
+        return e.sse < 0.0 ? kNegInf : -0.5 * e.sse / sigma2;
+    };
+
+    // 2. 初始化或从检查点继续
+    McmcState state;
+    const QString key = inputKey(input);
+    if (resume && resume->isValid() && resume->inputKey == key && resume->names == names) {
+        state = *resume;
+    } else {
+        state.inputKey = key;
+        state.names = names;
+        state.displayNames = displayNames;
+        state.logScale = logScale;
+        state.lower = lower;
+        state.upper = upper;
+        state.start = x0;
+        state.seed = options.seed;
+
+        Evaluation e0 = evaluate(x0);
+        if (e0.sse < 0.0) {
+            failure.message = "起始参数处理论曲线无效，请先完成拟合";
+            return failure;
+        }
+        state.sigma2 = qMax(e0.sse / qMax(1, e0.count - d), 1e-12);
+        const double lp0 = -0.5 * e0.sse / state.sigma2;
+
+        int walkers = options.walkers > 0 ? options.walkers : qMax(QThread::idealThreadCount(), 8);
+        walkers = qMax(walkers, 2 * d + 2);
+        if (walkers % 2 != 0) ++walkers;
+        state.walkers = walkers;
+
+        // 起始点附近的小球 (先验范围宽度的 0.1%)
+        state.positions.resize(walkers);
+        for (int w = 0; w < walkers; ++w) {
+            std::mt19937_64 rng(ParameterUncertainty::replicateSeed(state.seed ^ 0xA5A5A5A5A5A5A5A5ULL, w));
+            std::normal_distribution<double> gauss(0.0, 1.0);
+            QVector<double> x(d);
+            for (int j = 0; j < d; ++j) {
+                double width = 1e-3 * (upper[j] - lower[j]);
+                x[j] = qBound(lower[j], x0[j] + width * gauss(rng), upper[j]);
+            }
+            state.positions[w] = x;
+        }
+        QVector<int> indices(walkers);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::function<double(int)> initial = [&](int w) { return logPosterior(state.positions[w], state.sigma2); };
+        state.logProb = QtConcurrent::blockingMapped<QVector<double>>(indices, initial);
+        for (int w = 0; w < walkers; ++w) {
+            // 无效的初始点向起始点收缩，仍无效则直接取起始点
+            for (int k = 0; k < 10 && !std::isfinite(state.logProb[w]); ++k) {
+                for (int j = 0; j < d; ++j) state.positions[w][j] = x0[j] + 0.5 * (state.positions[w][j] - x0[j]);
+                state.logProb[w] = logPosterior(state.positions[w], state.sigma2);
+            }
+            if (!std::isfinite(state.logProb[w])) {
+                state.positions[w] = x0;
+                state.logProb[w] = lp0;
+            }
+        }
+        state.accepted = QVector<int>(walkers, 0);
+        state.step = 0;
+    }
+
+    // 3. 红蓝分组 stretch move
+    const int W = state.walkers;
+    const int half = W / 2;
+    const double a = options.stretch;
+    bool converged = false;
+    state.chain.reserve(static_cast<qsizetype>(qMax(options.maxSteps, state.step)) * W * d);
+
+    while (state.step < options.maxSteps) {
+        if (cancel && cancel->load()) break;
+
+        for (int part = 0; part < 2; ++part) {
+            const int begin = part * half;
+            const int otherBegin = (1 - part) * half;
+            QVector<int> movers(half);
+            std::iota(movers.begin(), movers.end(), begin);
+
+            std::function<WalkerMove(int)> propose = [&](int k) -> WalkerMove {
+                std::mt19937_64 rng(ParameterUncertainty::replicateSeed(state.seed, state.step * W + k));
+                std::uniform_real_distribution<double> uniform(0.0, 1.0);
+                int j = otherBegin + qMin(static_cast<int>(uniform(rng) * half), half - 1);
+                double z = std::pow((a - 1.0) * uniform(rng) + 1.0, 2) / a;
+
+                const QVector<double>& xk = state.positions[k];
+                const QVector<double>& xj = state.positions[j];
+                WalkerMove move;
+                move.x.resize(d);
+                for (int p = 0; p < d; ++p) move.x[p] = xj[p] + z * (xk[p] - xj[p]);
+                move.logProb = logPosterior(move.x, state.sigma2);
+
+                double logRatio = (d - 1) * std::log(z) + move.logProb - state.logProb[k];
+                if (std::isfinite(move.logProb) && std::log(uniform(rng)) < logRatio) {
+                    move.accepted = true;
+                } else {
+                    move.x = xk;
+                    move.logProb = state.logProb[k];
+                }
+                return move;
+            };
+
+            QVector<WalkerMove> moves = QtConcurrent::blockingMapped<QVector<WalkerMove>>(movers, propose);
+            for (int i = 0; i < half; ++i) {
+                int k = begin + i;
+                state.positions[k] = moves[i].x;
+                state.logProb[k] = moves[i].logProb;
+                if (moves[i].accepted) state.accepted[k]++;
+            }
+        }
+
+        for (int w = 0; w < W; ++w) {
+            for (int p = 0; p < d; ++p) state.chain.append(state.positions[w][p]);
+        }
+        state.step++;
+        if (progress) progress(state.step, options.maxSteps, state.lastTau);
+
+        if (state.step % options.checkInterval == 0) {
+            QVector<double> tau = autocorrelationTime(state);
+            double tauMax = *std::max_element(tau.begin(), tau.end());
+            if (state.lastTau > 0.0 && state.step > options.tauFactor * tauMax
+                && std::abs(state.lastTau - tauMax) / tauMax < options.tauTolerance) {
+                converged = true;
+            }
+            state.lastTau = tauMax;
+            if (checkpoint) checkpoint(state);
+            if (converged) break;
+        }
+    }
+
+    // 4. 汇总 (取消时也保留已完成部分，便于继续)
+    bool cancelled = cancel && cancel->load();
+    if (checkpoint) checkpoint(state);
+    McmcResult result = summarize(state);
+    result.converged = converged;
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    if (cancelled) {
+        result.ok = false;
+        result.message = QString("采样已取消 (已完成 %1 步)，可从检查点继续。").arg(state.step);
+    } else if (result.ok && !converged) {
+        result.message = QString("达到最大步数 %1 仍未满足收敛判据 (步数 > %2τ 且 τ 稳定)，结果仅供参考。")
+                             .arg(options.maxSteps).arg(options.tauFactor);
+    }
+    return result;
+}
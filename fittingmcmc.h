@@ -0,0 +1,110 @@
+/*
+ * 文件名: fittingmcmc.h
+ * 文件作用: 拟合参数后验分布 MCMC 采样器头文件
+ * 功能描述:
+ * 1. 仿射不变集合采样 (Goodman-Weare stretch move)：参数表中勾选拟合的参数为采样维度，
+ *    先验为参数上下限内的均匀分布 (对数更新的参数在 log10 空间均匀)，似然为对数残差的高斯模型。
+ * 2. 红蓝分组更新：一半 walker 以另一半为参照同时移动，同组的模型计算在线程池中并行。
+ * 3. 每步每个 walker 的随机数由 (种子, 步数, walker 序号) 确定，结果与线程数无关，
+ *    从检查点继续采样与一次性采样完全一致。
+ * 4. 定期计算积分自相关时间 τ，步数超过 tauFactor·τ 且 τ 估计稳定时提前结束。
+ * 5. McmcState 为可序列化的检查点 (当前位置、链、接受数)，随拟合分析状态保存。
+ * 6. 汇总后验分位数、均值、标准差、相关系数、R-hat 与接受率。
+ */
+
+#ifndef FITTINGMCMC_H
+#define FITTINGMCMC_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <atomic>
+#include <functional>
+
+#include "fittinguncertainty.h"
+
+// 采样设置
+struct McmcOptions {
+    int walkers = 0;                // walker 数，0 为自动 (不少于 2 倍维数与线程数，取偶数)
+    int maxSteps = 3000;            // 最大步数 (含检查点之前已完成的步数)
+    quint64 seed = 20260126;        // 随机种子
+    double stretch = 2.0;           // stretch move 尺度参数 a
+    int checkInterval = 100;        // 收敛检查与检查点间隔 (步)
+    double tauFactor = 50.0;        // 步数超过 tauFactor·τ 视为链足够长
+    double tauTolerance = 0.01;     // 相邻两次 τ 估计的相对变化小于该值视为稳定
+};
+
+// 采样检查点
+struct McmcState {
+    QString inputKey;               // 模型、参数设置与拟合数据的摘要，继续采样时必须一致
+    QStringList names;              // 采样参数
+    QStringList displayNames;       // 参数显示名称
+    QVector<bool> logScale;         // 是否在 log10 空间采样
+    QVector<double> lower, upper;   // 采样空间的先验范围
+    QVector<double> start;          // 起始参数 (采样空间)
+    double sigma2 = 1.0;            // 残差方差 (由起始参数估计，采样期间固定)
+    quint64 seed = 0;
+    int walkers = 0;
+    int step = 0;                   // 已完成的步数
+    QVector<QVector<double>> positions;     // 各 walker 当前位置 (采样空间)
+    QVector<double> logProb;                // 各 walker 当前对数后验
+    QVector<double> chain;                  // 链：按 [步][walker][参数] 顺序展开
+    QVector<int> accepted;                  // 各 walker 被接受的移动次数
+    double lastTau = 0.0;                   // 上次检查的最大自相关时间
+
+    int dim() const { return names.size(); }
+    bool isValid() const { return walkers > 0 && dim() > 0 && positions.size() == walkers; }
+    double chainValue(int s, int w, int p) const { return chain[(s * walkers + w) * dim() + p]; }
+
+    QJsonObject toJson() const;
+    static McmcState fromJson(const QJsonObject& json);
+};
+
+// 采样结果
+struct McmcResult {
+    bool ok = false;
+    QString message;                        // 失败或取消的说明
+    bool converged = false;                 // 是否因收敛诊断提前结束
+    McmcState state;                        // 最终状态 (可作为检查点继续)
+    int burnIn = 0;                         // 丢弃的预热步数
+    int thin = 1;                           // 后验样本抽稀间隔
+    double acceptance = 0.0;                // 平均接受率
+    double elapsedMs = 0.0;
+    QVector<double> tau;                    // 各参数积分自相关时间 (步)
+    QVector<double> rhat;                   // 各参数 Gelman-Rubin R-hat (以 walker 为链)
+    QVector<ParameterInterval> intervals;   // 后验统计 (物理量)
+    QVector<QVector<double>> samples;       // 后验样本 (物理量)，每行一个样本
+    QVector<QVector<double>> correlation;   // 相关系数 (采样空间)
+};
+
+class McmcSampler
+{
+public:
+    // 进度回调：(当前步, 最大步, 当前 τ 估计)，在工作线程中调用
+    using ProgressCallback = std::function<void(int, int, double)>;
+    // 检查点回调：每 checkInterval 步调用一次，在工作线程中调用
+    using CheckpointCallback = std::function<void(const McmcState&)>;
+
+    /**
+     * @brief 运行采样 (阻塞，应在工作线程中调用)
+     * @param resume 非空且与输入一致时从该检查点继续
+     * @param cancel 置位后在当前步结束时停止，结果中保留已完成部分 (ok 为 false)
+     */
+    static McmcResult run(const UncertaintyInput& input, const McmcOptions& options,
+                          const McmcState* resume = nullptr,
+                          const std::atomic<bool>* cancel = nullptr,
+                          const ProgressCallback& progress = ProgressCallback(),
+                          const CheckpointCallback& checkpoint = CheckpointCallback());
+
+    // 由状态汇总后验统计 (丢弃 2τ 预热，按 τ/2 抽稀)
+    static McmcResult summarize(const McmcState& state);
+
+    // 各参数的积分自相关时间 (walker 平均自相关函数 + Sokal 自适应窗口)
+    static QVector<double> autocorrelationTime(const McmcState& state, int firstStep = 0);
+
+    // 模型类型、拟合参数设置与数据的摘要
+    static QString inputKey(const UncertaintyInput& input);
+};
+
+#endif // FITTINGMCMC_H
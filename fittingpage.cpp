@@ -6,6 +6,10 @@
  * 2. 支持创建 FittingWidget (单分析) 和 FittingMultiplesWidget (多分析对比) 两种类型的页签。
  * 3. [修改] 构造函数中设置背景色为白色。
  * 4. [修改] 新建多分析页签时，传递从 Dialog 获取的曲线选择信息。
+ * 5. [新增] 工具栏“导出整井报告”：收集所有单分析页签的状态快照交给 FittingReportJob，
+ *    生成期间界面可继续操作，再次点击按钮可取消。
+ * 6. [新增] 工具栏“联合拟合”：收集已加载数据且空闲的单分析页签快照，在对话框中联合拟合，
+ *    确认后按页签名把各分析的最终参数写回对应页签。
  */
 
 #include "fittingpage.h"
@@ -13,8 +17,14 @@
 #include "wt_fittingwidget.h"
 #include "fittingnewdialog.h"
 #include "modelparameter.h"
+#include "fittingreportjob.h"
+#include "jointfitdialog.h"
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QPushButton>
+#include <QProgressBar>
 #include <QJsonArray>
 #include <QDebug>
 
@@ -22,10 +32,35 @@
 FittingPage::FittingPage(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::FittingPage),
-    m_modelManager(nullptr)
+    m_modelManager(nullptr),
+    m_btnWellReport(nullptr),
+    m_reportProgress(nullptr),
+    m_reportJob(nullptr),
+    m_btnJointFit(nullptr)
 {
     ui->setupUi(this);
 
+    // [新增] 整井报告按钮与进度条，放在“删除当前页”之后
+    m_btnWellReport = new QPushButton("导出整井报告", this);
+    m_reportProgress = new QProgressBar(this);
+    m_reportProgress->setRange(0, 100);
+    m_reportProgress->setFixedWidth(260);
+    m_reportProgress->setVisible(false);
+    int spacerIndex = ui->horizontalLayout->indexOf(ui->btnDeleteAnalysis) + 1;
+    ui->horizontalLayout->insertWidget(spacerIndex, m_btnWellReport);
+    ui->horizontalLayout->insertWidget(spacerIndex + 1, m_reportProgress);
+    connect(m_btnWellReport, &QPushButton::clicked, this, &FittingPage::onExportWellReportClicked);
+
+    // [新增] 联合拟合按钮，放在“导出整井报告”之前
+    m_btnJointFit = new QPushButton("联合拟合", this);
+    m_btnJointFit->setToolTip("多个分析共享储层参数 (如 km、omega、lambda) 一起拟合，井相关参数 (如 S、cD、Lf) 各自独立");
+    ui->horizontalLayout->insertWidget(spacerIndex, m_btnJointFit);
+    connect(m_btnJointFit, &QPushButton::clicked, this, &FittingPage::onJointFitClicked);
+
+    m_reportJob = new FittingReportJob(this);
+    connect(m_reportJob, &FittingReportJob::progressChanged, this, &FittingPage::onReportProgress);
+    connect(m_reportJob, &FittingReportJob::finished, this, &FittingPage::onReportFinished);
+
     // [修改] 拟合主界面背景默认为白色
     this->setAttribute(Qt::WA_StyledBackground, true);
     this->setStyleSheet("background-color: white;");
@@ -300,3 +335,109 @@ void FittingPage::resetAnalysis()
     }
     createNewTab("Analysis 1");
 }
+
+/**
+ * @brief 导出整井报告
+ * * 任务运行中再次点击则取消；否则收集全部单分析页签的状态快照并启动后台任务。
+ * * 快照在启动时复制，生成期间修改或删除页签不影响本次报告。
+ */
+void FittingPage::onExportWellReportClicked()
+{
+    if (m_reportJob->isRunning()) {
+        m_reportJob->cancel();
+        m_btnWellReport->setEnabled(false);
+        return;
+    }
+
+    QList<ReportAnalysisInput> inputs;
+    for (int i = 0; i < ui->tabWidget->count(); ++i) {
+        if (qobject_cast<FittingWidget*>(ui->tabWidget->widget(i))) {
+            ReportAnalysisInput input;
+            input.name = ui->tabWidget->tabText(i);
+            input.state = getTabState(i);
+            inputs.append(input);
+        }
+    }
+    if (inputs.isEmpty()) {
+        QMessageBox::warning(this, "警告", "当前没有可导出的单分析页面！");
+        return;
+    }
+
+    QString wellName = FittingReportJob::wellNameFromProject();
+    QString projectFilePath = ModelParameter::instance()->getProjectFilePath();
+    QString defaultDir = QFileInfo(projectFilePath).absolutePath();
+    if (defaultDir.isEmpty() || defaultDir == ".") defaultDir = ModelParameter::instance()->getProjectPath();
+    if (defaultDir.isEmpty()) defaultDir = ".";
+
+    QString fileName = QFileDialog::getSaveFileName(this, "导出整井报告",
+                                                    defaultDir + "/" + QString("%1整井试井解释报告.doc").arg(wellName),
+                                                    "Word 文档 (*.doc);;HTML 文件 (*.html)");
+    if (fileName.isEmpty()) return;
+
+    m_btnWellReport->setText("取消导出");
+    m_reportProgress->setValue(0);
+    m_reportProgress->setVisible(true);
+    m_reportJob->start(wellName, inputs, fileName);
+}
+
+void FittingPage::onReportProgress(int percent, const QString &stage)
+{
+    m_reportProgress->setValue(percent);
+    m_reportProgress->setFormat(QString("%1  %p%").arg(stage));
+}
+
+void FittingPage::onReportFinished(bool ok, const QString &filePath, const QString &message)
+{
+    m_btnWellReport->setText("导出整井报告");
+    m_btnWellReport->setEnabled(true);
+    m_reportProgress->setVisible(false);
+
+    if (ok) {
+        QMessageBox::information(this, "成功", QString("整井报告已导出！\n\n报告文件: %1\n各分析的完整数据表已保存在同一目录。").arg(filePath));
+    } else {
+        QMessageBox::warning(this, "导出失败", message);
+    }
+}
+
+/**
+ * @brief 多分析联合拟合
+ * * 只收集已加载观测数据且没有拟合/后台分析在运行的单分析页签；
+ * * 对话框确认后按页签名写回 (拟合期间被重命名或删除的页签跳过)。
+ */
+void FittingPage::onJointFitClicked()
+{
+    QVector<JointFitDataset> datasets;
+    QStringList skipped;
+    for (int i = 0; i < ui->tabWidget->count(); ++i) {
+        FittingWidget* fw = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
+        if (!fw) continue;
+        if (!fw->hasObservedData() || fw->isBusy()) {
+            skipped.append(ui->tabWidget->tabText(i));
+            continue;
+        }
+        JointFitDataset ds;
+        ds.name = ui->tabWidget->tabText(i);
+        ds.input = fw->fittingInputSnapshot();
+        datasets.append(ds);
+    }
+    if (datasets.size() < 2) {
+        QString msg = "联合拟合至少需要两个已加载观测数据且空闲的单分析页面。";
+        if (!skipped.isEmpty()) msg += QString("\n\n未加载数据或正在计算：%1").arg(skipped.join("、"));
+        QMessageBox::warning(this, "联合拟合", msg);
+        return;
+    }
+
+    JointFitDialog dlg(datasets, m_modelManager && m_modelManager->isHighPrecision(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    JointFitResult result = dlg.result();
+    for (int k = 0; k < result.datasetNames.size(); ++k) {
+        for (int i = 0; i < ui->tabWidget->count(); ++i) {
+            if (ui->tabWidget->tabText(i) != result.datasetNames[k]) continue;
+            if (FittingWidget* fw = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i))) {
+                fw->applyParameterValues(result.datasetParams[k]);
+            }
+            break;
+        }
+    }
+}
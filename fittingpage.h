@@ -6,6 +6,8 @@
  * 2. 负责将项目级数据（如模型管理器、观测数据模型集合）传递给各个子页签。
  * 3. 实现多页签的创建、重命名、删除及保存恢复功能。
  * 4. 集成 FittingNewDialog 进行新建分析的交互。
+ * 5. [新增] 导出整井报告：汇总全部单分析页签，由 FittingReportJob 在后台生成，工具栏显示进度。
+ * 6. [新增] 联合拟合：选择多个单分析共享储层参数一起拟合 (fittingjoint.h)，结果写回各分析页签。
  */
 
 #ifndef FITTINGPAGE_H
@@ -22,6 +24,9 @@
 
 // 前置声明
 class FittingWidget;
+class FittingReportJob;
+class QPushButton;
+class QProgressBar;
 
 namespace Ui {
 class FittingPage;
@@ -65,6 +70,14 @@ private slots:
     // 响应子页面的保存请求
     void onChildRequestSave();
 
+    // [新增] 整井报告：启动/取消、进度与完成
+    void onExportWellReportClicked();
+    void onReportProgress(int percent, const QString& stage);
+    void onReportFinished(bool ok, const QString& filePath, const QString& message);
+
+    // [新增] 多分析联合拟合
+    void onJointFitClicked();
+
 private:
     Ui::FittingPage *ui;
     ModelManager* m_modelManager;
@@ -72,6 +85,14 @@ private:
     // 存储所有已打开文件的数据模型映射表
     QMap<QString, QStandardItemModel*> m_dataMap;
 
+    // [新增] 整井报告 (按钮与进度条在代码中加入工具栏)
+    QPushButton* m_btnWellReport;
+    QProgressBar* m_reportProgress;
+    FittingReportJob* m_reportJob;
+
+    // [新增] 联合拟合按钮
+    QPushButton* m_btnJointFit;
+
     // 内部函数：创建新页签 (单分析)
     FittingWidget* createNewTab(const QString& name, const QJsonObject& initData = QJsonObject());
 
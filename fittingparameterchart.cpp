@@ -7,6 +7,7 @@
  * 3. 实现 eventFilter 逻辑：支持鼠标滚轮调节参数，增加了数值上下限检查 (min/max)。
  * 4. 引入 QTimer 实现滚轮事件的防抖动处理，避免快速滚动导致软件闪退。
  * 5. 保持 LfD (无因次缝长) 的自动计算与只读逻辑，LfD 默认显示但不拟合。
+ * 6. [新增] 裂缝表参数 (ModelSolver01_06::isFractureTableKey) 不显示、不拟合，切换模型时原样保留。
  */
 
 #include "fittingparameterchart.h"
@@ -265,10 +266,15 @@ void FittingParameterChart::setParameters(const QList<FitParameter> &params) { m
 void FittingParameterChart::switchModel(ModelManager::ModelType newType)
 {
     QMap<QString, double> oldValues;
-    for(const auto& p : m_params) oldValues.insert(p.name, p.value);
+    QList<FitParameter> fractureTable;
+    for(const auto& p : m_params) {
+        oldValues.insert(p.name, p.value);
+        if (ModelSolver01_06::isFractureTableKey(p.name)) fractureTable.append(p);
+    }
 
     // 重置参数（此处会更新 isFit 和 isVisible 状态）
     resetParams(newType);
+    m_params.append(fractureTable);
 
     // 恢复旧值
     for(auto& p : m_params) {
@@ -286,6 +292,57 @@ void FittingParameterChart::switchModel(ModelManager::ModelType newType)
     refreshParamTable();
 }
 
+void FittingParameterChart::setFractureTable(const QVector<double>& positions, const QVector<double>& halfLengths)
+{
+    m_params.erase(std::remove_if(m_params.begin(), m_params.end(), [](const FitParameter& p) {
+        return ModelSolver01_06::isFractureTableKey(p.name);
+    }), m_params.end());
+
+    const int count = qMin(positions.size(), halfLengths.size());
+    if (count > 0) {
+        auto addHidden = [this](const QString& name, const QString& displayName, double value) {
+            FitParameter p;
+            p.name = name;
+            p.displayName = displayName;
+            p.value = value;
+            p.isFit = false;
+            p.isVisible = false;
+            p.min = value;
+            p.max = value;
+            m_params.append(p);
+        };
+        addHidden(ModelSolver01_06::FractureCountKey, "裂缝表条数", count);
+        for (int i = 1; i <= count; ++i) {
+            addHidden(ModelSolver01_06::fractureXKey(i), QString("第%1条裂缝位置").arg(i), positions[i - 1]);
+            addHidden(ModelSolver01_06::fractureLfKey(i), QString("第%1条裂缝半长").arg(i), halfLengths[i - 1]);
+        }
+        for (auto& p : m_params) {
+            if (p.name == "nf") p.value = count;
+        }
+    }
+    refreshParamTable();
+}
+
+void FittingParameterChart::getFractureTable(QVector<double>& positions, QVector<double>& halfLengths) const
+{
+    positions.clear();
+    halfLengths.clear();
+    QMap<QString, double> values;
+    for (const auto& p : m_params) {
+        if (ModelSolver01_06::isFractureTableKey(p.name)) values.insert(p.name, p.value);
+    }
+    const int count = (int)values.value(ModelSolver01_06::FractureCountKey, 0.0);
+    for (int i = 1; i <= count; ++i) {
+        if (!values.contains(ModelSolver01_06::fractureXKey(i)) || !values.contains(ModelSolver01_06::fractureLfKey(i))) {
+            positions.clear();
+            halfLengths.clear();
+            return;
+        }
+        positions.append(values.value(ModelSolver01_06::fractureXKey(i)));
+        halfLengths.append(values.value(ModelSolver01_06::fractureLfKey(i)));
+    }
+}
+
 void FittingParameterChart::updateParamsFromTable()
 {
     if(!m_table) return;
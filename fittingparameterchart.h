@@ -6,6 +6,7 @@
  * 2. 管理拟合界面参数表格的显示、交互与逻辑。
  * 3. 实现参数的默认选择逻辑：根据试井模型类型，自动勾选需要拟合的核心参数。
  * 4. 实现鼠标滚轮调节参数功能，并增加防抖动和边界限制保护。
+ * 5. [新增] 裂缝表 (各裂缝位置与半长) 以隐藏参数保存在参数列表中，切换模型时保留。
  */
 
 #ifndef FITTINGPARAMETERCHART_H
@@ -50,6 +51,10 @@ public:
     // 切换模型（保留共有参数值）
     void switchModel(ModelManager::ModelType newType);
 
+    // 裂缝表：写入后参数 nf 设为裂缝条数；传入空表则删除裂缝表，恢复均匀布置
+    void setFractureTable(const QVector<double>& positions, const QVector<double>& halfLengths);
+    void getFractureTable(QVector<double>& positions, QVector<double>& halfLengths) const;
+
     // 从UI表格读取参数到内部结构
     void updateParamsFromTable();
 
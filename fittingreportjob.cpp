@@ -0,0 +1,588 @@
+/*
+ * 文件名: fittingreportjob.cpp
+ * 文件作用: 整井拟合报告后台生成任务实现文件
+ * 功能描述:
+ * 1. 准备阶段：QtConcurrent::mapped 并行处理各分析，每个分析使用私有的高精度求解器，
+ *    与界面上正在使用的 ModelManager 求解器互不干扰。
+ * 2. 绘图阶段：QWidget/QPixmap 只能在界面线程使用，因此在隐藏的离屏 QCustomPlot 上
+ *    每个事件循环只渲染一个分析并转为 QImage，界面在分析之间保持响应。
+ * 3. 组装阶段：QImage 可跨线程使用，PNG 编码与 Base64 在线程池中并行完成，
+ *    随后拼装 Word 兼容 HTML，并为每个分析写出完整数据表 CSV。
+ * 4. [修改] 参数表不逐项列出裂缝表参数，只注明裂缝表条数。
+ * 5. [修改] 理论曲线时间序列与拟合界面一致，由 generateCurveTimeSteps 生成。
+ * 6. [修改] MSE 的抽样设置包含自适应抽样点数。
+ * 7. [修复] MSE 按分析保存的密度加权设置使用逐点权重，与拟合目标函数一致。
+ * 8. [修复] 组装阶段在写出数据表和报告文件前再次检查取消标志，已取消时不留下文件。
+ */
+
+#include "fittingreportjob.h"
+#include "modelparameter.h"
+#include "modelmanager.h"
+#include "qcustomplot.h"
+#include "tracerecorder.h"
+
+#include <QtConcurrent>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QBuffer>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cmath>
+
+namespace {
+
+// 绘图尺寸 (与单分析报告一致)
+const int kImageWidth = 800;
+const int kImageHeight = 600;
+
+// 图片编码为 PNG Base64
+QString imageToBase64(const QImage& image)
+{
+    QByteArray byteArray;
+    QBuffer buffer(&byteArray);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return QString::fromLatin1(byteArray.toBase64());
+}
+
+// 分析名称转为可用于文件名的形式
+QString safeFileName(const QString& name)
+{
+    QString s = name;
+    static const QString invalid = "\\/:*?\"<>|";
+    for (QChar& c : s) {
+        if (invalid.contains(c)) c = '_';
+    }
+    return s.trimmed().isEmpty() ? QString("分析") : s.trimmed();
+}
+
+QString paramTableHeader()
+{
+    return "<table><tr><th width='10%'>序号</th><th width='30%'>参数名称</th><th width='20%'>符号</th><th width='25%'>数值</th><th width='15%'>单位</th></tr>";
+}
+
+} // namespace
+
+FittingReportJob::FittingReportJob(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_prepareWatcher, &QFutureWatcher<AnalysisData>::progressValueChanged, this, [this](int value) {
+        int total = qMax(1, m_inputs.size());
+        emit progressChanged(value * 40 / total, QString("计算理论曲线 (%1/%2)").arg(value).arg(m_inputs.size()));
+    });
+
+    connect(&m_prepareWatcher, &QFutureWatcher<AnalysisData>::finished, this, [this]() {
+        if (m_cancelRequested || m_prepareWatcher.isCanceled()) {
+            finish(false, "报告生成已取消");
+            return;
+        }
+        m_analyses = m_prepareWatcher.future().results();
+        m_renderIndex = 0;
+        setupOffscreenPlot();
+        QTimer::singleShot(0, this, &FittingReportJob::renderNext);
+    });
+
+    connect(&m_assembleWatcher, &QFutureWatcher<QString>::finished, this, [this]() {
+        QString error = m_assembleWatcher.result();
+        if (m_cancelRequested) finish(false, "报告生成已取消");
+        else finish(error.isEmpty(), error);
+    });
+}
+
+FittingReportJob::~FittingReportJob()
+{
+    // 后台任务引用本对象的成员，析构前须等待其结束
+    m_cancelRequested = true;
+    m_prepareWatcher.cancel();
+    m_prepareWatcher.waitForFinished();
+    m_assembleWatcher.waitForFinished();
+    delete m_plot;
+}
+
+void FittingReportJob::start(const QString& wellName, const QList<ReportAnalysisInput>& inputs, const QString& filePath)
+{
+    if (m_running) return;
+    m_running = true;
+    m_cancelRequested = false;
+    m_wellName = wellName;
+    m_filePath = filePath;
+    m_inputs = inputs;
+    m_analyses.clear();
+
+    emit progressChanged(0, "计算理论曲线");
+    m_prepareWatcher.setFuture(QtConcurrent::mapped(m_inputs, &FittingReportJob::prepareAnalysis));
+}
+
+void FittingReportJob::cancel()
+{
+    if (!m_running) return;
+    m_cancelRequested = true;
+    m_prepareWatcher.cancel();
+}
+
+void FittingReportJob::finish(bool ok, const QString& message)
+{
+    delete m_plot;
+    m_plot = nullptr;
+    m_analyses.clear();
+    m_running = false;
+    if (ok) emit progressChanged(100, "完成");
+    emit finished(ok, m_filePath, message);
+}
+
+// ============================================================================
+// 准备阶段 (工作线程)
+// ============================================================================
+
+FittingReportJob::AnalysisData FittingReportJob::prepareAnalysis(const ReportAnalysisInput& input)
+{
+    TraceSpan span("FittingReportJob::prepare", "report");
+
+    AnalysisData d;
+    d.name = input.name;
+    const QJsonObject& root = input.state;
+
+    int type = root["modelType"].toInt();
+    if (type < 0 || type > ModelSolver01_06::Model_6) type = 0;
+    d.modelType = static_cast<ModelSolver01_06::ModelType>(type);
+
+    // 参数 (状态中保存了完整参数表)
+    QMap<QString, double> params;
+    QJsonArray paramArr = root["parameters"].toArray();
+    for (const QJsonValue& v : paramArr) {
+        QJsonObject pObj = v.toObject();
+        FitParameter p;
+        p.name = pObj["name"].toString();
+        p.value = pObj["value"].toDouble();
+        p.isFit = pObj["isFit"].toBool();
+        p.min = pObj["min"].toDouble();
+        p.max = pObj["max"].toDouble();
+        p.isVisible = pObj.contains("isVisible") ? pObj["isVisible"].toBool() : true;
+        d.params.append(p);
+        params.insert(p.name, p.value);
+    }
+    if (!params.contains("LfD")) params["LfD"] = 0.0;
+    FittingCore::applyParamConstraints(params);
+
+    // 观测数据
+    QJsonObject obs = root["observedData"].toObject();
+    for (const QJsonValue& v : obs["time"].toArray()) d.obsT.append(v.toDouble());
+    for (const QJsonValue& v : obs["pressure"].toArray()) d.obsP.append(v.toDouble());
+    for (const QJsonValue& v : obs["derivative"].toArray()) d.obsD.append(v.toDouble());
+
+    // 双对数视图范围
+    QJsonObject view = root["plotView"].toObject();
+    d.xMin = view["xMin"].toDouble(); d.xMax = view["xMax"].toDouble();
+    d.yMin = view["yMin"].toDouble(); d.yMax = view["yMax"].toDouble();
+    d.hasView = d.xMin > 0 && d.xMax > d.xMin && d.yMin > 0 && d.yMax > d.yMin;
+
+    // 时间序列与 FittingWidget::updateModelCurve 一致
+    QVector<double> targetT;
+    if (d.obsT.size() > 300) {
+        double tMin = d.obsT.first() > 1e-5 ? d.obsT.first() : 1e-5;
+        targetT = ModelManager::generateCurveTimeSteps(300, log10(tMin), log10(d.obsT.last()));
+    } else if (!d.obsT.isEmpty()) {
+        targetT = d.obsT;
+    } else {
+        for (double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e));
+    }
+
+    // 私有求解器：报告始终按高精度计算
+    ModelSolver01_06 solver(d.modelType);
+    solver.setHighPrecision(true);
+    ModelCurveData curve = solver.calculateTheoreticalCurve(params, targetT);
+    d.curveT = std::get<0>(curve);
+    d.curveP = std::get<1>(curve);
+    d.curveD = std::get<2>(curve);
+
+    // MSE：与界面相同的抽样与残差定义
+    if (!d.obsT.isEmpty()) {
+        QList<SamplingInterval> intervals;
+        for (const QJsonValue& v : root["customIntervals"].toArray()) {
+            QJsonObject obj = v.toObject();
+            SamplingInterval item;
+            item.tStart = obj["start"].toDouble();
+            item.tEnd = obj["end"].toDouble();
+            item.count = obj["count"].toInt();
+            intervals.append(item);
+        }
+        QVector<double> sampleT, sampleP, sampleD;
+        FittingCore::getLogSampledData(d.obsT, d.obsP, d.obsD, root["useCustomSampling"].toBool(), intervals,
+                                       sampleT, sampleP, sampleD, root["adaptiveSampleCount"].toInt());
+
+        FittingCore core([&solver](FittingCore::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(p, t);
+        });
+        core.setPointWeights(FittingCore::samplingPointWeights(sampleT, root["useCustomSampling"].toBool(),
+                                                               root["adaptiveSampleCount"].toInt(),
+                                                               root["densityWeighting"].toBool(false)));
+        double weight = root.contains("fitWeightVal") ? root["fitWeightVal"].toInt() / 100.0 : 0.5;
+        QVector<double> residuals = core.calculateResiduals(params, d.modelType, weight, sampleT, sampleP, sampleD);
+        if (!residuals.isEmpty())
+            d.mse = FittingCore::calculateSumSquaredError(residuals) / residuals.size();
+    }
+    return d;
+}
+
+// ============================================================================
+// 绘图阶段 (界面线程)
+// ============================================================================
+
+/**
+ * @brief 创建离屏图表，样式与 FittingWidget::setupPlot 一致
+ */
+void FittingReportJob::setupOffscreenPlot()
+{
+    delete m_plot;
+    m_plot = new QCustomPlot();
+    m_plot->setAttribute(Qt::WA_DontShowOnScreen, true);
+    m_plot->resize(kImageWidth, kImageHeight);
+    m_plot->setBackground(Qt::white);
+    m_plot->axisRect()->setBackground(Qt::white);
+
+    QFont labelFont("Microsoft YaHei", 10, QFont::Bold);
+    QFont tickFont("Microsoft YaHei", 9);
+    m_plot->xAxis->setLabel("时间 Time (h)");
+    m_plot->yAxis->setLabel("压差 & 导数 Delta P & Derivative (MPa)");
+    m_plot->xAxis->setLabelFont(labelFont); m_plot->yAxis->setLabelFont(labelFont);
+    m_plot->xAxis->setTickLabelFont(tickFont); m_plot->yAxis->setTickLabelFont(tickFont);
+
+    m_plot->xAxis2->setVisible(true); m_plot->yAxis2->setVisible(true);
+    m_plot->xAxis2->setTickLabels(false); m_plot->yAxis2->setTickLabels(false);
+    connect(m_plot->xAxis, SIGNAL(rangeChanged(QCPRange)), m_plot->xAxis2, SLOT(setRange(QCPRange)));
+    connect(m_plot->yAxis, SIGNAL(rangeChanged(QCPRange)), m_plot->yAxis2, SLOT(setRange(QCPRange)));
+
+    m_plot->xAxis->grid()->setSubGridVisible(true); m_plot->yAxis->grid()->setSubGridVisible(true);
+    m_plot->xAxis->grid()->setPen(QPen(QColor(220, 220, 220), 1, Qt::SolidLine));
+    m_plot->yAxis->grid()->setPen(QPen(QColor(220, 220, 220), 1, Qt::SolidLine));
+    m_plot->xAxis->grid()->setSubGridPen(QPen(QColor(240, 240, 240), 1, Qt::DotLine));
+    m_plot->yAxis->grid()->setSubGridPen(QPen(QColor(240, 240, 240), 1, Qt::DotLine));
+
+    m_plot->addGraph(); m_plot->graph(0)->setPen(Qt::NoPen);
+    m_plot->graph(0)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, QColor(0, 100, 0), 6));
+    m_plot->graph(0)->setName("实测压差");
+
+    m_plot->addGraph(); m_plot->graph(1)->setPen(Qt::NoPen);
+    m_plot->graph(1)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssTriangle, Qt::magenta, 6));
+    m_plot->graph(1)->setName("实测导数");
+
+    m_plot->addGraph(); m_plot->graph(2)->setPen(QPen(Qt::red, 2));
+    m_plot->graph(2)->setName("理论压差");
+
+    m_plot->addGraph(); m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
+    m_plot->graph(3)->setName("理论导数");
+
+    m_plot->legend->setVisible(true);
+    m_plot->legend->setFont(QFont("Microsoft YaHei", 9));
+    m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
+}
+
+void FittingReportJob::renderNext()
+{
+    if (m_cancelRequested) {
+        finish(false, "报告生成已取消");
+        return;
+    }
+
+    if (m_renderIndex < m_analyses.size()) {
+        AnalysisData& data = m_analyses[m_renderIndex];
+        renderAnalysis(data);
+        ++m_renderIndex;
+        emit progressChanged(40 + m_renderIndex * 40 / m_analyses.size(),
+                             QString("绘制图表 (%1/%2)").arg(m_renderIndex).arg(m_analyses.size()));
+        QTimer::singleShot(0, this, &FittingReportJob::renderNext);
+        return;
+    }
+
+    // 全部渲染完成，释放离屏图表并进入组装阶段
+    delete m_plot;
+    m_plot = nullptr;
+    emit progressChanged(80, "编码图片并生成文档");
+    m_assembleWatcher.setFuture(QtConcurrent::run(&FittingReportJob::assembleReport, m_analyses, m_wellName, m_filePath,
+                                                    &m_cancelRequested));
+}
+
+/**
+ * @brief 渲染一个分析的三张图 (与单分析报告相同的图序与显示规则)
+ */
+void FittingReportJob::renderAnalysis(AnalysisData& data)
+{
+    TraceSpan span("FittingReportJob::render", "report", m_renderIndex);
+
+    QCPGraph* gObsP = m_plot->graph(0);
+    QCPGraph* gObsD = m_plot->graph(1);
+    QCPGraph* gModP = m_plot->graph(2);
+    QCPGraph* gModD = m_plot->graph(3);
+
+    // 对数坐标下仅保留正值
+    QVector<double> dT, dD;
+    for (int i = 0; i < data.obsT.size() && i < data.obsD.size(); ++i) {
+        if (data.obsT[i] > 0 && data.obsD[i] > 0) { dT.append(data.obsT[i]); dD.append(data.obsD[i]); }
+    }
+    QVector<double> mT, mP, mD;
+    for (int i = 0; i < data.curveT.size(); ++i) {
+        if (data.curveT[i] > 0 && i < data.curveP.size() && data.curveP[i] > 0 && i < data.curveD.size() && data.curveD[i] > 0) {
+            mT.append(data.curveT[i]); mP.append(data.curveP[i]); mD.append(data.curveD[i]);
+        }
+    }
+    gObsP->setData(data.obsT, data.obsP);
+    gObsD->setData(dT, dD);
+    gModP->setData(mT, mP);
+    gModD->setData(mT, mD);
+
+    QSharedPointer<QCPAxisTicker> linTicker(new QCPAxisTicker);
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    auto setScale = [&](QCPAxis* axis, QCPAxis* axis2, bool logScale) {
+        axis->setScaleType(logScale ? QCPAxis::stLogarithmic : QCPAxis::stLinear);
+        axis2->setScaleType(axis->scaleType());
+        axis->setTicker(logScale ? QSharedPointer<QCPAxisTicker>(logTicker) : linTicker);
+        axis2->setTicker(axis->ticker());
+        axis->setNumberFormat(logScale ? "eb" : "g");
+        axis->setNumberPrecision(logScale ? 0 : 6);
+    };
+
+    data.images.clear();
+
+    // 图1：标准坐标 (只显实测压差)
+    gObsD->setVisible(false); gModP->setVisible(false); gModD->setVisible(false);
+    setScale(m_plot->xAxis, m_plot->xAxis2, false);
+    setScale(m_plot->yAxis, m_plot->yAxis2, false);
+    m_plot->rescaleAxes();
+    m_plot->yAxis->scaleRange(1.1);
+    data.images.append(m_plot->toPixmap(kImageWidth, kImageHeight).toImage());
+
+    // 图2：半对数 (只显实测压差)
+    setScale(m_plot->xAxis, m_plot->xAxis2, true);
+    m_plot->rescaleAxes();
+    if (m_plot->xAxis->range().lower <= 0) m_plot->xAxis->setRangeLower(1e-4);
+    m_plot->yAxis->scaleRange(1.1);
+    data.images.append(m_plot->toPixmap(kImageWidth, kImageHeight).toImage());
+
+    // 图3：双对数 (全显示)，优先使用分析中保存的视图范围
+    gObsD->setVisible(true); gModP->setVisible(true); gModD->setVisible(true);
+    setScale(m_plot->yAxis, m_plot->yAxis2, true);
+    if (data.hasView) {
+        m_plot->xAxis->setRange(data.xMin, data.xMax);
+        m_plot->yAxis->setRange(data.yMin, data.yMax);
+    } else {
+        m_plot->rescaleAxes();
+        if (m_plot->xAxis->range().lower <= 0) m_plot->xAxis->setRangeLower(1e-4);
+        if (m_plot->yAxis->range().lower <= 0) m_plot->yAxis->setRangeLower(1e-4);
+    }
+    data.images.append(m_plot->toPixmap(kImageWidth, kImageHeight).toImage());
+}
+
+// ============================================================================
+// 组装阶段 (工作线程)
+// ============================================================================
+
+QString FittingReportJob::assembleReport(QList<AnalysisData> analyses, const QString& wellName, const QString& filePath,
+                                         const std::atomic<bool>* cancel)
+{
+    TraceSpan span("FittingReportJob::assemble", "report", analyses.size());
+
+    QFileInfo fileInfo(filePath);
+    QString baseName = fileInfo.completeBaseName();
+    QString path = fileInfo.path();
+
+    // 已写出的文件；取消时删除，不留下不完整的报告
+    QStringList written;
+    auto cancelled = [&]() {
+        if (!cancel->load()) return false;
+        for (const QString& f : written) QFile::remove(f);
+        return true;
+    };
+    const QString cancelMessage = "报告生成已取消";
+
+    // 1. 所有图片并行编码
+    QVector<QImage> allImages;
+    for (const AnalysisData& d : analyses) allImages += d.images;
+    QList<QString> encoded = QtConcurrent::blockingMapped<QList<QString>>(allImages, imageToBase64);
+
+    // 2. 每个分析的完整数据表
+    for (int i = 0; i < analyses.size(); ++i) {
+        AnalysisData& d = analyses[i];
+        d.dataFileName = QString("%1_%2_%3_数据表.csv").arg(baseName).arg(i + 1).arg(safeFileName(d.name));
+        if (cancelled()) return cancelMessage;
+        QFile dataFile(path + "/" + d.dataFileName);
+        if (!dataFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return "无法写入数据文件:\n" + dataFile.fileName() + "\n" + dataFile.errorString();
+        }
+        written << dataFile.fileName();
+        dataFile.write("\xEF\xBB\xBF"); // BOM
+        QTextStream outData(&dataFile);
+        outData << "序号,时间(h),压差(MPa),压力导数(MPa)\n";
+        for (int k = 0; k < d.obsT.size(); ++k) {
+            outData << QString("%1,%2,%3,%4\n")
+                           .arg(k + 1)
+                           .arg(d.obsT[k])
+                           .arg(k < d.obsP.size() ? d.obsP[k] : 0.0)
+                           .arg(k < d.obsD.size() ? d.obsD[k] : 0.0);
+        }
+        dataFile.close();
+    }
+
+    // 3. 拼装文档
+    QString html = reportHtmlHead();
+    html += QString("<h1>%1整井试井解释报告</h1>").arg(wellName);
+    html += QString("<p><b>井名：</b>%1</p>").arg(wellName);
+    html += QString("<p><b>报告日期：</b>%1</p>").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd"));
+    html += QString("<p><b>分析数量：</b>%1</p>").arg(analyses.size());
+
+    html += "<h2>分析汇总</h2>";
+    html += "<table><tr><th width='8%'>序号</th><th width='27%'>分析名称</th><th width='35%'>解释模型</th><th width='15%'>数据点数</th><th width='15%'>MSE</th></tr>";
+    for (int i = 0; i < analyses.size(); ++i) {
+        const AnalysisData& d = analyses[i];
+        html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>")
+                    .arg(i + 1)
+                    .arg(d.name.toHtmlEscaped())
+                    .arg(ModelManager::getModelTypeName(d.modelType))
+                    .arg(d.obsT.size())
+                    .arg(d.mse >= 0 ? QString::number(d.mse, 'e', 3) : QString("-"));
+    }
+    html += "</table>";
+
+    int imageOffset = 0;
+    for (int i = 0; i < analyses.size(); ++i) {
+        const AnalysisData& d = analyses[i];
+        QStringList images = encoded.mid(imageOffset, d.images.size());
+        imageOffset += d.images.size();
+        html += buildAnalysisSection(d, i, images);
+    }
+
+    html += "<br/><hr/><p style='text-align:center; font-size:9pt; color:#888;'>报告来自PWT压力试井分析系统</p>";
+    html += "</body></html>";
+
+    if (cancelled()) return cancelMessage;
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return "无法保存报告文件:\n" + file.errorString();
+    }
+    written << filePath;
+    file.write("\xEF\xBB\xBF");
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+    out << html;
+    file.close();
+    if (cancelled()) return cancelMessage;
+    return QString();
+}
+
+/**
+ * @brief 生成单个分析的章节 (拟合曲线 + 拟合参数 + 默认参数)，每个分析另起一页
+ */
+QString FittingReportJob::buildAnalysisSection(const AnalysisData& data, int index, const QStringList& imagesBase64)
+{
+    static const char* captions[] = {
+        "标准坐标系压力历史图 (实测压差)",
+        "半对数坐标系压力历史图 (实测压差)",
+        "双对数拟合结果图"
+    };
+
+    QString html;
+    html += "<br class='page-break' />";
+    html += QString("<h2>%1、%2</h2>").arg(index + 1).arg(data.name.toHtmlEscaped());
+    html += QString("<p><b>解释模型：</b>%1</p>").arg(ModelManager::getModelTypeName(data.modelType));
+    html += QString("<p><b>数据文件：</b>%1</p>").arg(data.dataFileName);
+    html += QString("<p><b>拟合精度 (MSE)：</b>%1</p>").arg(data.mse >= 0 ? QString::number(data.mse, 'e', 3) : QString("-"));
+
+    for (int k = 0; k < imagesBase64.size() && k < 3; ++k) {
+        html += "<div class='img-box'>";
+        html += QString("<img src='data:image/png;base64,%1' width='500' /><br/>").arg(imagesBase64[k]);
+        html += QString("<div class='img-cap'>图%1-%2 %3</div>").arg(index + 1).arg(k + 1).arg(captions[k]);
+        html += "</div>";
+    }
+
+    QString fitParamRows;
+    QString defaultParamRows;
+    int idxFit = 1, idxDef = 1;
+    int fractureCount = 0;
+    for (const FitParameter& p : data.params) {
+        // 裂缝表参数不逐项列出，只在默认参数表末尾注明条数
+        if (ModelSolver01_06::isFractureTableKey(p.name)) {
+            if (p.name == ModelSolver01_06::FractureCountKey) fractureCount = (int)p.value;
+            continue;
+        }
+        QString chName, symbol, uniSym, unit;
+        FittingParameterChart::getParamDisplayInfo(p.name, chName, symbol, uniSym, unit);
+        if (unit == "无因次" || unit == "小数") unit = "-";
+
+        QString row = QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>")
+                          .arg(p.isFit ? idxFit++ : idxDef++)
+                          .arg(chName)
+                          .arg(uniSym)
+                          .arg(p.value, 0, 'g', 6)
+                          .arg(unit);
+        if (p.isFit) fitParamRows += row;
+        else defaultParamRows += row;
+    }
+    if (fractureCount > 0) {
+        defaultParamRows += QString("<tr><td>%1</td><td>裂缝表</td><td>-</td><td>%2 条 (非均匀位置与半长)</td><td>-</td></tr>")
+                                .arg(idxDef++).arg(fractureCount);
+    }
+
+    html += "<p><b>拟合参数：</b></p>";
+    html += fitParamRows.isEmpty() ? QString("<p>无拟合参数。</p>") : paramTableHeader() + fitParamRows + "</table>";
+    html += "<p><b>默认参数：</b></p>";
+    html += defaultParamRows.isEmpty() ? QString("<p>无默认参数。</p>") : paramTableHeader() + defaultParamRows + "</table>";
+    return html;
+}
+
+// ============================================================================
+// 报告公共部分
+// ============================================================================
+
+QString FittingReportJob::wellNameFromProject()
+{
+    QString wellName;
+    QString projectFilePath = ModelParameter::instance()->getProjectFilePath();
+
+    QFile pwtFile(projectFilePath);
+    if (pwtFile.exists() && pwtFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QJsonDocument doc = QJsonDocument::fromJson(pwtFile.readAll());
+        if (doc.isObject()) {
+            QJsonObject root = doc.object();
+            if (root.contains("wellName")) {
+                wellName = root["wellName"].toString();
+            } else if (root.contains("basicParams")) {
+                wellName = root["basicParams"].toObject()["wellName"].toString();
+            }
+        }
+        pwtFile.close();
+    }
+
+    // 读取失败时回退到项目文件名
+    if (wellName.isEmpty()) wellName = QFileInfo(projectFilePath).completeBaseName();
+    if (wellName.isEmpty()) wellName = "未命名井";
+    return wellName;
+}
+
+QString FittingReportJob::reportHtmlHead()
+{
+    QString html = "<html xmlns:o='urn:schemas-microsoft-com:office:office' xmlns:w='urn:schemas-microsoft-com:office:word' xmlns='http://www.w3.org/TR/REC-html40'>";
+    html += "<head><meta charset='utf-8'><title>Report</title>";
+    html += "<style>";
+
+    // 字体设置：西文 Times New Roman，中文 SimSun (宋体)；5号对应 10.5pt
+    html += "body { font-family: 'Times New Roman', 'SimSun'; font-size: 10.5pt; }";
+    html += "h1 { text-align: center; font-size: 16pt; font-weight: bold; margin: 20px 0; font-family: 'SimSun'; }";
+    html += "h2 { font-size: 14pt; font-weight: bold; margin-top: 15px; font-family: 'SimSun'; }";
+    html += "p { margin: 3px 0; line-height: 1.5; }";
+
+    // 表格样式
+    html += "table { border-collapse: collapse; width: 100%; margin: 5px 0; font-size: 10.5pt; }";
+    html += "th, td { border: 1px solid black; padding: 2px 4px; text-align: center; }";
+    html += "th { background-color: #f2f2f2; font-family: 'SimSun'; }";
+
+    html += ".img-box { text-align: center; margin: 10px 0; }";
+    html += ".img-cap { font-size: 9pt; font-weight: bold; margin-top: 2px; font-family: 'SimSun'; }";
+
+    // 分页符样式类
+    html += ".page-break { page-break-before: always; }";
+
+    html += "</style></head><body>";
+    return html;
+}
@@ -0,0 +1,111 @@
+/*
+ * 文件名: fittingreportjob.h
+ * 文件作用: 整井拟合报告后台生成任务头文件
+ * 功能描述:
+ * 1. 定义 ReportAnalysisInput：一个拟合分析页签的名称与状态快照 (FittingWidget::getJsonState 的结果)。
+ * 2. 声明 FittingReportJob：汇总任意多个拟合分析，生成一份整井报告 (Word 兼容 HTML + 每个分析的数据表 CSV)。
+ * 3. 流水线分三个阶段，全程不阻塞界面：
+ *    - 准备阶段 (线程池并行)：解析状态、以私有高精度求解器计算理论曲线与 MSE；
+ *    - 绘图阶段 (界面线程，逐个分析分片执行)：在隐藏的离屏图表上渲染三张图；
+ *    - 组装阶段 (线程池)：PNG 编码与 Base64 并行完成，拼装文档并写入文件。
+ * 4. 提供报告公共部分 (井名解析、样式表) 的静态函数，单分析报告与整井报告共用。
+ */
+
+#ifndef FITTINGREPORTJOB_H
+#define FITTINGREPORTJOB_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <QImage>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "fittingcore.h"
+
+class QCustomPlot;
+
+// 一个拟合分析的报告输入
+struct ReportAnalysisInput {
+    QString name;       // 页签名称
+    QJsonObject state;  // 分析状态快照
+};
+
+class FittingReportJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FittingReportJob(QObject *parent = nullptr);
+    ~FittingReportJob();
+
+    /**
+     * @brief 启动报告生成 (立即返回)
+     * @param wellName 井名 (报告标题)
+     * @param inputs 参与报告的分析列表
+     * @param filePath 报告文件路径 (.doc/.html)，数据表 CSV 写在同一目录
+     */
+    void start(const QString& wellName, const QList<ReportAnalysisInput>& inputs, const QString& filePath);
+
+    // 请求取消，当前阶段结束后以失败结束
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+
+    // 从当前项目文件解析井名 (根节点或 basicParams 中的 wellName，缺省时用文件名)
+    static QString wellNameFromProject();
+
+    // 报告 HTML 文档头 (Word 命名空间 + 样式表)，以 <body> 结尾
+    static QString reportHtmlHead();
+
+signals:
+    // 进度 (0-100) 与当前阶段说明
+    void progressChanged(int percent, const QString& stage);
+    // 完成：ok 为 false 时 message 为错误信息 (取消也视为失败)
+    void finished(bool ok, const QString& filePath, const QString& message);
+
+private:
+    // 单个分析在各阶段之间传递的数据
+    struct AnalysisData {
+        QString name;
+        ModelSolver01_06::ModelType modelType = ModelSolver01_06::Model_1;
+        QList<FitParameter> params;
+        QVector<double> obsT, obsP, obsD;
+        QVector<double> curveT, curveP, curveD;
+        bool hasView = false;           // 状态中保存了双对数视图范围
+        double xMin = 0, xMax = 0, yMin = 0, yMax = 0;
+        double mse = -1.0;              // 按拟合抽样计算的 MSE，无数据时为负
+        QVector<QImage> images;         // 标准坐标、半对数、双对数三张图
+        QString dataFileName;           // 数据表文件名
+    };
+
+    // 准备阶段：在工作线程中运行，不访问任何界面对象
+    static AnalysisData prepareAnalysis(const ReportAnalysisInput& input);
+    // 绘图阶段：每次事件循环渲染一个分析
+    void renderNext();
+    void renderAnalysis(AnalysisData& data);
+    void setupOffscreenPlot();
+    // 组装阶段：在工作线程中运行，返回错误信息 (空串表示成功)；
+    // 写文件前检查 cancel，已取消时不写出或删除已写出的文件
+    static QString assembleReport(QList<AnalysisData> analyses, const QString& wellName, const QString& filePath,
+                                  const std::atomic<bool>* cancel);
+    static QString buildAnalysisSection(const AnalysisData& data, int index, const QStringList& imagesBase64);
+
+    void finish(bool ok, const QString& message);
+
+    QString m_wellName;
+    QString m_filePath;
+    QList<ReportAnalysisInput> m_inputs;
+    QList<AnalysisData> m_analyses;
+    int m_renderIndex = 0;
+    bool m_running = false;
+    std::atomic<bool> m_cancelRequested{false};
+
+    QCustomPlot* m_plot = nullptr;  // 离屏图表 (仅界面线程使用)
+    QFutureWatcher<AnalysisData> m_prepareWatcher;
+    QFutureWatcher<QString> m_assembleWatcher;
+};
+
+#endif // FITTINGREPORTJOB_H
@@ -0,0 +1,109 @@
+/*
+ * 文件名: fittingresidualkernel.cpp
+ * 文件作用: 拟合残差计算核实现文件
+ * 功能描述:
+ * 1. 构造时一次性完成观测值取对数、有效性判断与权重合成。
+ * 2. evaluate 以 Eigen 数组表达式整段计算 (对数与掩码选择由 Eigen 向量化)，无逐点分支与 append。
+ * 3. 抽样密度权重按相邻点对数时间间距 (端点取单侧间距) 归一化得到。
+ */
+
+#include "fittingresidualkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kValueFloor = 1e-10;   // 压差/导数有效下限 (与原残差定义一致)
+const double kMaxDensityWeight = 20.0;
+}
+
+FittingResidualKernel::FittingResidualKernel(double weight, const QVector<double>& obsP, const QVector<double>& obsD,
+                                             const QVector<double>& pointWeights)
+{
+    m_pointCount = obsP.size();
+    m_derivCount = std::min(int(obsD.size()), m_pointCount);
+    const bool hasPointWeights = (pointWeights.size() == m_pointCount);
+    const double wp = weight;
+    const double wd = 1.0 - weight;
+
+    m_logObsP = Eigen::ArrayXd::Zero(m_pointCount);
+    m_validP = Eigen::ArrayXd::Zero(m_pointCount);
+    m_weightP = Eigen::ArrayXd::Constant(m_pointCount, wp);
+    m_logObsD = Eigen::ArrayXd::Zero(m_derivCount);
+    m_validD = Eigen::ArrayXd::Zero(m_derivCount);
+    m_weightD = Eigen::ArrayXd::Constant(m_derivCount, wd);
+
+    for (int i = 0; i < m_pointCount; ++i) {
+        double scale = hasPointWeights ? std::sqrt(std::max(0.0, pointWeights[i])) : 1.0;
+        if (obsP[i] > kValueFloor) {
+            m_logObsP[i] = std::log(obsP[i]);
+            m_validP[i] = 1.0;
+        }
+        m_weightP[i] *= scale;
+        if (i < m_derivCount) {
+            if (obsD[i] > kValueFloor) {
+                m_logObsD[i] = std::log(obsD[i]);
+                m_validD[i] = 1.0;
+            }
+            m_weightD[i] *= scale;
+        }
+    }
+}
+
+double FittingResidualKernel::evaluate(const ModelCurveData& curve, QVector<double>& out) const
+{
+    const QVector<double>& pCal = std::get<1>(curve);
+    const QVector<double>& dpCal = std::get<2>(curve);
+
+    const int count = std::min(m_pointCount, int(pCal.size()));
+    const int dCount = std::min(m_derivCount, std::min(int(dpCal.size()), count));
+    if (out.size() != count + dCount) out.resize(count + dCount);
+    if (count + dCount == 0) return 0.0;
+
+    Eigen::Map<const Eigen::ArrayXd> calP(pCal.constData(), count);
+    Eigen::Map<const Eigen::ArrayXd> calD(dpCal.constData(), dCount);
+    Eigen::Map<Eigen::ArrayXd> rP(out.data(), count);
+    Eigen::Map<Eigen::ArrayXd> rD(out.data() + count, dCount);
+
+    // 两侧都有效才计残差；理论值先截到下限再取对数，避免无效点产生 NaN
+    rP = ((calP > kValueFloor) && (m_validP.head(count) > 0.5))
+             .select((m_logObsP.head(count) - calP.max(kValueFloor).log()) * m_weightP.head(count), 0.0);
+    rD = ((calD > kValueFloor) && (m_validD.head(dCount) > 0.5))
+             .select((m_logObsD.head(dCount) - calD.max(kValueFloor).log()) * m_weightD.head(dCount), 0.0);
+
+    return rP.square().sum() + rD.square().sum();
+}
+
+QVector<double> FittingResidualKernel::samplingDensityWeights(const QVector<double>& t)
+{
+    const int n = t.size();
+    QVector<double> w(n, 1.0);
+    if (n < 3) return w;
+
+    QVector<double> logT(n);
+    for (int i = 0; i < n; ++i) {
+        if (!(t[i] > 0.0)) return w;
+        logT[i] = std::log10(t[i]);
+    }
+
+    // 每点代表的对数时间宽度：内部点取两侧间距的平均，端点取单侧间距
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (i == 0) w[i] = logT[1] - logT[0];
+        else if (i == n - 1) w[i] = logT[n - 1] - logT[n - 2];
+        else w[i] = 0.5 * (logT[i + 1] - logT[i - 1]);
+        w[i] = std::max(0.0, w[i]);
+        sum += w[i];
+    }
+    if (!(sum > 0.0)) return QVector<double>(n, 1.0);
+
+    // 归一化到均值 1，截断过大的孤立点权重后再次归一化
+    const double mean = sum / n;
+    sum = 0.0;
+    for (double& v : w) {
+        v = std::min(v / mean, kMaxDensityWeight);
+        sum += v;
+    }
+    for (double& v : w) v *= n / sum;
+    return w;
+}
@@ -0,0 +1,56 @@
+/*
+ * 文件名: fittingresidualkernel.h
+ * 文件作用: 拟合残差计算核头文件
+ * 功能描述:
+ * 1. FittingResidualKernel 每次拟合由抽样观测数据构造一次：预先计算观测压差/导数的对数、有效性掩码
+ *    (观测值 > 1e-10) 与逐点权重 (压差权重 wp 或导数权重 wd 乘以逐点权重的平方根)，以 Eigen 数组保存。
+ * 2. evaluate 对一条理论曲线向量化地一次算出全部残差 (取对数、掩码、加权) 写入调用方预分配的缓冲区，并返回 SSE。
+ * 3. 残差定义 (对数空间差值乘以权重)：观测值或理论值 <= 1e-10 的点残差为 0，
+ *    残差长度为 (压差段 + 导数段)，理论曲线较短时按曲线长度截断。
+ * 4. samplingDensityWeights：按对数时间间距给出逐点权重 (均值为 1)，自定义分段抽样各段点数不同时，
+ *    点密集的时间段不再主导拟合。
+ */
+
+#ifndef FITTINGRESIDUALKERNEL_H
+#define FITTINGRESIDUALKERNEL_H
+
+#include <QVector>
+#include <Eigen/Dense>
+
+#include "modelsolver01-06.h"
+
+class FittingResidualKernel
+{
+public:
+    FittingResidualKernel() = default;
+
+    /**
+     * @param weight       压差权重 (导数权重为 1 - weight)
+     * @param obsP/obsD    抽样后的观测压差与导数
+     * @param pointWeights 逐点权重 (作用于残差平方)，为空或长度与 obsP 不符时各点权重为 1
+     */
+    FittingResidualKernel(double weight, const QVector<double>& obsP, const QVector<double>& obsD,
+                          const QVector<double>& pointWeights = QVector<double>());
+
+    bool isEmpty() const { return m_pointCount == 0; }
+    // 理论曲线点数足够时的残差向量长度 (压差段 + 导数段)
+    int residualCount() const { return m_pointCount + m_derivCount; }
+
+    // 计算残差写入 out (长度不符时才重新分配)，返回残差平方和
+    double evaluate(const ModelCurveData& curve, QVector<double>& out) const;
+
+    // 按对数时间间距计算逐点权重：对数均匀的点权重均为 1，间距为平均值 k 倍的点权重为 k (上限 20)
+    static QVector<double> samplingDensityWeights(const QVector<double>& t);
+
+private:
+    int m_pointCount = 0;           // 压差段点数
+    int m_derivCount = 0;           // 导数段点数
+    Eigen::ArrayXd m_logObsP;       // 观测压差对数 (无效点为 0)
+    Eigen::ArrayXd m_validP;        // 观测压差有效性 (1/0)
+    Eigen::ArrayXd m_weightP;       // 压差段残差权重
+    Eigen::ArrayXd m_logObsD;
+    Eigen::ArrayXd m_validD;
+    Eigen::ArrayXd m_weightD;
+};
+
+#endif // FITTINGRESIDUALKERNEL_H
@@ -0,0 +1,242 @@
+/*
+ * 文件名: fittingsampler.cpp
+ * 文件作用: 信息密度自适应抽样实现文件
+ * 功能描述:
+ * 1. 分箱：log10(t) 等宽分箱，箱内取 log10(导数)、log10(压差) 的均值，空箱线性插值，再做 [1 2 1] 平滑。
+ * 2. 曲率项：平滑均值的二阶差分除以箱宽，即跨过一个箱的斜率变化 (压差曲线按一半计入)。
+ * 3. 噪声项：导数对数值相对平滑均值插值的残差，按箱求均方根。
+ * 4. 选点：密度累积分布的分位点 → 对数时间 → 在对数时间数组上二分查找最近的实测点。
+ */
+
+#include "fittingsampler.h"
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const double kValueFloor = 1e-10;   // 压差/导数有效下限 (与残差定义一致)
+
+// 有效点 (t > 0) 的对数时间与分箱信息
+struct LogGrid {
+    int first = 0;                  // 第一个 t > 0 的下标
+    std::vector<double> logT;       // logT[k] = log10(t[first + k])
+    double logMin = 0.0;
+    double logMax = 0.0;
+    int bins = 0;
+    double width = 0.0;
+
+    int binOf(int k) const { return std::min(bins - 1, std::max(0, int((logT[k] - logMin) / width))); }
+};
+
+bool buildGrid(const QVector<double>& t, const AdaptiveSamplingOptions& options, LogGrid& grid)
+{
+    grid.first = int(std::upper_bound(t.begin(), t.end(), 0.0) - t.begin());
+    const int m = t.size() - grid.first;
+    if (m < 2) return false;
+
+    grid.logT.resize(m);
+    for (int k = 0; k < m; ++k) grid.logT[k] = std::log10(t[grid.first + k]);
+    grid.logMin = grid.logT.front();
+    grid.logMax = grid.logT.back();
+    if (!(grid.logMax > grid.logMin)) return false;
+
+    grid.bins = options.bins > 0 ? options.bins : std::min(200, std::max(16, 2 * options.targetCount));
+    grid.width = (grid.logMax - grid.logMin) / grid.bins;
+    return true;
+}
+
+// 各箱 log10(v) 的平滑均值；没有任何有效值时返回空
+std::vector<double> smoothedBinMeans(const LogGrid& grid, const QVector<double>& v)
+{
+    const int B = grid.bins;
+    std::vector<double> sum(B, 0.0);
+    std::vector<int> count(B, 0);
+    for (int k = 0; k < (int)grid.logT.size(); ++k) {
+        int i = grid.first + k;
+        if (i >= v.size() || !(v[i] > kValueFloor)) continue;
+        int b = grid.binOf(k);
+        sum[b] += std::log10(v[i]);
+        count[b]++;
+    }
+
+    std::vector<double> mean(B, 0.0);
+    std::vector<int> filled;
+    for (int b = 0; b < B; ++b) {
+        if (count[b] > 0) { mean[b] = sum[b] / count[b]; filled.push_back(b); }
+    }
+    if (filled.empty()) return std::vector<double>();
+
+    // 空箱：两侧有值时线性插值，否则取最近的有值箱
+    for (int b = 0; b < B; ++b) {
+        if (count[b] > 0) continue;
+        auto it = std::lower_bound(filled.begin(), filled.end(), b);
+        if (it == filled.begin()) mean[b] = mean[*it];
+        else if (it == filled.end()) mean[b] = mean[filled.back()];
+        else {
+            int hi = *it, lo = *(it - 1);
+            mean[b] = mean[lo] + (mean[hi] - mean[lo]) * (b - lo) / double(hi - lo);
+        }
+    }
+
+    // 端箱外侧按线性外推补值，避免平滑在两端引入虚假弯曲
+    std::vector<double> smooth(B);
+    for (int b = 0; b < B; ++b) {
+        double left = (b > 0) ? mean[b - 1] : (B > 1 ? 2.0 * mean[0] - mean[1] : mean[0]);
+        double right = (b < B - 1) ? mean[b + 1] : (B > 1 ? 2.0 * mean[B - 1] - mean[B - 2] : mean[B - 1]);
+        smooth[b] = 0.25 * left + 0.5 * mean[b] + 0.25 * right;
+    }
+    return smooth;
+}
+
+// 跨过一个箱的斜率变化 |Δ²L| / 箱宽，端箱取相邻内部箱的值
+std::vector<double> slopeChange(const std::vector<double>& L, double width)
+{
+    const int B = L.size();
+    std::vector<double> c(B, 0.0);
+    if (B < 3) return c;
+    for (int b = 1; b < B - 1; ++b) c[b] = std::abs(L[b - 1] - 2.0 * L[b] + L[b + 1]) / width;
+    c[0] = c[1];
+    c[B - 1] = c[B - 2];
+    return c;
+}
+
+// 抽样密度 (均值为 1)；曲率与噪声均为零 (双对数直线) 时为均匀密度
+std::vector<double> computeDensity(const QVector<double>& p, const QVector<double>& d,
+                                   const AdaptiveSamplingOptions& options, const LogGrid& grid)
+{
+    const int B = grid.bins;
+    std::vector<double> info(B, 0.0);
+
+    std::vector<double> LD = smoothedBinMeans(grid, d);
+    std::vector<double> LP = smoothedBinMeans(grid, p);
+    if (!LD.empty()) {
+        std::vector<double> c = slopeChange(LD, grid.width);
+        for (int b = 0; b < B; ++b) info[b] += c[b];
+    }
+    if (!LP.empty()) {
+        std::vector<double> c = slopeChange(LP, grid.width);
+        for (int b = 0; b < B; ++b) info[b] += 0.5 * c[b];
+    }
+
+    // 噪声：导数对数值相对平滑均值 (按箱中心线性插值) 的残差均方根
+    if (!LD.empty() && options.noiseWeight > 0.0) {
+        std::vector<double> sq(B, 0.0);
+        std::vector<int> count(B, 0);
+        for (int k = 0; k < (int)grid.logT.size(); ++k) {
+            int i = grid.first + k;
+            if (i >= d.size() || !(d[i] > kValueFloor)) continue;
+            double x = (grid.logT[k] - grid.logMin) / grid.width - 0.5;
+            x = std::min(double(B - 1), std::max(0.0, x));
+            int b0 = std::min(B - 2, int(x));
+            double trend = (B > 1) ? LD[b0] + (LD[b0 + 1] - LD[b0]) * (x - b0) : LD[0];
+            double r = std::log10(d[i]) - trend;
+            int b = grid.binOf(k);
+            sq[b] += r * r;
+            count[b]++;
+        }
+        for (int b = 0; b < B; ++b) {
+            if (count[b] > 0) info[b] += options.noiseWeight * std::sqrt(sq[b] / count[b]);
+        }
+    }
+
+    double mean = 0.0;
+    for (double v : info) mean += v;
+    mean /= B;
+
+    const double floor = std::min(1.0, std::max(0.0, options.floorFraction));
+    std::vector<double> rho(B, 1.0);
+    if (mean > 1e-15) {
+        double total = 0.0;
+        for (int b = 0; b < B; ++b) {
+            double r = std::min(info[b] / mean, options.maxDensityRatio);
+            rho[b] = floor + (1.0 - floor) * r;
+            total += rho[b];
+        }
+        for (double& r : rho) r *= B / total;
+    }
+    return rho;
+}
+
+} // namespace
+
+QVector<int> AdaptiveSampler::selectIndices(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                            const AdaptiveSamplingOptions& options)
+{
+    QVector<int> indices;
+    LogGrid grid;
+    if (!buildGrid(t, options, grid)) {
+        for (int i = int(std::upper_bound(t.begin(), t.end(), 0.0) - t.begin()); i < t.size(); ++i) indices.append(i);
+        return indices;
+    }
+
+    const int m = grid.logT.size();
+    const int N = std::max(2, options.targetCount);
+    if (m <= N) {
+        for (int k = 0; k < m; ++k) indices.append(grid.first + k);
+        return indices;
+    }
+
+    PerfStageTimer perfTimer(PerfCounters::Stage_Sampling);
+    std::vector<double> rho = computeDensity(p, d, options, grid);
+    const int B = grid.bins;
+    std::vector<double> cumulative(B + 1, 0.0);
+    for (int b = 0; b < B; ++b) cumulative[b + 1] = cumulative[b] + rho[b];
+
+    std::vector<int> picked;
+    picked.reserve(N + 2);
+    picked.push_back(0);
+    picked.push_back(m - 1);
+    for (int k = 0; k < N; ++k) {
+        // 密度分位点 → 对数时间
+        double u = (k + 0.5) / N * cumulative[B];
+        int b = int(std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin()) - 1;
+        b = std::min(B - 1, std::max(0, b));
+        double frac = rho[b] > 0.0 ? (u - cumulative[b]) / rho[b] : 0.5;
+        double target = grid.logMin + (b + frac) * grid.width;
+
+        // 二分查找最近的实测点
+        int pos = int(std::lower_bound(grid.logT.begin(), grid.logT.end(), target) - grid.logT.begin());
+        if (pos >= m) pos = m - 1;
+        if (pos > 0 && target - grid.logT[pos - 1] < grid.logT[pos] - target) --pos;
+        picked.push_back(pos);
+    }
+    std::sort(picked.begin(), picked.end());
+    picked.erase(std::unique(picked.begin(), picked.end()), picked.end());
+
+    indices.reserve(picked.size());
+    for (int k : picked) indices.append(grid.first + k);
+    return indices;
+}
+
+void AdaptiveSampler::sample(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                             const AdaptiveSamplingOptions& options,
+                             QVector<double>& outT, QVector<double>& outP, QVector<double>& outD)
+{
+    const QVector<int> indices = selectIndices(t, p, d, options);
+    outT.resize(indices.size());
+    outP.resize(indices.size());
+    outD.resize(indices.size());
+    for (int k = 0; k < indices.size(); ++k) {
+        int i = indices[k];
+        outT[k] = t[i];
+        outP[k] = i < p.size() ? p[i] : 0.0;
+        outD[k] = i < d.size() ? d[i] : 0.0;
+    }
+}
+
+QVector<double> AdaptiveSampler::densityProfile(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                                const AdaptiveSamplingOptions& options, double& logMin, double& logMax)
+{
+    LogGrid grid;
+    if (!buildGrid(t, options, grid)) {
+        logMin = logMax = 0.0;
+        return QVector<double>();
+    }
+    logMin = grid.logMin;
+    logMax = grid.logMax;
+    std::vector<double> rho = computeDensity(p, d, options, grid);
+    return QVector<double>(rho.begin(), rho.end());
+}
@@ -0,0 +1,51 @@
+/*
+ * 文件名: fittingsampler.h
+ * 文件作用: 信息密度自适应抽样头文件
+ * 功能描述:
+ * 1. 在对数时间上分箱估计“信息密度”：导数 (及压差) 双对数曲线的局部曲率反映流动段转换，
+ *    去趋势后的箱内离散度反映噪声水平；两者之和归一化后与均匀保底密度混合。
+ * 2. 按密度的累积分布取目标点数个分位点，在预先计算的对数时间数组上二分查找最近的实测点，
+ *    转换段多取点、平台段少取点，首末点始终保留。
+ * 3. 与 FittingCore::getLogSampledData 的默认对数均匀抽样相比，同样的参数识别精度所需残差点数更少，
+ *    每次迭代的理论曲线计算 (拉普拉斯反演) 随之减少。
+ */
+
+#ifndef FITTINGSAMPLER_H
+#define FITTINGSAMPLER_H
+
+#include <QVector>
+
+// 自适应抽样设置
+struct AdaptiveSamplingOptions {
+    int targetCount = 60;           // 目标抽样点数
+    int bins = 0;                   // 密度估计的对数时间分箱数 (0：取 2 × 目标点数，限制在 [16, 200])
+    double floorFraction = 0.3;     // 均匀保底密度占比 (平台段仍保留的点数比例)
+    double noiseWeight = 1.0;       // 局部噪声 (对数残差均方根) 相对曲率的权重
+    double maxDensityRatio = 8.0;   // 单箱密度上限 (相对平均值)，避免孤立尖峰吸走全部点
+};
+
+class AdaptiveSampler
+{
+public:
+    /**
+     * @brief 选择抽样点
+     * @param t/p/d 按时间递增的实测时间、压差与导数 (t <= 0 的点不参与)
+     * @return 选中点的下标 (递增、无重复)；有效点数不超过目标点数时返回全部有效点
+     */
+    static QVector<int> selectIndices(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                      const AdaptiveSamplingOptions& options);
+
+    // 按 selectIndices 的结果输出抽样数据
+    static void sample(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                       const AdaptiveSamplingOptions& options,
+                       QVector<double>& outT, QVector<double>& outP, QVector<double>& outD);
+
+    /**
+     * @brief 各分箱的抽样密度 (均值为 1)，基准测试的自适应抽样拟合用例输出该分布
+     * @param logMin/logMax 输出分箱覆盖的 log10(t) 范围
+     */
+    static QVector<double> densityProfile(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                          const AdaptiveSamplingOptions& options, double& logMin, double& logMax);
+};
+
+#endif // FITTINGSAMPLER_H
@@ -0,0 +1,277 @@
+/*
+ * 文件名: fittinguncertainty.cpp
+ * 文件作用: 拟合参数不确定性分析实现文件
+ * 功能描述:
+ * 1. 在拟合参数处计算理论曲线，得到压差与导数的对数残差，估计噪声水平。
+ * 2. 每个重复拟合：以独立随机数流生成合成数据，使用私有低精度求解器 (与拟合时精度一致)
+ *    从拟合结果热启动 LM，关闭按 MSE 提前结束，使每组数据都真正收敛到各自的最优解。
+ * 3. 重复拟合通过 QtConcurrent::blockingMapped 分配到全部核心，结果按重复序号排列。
+ * 4. 汇总分位数、均值、标准差与相关系数矩阵。
+ */
+
+#include "fittinguncertainty.h"
+#include "tracerecorder.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <algorithm>
+
+namespace {
+
+// 单个重复拟合的结果
+struct ReplicateOutcome {
+    bool ok = false;
+    QVector<double> values;     // 各拟合参数的值
+};
+
+// 与 FittingCore 一致：正值且非 S/nf 的参数在对数空间更新
+bool isLogParam(const QString& name, double value)
+{
+    return value > 1e-12 && name != "S" && name != "nf";
+}
+
+double sampleStdDev(const QVector<double>& v, double mean)
+{
+    if (v.size() < 2) return 0.0;
+    double ss = 0.0;
+    for (double x : v) ss += (x - mean) * (x - mean);
+    return std::sqrt(ss / (v.size() - 1));
+}
+
+double vectorMean(const QVector<double>& v)
+{
+    if (v.isEmpty()) return 0.0;
+    return std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+}
+
+// 计算对数残差 ln(obs/cal)，仅取两者均为正的点
+QVector<double> logResiduals(const QVector<double>& obs, const QVector<double>& cal)
+{
+    QVector<double> r;
+    int n = qMin(obs.size(), cal.size());
+    r.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (obs[i] > 1e-10 && cal[i] > 1e-10) r.append(std::log(obs[i] / cal[i]));
+    }
+    return r;
+}
+
+// 在理论曲线上叠加噪声生成合成观测；理论值无效的点保留原观测值
+QVector<double> synthesize(const QVector<double>& obs, const QVector<double>& cal, const QVector<double>& residuals,
+                           double sigma, UncertaintyMethod method, std::mt19937_64& rng)
+{
+    QVector<double> out = obs;
+    if (residuals.isEmpty()) return out;
+
+    std::uniform_int_distribution<int> pick(0, residuals.size() - 1);
+    std::normal_distribution<double> gauss(0.0, sigma);
+    int n = qMin(obs.size(), cal.size());
+    for (int i = 0; i < n; ++i) {
+        if (cal[i] <= 1e-10) continue;
+        double e = (method == UncertaintyMethod::ResidualBootstrap) ? residuals[pick(rng)] : gauss(rng);
+        out[i] = cal[i] * std::exp(e);
+    }
+    return out;
+}
+
+} // namespace
+
+quint64 ParameterUncertainty::replicateSeed(quint64 seed, int index)
+{
+    quint64 z = seed + 0x9E3779B97F4A7C15ULL * (static_cast<quint64>(index) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double ParameterUncertainty::percentile(const QVector<double>& sorted, double q)
+{
+    if (sorted.isEmpty()) return 0.0;
+    if (sorted.size() == 1) return sorted.first();
+    double pos = qBound(0.0, q, 1.0) * (sorted.size() - 1);
+    int lo = static_cast<int>(std::floor(pos));
+    int hi = qMin(lo + 1, static_cast<int>(sorted.size()) - 1);
+    double frac = pos - lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+QString ParameterUncertainty::methodName(UncertaintyMethod method)
+{
+    switch (method) {
+    case UncertaintyMethod::ResidualBootstrap: return "残差重抽样 (Bootstrap)";
+    case UncertaintyMethod::NoisePerturbation: return "噪声扰动 (Monte-Carlo)";
+    }
+    return QString();
+}
+
+UncertaintyResult ParameterUncertainty::run(const UncertaintyInput& input, const UncertaintyOptions& options,
+                                            const std::atomic<bool>* cancel, const ProgressCallback& progress)
+{
+    TraceSpan span("ParameterUncertainty::run", "fit");
+    QElapsedTimer timer;
+    timer.start();
+
+    UncertaintyResult result;
+    result.options = options;
+
+    QVector<int> fitIndices;
+    for (int i = 0; i < input.params.size(); ++i) {
+        if (input.params[i].isFit && input.params[i].name != "LfD") fitIndices.append(i);
+    }
+    if (fitIndices.isEmpty()) {
+        result.message = "未选择拟合参数";
+        return result;
+    }
+    if (input.fitT.isEmpty()) {
+        result.message = "没有可用的拟合数据";
+        return result;
+    }
+    if (options.replicates < 2) {
+        result.message = "重复拟合次数至少为 2";
+        return result;
+    }
+
+    // 1. 拟合参数处的理论曲线与对数残差 (噪声模型)
+    QMap<QString, double> fittedMap;
+    for (const FitParameter& p : input.params) fittedMap.insert(p.name, p.value);
+    FittingCore::applyParamConstraints(fittedMap);
+
+    ModelSolver01_06 baseSolver(input.modelType);
+    baseSolver.setHighPrecision(false);
+    ModelCurveData baseCurve = baseSolver.calculateTheoreticalCurve(fittedMap, input.fitT);
+    const QVector<double>& calP = std::get<1>(baseCurve);
+    const QVector<double>& calD = std::get<2>(baseCurve);
+
+    QVector<double> resP = logResiduals(input.fitP, calP);
+    QVector<double> resD = logResiduals(input.fitD, calD);
+    if (resP.size() < 3) {
+        result.message = "有效残差点过少，无法估计噪声水平";
+        return result;
+    }
+
+    // 残差中心化：重抽样只反映离散程度，不引入整体偏移
+    double meanP = vectorMean(resP);
+    for (double& e : resP) e -= meanP;
+    double meanD = vectorMean(resD);
+    for (double& e : resD) e -= meanD;
+    result.noiseP = sampleStdDev(resP, 0.0);
+    result.noiseD = sampleStdDev(resD, 0.0);
+
+    // 2. 并行重复拟合
+    const int total = options.replicates;
+    std::atomic<int> finished{0};
+    QList<FitParameter> startParams = input.params;
+
+    std::function<ReplicateOutcome(int)> runReplicate = [&](int index) -> ReplicateOutcome {
+        ReplicateOutcome out;
+        if (cancel && cancel->load()) return out;
+        TraceSpan replicateSpan("ParameterUncertainty replicate", "fit", index);
+
+        std::mt19937_64 rng(replicateSeed(options.seed, index));
+        QVector<double> synP = synthesize(input.fitP, calP, resP, result.noiseP, options.method, rng);
+        QVector<double> synD = synthesize(input.fitD, calD, resD, result.noiseD, options.method, rng);
+
+        ModelSolver01_06 solver(input.modelType);
+        solver.setHighPrecision(false);
+        FittingCore core([&solver](FittingCore::ModelType, const QMap<QString, double>& params, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(params, t);
+        });
+        core.setMaxIterations(options.maxIterations);
+        core.setTargetMse(0.0);
+        core.setPointWeights(input.fitWeights);
+        if (cancel) core.setStopChecker([cancel]() { return cancel->load(); });
+
+        FittingResult fit = core.runLevenbergMarquardt(input.modelType, startParams, input.weight, input.fitT, synP, synD);
+        if (fit.success && !(cancel && cancel->load())) {
+            out.ok = true;
+            for (int idx : fitIndices) {
+                double v = fit.params.value(input.params[idx].name);
+                if (!std::isfinite(v)) out.ok = false;
+                out.values.append(v);
+            }
+        }
+
+        int done = ++finished;
+        if (progress) progress(done, total);
+        return out;
+    };
+
+    QVector<int> indices(total);
+    std::iota(indices.begin(), indices.end(), 0);
+    QVector<ReplicateOutcome> outcomes = QtConcurrent::blockingMapped<QVector<ReplicateOutcome>>(indices, runReplicate);
+
+    if (cancel && cancel->load()) {
+        result.message = "不确定性分析已取消";
+        return result;
+    }
+
+    for (const ReplicateOutcome& o : outcomes) {
+        if (o.ok) result.samples.append(o.values);
+    }
+    result.completed = result.samples.size();
+    result.failed = total - result.completed;
+    if (result.completed < 2) {
+        result.message = QString("有效的重复拟合仅 %1 次，无法统计").arg(result.completed);
+        return result;
+    }
+
+    // 3. 分位数与矩统计
+    const int nParams = fitIndices.size();
+    QVector<QVector<double>> columns(nParams);
+    for (const QVector<double>& row : result.samples) {
+        for (int j = 0; j < nParams; ++j) columns[j].append(row[j]);
+    }
+
+    for (int j = 0; j < nParams; ++j) {
+        const FitParameter& p = input.params[fitIndices[j]];
+        ParameterInterval iv;
+        iv.name = p.name;
+        iv.displayName = p.displayName;
+        iv.fitted = p.value;
+        QVector<double> sorted = columns[j];
+        std::sort(sorted.begin(), sorted.end());
+        iv.p10 = percentile(sorted, 0.10);
+        iv.p50 = percentile(sorted, 0.50);
+        iv.p90 = percentile(sorted, 0.90);
+        iv.mean = vectorMean(columns[j]);
+        iv.stdDev = sampleStdDev(columns[j], iv.mean);
+        result.intervals.append(iv);
+    }
+
+    // 4. 相关系数矩阵 (对数更新的参数取 log10，与拟合空间一致)
+    QVector<QVector<double>> transformed = columns;
+    for (int j = 0; j < nParams; ++j) {
+        bool useLog = isLogParam(result.intervals[j].name, result.intervals[j].fitted)
+                      && std::all_of(columns[j].begin(), columns[j].end(), [](double v) { return v > 0.0; });
+        if (useLog) {
+            for (double& v : transformed[j]) v = std::log10(v);
+        }
+    }
+    QVector<double> means(nParams), stds(nParams);
+    for (int j = 0; j < nParams; ++j) {
+        means[j] = vectorMean(transformed[j]);
+        stds[j] = sampleStdDev(transformed[j], means[j]);
+    }
+    result.correlation = QVector<QVector<double>>(nParams, QVector<double>(nParams, 0.0));
+    const int m = result.completed;
+    for (int a = 0; a < nParams; ++a) {
+        result.correlation[a][a] = 1.0;
+        for (int b = 0; b < a; ++b) {
+            double r = 0.0;
+            if (stds[a] > 0.0 && stds[b] > 0.0) {
+                double cov = 0.0;
+                for (int k = 0; k < m; ++k) cov += (transformed[a][k] - means[a]) * (transformed[b][k] - means[b]);
+                r = cov / (m - 1) / (stds[a] * stds[b]);
+            }
+            result.correlation[a][b] = r;
+            result.correlation[b][a] = r;
+        }
+    }
+
+    result.ok = true;
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
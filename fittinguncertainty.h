@@ -0,0 +1,99 @@
+/*
+ * 文件名: fittinguncertainty.h
+ * 文件作用: 拟合参数不确定性分析 (Bootstrap / 噪声扰动) 头文件
+ * 功能描述:
+ * 1. 以拟合结果为中心生成若干组合成观测数据：
+ *    - 残差重抽样 (Bootstrap)：对数空间残差有放回抽样后叠加到拟合曲线上；
+ *    - 噪声扰动：按残差估计的对数正态噪声水平，在拟合曲线上叠加随机噪声。
+ * 2. 每组数据从拟合结果出发 (热启动) 重新执行 LM 拟合，全部重复拟合在线程池中并行执行。
+ * 3. 每个重复拟合使用独立的随机数流 (由种子与重复序号确定)，结果与线程数、调度顺序无关，可复现。
+ * 4. 输出各拟合参数的 P10/P50/P90、均值、标准差及参数相关系数矩阵；支持取消。
+ * 5. [新增] 输入可带抽样点逐点权重 (fitWeights)，重复拟合、MCMC、目标函数地形与联合拟合的残差均按其加权。
+ */
+
+#ifndef FITTINGUNCERTAINTY_H
+#define FITTINGUNCERTAINTY_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+
+#include "fittingcore.h"
+
+// 合成数据的生成方式
+enum class UncertaintyMethod {
+    ResidualBootstrap,  // 残差重抽样
+    NoisePerturbation   // 对数正态噪声扰动
+};
+
+// 分析设置
+struct UncertaintyOptions {
+    UncertaintyMethod method = UncertaintyMethod::ResidualBootstrap;
+    int replicates = 200;           // 重复拟合次数
+    quint64 seed = 20260126;        // 随机种子 (相同种子与输入得到相同结果)
+    int maxIterations = 30;         // 每个重复拟合的最大 LM 迭代次数
+};
+
+// 分析输入 (拟合完成时的快照)
+struct UncertaintyInput {
+    ModelSolver01_06::ModelType modelType = ModelSolver01_06::Model_1;
+    QList<FitParameter> params;     // 参数表，value 为拟合结果 (作为热启动初值)
+    double weight = 0.5;            // 压差权重
+    QVector<double> fitT, fitP, fitD;   // 拟合所用的抽样数据
+    QVector<double> fitWeights;         // 抽样点逐点权重 (为空表示等权)
+};
+
+// 单个参数的统计区间
+struct ParameterInterval {
+    QString name;
+    QString displayName;
+    double fitted = 0.0;            // 原拟合值
+    double p10 = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double mean = 0.0;
+    double stdDev = 0.0;
+};
+
+// 分析结果
+struct UncertaintyResult {
+    bool ok = false;
+    QString message;                        // 失败或取消时的说明
+    UncertaintyOptions options;
+    int completed = 0;                      // 成功完成的重复拟合数
+    int failed = 0;                         // 失败 (曲线无效) 的重复拟合数
+    double noiseP = 0.0;                    // 估计的压差对数噪声标准差
+    double noiseD = 0.0;                    // 估计的导数对数噪声标准差
+    double elapsedMs = 0.0;
+    QVector<ParameterInterval> intervals;   // 按参数表顺序的拟合参数
+    QVector<QVector<double>> samples;       // 每个成功的重复拟合一行，列与 intervals 对应
+    QVector<QVector<double>> correlation;   // 相关系数矩阵 (对数更新的参数在 log10 空间计算)
+};
+
+class ParameterUncertainty
+{
+public:
+    // 进度回调：(已完成数, 总数)，在工作线程中调用
+    using ProgressCallback = std::function<void(int, int)>;
+
+    /**
+     * @brief 执行不确定性分析 (阻塞，应在工作线程中调用；内部在全局线程池中并行)
+     * @param cancel 非空时定期检查，置位后尽快返回 (ok 为 false)
+     */
+    static UncertaintyResult run(const UncertaintyInput& input, const UncertaintyOptions& options,
+                                 const std::atomic<bool>* cancel = nullptr,
+                                 const ProgressCallback& progress = ProgressCallback());
+
+    // 线性插值分位数 (sorted 需升序，q 取 0~1)
+    static double percentile(const QVector<double>& sorted, double q);
+
+    // 第 index 个重复拟合的随机数种子 (SplitMix64)，各流互不相关
+    static quint64 replicateSeed(quint64 seed, int index);
+
+    static QString methodName(UncertaintyMethod method);
+};
+
+#endif // FITTINGUNCERTAINTY_H
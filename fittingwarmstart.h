@@ -0,0 +1,46 @@
+/*
+ * 文件名: fittingwarmstart.h
+ * 文件作用: LM 拟合热启动状态头文件
+ * 功能描述:
+ * 1. 定义 FitWarmStart：一次拟合结束时的优化器状态 (最后被接受的阻尼系数/信赖域半径、
+ *    差分坐标下的雅可比矩阵及其线性化点、抽样数据摘要)，随分析状态保存。
+ * 2. 再次拟合时若模型、权重与抽样数据 (摘要) 相同，且参数值与线性化点一致 (参数表显示精度内)，
+ *    FittingCore 直接复用保存的雅可比各列与阻尼系数，只为新勾选的拟合参数计算差分列。
+ * 3. 上下限与上下限处理方式不参与匹配：雅可比按差分坐标 (log10 或线性) 保存，变换在使用时换算。
+ */
+
+#ifndef FITTINGWARMSTART_H
+#define FITTINGWARMSTART_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+struct FitWarmStart {
+    QString dataKey;                // 模型类型、权重、抽样数据与逐点权重的摘要
+    int stepStrategy = 0;           // 产生该状态的迭代步策略 (阻尼系数只在策略相同时复用)
+    double lambda = 0.0;            // 最后被接受的阻尼系数 (狗腿法为信赖域半径)
+    QMap<QString, double> params;   // 线性化点 (拟合结束时的全部参数)
+    QStringList names;              // 雅可比各列对应的参数
+    QVector<bool> logColumn;        // 各列的差分坐标是否为 log10
+    int residualCount = 0;          // 残差向量长度
+    QVector<double> jacobian;       // 雅可比矩阵，按 [残差][列] 顺序展开
+
+    bool isValid() const
+    {
+        return !dataKey.isEmpty() && !names.isEmpty() && logColumn.size() == names.size()
+               && residualCount > 0 && jacobian.size() == residualCount * names.size();
+    }
+    double entry(int k, int col) const { return jacobian[k * names.size() + col]; }
+
+    QJsonObject toJson() const;
+    static FitWarmStart fromJson(const QJsonObject& json);
+
+    // 拟合输入的摘要：与求解器版本、模型类型、压差权重、抽样数据及逐点权重逐位相关
+    static QString makeDataKey(int modelType, double weight, const QVector<double>& fitT, const QVector<double>& fitP,
+                               const QVector<double>& fitD, const QVector<double>& pointWeights);
+};
+
+#endif // FITTINGWARMSTART_H
@@ -0,0 +1,310 @@
+/*
+ * 文件名: flowsegmenter.cpp
+ * 文件作用: 长期压力计记录的流动段自动识别实现文件
+ * 功能描述:
+ * 1. PELT：按时间顺序推进，代价由前缀和 O(1) 得到，不可能成为最优的候选起点随即剪除，
+ *    有真实变点的记录中候选集合保持很小，整体近似线性。
+ * 2. 长记录先按块平均压缩到 maxPoints 以内；仅有压力时在块平均压力上求变化率，降低差分噪声。
+ * 3. 归类：产量序列按平均产量判断关井；仅有压力时按压力变化率的符号判断 (上升为压力恢复)。
+ * 4. 相邻同类段 (产量相近的生产段、连续的关井段) 合并后，边界在原始序列上细化：
+ *    产量取阶跃位置，仅有压力时关井取压力最低点、开井取压力最高点。
+ */
+
+#include "flowsegmenter.h"
+#include "timeseriesmerge.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kInf = std::numeric_limits<double>::infinity();
+const int kCancelCheckStride = 4096;
+
+// 一阶前缀和与二阶前缀和 (先减去均值以减小大数相消误差)
+struct PrefixSums {
+    QVector<double> s1, s2;
+
+    explicit PrefixSums(const QVector<double>& y)
+    {
+        const int n = y.size();
+        double mean = 0.0;
+        for (double v : y) mean += v;
+        if (n > 0) mean /= n;
+        s1.resize(n + 1);
+        s2.resize(n + 1);
+        s1[0] = s2[0] = 0.0;
+        for (int i = 0; i < n; ++i) {
+            double v = y[i] - mean;
+            s1[i + 1] = s1[i] + v;
+            s2[i + 1] = s2[i] + v * v;
+        }
+        m_mean = mean;
+    }
+
+    // 区间 [a, b) 的均值漂移代价 (残差平方和)
+    double cost(int a, int b) const
+    {
+        double sum = s1[b] - s1[a];
+        return (s2[b] - s2[a]) - sum * sum / (b - a);
+    }
+
+    double mean(int a, int b) const { return (s1[b] - s1[a]) / (b - a) + m_mean; }
+
+private:
+    double m_mean = 0.0;
+};
+
+double median(QVector<double> v)
+{
+    if (v.isEmpty()) return 0.0;
+    auto mid = v.begin() + v.size() / 2;
+    std::nth_element(v.begin(), mid, v.end());
+    return *mid;
+}
+
+bool isCancelled(const std::atomic<bool>* cancel)
+{
+    return cancel && cancel->load(std::memory_order_relaxed);
+}
+
+// 压力变化率序列 (按时间)，末点沿用前一点
+QVector<double> pressureSlope(const QVector<double>& t, const QVector<double>& p)
+{
+    const int n = p.size();
+    QVector<double> s(n, 0.0);
+    for (int i = 0; i + 1 < n; ++i) {
+        double dt = t[i + 1] - t[i];
+        s[i] = dt > 0.0 ? (p[i + 1] - p[i]) / dt : 0.0;
+    }
+    if (n >= 2) s[n - 1] = s[n - 2];
+    return s;
+}
+
+} // namespace
+
+QString FlowPeriod::typeName(Type type)
+{
+    return type == Buildup ? "压力恢复" : "压降";
+}
+
+double FlowPeriodSegmenter::robustNoise(const QVector<double>& y)
+{
+    if (y.size() < 3) return 0.0;
+    QVector<double> d(y.size() - 1);
+    for (int i = 0; i + 1 < y.size(); ++i) d[i] = y[i + 1] - y[i];
+    double med = median(d);
+    for (double& v : d) v = qAbs(v - med);
+    return 1.4826 * median(d) / M_SQRT2;
+}
+
+QVector<int> FlowPeriodSegmenter::detectChangePoints(const QVector<double>& y, double penalty, int minSize,
+                                                     const std::atomic<bool>* cancel)
+{
+    const int n = y.size();
+    minSize = qMax(1, minSize);
+    if (n < 2 * minSize) return QVector<int>{0};
+
+    PrefixSums sums(y);
+    QVector<double> F(n + 1, kInf);
+    QVector<int> last(n + 1, 0);
+    F[0] = -penalty;
+
+    QVector<int> candidates{0};
+    QVector<int> kept;
+    QVector<double> candidateCost;
+    for (int t = minSize; t <= n; ++t) {
+        if ((t & (kCancelCheckStride - 1)) == 0 && isCancelled(cancel)) return QVector<int>();
+
+        // 新候选起点 t - minSize (保证每段至少 minSize 点)
+        if (t - minSize >= minSize) candidates.append(t - minSize);
+
+        candidateCost.resize(candidates.size());
+        double best = kInf;
+        int bestTau = 0;
+        for (int k = 0; k < candidates.size(); ++k) {
+            int tau = candidates[k];
+            double c = F[tau] + sums.cost(tau, t);
+            candidateCost[k] = c;
+            if (c + penalty < best) { best = c + penalty; bestTau = tau; }
+        }
+        F[t] = best;
+        last[t] = bestTau;
+
+        // 剪枝：F(τ) + C(τ, t) > F(t) 的起点以后不可能最优
+        kept.clear();
+        for (int k = 0; k < candidates.size(); ++k) {
+            if (candidateCost[k] <= best) kept.append(candidates[k]);
+        }
+        candidates.swap(kept);
+    }
+
+    QVector<int> starts;
+    for (int t = n; t > 0; t = last[t]) starts.append(last[t]);
+    std::reverse(starts.begin(), starts.end());
+    if (starts.isEmpty() || starts.first() != 0) starts.prepend(0);
+    return starts;
+}
+
+FlowSegmentationResult FlowPeriodSegmenter::segment(const FlowSegmentationInput& input,
+                                                    const FlowSegmentationOptions& options,
+                                                    const std::atomic<bool>* cancel)
+{
+    FlowSegmentationResult result;
+    const QVector<double>& t = input.time;
+    const QVector<double>& p = input.pressure;
+    const int n = qMin(t.size(), p.size());
+    const int minPoints = qMax(2, options.minPoints);
+    if (n < 2 * minPoints) {
+        result.message = QString("数据点过少 (%1 点)，无法分段。").arg(n);
+        return result;
+    }
+    const int maxPoints = qMax(1, options.maxPoints);
+
+    // 1. 选择检测序列：有非零产量时直接在产量表 (自身时间轴) 上检测，否则在块平均压力的变化率上检测
+    const int m = qMin(input.rateTime.size(), input.rate.size());
+    double maxRate = 0.0;
+    for (int i = 0; i < m; ++i) maxRate = qMax(maxRate, qAbs(input.rate[i]));
+    result.usedRate = maxRate > 0.0;
+
+    const int seriesLength = result.usedRate ? m : n;
+    int block = qMax(1, (seriesLength + maxPoints - 1) / maxPoints);
+    if (!result.usedRate) block = qMax(block, qMax(1, options.slopeWindow));
+    auto blockMeans = [seriesLength, block](const QVector<double>& v) {
+        QVector<double> out;
+        out.reserve(seriesLength / block + 1);
+        for (int i = 0; i < seriesLength; i += block) {
+            const int e = qMin(seriesLength, i + block);
+            double sum = 0.0;
+            for (int k = i; k < e; ++k) sum += v[k];
+            out.append(sum / (e - i));
+        }
+        return out;
+    };
+    const QVector<double> reduced = result.usedRate ? blockMeans(input.rate)
+                                                    : pressureSlope(blockMeans(t), blockMeans(p));
+
+    // 2. 惩罚项：稳健噪声的平方乘以 ln(n)，噪声为零 (如阶梯产量表) 时取相对下限；
+    //    产量表每行都可能是一次变化，差分 MAD 会高估噪声，故不超过关井判定阈值
+    double sigma = robustNoise(reduced);
+    double scale = 0.0;
+    for (double v : reduced) scale = qMax(scale, qAbs(v));
+    if (result.usedRate) sigma = qMin(sigma, options.shutInRatio * maxRate);
+    sigma = qMax(sigma, 1e-3 * scale + 1e-12);
+    const double penalty = options.penaltyFactor * sigma * sigma * std::log(double(qMax(2, reduced.size())));
+    const int minSize = result.usedRate ? 1 : qMax(2, (minPoints + block - 1) / block);
+
+    const QVector<int> starts = detectChangePoints(reduced, penalty, minSize, cancel);
+    if (starts.isEmpty() || isCancelled(cancel)) {
+        result.message = "分段已取消。";
+        return result;
+    }
+
+    // 3. 在检测序列上归类，合并相邻同类段
+    struct Segment { int begin; int end; FlowPeriod::Type type; double level; };
+    const PrefixSums reducedSums(reduced);
+    QVector<Segment> segments;
+    for (int k = 0; k < starts.size(); ++k) {
+        const int b = starts[k];
+        const int e = k + 1 < starts.size() ? starts[k + 1] : reduced.size();
+        if (e <= b) continue;
+        const double level = reducedSums.mean(b, e);
+        FlowPeriod::Type type;
+        if (result.usedRate) type = qAbs(level) <= options.shutInRatio * maxRate ? FlowPeriod::Buildup : FlowPeriod::Drawdown;
+        else type = level > 0.0 ? FlowPeriod::Buildup : FlowPeriod::Drawdown;
+        if (!segments.isEmpty() && segments.last().type == type
+            && (!result.usedRate || type == FlowPeriod::Buildup
+                || qAbs(level - segments.last().level) <= options.shutInRatio * maxRate)) {
+            segments.last().end = e;
+            segments.last().level = reducedSums.mean(segments.last().begin, e);
+            continue;
+        }
+        segments.append({b, e, type, level});
+    }
+
+    // 4. 边界映射为压力序列索引：
+    //    产量在 ±block 内按两段代价最小定位阶跃，再取阶跃时刻之后的第一个压力点；
+    //    仅有压力时在相邻两段中点之间找压力阶跃最大的位置 (前后各 block 点均值之差，关井向上、开井向下)，
+    //    井筒储集使开关井后压力立即明显变化，阶跃比单点极值更不易受噪声影响
+    QVector<int> bounds;
+    bounds.append(0);
+    if (result.usedRate) {
+        const PrefixSums rateSums(input.rate.mid(0, m));
+        QVector<int> rb;
+        for (const Segment& s : segments) rb.append(qMin(m, s.begin * block));
+        rb.append(m);
+        for (int k = 1; k + 1 < rb.size(); ++k) {
+            const int lo = qMax(rb[k - 1] + 1, rb[k] - block);
+            const int hi = qMin(rb[k + 1] - 1, rb[k] + block);
+            double bestCost = kInf;
+            for (int b = lo; b <= hi; ++b) {
+                double c = rateSums.cost(rb[k - 1], b) + rateSums.cost(b, rb[k + 1]);
+                if (c < bestCost) { bestCost = c; rb[k] = b; }
+            }
+            const double changeTime = input.rateTime[rb[k]];
+            bounds.append(int(std::lower_bound(t.begin(), t.begin() + n, changeTime) - t.begin()));
+        }
+    } else {
+        const PrefixSums pressureSums(p.mid(0, n));
+        for (int k = 1; k < segments.size(); ++k) {
+            const int lo = qMax(block, (segments[k - 1].begin + segments[k - 1].end) / 2 * block);
+            const int hi = qMin(n - block, (segments[k].begin + segments[k].end) / 2 * block);
+            const double sign = segments[k].type == FlowPeriod::Buildup ? 1.0 : -1.0;
+            int best = qBound(lo, segments[k].begin * block, qMax(lo, hi));
+            double bestStep = -kInf;
+            for (int i = lo; i <= hi; ++i) {
+                double step = sign * (pressureSums.mean(i, i + block) - pressureSums.mean(i - block, i));
+                if (step > bestStep) { bestStep = step; best = i; }
+            }
+            bounds.append(best);
+        }
+    }
+    bounds.append(n);
+
+    // 5. 生成流动段；不足 minPoints 的段 (如产量表超出压力记录范围、过渡块) 并入前一段
+    const QVector<double> q = result.usedRate ? TimeSeriesMerger::alignTo(t.mid(0, n), input.rateTime, input.rate, MergeAlignMode::StepHold) : QVector<double>();
+    const PrefixSums qSums(q);
+    auto finalize = [&](FlowPeriod& period) {
+        period.startTime = t[period.startIndex];
+        period.endTime = t[period.endIndex];
+        period.pStart = p[period.startIndex];
+        period.pEnd = p[period.endIndex];
+        period.rate = (result.usedRate && period.type == FlowPeriod::Drawdown)
+                          ? qSums.mean(period.startIndex, period.endIndex + 1) : 0.0;
+    };
+    for (int k = 0; k < segments.size(); ++k) {
+        const int b = qMax(bounds[k], result.periods.isEmpty() ? 0 : result.periods.last().endIndex + 1);
+        const int e = bounds[k + 1] - 1;
+        if (e < b) continue;
+        if (e - b + 1 < minPoints && !result.periods.isEmpty()) {
+            result.periods.last().endIndex = e;
+            finalize(result.periods.last());
+            continue;
+        }
+        FlowPeriod period;
+        period.type = segments[k].type;
+        period.startIndex = b;
+        period.endIndex = e;
+        finalize(period);
+
+        // 并段后与前一段同类且产量相近时合并
+        if (!result.periods.isEmpty()) {
+            FlowPeriod& prev = result.periods.last();
+            if (prev.type == period.type
+                && (period.type == FlowPeriod::Buildup || qAbs(prev.rate - period.rate) <= options.shutInRatio * maxRate)) {
+                prev.endIndex = e;
+                finalize(prev);
+                continue;
+            }
+        }
+        result.periods.append(period);
+    }
+
+    result.ok = !result.periods.isEmpty();
+    result.message = QString("%1分段，识别出 %2 个流动段").arg(result.usedRate ? "按产量" : "按压力变化率").arg(result.periods.size());
+    if (block > 1) result.message += QString(" (检测序列 %1 点，按 %2 点一块平均后检测)").arg(seriesLength).arg(block);
+    result.message += "。";
+    return result;
+}
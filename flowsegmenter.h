@@ -0,0 +1,82 @@
+/*
+ * 文件名: flowsegmenter.h
+ * 文件作用: 长期压力计记录的流动段自动识别头文件
+ * 功能描述:
+ * 1. 定义 FlowPeriod：一个流动段 (生产/压降段或关井/压力恢复段) 的起止索引、起止时间、产量与起止压力。
+ * 2. 声明 FlowPeriodSegmenter：按时间顺序逐点推进的 PELT 变点检测 (均值漂移代价 + 候选剪枝)，
+ *    有产量数据时在产量序列上分段，否则在压力变化率序列上分段，再按关井/生产归类并合并相邻同类段。
+ * 3. 产量按压力时间对齐统一使用 TimeSeriesMerger (阶梯保持)。
+ */
+
+#ifndef FLOWSEGMENTER_H
+#define FLOWSEGMENTER_H
+
+#include <QVector>
+#include <QString>
+#include <atomic>
+
+// 一个流动段
+struct FlowPeriod {
+    enum Type { Drawdown = 0, Buildup };
+
+    Type type = Drawdown;
+    int startIndex = 0;     // 压力序列中的起始索引 (含)
+    int endIndex = 0;       // 压力序列中的结束索引 (含)
+    double startTime = 0.0;
+    double endTime = 0.0;
+    double rate = 0.0;      // 段内平均产量 (关井段为 0)
+    double pStart = 0.0;    // 起始压力 (压力恢复段即关井时刻井底流压)
+    double pEnd = 0.0;      // 结束压力
+
+    double duration() const { return endTime - startTime; }
+    int pointCount() const { return endIndex - startIndex + 1; }
+    static QString typeName(Type type);
+};
+
+// 分段输入：压力序列必须按时间升序；产量可为空
+struct FlowSegmentationInput {
+    QVector<double> time;
+    QVector<double> pressure;
+    QVector<double> rateTime;
+    QVector<double> rate;
+};
+
+// 分段参数
+struct FlowSegmentationOptions {
+    double penaltyFactor = 4.0;     // 惩罚项 β = penaltyFactor · σ² · ln(n)
+    int minPoints = 10;             // 每段最少点数
+    double shutInRatio = 0.01;      // 平均产量不超过最大产量的该比例视为关井
+    int maxPoints = 20000;          // 超过该点数时先按块平均压缩再检测
+    int slopeWindow = 10;           // 无产量时按该点数块平均后再计算压力变化率
+};
+
+struct FlowSegmentationResult {
+    bool ok = false;
+    bool usedRate = false;          // 是否按产量序列分段
+    QVector<FlowPeriod> periods;
+    QString message;                // 失败原因或分段说明
+};
+
+class FlowPeriodSegmenter
+{
+public:
+    /**
+     * @brief 自动识别流动段 (可在工作线程中调用)
+     * @param cancel 非空时定期检查，置位则返回失败结果
+     */
+    static FlowSegmentationResult segment(const FlowSegmentationInput& input,
+                                          const FlowSegmentationOptions& options = FlowSegmentationOptions(),
+                                          const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief PELT 均值漂移变点检测
+     * @return 各段起始索引 (首元素恒为 0)，取消时返回空
+     */
+    static QVector<int> detectChangePoints(const QVector<double>& y, double penalty, int minSize,
+                                           const std::atomic<bool>* cancel = nullptr);
+
+    // 稳健噪声估计：一阶差分的 MAD / √2
+    static double robustNoise(const QVector<double>& y);
+};
+
+#endif // FLOWSEGMENTER_H
@@ -0,0 +1,330 @@
+/*
+ * 文件名: fracturehmatrix.cpp
+ * 文件作用: 多裂缝影响矩阵的层次矩阵压缩与迭代求解实现文件
+ * 功能描述:
+ * 1. 聚类树按裂缝数二分 (排序后的连续下标区间)，叶节点不超过 leafSize 条裂缝。
+ * 2. 远场块用部分选主元 ACA：逐次取残差行/列，秩达到块尺寸一半仍未收敛时改为稠密块。
+ * 3. 内部向量均按排序后的裂缝顺序存放，对外接口使用原始裂缝序号。
+ * 4. GMRES 使用修正 Gram-Schmidt 与 Givens 旋转，每次重启后以真实残差判断收敛。
+ */
+
+#include "fracturehmatrix.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+FractureHMatrix::FractureHMatrix(const QVector<double>& centers, const QVector<double>& halfLengths,
+                                 const EntryFunc& entry, const Options& options)
+    : m_n(centers.size()), m_options(options)
+{
+    if (m_n == 0) return;
+
+    m_order.resize(m_n);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(), [&](int a, int b) { return centers[a] < centers[b]; });
+
+    int root = buildCluster(0, m_n, centers, halfLengths);
+    buildBlocks(root, root, entry);
+
+    // 对角叶块的 LU 分解作为块对角预条件
+    for (const Block& block : m_blocks) {
+        if (block.lowRank || block.row != block.col) continue;
+        m_diagLu.emplace_back(block.dense);
+        m_diagCluster.push_back(block.row);
+    }
+}
+
+int FractureHMatrix::buildCluster(int begin, int end, const QVector<double>& centers, const QVector<double>& halfLengths)
+{
+    Cluster c;
+    c.begin = begin;
+    c.end = end;
+    c.lo = centers[m_order[begin]] - std::abs(halfLengths[m_order[begin]]);
+    c.hi = centers[m_order[begin]] + std::abs(halfLengths[m_order[begin]]);
+    for (int k = begin + 1; k < end; ++k) {
+        int idx = m_order[k];
+        c.lo = std::min(c.lo, centers[idx] - std::abs(halfLengths[idx]));
+        c.hi = std::max(c.hi, centers[idx] + std::abs(halfLengths[idx]));
+    }
+
+    int id = (int)m_clusters.size();
+    m_clusters.push_back(c);
+    if (end - begin > m_options.leafSize) {
+        int mid = begin + (end - begin) / 2;
+        int left = buildCluster(begin, mid, centers, halfLengths);
+        int right = buildCluster(mid, end, centers, halfLengths);
+        m_clusters[id].left = left;
+        m_clusters[id].right = right;
+    }
+    return id;
+}
+
+bool FractureHMatrix::admissible(const Cluster& a, const Cluster& b) const
+{
+    double dist = std::max(a.lo, b.lo) - std::min(a.hi, b.hi);
+    if (dist <= 0.0) return false;
+    double diam = std::min(a.hi - a.lo, b.hi - b.lo);
+    return dist >= m_options.eta * diam;
+}
+
+void FractureHMatrix::buildBlocks(int row, int col, const EntryFunc& entry)
+{
+    const Cluster& r = m_clusters[row];
+    const Cluster& c = m_clusters[col];
+    bool rowLeaf = (r.left < 0);
+    bool colLeaf = (c.left < 0);
+
+    if (row != col && admissible(r, c)) {
+        Block block;
+        block.row = row;
+        block.col = col;
+        if (acaBlock(block, entry)) {
+            block.lowRank = true;
+            m_stats.lowRankBlocks++;
+            m_stats.maxRank = std::max(m_stats.maxRank, (int)block.U.cols());
+        } else {
+            denseBlock(block, entry);
+        }
+        m_blocks.push_back(std::move(block));
+        return;
+    }
+
+    if (rowLeaf && colLeaf) {
+        Block block;
+        block.row = row;
+        block.col = col;
+        denseBlock(block, entry);
+        m_blocks.push_back(std::move(block));
+        return;
+    }
+
+    const int rowChildren[2] = { rowLeaf ? row : r.left, rowLeaf ? -1 : r.right };
+    const int colChildren[2] = { colLeaf ? col : c.left, colLeaf ? -1 : c.right };
+    for (int rc : rowChildren) {
+        if (rc < 0) continue;
+        for (int cc : colChildren) {
+            if (cc < 0) continue;
+            buildBlocks(rc, cc, entry);
+        }
+    }
+}
+
+double FractureHMatrix::entryAt(const EntryFunc& entry, int i, int j)
+{
+    m_stats.entriesEvaluated++;
+    return entry(m_order[i], m_order[j]);
+}
+
+void FractureHMatrix::denseBlock(Block& block, const EntryFunc& entry)
+{
+    const Cluster& r = m_clusters[block.row];
+    const Cluster& c = m_clusters[block.col];
+    block.lowRank = false;
+    block.U.resize(0, 0);
+    block.V.resize(0, 0);
+    block.dense.resize(r.end - r.begin, c.end - c.begin);
+    for (int i = r.begin; i < r.end; ++i) {
+        for (int j = c.begin; j < c.end; ++j) {
+            block.dense(i - r.begin, j - c.begin) = entryAt(entry, i, j);
+        }
+    }
+    m_stats.denseBlocks++;
+}
+
+/**
+ * @brief 部分选主元 ACA
+ * * 每步取一行残差，选其最大元素为主元列，再取该列残差；下一行取新列残差绝对值最大的未用行。
+ * * 以 ‖u‖‖v‖ <= acaTol × ‖S‖_F (逐步更新的 Frobenius 范数估计) 为收敛判据。
+ * @return false 表示秩超过块尺寸一半，调用方改为稠密块
+ */
+bool FractureHMatrix::acaBlock(Block& block, const EntryFunc& entry)
+{
+    const Cluster& r = m_clusters[block.row];
+    const Cluster& c = m_clusters[block.col];
+    const int m = r.end - r.begin;
+    const int n = c.end - c.begin;
+    const int maxRank = std::max(1, std::min(m, n) / 2);
+
+    std::vector<Eigen::VectorXd> us, vs;
+    std::vector<bool> usedRow(m, false);
+    double normS2 = 0.0;
+    int iStar = 0;
+
+    while (true) {
+        Eigen::VectorXd row(n);
+        for (int j = 0; j < n; ++j) row(j) = entryAt(entry, r.begin + iStar, c.begin + j);
+        for (size_t k = 0; k < us.size(); ++k) row -= us[k](iStar) * vs[k];
+        usedRow[iStar] = true;
+
+        int jStar = 0;
+        double pivot = row.cwiseAbs().maxCoeff(&jStar);
+        if (pivot > 0.0 && std::isfinite(pivot)) {
+            Eigen::VectorXd v = row / row(jStar);
+            Eigen::VectorXd u(m);
+            for (int i = 0; i < m; ++i) u(i) = entryAt(entry, r.begin + i, c.begin + jStar);
+            for (size_t k = 0; k < us.size(); ++k) u -= vs[k](jStar) * us[k];
+
+            double uv2 = u.squaredNorm() * v.squaredNorm();
+            for (size_t k = 0; k < us.size(); ++k) normS2 += 2.0 * us[k].dot(u) * vs[k].dot(v);
+            normS2 += uv2;
+            us.push_back(u);
+            vs.push_back(v);
+
+            if (std::sqrt(uv2) <= m_options.acaTol * std::sqrt(std::max(normS2, 0.0))) break;
+            if ((int)us.size() >= maxRank) return false;
+
+            double best = -1.0;
+            int next = -1;
+            for (int i = 0; i < m; ++i) {
+                if (!usedRow[i] && std::abs(u(i)) > best) { best = std::abs(u(i)); next = i; }
+            }
+            if (next < 0) break;
+            iStar = next;
+        } else {
+            // 残差行为零：换下一未用行，全部用完则结束
+            int next = -1;
+            for (int i = 0; i < m; ++i) {
+                if (!usedRow[i]) { next = i; break; }
+            }
+            if (next < 0) break;
+            iStar = next;
+        }
+    }
+
+    block.U.resize(m, (int)us.size());
+    block.V.resize(n, (int)vs.size());
+    for (size_t k = 0; k < us.size(); ++k) {
+        block.U.col((int)k) = us[k];
+        block.V.col((int)k) = vs[k];
+    }
+    return true;
+}
+
+// 原始裂缝顺序与排序后顺序之间的置换
+static Eigen::VectorXd permute(const Eigen::VectorXd& x, const std::vector<int>& order, bool toSorted)
+{
+    Eigen::VectorXd y(x.size());
+    for (int k = 0; k < (int)order.size(); ++k) {
+        if (toSorted) y(k) = x(order[k]);
+        else y(order[k]) = x(k);
+    }
+    return y;
+}
+
+Eigen::VectorXd FractureHMatrix::multiply(const Eigen::VectorXd& x) const
+{
+    Eigen::VectorXd xs = permute(x, m_order, true);
+    Eigen::VectorXd ys = Eigen::VectorXd::Zero(m_n);
+    for (const Block& block : m_blocks) {
+        const Cluster& r = m_clusters[block.row];
+        const Cluster& c = m_clusters[block.col];
+        auto xSeg = xs.segment(c.begin, c.end - c.begin);
+        if (block.lowRank) {
+            if (block.U.cols() > 0) ys.segment(r.begin, r.end - r.begin) += block.U * (block.V.transpose() * xSeg);
+        } else {
+            ys.segment(r.begin, r.end - r.begin) += block.dense * xSeg;
+        }
+    }
+    return permute(ys, m_order, false);
+}
+
+Eigen::VectorXd FractureHMatrix::applyPreconditioner(const Eigen::VectorXd& x) const
+{
+    Eigen::VectorXd xs = permute(x, m_order, true);
+    for (size_t k = 0; k < m_diagLu.size(); ++k) {
+        const Cluster& c = m_clusters[m_diagCluster[k]];
+        xs.segment(c.begin, c.end - c.begin) = m_diagLu[k].solve(xs.segment(c.begin, c.end - c.begin));
+    }
+    return permute(xs, m_order, false);
+}
+
+/**
+ * @brief 右预条件重启 GMRES：求解 (A·M⁻¹)·u = b，x = M⁻¹·u
+ */
+bool FractureHMatrix::solve(const Eigen::VectorXd& b, Eigen::VectorXd& x)
+{
+    x = Eigen::VectorXd::Zero(m_n);
+    m_stats.converged = false;
+    const double bNorm = b.norm();
+    if (m_n == 0 || bNorm == 0.0) {
+        m_stats.converged = true;
+        return true;
+    }
+
+    const int restart = std::max(1, std::min(m_options.restart, m_n));
+    const double target = m_options.gmresTol * bNorm;
+    Eigen::VectorXd r = b;
+    double beta = bNorm;
+
+    while (m_stats.gmresIterations < m_options.maxIterations) {
+        Eigen::MatrixXd V(m_n, restart + 1);
+        Eigen::MatrixXd H = Eigen::MatrixXd::Zero(restart + 1, restart);
+        Eigen::VectorXd cs = Eigen::VectorXd::Zero(restart);
+        Eigen::VectorXd sn = Eigen::VectorXd::Zero(restart);
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(restart + 1);
+        V.col(0) = r / beta;
+        g(0) = beta;
+
+        int steps = 0;
+        for (int k = 0; k < restart && m_stats.gmresIterations < m_options.maxIterations; ++k) {
+            Eigen::VectorXd w = multiply(applyPreconditioner(V.col(k)));
+            for (int i = 0; i <= k; ++i) {
+                H(i, k) = w.dot(V.col(i));
+                w -= H(i, k) * V.col(i);
+            }
+            H(k + 1, k) = w.norm();
+            bool breakdown = (H(k + 1, k) <= 1e-300);
+            if (!breakdown) V.col(k + 1) = w / H(k + 1, k);
+
+            for (int i = 0; i < k; ++i) {
+                double t = cs(i) * H(i, k) + sn(i) * H(i + 1, k);
+                H(i + 1, k) = -sn(i) * H(i, k) + cs(i) * H(i + 1, k);
+                H(i, k) = t;
+            }
+            double denom = std::hypot(H(k, k), H(k + 1, k));
+            cs(k) = denom > 0.0 ? H(k, k) / denom : 1.0;
+            sn(k) = denom > 0.0 ? H(k + 1, k) / denom : 0.0;
+            H(k, k) = denom;
+            H(k + 1, k) = 0.0;
+            g(k + 1) = -sn(k) * g(k);
+            g(k) = cs(k) * g(k);
+
+            steps = k + 1;
+            m_stats.gmresIterations++;
+            if (std::abs(g(k + 1)) <= target || breakdown) break;
+        }
+        if (steps == 0) break;
+
+        Eigen::VectorXd y = H.topLeftCorner(steps, steps).triangularView<Eigen::Upper>().solve(g.head(steps));
+        x += applyPreconditioner(V.leftCols(steps) * y);
+
+        r = b - multiply(x);
+        beta = r.norm();
+        if (!std::isfinite(beta)) return false;
+        if (beta <= target) {
+            m_stats.converged = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+Eigen::MatrixXd FractureHMatrix::toDense() const
+{
+    Eigen::MatrixXd sorted = Eigen::MatrixXd::Zero(m_n, m_n);
+    for (const Block& block : m_blocks) {
+        const Cluster& r = m_clusters[block.row];
+        const Cluster& c = m_clusters[block.col];
+        if (block.lowRank) {
+            if (block.U.cols() > 0) sorted.block(r.begin, c.begin, r.end - r.begin, c.end - c.begin) = block.U * block.V.transpose();
+        } else {
+            sorted.block(r.begin, c.begin, r.end - r.begin, c.end - c.begin) = block.dense;
+        }
+    }
+    Eigen::MatrixXd out(m_n, m_n);
+    for (int i = 0; i < m_n; ++i) {
+        for (int j = 0; j < m_n; ++j) out(m_order[i], m_order[j]) = sorted(i, j);
+    }
+    return out;
+}
@@ -0,0 +1,102 @@
+/*
+ * 文件名: fracturehmatrix.h
+ * 文件作用: 多裂缝影响矩阵的层次矩阵 (H-矩阵) 压缩与迭代求解头文件
+ * 功能描述:
+ * 1. 按裂缝中心位置排序并二分建立聚类树，每个聚类记录其覆盖区间 (中心 ± 半长)。
+ * 2. 相距足够远的聚类对 (距离 >= eta × 较小直径) 为远场块，用部分选主元自适应交叉逼近 (ACA)
+ *    只计算 O(k(m+n)) 个元素得到低秩分解 U·Vᵀ；其余叶块直接稠密计算。
+ * 3. 以对角叶块的 LU 分解为块对角预条件，用重启 GMRES (右预条件) 求解 A·y = b；
+ *    不收敛时由调用方回退到稠密求解。
+ * 4. 不依赖具体物理模型：矩阵元素由回调给出，ModelSolver01_06 在裂缝条数较多时使用。
+ */
+
+#ifndef FRACTUREHMATRIX_H
+#define FRACTUREHMATRIX_H
+
+#include <QVector>
+#include <functional>
+#include <vector>
+#include <Eigen/Dense>
+
+class FractureHMatrix
+{
+public:
+    // 矩阵元素回调：(观测裂缝 i, 源裂缝 j) -> A(i, j)，下标为原始裂缝序号
+    using EntryFunc = std::function<double(int, int)>;
+
+    struct Options {
+        int leafSize = 16;          // 聚类树叶节点最大裂缝数 (也是块对角预条件的块大小)
+        double eta = 0.5;           // 远场判据：距离 >= eta × 较小聚类直径
+        double acaTol = 1e-8;       // ACA 相对截断误差
+        double gmresTol = 1e-10;    // GMRES 相对残差
+        int restart = 40;           // GMRES 重启步数
+        int maxIterations = 100;    // GMRES 最大迭代次数 (累计)
+    };
+
+    struct Stats {
+        int entriesEvaluated = 0;   // 实际计算的矩阵元素个数
+        int denseBlocks = 0;
+        int lowRankBlocks = 0;
+        int maxRank = 0;
+        int gmresIterations = 0;
+        bool converged = false;
+    };
+
+    /**
+     * @param centers     各裂缝中心位置 (无因次)
+     * @param halfLengths 各裂缝半长 (无因次)
+     * @param entry       矩阵元素回调 (构造期间调用，之后不再使用)
+     */
+    FractureHMatrix(const QVector<double>& centers, const QVector<double>& halfLengths,
+                    const EntryFunc& entry, const Options& options);
+
+    int size() const { return m_n; }
+    const Stats& stats() const { return m_stats; }
+
+    // y = A·x (原始裂缝序号)
+    Eigen::VectorXd multiply(const Eigen::VectorXd& x) const;
+
+    // 求解 A·x = b；返回是否收敛 (迭代次数计入 stats)
+    bool solve(const Eigen::VectorXd& b, Eigen::VectorXd& x);
+
+    // 展开为稠密矩阵 (低秩块按分解结果)，供回退求解
+    Eigen::MatrixXd toDense() const;
+
+private:
+    struct Cluster {
+        int begin = 0;              // 排序后下标区间 [begin, end)
+        int end = 0;
+        double lo = 0.0;            // 覆盖区间
+        double hi = 0.0;
+        int left = -1;              // 子聚类 (叶节点为 -1)
+        int right = -1;
+    };
+
+    struct Block {
+        int row = 0;                // 行聚类 / 列聚类
+        int col = 0;
+        bool lowRank = false;
+        Eigen::MatrixXd dense;      // 稠密块
+        Eigen::MatrixXd U;          // 低秩块 U·Vᵀ
+        Eigen::MatrixXd V;
+    };
+
+    int buildCluster(int begin, int end, const QVector<double>& centers, const QVector<double>& halfLengths);
+    void buildBlocks(int row, int col, const EntryFunc& entry);
+    bool admissible(const Cluster& a, const Cluster& b) const;
+    double entryAt(const EntryFunc& entry, int i, int j);
+    void denseBlock(Block& block, const EntryFunc& entry);
+    bool acaBlock(Block& block, const EntryFunc& entry);
+    Eigen::VectorXd applyPreconditioner(const Eigen::VectorXd& x) const;
+
+    int m_n = 0;
+    Options m_options;
+    Stats m_stats;
+    std::vector<int> m_order;       // 排序后第 k 个位置对应的原始裂缝序号
+    std::vector<Cluster> m_clusters;
+    std::vector<Block> m_blocks;
+    std::vector<Eigen::PartialPivLU<Eigen::MatrixXd>> m_diagLu;  // 对角叶块 LU (预条件)
+    std::vector<int> m_diagCluster; // 对应叶聚类
+};
+
+#endif // FRACTUREHMATRIX_H
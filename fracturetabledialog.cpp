@@ -0,0 +1,205 @@
+/*
+ * 文件名: fracturetabledialog.cpp
+ * 文件作用: 非均匀裂缝表编辑对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建；表格两列 (位置、半长)，行号即裂缝序号。
+ * 2. 粘贴时每行取前两个数值 (位置、半长)，只有一列时半长取当前 Lf；无法解析的行 (如表头) 跳过。
+ * 3. 确定时校验：至少一条裂缝、数值有效且半长大于零。
+ */
+
+#include "fracturetabledialog.h"
+#include "modelsolver01-06.h"
+
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QApplication>
+#include <QClipboard>
+#include <QRegularExpression>
+#include <algorithm>
+
+FractureTableDialog::FractureTableDialog(const QVector<double>& positions, const QVector<double>& halfLengths,
+                                         int nf, double L, double Lf, QWidget* parent)
+    : QDialog(parent), m_nf(std::max(1, nf)), m_L(L), m_Lf(Lf)
+{
+    setWindowTitle("裂缝表 (非均匀裂缝位置与半长)");
+    resize(460, 560);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QLabel* hint = new QLabel(QString("每行一条裂缝。位置为裂缝中心沿水平井的坐标 (m)，半长为单翼缝长 (m)。\n"
+                                      "裂缝条数达到 %1 条时自动使用快速求解 (远场低秩压缩 + GMRES)。")
+                                  .arg(ModelSolver01_06::HMatrixMinFractures), this);
+    hint->setWordWrap(true);
+    mainLayout->addWidget(hint);
+
+    m_table = new QTableWidget(0, 2, this);
+    m_table->setHorizontalHeaderLabels({"位置 (m)", "半长 (m)"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    mainLayout->addWidget(m_table, 1);
+
+    QHBoxLayout* editLayout = new QHBoxLayout();
+    QPushButton* btnAdd = new QPushButton("添加", this);
+    QPushButton* btnRemove = new QPushButton("删除所选", this);
+    QPushButton* btnUniform = new QPushButton("均匀布置", this);
+    btnUniform->setToolTip(QString("按当前参数生成 %1 条半长 %2 m 的均匀裂缝").arg(m_nf).arg(m_Lf));
+    QPushButton* btnPaste = new QPushButton("粘贴", this);
+    btnPaste->setToolTip("从剪贴板粘贴两列数据 (位置、半长)，替换当前表格");
+    QPushButton* btnClear = new QPushButton("清空", this);
+    btnClear->setToolTip("清空后确定即恢复均匀等长裂缝");
+    editLayout->addWidget(btnAdd);
+    editLayout->addWidget(btnRemove);
+    editLayout->addWidget(btnUniform);
+    editLayout->addWidget(btnPaste);
+    editLayout->addWidget(btnClear);
+    mainLayout->addLayout(editLayout);
+
+    m_recenter = new QCheckBox("位置按沿井筒测深录入，确定时以压裂段中点为原点重新居中", this);
+    mainLayout->addWidget(m_recenter);
+    m_summary = new QLabel(this);
+    mainLayout->addWidget(m_summary);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    QPushButton* btnOk = new QPushButton("确定", this);
+    QPushButton* btnCancel = new QPushButton("取消", this);
+    btnLayout->addWidget(btnOk);
+    btnLayout->addWidget(btnCancel);
+    mainLayout->addLayout(btnLayout);
+
+    connect(btnAdd, &QPushButton::clicked, this, &FractureTableDialog::onAddRow);
+    connect(btnRemove, &QPushButton::clicked, this, &FractureTableDialog::onRemoveRows);
+    connect(btnUniform, &QPushButton::clicked, this, &FractureTableDialog::onUniform);
+    connect(btnPaste, &QPushButton::clicked, this, &FractureTableDialog::onPaste);
+    connect(btnClear, &QPushButton::clicked, this, [this]() { m_table->setRowCount(0); updateSummary(); });
+    connect(btnOk, &QPushButton::clicked, this, &FractureTableDialog::accept);
+    connect(btnCancel, &QPushButton::clicked, this, &FractureTableDialog::reject);
+    connect(m_table, &QTableWidget::itemChanged, this, &FractureTableDialog::updateSummary);
+
+    setRows(positions, halfLengths);
+}
+
+void FractureTableDialog::setRows(const QVector<double>& positions, const QVector<double>& halfLengths)
+{
+    m_table->blockSignals(true);
+    m_table->setRowCount(0);
+    for (int i = 0; i < positions.size() && i < halfLengths.size(); ++i) appendRow(positions[i], halfLengths[i]);
+    m_table->blockSignals(false);
+    updateSummary();
+}
+
+void FractureTableDialog::appendRow(double position, double halfLength)
+{
+    int row = m_table->rowCount();
+    m_table->insertRow(row);
+    m_table->setItem(row, 0, new QTableWidgetItem(QString::number(position, 'g', 8)));
+    m_table->setItem(row, 1, new QTableWidgetItem(QString::number(halfLength, 'g', 8)));
+}
+
+void FractureTableDialog::onAddRow()
+{
+    double position = 0.0;
+    if (m_table->rowCount() > 0) {
+        QTableWidgetItem* last = m_table->item(m_table->rowCount() - 1, 0);
+        position = (last ? last->text().toDouble() : 0.0) + (m_L > 0 ? 1.8 * m_L / std::max(1, m_nf - 1) : 50.0);
+    }
+    m_table->blockSignals(true);
+    appendRow(position, m_Lf);
+    m_table->blockSignals(false);
+    updateSummary();
+}
+
+void FractureTableDialog::onRemoveRows()
+{
+    QList<int> rows;
+    for (const QModelIndex& idx : m_table->selectionModel()->selectedRows()) rows.append(idx.row());
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    for (int row : rows) m_table->removeRow(row);
+    updateSummary();
+}
+
+/**
+ * @brief 生成与模型默认布置相同的均匀裂缝：中心在 [-0.9L, 0.9L] 等距分布
+ */
+void FractureTableDialog::onUniform()
+{
+    QVector<double> positions, halfLengths;
+    for (int i = 0; i < m_nf; ++i) {
+        positions.append(m_nf == 1 ? 0.0 : (-0.9 + 1.8 * i / (m_nf - 1)) * m_L);
+        halfLengths.append(m_Lf);
+    }
+    m_recenter->setChecked(false);
+    setRows(positions, halfLengths);
+}
+
+void FractureTableDialog::onPaste()
+{
+    const QStringList lines = QApplication::clipboard()->text().split(QRegularExpression("[\r\n]+"), Qt::SkipEmptyParts);
+    QVector<double> positions, halfLengths;
+    for (const QString& line : lines) {
+        const QStringList cells = line.split(QRegularExpression("[\t,;\\s]+"), Qt::SkipEmptyParts);
+        bool okX = false, okL = true;
+        double x = cells.value(0).toDouble(&okX);
+        double half = cells.size() > 1 ? cells.value(1).toDouble(&okL) : m_Lf;
+        if (!okX || !okL) continue;
+        positions.append(x);
+        halfLengths.append(half);
+    }
+    if (positions.isEmpty()) {
+        QMessageBox::warning(this, "粘贴", "剪贴板中没有可识别的数值 (每行: 位置, 半长)。");
+        return;
+    }
+    setRows(positions, halfLengths);
+}
+
+void FractureTableDialog::updateSummary()
+{
+    int rows = m_table->rowCount();
+    if (rows == 0) {
+        m_summary->setText(QString("表格为空：确定后恢复均匀布置 (%1 条等长裂缝)。").arg(m_nf));
+        return;
+    }
+    double lo = 0.0, hi = 0.0;
+    for (int r = 0; r < rows; ++r) {
+        QTableWidgetItem* item = m_table->item(r, 0);
+        double x = item ? item->text().toDouble() : 0.0;
+        if (r == 0 || x < lo) lo = x;
+        if (r == 0 || x > hi) hi = x;
+    }
+    m_summary->setText(QString("共 %1 条裂缝，位置范围 %2 ~ %3 m；确定后参数 nf 将设为 %1。")
+                           .arg(rows).arg(lo, 0, 'g', 6).arg(hi, 0, 'g', 6));
+}
+
+void FractureTableDialog::accept()
+{
+    QVector<double> positions, halfLengths;
+    for (int r = 0; r < m_table->rowCount(); ++r) {
+        QTableWidgetItem* itemX = m_table->item(r, 0);
+        QTableWidgetItem* itemL = m_table->item(r, 1);
+        bool okX = false, okL = false;
+        double x = itemX ? itemX->text().toDouble(&okX) : 0.0;
+        double half = itemL ? itemL->text().toDouble(&okL) : 0.0;
+        if (!okX || !okL || half <= 0.0) {
+            QMessageBox::warning(this, "裂缝表", QString("第 %1 行数值无效 (位置需为数值，半长需大于 0)。").arg(r + 1));
+            m_table->selectRow(r);
+            return;
+        }
+        positions.append(x);
+        halfLengths.append(half);
+    }
+
+    if (m_recenter->isChecked() && !positions.isEmpty()) {
+        auto range = std::minmax_element(positions.begin(), positions.end());
+        double center = 0.5 * (*range.first + *range.second);
+        for (double& x : positions) x -= center;
+    }
+
+    m_positions = positions;
+    m_halfLengths = halfLengths;
+    QDialog::accept();
+}
@@ -0,0 +1,61 @@
+/*
+ * 文件名: fracturetabledialog.h
+ * 文件作用: 非均匀裂缝表编辑对话框头文件
+ * 功能描述:
+ * 1. 逐条编辑裂缝中心位置与半长 (m)，可增删行、按当前 nf/L/Lf 生成均匀布置、从剪贴板粘贴 (Excel 两列)。
+ * 2. 位置可按沿井筒测深录入，确定时按压裂段中点重新居中 (模型以压裂段中点为原点)。
+ * 3. 清空表格后确定即恢复均匀等长裂缝。
+ */
+
+#ifndef FRACTURETABLEDIALOG_H
+#define FRACTURETABLEDIALOG_H
+
+#include <QDialog>
+#include <QVector>
+
+class QTableWidget;
+class QCheckBox;
+class QLabel;
+
+class FractureTableDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    /**
+     * @param positions   已有裂缝表的中心位置 (m，相对压裂段中点)，为空表示当前为均匀布置
+     * @param halfLengths 已有裂缝表的半长 (m)
+     * @param nf/L/Lf     当前参数表中的裂缝条数、参考长度与缝半长，用于生成均匀布置
+     */
+    FractureTableDialog(const QVector<double>& positions, const QVector<double>& halfLengths,
+                        int nf, double L, double Lf, QWidget* parent = nullptr);
+
+    // 确定后的裂缝表 (为空表示恢复均匀布置)
+    QVector<double> positions() const { return m_positions; }
+    QVector<double> halfLengths() const { return m_halfLengths; }
+
+protected:
+    void accept() override;
+
+private slots:
+    void onAddRow();
+    void onRemoveRows();
+    void onUniform();
+    void onPaste();
+    void updateSummary();
+
+private:
+    void setRows(const QVector<double>& positions, const QVector<double>& halfLengths);
+    void appendRow(double position, double halfLength);
+
+    int m_nf;
+    double m_L;
+    double m_Lf;
+    QVector<double> m_positions;
+    QVector<double> m_halfLengths;
+
+    QTableWidget* m_table = nullptr;
+    QCheckBox* m_recenter = nullptr;
+    QLabel* m_summary = nullptr;
+};
+
+#endif // FRACTURETABLEDIALOG_H
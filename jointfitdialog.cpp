@@ -0,0 +1,280 @@
+/*
+ * 文件名: jointfitdialog.cpp
+ * 文件作用: 多分析联合拟合对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建；参数表为所选分析中勾选拟合参数的并集，切换分析时保留已做的共享/独立选择。
+ * 2. 拟合在 QtConcurrent 线程中运行，进度经信号排队回到界面线程；拟合中关闭对话框会先停止并等待。
+ * 3. 某参数只出现在一个分析中时仍可设为共享，此时等同于该分析的独立参数。
+ */
+
+#include "jointfitdialog.h"
+
+#include <QtConcurrent>
+#include <QListWidget>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QGroupBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+
+namespace {
+
+QString fmt(double v)
+{
+    return QString::number(v, 'g', 5);
+}
+
+} // namespace
+
+JointFitDialog::JointFitDialog(const QVector<JointFitDataset>& datasets, bool highPrecision, QWidget* parent)
+    : QDialog(parent), m_datasets(datasets), m_highPrecision(highPrecision)
+{
+    setWindowTitle("联合拟合 (共享参数)");
+    resize(760, 680);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QHBoxLayout* topLayout = new QHBoxLayout();
+
+    QGroupBox* analysisBox = new QGroupBox("参与拟合的分析", this);
+    QVBoxLayout* analysisLayout = new QVBoxLayout(analysisBox);
+    m_analysisList = new QListWidget(analysisBox);
+    for (const JointFitDataset& ds : m_datasets) {
+        QListWidgetItem* item = new QListWidgetItem(ds.name, m_analysisList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Checked);
+    }
+    analysisLayout->addWidget(m_analysisList);
+    topLayout->addWidget(analysisBox, 1);
+
+    QGroupBox* paramBox = new QGroupBox("拟合参数 (勾选“共享”的参数在各分析间取同一值)", this);
+    QVBoxLayout* paramLayout = new QVBoxLayout(paramBox);
+    m_paramTable = new QTableWidget(0, 3, paramBox);
+    m_paramTable->setHorizontalHeaderLabels({"参数", "所在分析数", "共享"});
+    m_paramTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_paramTable->verticalHeader()->setVisible(false);
+    m_paramTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    paramLayout->addWidget(m_paramTable);
+    topLayout->addWidget(paramBox, 2);
+    mainLayout->addLayout(topLayout, 1);
+
+    QHBoxLayout* runLayout = new QHBoxLayout();
+    runLayout->addWidget(new QLabel("最大迭代次数:", this));
+    m_maxIterations = new QSpinBox(this);
+    m_maxIterations->setRange(1, 500);
+    m_maxIterations->setValue(50);
+    runLayout->addWidget(m_maxIterations);
+    m_progress = new QProgressBar(this);
+    m_progress->setRange(0, 100);
+    m_progress->setValue(0);
+    runLayout->addWidget(m_progress, 1);
+    m_btnStart = new QPushButton("开始联合拟合", this);
+    runLayout->addWidget(m_btnStart);
+    mainLayout->addLayout(runLayout);
+
+    m_status = new QLabel("勾选至少两个分析后开始拟合。", this);
+    m_status->setWordWrap(true);
+    mainLayout->addWidget(m_status);
+
+    m_resultTable = new QTableWidget(this);
+    m_resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    mainLayout->addWidget(m_resultTable, 2);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    m_btnApply = new QPushButton("应用到各分析", this);
+    m_btnApply->setEnabled(false);
+    QPushButton* btnClose = new QPushButton("关闭", this);
+    btnLayout->addWidget(m_btnApply);
+    btnLayout->addWidget(btnClose);
+    mainLayout->addLayout(btnLayout);
+
+    connect(m_analysisList, &QListWidget::itemChanged, this, &JointFitDialog::refreshParamTable);
+    connect(m_btnStart, &QPushButton::clicked, this, &JointFitDialog::onStartStop);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(btnClose, &QPushButton::clicked, this, &JointFitDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<JointFitResult>::finished, this, &JointFitDialog::onFinished);
+    connect(this, &JointFitDialog::progressChanged, this, &JointFitDialog::onProgress, Qt::QueuedConnection);
+
+    refreshParamTable();
+}
+
+JointFitDialog::~JointFitDialog()
+{
+    m_cancel = true;
+    m_watcher.waitForFinished();
+}
+
+void JointFitDialog::reject()
+{
+    m_cancel = true;
+    m_watcher.waitForFinished();
+    QDialog::reject();
+}
+
+QVector<JointFitDataset> JointFitDialog::selectedDatasets() const
+{
+    QVector<JointFitDataset> out;
+    for (int i = 0; i < m_analysisList->count(); ++i) {
+        if (m_analysisList->item(i)->checkState() == Qt::Checked) out.append(m_datasets[i]);
+    }
+    return out;
+}
+
+/**
+ * @brief 按所选分析重建参数表，已有行保留共享选择，新行按默认规则 (井相关参数独立)
+ */
+void JointFitDialog::refreshParamTable()
+{
+    QMap<QString, bool> previous;
+    for (int r = 0; r < m_paramTable->rowCount(); ++r) {
+        previous.insert(m_paramTable->item(r, 0)->data(Qt::UserRole).toString(),
+                        m_paramTable->item(r, 2)->checkState() == Qt::Checked);
+    }
+
+    QStringList names;
+    QMap<QString, QString> displayNames;
+    QMap<QString, int> counts;
+    for (const JointFitDataset& ds : selectedDatasets()) {
+        for (const FitParameter& p : ds.input.params) {
+            if (!p.isFit || p.name == "LfD") continue;
+            if (!names.contains(p.name)) {
+                names.append(p.name);
+                displayNames.insert(p.name, p.displayName.isEmpty() ? p.name : p.displayName);
+            }
+            counts[p.name]++;
+        }
+    }
+
+    const QStringList localDefaults = JointFitting::defaultLocalParams();
+    m_paramTable->setRowCount(names.size());
+    for (int r = 0; r < names.size(); ++r) {
+        const QString& name = names[r];
+        QTableWidgetItem* nameItem = new QTableWidgetItem(QString("%1 (%2)").arg(displayNames.value(name), name));
+        nameItem->setData(Qt::UserRole, name);
+        m_paramTable->setItem(r, 0, nameItem);
+        QTableWidgetItem* countItem = new QTableWidgetItem(QString::number(counts.value(name)));
+        countItem->setTextAlignment(Qt::AlignCenter);
+        m_paramTable->setItem(r, 1, countItem);
+        QTableWidgetItem* sharedItem = new QTableWidgetItem();
+        sharedItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+        bool shared = previous.contains(name) ? previous.value(name) : !localDefaults.contains(name);
+        sharedItem->setCheckState(shared ? Qt::Checked : Qt::Unchecked);
+        m_paramTable->setItem(r, 2, sharedItem);
+    }
+}
+
+void JointFitDialog::onStartStop()
+{
+    if (m_watcher.isRunning()) {
+        m_cancel = true;
+        m_btnStart->setEnabled(false);
+        return;
+    }
+
+    QVector<JointFitDataset> datasets = selectedDatasets();
+    if (datasets.size() < 2) {
+        QMessageBox::warning(this, "联合拟合", "请至少勾选两个分析。");
+        return;
+    }
+    JointFitOptions options;
+    for (int r = 0; r < m_paramTable->rowCount(); ++r) {
+        if (m_paramTable->item(r, 2)->checkState() == Qt::Checked) {
+            options.sharedParams.append(m_paramTable->item(r, 0)->data(Qt::UserRole).toString());
+        }
+    }
+    options.maxIterations = m_maxIterations->value();
+    options.highPrecision = m_highPrecision;
+
+    m_cancel = false;
+    m_btnStart->setText("停止");
+    m_btnApply->setEnabled(false);
+    m_analysisList->setEnabled(false);
+    m_paramTable->setEnabled(false);
+    m_progress->setValue(0);
+    m_status->setText("联合拟合中...");
+
+    m_watcher.setFuture(QtConcurrent::run([this, datasets, options]() {
+        return JointFitting::run(datasets, options, &m_cancel, [this](int iteration, int maxIterations, double mse) {
+            emit progressChanged(iteration, maxIterations, mse);
+        });
+    }));
+}
+
+void JointFitDialog::onProgress(int iteration, int maxIterations, double mse)
+{
+    m_progress->setValue(maxIterations > 0 ? iteration * 100 / maxIterations : 0);
+    m_status->setText(QString("第 %1 次迭代，总 MSE = %2").arg(iteration).arg(fmt(mse)));
+}
+
+void JointFitDialog::onFinished()
+{
+    m_btnStart->setText("开始联合拟合");
+    m_btnStart->setEnabled(true);
+    m_analysisList->setEnabled(true);
+    m_paramTable->setEnabled(true);
+
+    JointFitResult result = m_watcher.result();
+    if (!result.success) {
+        m_status->setText(result.errorMessage);
+        QMessageBox::warning(this, "联合拟合", result.errorMessage);
+        return;
+    }
+    m_progress->setValue(100);
+    m_result = result;
+    showResult(result);
+    m_btnApply->setEnabled(true);
+}
+
+void JointFitDialog::showResult(const JointFitResult& result)
+{
+    const int K = result.datasetNames.size();
+    QStringList rows = result.sharedNames;
+    for (const QStringList& locals : result.localNames) {
+        for (const QString& name : locals) {
+            if (!rows.contains(name)) rows.append(name);
+        }
+    }
+
+    m_resultTable->clear();
+    m_resultTable->setColumnCount(K);
+    m_resultTable->setRowCount(rows.size() + 1);
+    m_resultTable->setHorizontalHeaderLabels(result.datasetNames);
+    QStringList rowLabels;
+    for (const QString& name : rows) {
+        rowLabels.append(result.sharedNames.contains(name) ? QString("%1 (共享)").arg(name) : name);
+    }
+    rowLabels.append("MSE");
+    m_resultTable->setVerticalHeaderLabels(rowLabels);
+
+    for (int r = 0; r < rows.size(); ++r) {
+        const bool shared = result.sharedNames.contains(rows[r]);
+        for (int k = 0; k < K; ++k) {
+            bool fitted = shared ? result.datasetParams[k].contains(rows[r]) : result.localNames[k].contains(rows[r]);
+            QTableWidgetItem* item = new QTableWidgetItem(fitted ? fmt(result.datasetParams[k].value(rows[r])) : "-");
+            item->setTextAlignment(Qt::AlignCenter);
+            if (shared) {
+                QFont f = item->font();
+                f.setBold(true);
+                item->setFont(f);
+            }
+            m_resultTable->setItem(r, k, item);
+        }
+    }
+    for (int k = 0; k < K; ++k) {
+        QTableWidgetItem* item = new QTableWidgetItem(fmt(result.datasetMse[k]));
+        item->setTextAlignment(Qt::AlignCenter);
+        m_resultTable->setItem(rows.size(), k, item);
+    }
+
+    m_status->setText(QString("完成：%1 次迭代，总 MSE = %2；未知数 %3 个 (共享 %4 个)，残差 %5 个，理论曲线计算 %6 次，耗时 %7 s")
+                          .arg(result.iterations).arg(fmt(result.mse))
+                          .arg(result.unknownCount).arg(result.sharedNames.size())
+                          .arg(result.residualCount).arg(result.residualEvaluations)
+                          .arg(result.elapsedMs / 1000.0, 0, 'f', 2));
+}
@@ -0,0 +1,75 @@
+/*
+ * 文件名: jointfitdialog.h
+ * 文件作用: 多分析联合拟合对话框头文件
+ * 功能描述:
+ * 1. 勾选参与联合拟合的单分析，并在参数表中逐个指定共享/独立 (默认 S、cD、Lf 等井相关参数独立)。
+ * 2. 后台执行联合拟合 (fittingjoint.h)，显示迭代进度，可中途停止。
+ * 3. 结果表按“参数 × 分析”列出最终值，共享参数整行相同并加粗，末行为各分析 MSE；
+ *    点击“应用到各分析”后由调用方把结果写回各分析页签。
+ */
+
+#ifndef JOINTFITDIALOG_H
+#define JOINTFITDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "fittingjoint.h"
+
+class QListWidget;
+class QTableWidget;
+class QSpinBox;
+class QPushButton;
+class QProgressBar;
+class QLabel;
+
+class JointFitDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    /**
+     * @param datasets 各单分析的快照 (均已加载观测数据)
+     * @param highPrecision 模型计算精度
+     */
+    JointFitDialog(const QVector<JointFitDataset>& datasets, bool highPrecision, QWidget* parent = nullptr);
+    ~JointFitDialog() override;
+
+    // 最近一次成功的联合拟合结果
+    JointFitResult result() const { return m_result; }
+
+signals:
+    // 工作线程进度 (排队连接到界面)
+    void progressChanged(int iteration, int maxIterations, double mse);
+
+private slots:
+    void onStartStop();
+    void onFinished();
+    void onProgress(int iteration, int maxIterations, double mse);
+    void refreshParamTable();
+
+protected:
+    void reject() override;
+
+private:
+    QVector<JointFitDataset> selectedDatasets() const;
+    void showResult(const JointFitResult& result);
+
+    QVector<JointFitDataset> m_datasets;
+    bool m_highPrecision;
+    JointFitResult m_result;
+
+    QListWidget* m_analysisList = nullptr;
+    QTableWidget* m_paramTable = nullptr;
+    QSpinBox* m_maxIterations = nullptr;
+    QPushButton* m_btnStart = nullptr;
+    QPushButton* m_btnApply = nullptr;
+    QProgressBar* m_progress = nullptr;
+    QLabel* m_status = nullptr;
+    QTableWidget* m_resultTable = nullptr;
+
+    QFutureWatcher<JointFitResult> m_watcher;
+    std::atomic<bool> m_cancel{false};
+};
+
+#endif // JOINTFITDIALOG_H
@@ -0,0 +1,338 @@
+/*
+ * 文件名: landscapedialog.cpp
+ * 文件作用: 双参数目标函数地形对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建；参数候选为参数表中可见的参数 (LfD 除外)，默认取前两个拟合参数。
+ * 2. 对数轴在 log10 坐标下绘制 (轴标题注明 log10)，保证热力图单元等宽。
+ * 3. 工作线程的网格快照经排队调用回到界面线程刷新，过期任务 (代号不符) 的快照被丢弃。
+ * 4. 色标为 log10(MSE)，无效节点透明显示。
+ */
+
+#include "landscapedialog.h"
+#include "qcustomplot.h"
+
+#include <QtConcurrent>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDoubleValidator>
+#include <QMessageBox>
+#include <QCloseEvent>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+QString fmt(double v)
+{
+    return QString::number(v, 'g', 5);
+}
+
+} // namespace
+
+LandscapeDialog::LandscapeDialog(const UncertaintyInput& input, QWidget* parent)
+    : QDialog(parent), m_input(input)
+{
+    setWindowTitle("目标函数地形");
+    resize(820, 720);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QGridLayout* form = new QGridLayout();
+
+    m_paramX = new QComboBox(this);
+    m_paramY = new QComboBox(this);
+    QStringList fitNames;
+    for (const FitParameter& p : m_input.params) {
+        if (!p.isVisible || p.name == "LfD") continue;
+        m_paramX->addItem(p.displayName.isEmpty() ? p.name : p.displayName, p.name);
+        m_paramY->addItem(p.displayName.isEmpty() ? p.name : p.displayName, p.name);
+        if (p.isFit) fitNames.append(p.name);
+    }
+    if (fitNames.size() >= 2) {
+        m_paramX->setCurrentIndex(m_paramX->findData(fitNames[0]));
+        m_paramY->setCurrentIndex(m_paramY->findData(fitNames[1]));
+    } else if (m_paramY->count() > 1) {
+        m_paramY->setCurrentIndex(1);
+    }
+
+    auto makeEdit = [this]() {
+        QLineEdit* e = new QLineEdit(this);
+        QDoubleValidator* v = new QDoubleValidator(e);
+        v->setNotation(QDoubleValidator::ScientificNotation);
+        e->setValidator(v);
+        return e;
+    };
+    m_xMin = makeEdit(); m_xMax = makeEdit();
+    m_yMin = makeEdit(); m_yMax = makeEdit();
+    m_logX = new QCheckBox("对数刻度", this);
+    m_logY = new QCheckBox("对数刻度", this);
+
+    form->addWidget(new QLabel("横轴参数:", this), 0, 0);
+    form->addWidget(m_paramX, 0, 1);
+    form->addWidget(new QLabel("范围:", this), 0, 2);
+    form->addWidget(m_xMin, 0, 3);
+    form->addWidget(new QLabel("~", this), 0, 4);
+    form->addWidget(m_xMax, 0, 5);
+    form->addWidget(m_logX, 0, 6);
+    form->addWidget(new QLabel("纵轴参数:", this), 1, 0);
+    form->addWidget(m_paramY, 1, 1);
+    form->addWidget(new QLabel("范围:", this), 1, 2);
+    form->addWidget(m_yMin, 1, 3);
+    form->addWidget(new QLabel("~", this), 1, 4);
+    form->addWidget(m_yMax, 1, 5);
+    form->addWidget(m_logY, 1, 6);
+    mainLayout->addLayout(form);
+
+    QHBoxLayout* runLayout = new QHBoxLayout();
+    runLayout->addWidget(new QLabel("分辨率:", this));
+    m_resolution = new QSpinBox(this);
+    m_resolution->setRange(9, 400);
+    m_resolution->setValue(100);
+    m_resolution->setSuffix(" × N");
+    m_resolution->setToolTip("每轴节点数；只在最小值附近和变化剧烈的区域计算到该分辨率，其余区域插值");
+    runLayout->addWidget(m_resolution);
+    m_profile = new QCheckBox("其余拟合参数逐点优化", this);
+    m_profile->setToolTip("勾选：每个网格点上对其余拟合参数做短程 LM 优化 (剖面目标函数，较慢)；\n"
+                          "不勾选：其余参数固定为参数表当前值");
+    runLayout->addWidget(m_profile);
+    runLayout->addStretch();
+    m_btnStart = new QPushButton("开始计算", this);
+    runLayout->addWidget(m_btnStart);
+    mainLayout->addLayout(runLayout);
+
+    m_plot = new QCustomPlot(this);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_colorMap = new QCPColorMap(m_plot->xAxis, m_plot->yAxis);
+    QCPColorScale* scale = new QCPColorScale(m_plot);
+    m_plot->plotLayout()->addElement(0, 1, scale);
+    scale->setType(QCPAxis::atRight);
+    scale->axis()->setLabel("log10(MSE)");
+    m_colorMap->setColorScale(scale);
+    QCPColorGradient gradient(QCPColorGradient::gpJet);
+    gradient.setNanHandling(QCPColorGradient::nhTransparent);
+    m_colorMap->setGradient(gradient);
+    m_colorMap->setInterpolate(false);
+    QCPMarginGroup* margins = new QCPMarginGroup(m_plot);
+    m_plot->axisRect()->setMarginGroup(QCP::msBottom | QCP::msTop, margins);
+    scale->setMarginGroup(QCP::msBottom | QCP::msTop, margins);
+
+    m_currentMarker = m_plot->addGraph();
+    m_currentMarker->setName("当前参数");
+    m_currentMarker->setLineStyle(QCPGraph::lsNone);
+    m_currentMarker->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCrossCircle, QPen(Qt::white, 2), Qt::NoBrush, 12));
+    m_minMarker = m_plot->addGraph();
+    m_minMarker->setName("网格最小值");
+    m_minMarker->setLineStyle(QCPGraph::lsNone);
+    m_minMarker->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssStar, QPen(Qt::black, 2), Qt::NoBrush, 14));
+    m_colorMap->removeFromLegend();
+    m_plot->legend->setVisible(true);
+    mainLayout->addWidget(m_plot, 1);
+
+    m_status = new QLabel("设置参数与范围后点击“开始计算”；双击热力图可将该点参数应用到参数表。", this);
+    mainLayout->addWidget(m_status);
+
+    fillRange(m_paramX, m_xMin, m_xMax, m_logX);
+    fillRange(m_paramY, m_yMin, m_yMax, m_logY);
+
+    connect(m_paramX, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LandscapeDialog::onAxisParamChanged);
+    connect(m_paramY, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LandscapeDialog::onAxisParamChanged);
+    connect(m_btnStart, &QPushButton::clicked, this, &LandscapeDialog::onStartStop);
+    connect(&m_watcher, &QFutureWatcher<LandscapeGrid>::finished, this, &LandscapeDialog::onFinished);
+    connect(m_plot, &QCustomPlot::mouseDoubleClick, this, &LandscapeDialog::onPlotDoubleClick);
+}
+
+LandscapeDialog::~LandscapeDialog()
+{
+    m_cancel = true;
+    m_watcher.waitForFinished();
+}
+
+void LandscapeDialog::closeEvent(QCloseEvent* event)
+{
+    m_cancel = true;
+    m_watcher.waitForFinished();
+    QDialog::closeEvent(event);
+}
+
+/**
+ * @brief 按参数表上下限填入默认范围；跨两个数量级以上的正值参数默认取对数刻度
+ */
+void LandscapeDialog::fillRange(QComboBox* combo, QLineEdit* minEdit, QLineEdit* maxEdit, QCheckBox* logBox)
+{
+    QString name = combo->currentData().toString();
+    for (const FitParameter& p : m_input.params) {
+        if (p.name != name) continue;
+        double lo = p.min, hi = p.max;
+        if (!(hi > lo)) {
+            lo = p.value * 0.5;
+            hi = p.value * 2.0;
+        }
+        minEdit->setText(fmt(lo));
+        maxEdit->setText(fmt(hi));
+        logBox->setChecked(lo > 0.0 && hi / lo >= 100.0);
+        return;
+    }
+}
+
+void LandscapeDialog::onAxisParamChanged()
+{
+    if (sender() == m_paramX) fillRange(m_paramX, m_xMin, m_xMax, m_logX);
+    else fillRange(m_paramY, m_yMin, m_yMax, m_logY);
+}
+
+bool LandscapeDialog::collectOptions(LandscapeOptions& options)
+{
+    options.paramX = m_paramX->currentData().toString();
+    options.paramY = m_paramY->currentData().toString();
+    if (options.paramX.isEmpty() || options.paramY.isEmpty() || options.paramX == options.paramY) {
+        QMessageBox::warning(this, "目标函数地形", "请选择两个不同的参数。");
+        return false;
+    }
+    bool ok1, ok2, ok3, ok4;
+    options.xMin = m_xMin->text().toDouble(&ok1);
+    options.xMax = m_xMax->text().toDouble(&ok2);
+    options.yMin = m_yMin->text().toDouble(&ok3);
+    options.yMax = m_yMax->text().toDouble(&ok4);
+    if (!(ok1 && ok2 && ok3 && ok4) || !(options.xMax > options.xMin) || !(options.yMax > options.yMin)) {
+        QMessageBox::warning(this, "目标函数地形", "参数范围无效：上限必须大于下限。");
+        return false;
+    }
+    options.logX = m_logX->isChecked();
+    options.logY = m_logY->isChecked();
+    if ((options.logX && options.xMin <= 0.0) || (options.logY && options.yMin <= 0.0)) {
+        QMessageBox::warning(this, "目标函数地形", "对数刻度的参数范围必须为正。");
+        return false;
+    }
+    options.resolution = m_resolution->value();
+    options.profile = m_profile->isChecked();
+    return true;
+}
+
+void LandscapeDialog::setRunning(bool running)
+{
+    m_btnStart->setText(running ? "停止" : "开始计算");
+    m_btnStart->setEnabled(true);
+    for (QWidget* w : std::initializer_list<QWidget*>{m_paramX, m_paramY, m_xMin, m_xMax, m_yMin, m_yMax,
+                                                     m_logX, m_logY, m_resolution, m_profile}) {
+        w->setEnabled(!running);
+    }
+}
+
+void LandscapeDialog::onStartStop()
+{
+    if (m_watcher.isRunning()) {
+        m_cancel = true;
+        m_btnStart->setEnabled(false);
+        return;
+    }
+    LandscapeOptions options;
+    if (!collectOptions(options)) return;
+    m_options = options;
+
+    m_plot->xAxis->setLabel(options.logX ? QString("log10(%1)").arg(options.paramX) : options.paramX);
+    m_plot->yAxis->setLabel(options.logY ? QString("log10(%1)").arg(options.paramY) : options.paramY);
+    m_colorMap->data()->clear();
+    m_minMarker->data()->clear();
+    m_currentMarker->data()->clear();
+    double cx = 0.0, cy = 0.0;
+    for (const FitParameter& p : m_input.params) {
+        if (p.name == options.paramX) cx = p.value;
+        if (p.name == options.paramY) cy = p.value;
+    }
+    if ((!options.logX || cx > 0.0) && (!options.logY || cy > 0.0)) {
+        m_currentMarker->addData(plotCoord(cx, options.logX), plotCoord(cy, options.logY));
+    }
+    m_plot->xAxis->setRange(plotCoord(options.xMin, options.logX), plotCoord(options.xMax, options.logX));
+    m_plot->yAxis->setRange(plotCoord(options.yMin, options.logY), plotCoord(options.yMax, options.logY));
+    m_plot->replot();
+
+    m_cancel = false;
+    const int generation = ++m_generation;
+    setRunning(true);
+    m_status->setText("计算中...");
+
+    UncertaintyInput input = m_input;
+    m_watcher.setFuture(QtConcurrent::run([this, input, options, generation]() {
+        return ObjectiveLandscape::compute(input, options, &m_cancel, [this, generation](const LandscapeGrid& grid) {
+            QMetaObject::invokeMethod(this, [this, grid, generation]() {
+                if (generation == m_generation) showGrid(grid);
+            }, Qt::QueuedConnection);
+        });
+    }));
+}
+
+void LandscapeDialog::onFinished()
+{
+    setRunning(false);
+    LandscapeGrid grid = m_watcher.result();
+    showGrid(grid);
+    if (!grid.finished) m_status->setText(m_status->text() + "  (已停止)");
+}
+
+double LandscapeDialog::plotCoord(double v, bool logScale) const
+{
+    return logScale ? std::log10(v) : v;
+}
+
+void LandscapeDialog::showGrid(const LandscapeGrid& grid)
+{
+    if (grid.n < 2) return;
+    const int n = grid.n;
+    QCPColorMapData* data = m_colorMap->data();
+    data->setSize(n, n);
+    data->setRange(QCPRange(plotCoord(grid.xs.first(), m_options.logX), plotCoord(grid.xs.last(), m_options.logX)),
+                   QCPRange(plotCoord(grid.ys.first(), m_options.logY), plotCoord(grid.ys.last(), m_options.logY)));
+    double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            double v = grid.value(i, j);
+            data->setCell(i, j, v);
+            if (!std::isnan(v)) {
+                lo = qMin(lo, v);
+                hi = qMax(hi, v);
+            }
+        }
+    }
+    if (hi >= lo) m_colorMap->setDataRange(QCPRange(lo, hi > lo ? hi : lo + 1.0));
+
+    m_minMarker->data()->clear();
+    if (grid.hasMinimum) m_minMarker->addData(plotCoord(grid.minX, m_options.logX), plotCoord(grid.minY, m_options.logY));
+    m_plot->replot(QCustomPlot::rpQueuedReplot);
+
+    QString text = QString("已计算 %1 / %2 个节点 (%3%)，细化层 %4")
+                       .arg(grid.evaluations).arg(n * n)
+                       .arg(100.0 * grid.evaluations / (n * n), 0, 'f', 1).arg(grid.level);
+    if (grid.hasMinimum) {
+        text += QString("；网格最小值 MSE = %1，位于 %2 = %3, %4 = %5")
+                    .arg(fmt(std::pow(10.0, grid.minValue)))
+                    .arg(m_options.paramX, fmt(grid.minX), m_options.paramY, fmt(grid.minY));
+    }
+    if (grid.finished) text += "；完成";
+    m_status->setText(text);
+}
+
+/**
+ * @brief 双击热力图：将该点的两个参数值发送给参数表
+ */
+void LandscapeDialog::onPlotDoubleClick(QMouseEvent* event)
+{
+    if (m_colorMap->data()->keySize() == 0 || m_options.paramX.isEmpty()) return;
+    double px = m_plot->xAxis->pixelToCoord(event->pos().x());
+    double py = m_plot->yAxis->pixelToCoord(event->pos().y());
+    double x = m_options.logX ? std::pow(10.0, px) : px;
+    double y = m_options.logY ? std::pow(10.0, py) : py;
+    if (x < qMin(m_options.xMin, m_options.xMax) || x > qMax(m_options.xMin, m_options.xMax)) return;
+    if (y < qMin(m_options.yMin, m_options.yMax) || y > qMax(m_options.yMin, m_options.yMax)) return;
+
+    if (QMessageBox::question(this, "目标函数地形",
+            QString("将参数表中 %1 设为 %2、%3 设为 %4？").arg(m_options.paramX, fmt(x), m_options.paramY, fmt(y)))
+        == QMessageBox::Yes) {
+        emit pointSelected(m_options.paramX, x, m_options.paramY, y);
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * 文件名: landscapedialog.h
+ * 文件作用: 双参数目标函数地形 (热力图) 对话框头文件
+ * 功能描述:
+ * 1. 选择横/纵轴参数、范围、对数刻度、分辨率以及其余参数固定或逐点优化 (剖面)。
+ * 2. 后台渐进计算 (fittinglandscape.h)，每完成一块节点即刷新热力图，可随时停止。
+ * 3. 热力图标出当前参数点与网格最小值；双击热力图可将该点的两个参数值应用到参数表。
+ * 4. 非模态，关闭时取消未完成的计算。
+ */
+
+#ifndef LANDSCAPEDIALOG_H
+#define LANDSCAPEDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <atomic>
+
+#include "fittinglandscape.h"
+
+class QComboBox;
+class QLineEdit;
+class QCheckBox;
+class QSpinBox;
+class QPushButton;
+class QLabel;
+class QCustomPlot;
+class QCPColorMap;
+class QCPGraph;
+class QMouseEvent;
+
+class LandscapeDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    /**
+     * @param input 参数表与拟合抽样数据快照 (与不确定性分析/MCMC 相同)
+     */
+    explicit LandscapeDialog(const UncertaintyInput& input, QWidget* parent = nullptr);
+    ~LandscapeDialog() override;
+
+signals:
+    // 双击热力图选定的参数点
+    void pointSelected(const QString& paramX, double x, const QString& paramY, double y);
+
+private slots:
+    void onStartStop();
+    void onFinished();
+    void onAxisParamChanged();
+    void onPlotDoubleClick(QMouseEvent* event);
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
+private:
+    void fillRange(QComboBox* combo, QLineEdit* minEdit, QLineEdit* maxEdit, QCheckBox* logBox);
+    bool collectOptions(LandscapeOptions& options);
+    void showGrid(const LandscapeGrid& grid);
+    double plotCoord(double v, bool logScale) const;
+    void setRunning(bool running);
+
+    UncertaintyInput m_input;
+    LandscapeOptions m_options;     // 正在显示的地形设置
+
+    QComboBox* m_paramX = nullptr;
+    QComboBox* m_paramY = nullptr;
+    QLineEdit* m_xMin = nullptr;
+    QLineEdit* m_xMax = nullptr;
+    QLineEdit* m_yMin = nullptr;
+    QLineEdit* m_yMax = nullptr;
+    QCheckBox* m_logX = nullptr;
+    QCheckBox* m_logY = nullptr;
+    QSpinBox* m_resolution = nullptr;
+    QCheckBox* m_profile = nullptr;
+    QPushButton* m_btnStart = nullptr;
+    QLabel* m_status = nullptr;
+
+    QCustomPlot* m_plot = nullptr;
+    QCPColorMap* m_colorMap = nullptr;
+    QCPGraph* m_currentMarker = nullptr;
+    QCPGraph* m_minMarker = nullptr;
+
+    QFutureWatcher<LandscapeGrid> m_watcher;
+    std::atomic<bool> m_cancel{false};
+    int m_generation = 0;           // 每次开始计算递增，丢弃过期的刷新
+};
+
+#endif // LANDSCAPEDIALOG_H
@@ -11,6 +11,8 @@
  * - [优化] 全新设计的 QComboBox：6px圆角、36px高度、现代化下拉效果。
  * 5. 设置全局调色板以适配不同系统主题。
  * 6. 启动主窗口。
+ * 7. 命令行参数 --trace <文件>：启动即开启时间线追踪，退出时导出 Chrome Trace JSON。
+ * 8. 记录启动各阶段耗时 (StartupProfiler)，进入事件循环后输出耗时分解日志。
  */
 
 #include "mainwindow.h"
@@ -20,6 +22,10 @@
 #include <QFileDialog>
 #include <QIcon>
 #include <QTranslator>
+#include <QDebug>
+#include "tracerecorder.h"
+#include "startupprofiler.h"
+#include <QTimer>
 
 // ========================================================================
 // 自定义翻译器类：用于全局汉化标准按钮
@@ -65,12 +71,24 @@ public:
 
 int main(int argc, char *argv[])
 {
+    StartupProfiler::start();
+
 // 解决 HighDpiScaling 在 Qt6 中已废弃的警告
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 #endif
 
     QApplication app(argc, argv);
+    StartupProfiler::mark("应用对象");
+
+    // 命令行参数：--trace <文件> 开启时间线追踪，程序退出时导出
+    QString traceFilePath;
+    const QStringList args = app.arguments();
+    int traceArgIndex = args.indexOf("--trace");
+    if (traceArgIndex > 0 && traceArgIndex + 1 < args.size()) {
+        traceFilePath = args.at(traceArgIndex + 1);
+        TraceRecorder::setEnabled(true);
+    }
 
     // [新增] 加载自定义翻译器，解决标准按钮(QDialogButtonBox)中文显示问题
     ChineseTranslator translator;
@@ -476,6 +494,7 @@ int main(int argc, char *argv[])
     )";
 
     app.setStyleSheet(styleSheet);
+    StartupProfiler::mark("全局样式表");
 
     // 设置全局调色板 (双重保险，防止原生控件未被 CSS 覆盖时的颜色异常)
     QPalette palette = app.palette();
@@ -496,7 +515,22 @@ int main(int argc, char *argv[])
     QApplication::setPalette(palette);
 
     MainWindow w;
+    StartupProfiler::mark("主窗口其余部分");
     w.show();
+    StartupProfiler::mark("窗口显示");
+
+    // 首次事件循环 (首帧绘制) 完成后输出启动耗时分解
+    QTimer::singleShot(0, []() {
+        StartupProfiler::mark("首帧绘制");
+        StartupProfiler::finish();
+    });
 
-    return app.exec();
+    int ret = app.exec();
+
+    if (!traceFilePath.isEmpty()) {
+        QString error;
+        if (!TraceRecorder::exportChromeTrace(traceFilePath, &error))
+            qWarning() << "时间线导出失败:" << error;
+    }
+    return ret;
 }
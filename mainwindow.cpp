@@ -6,6 +6,8 @@
  * 2. 实现了左侧导航栏的逻辑控制和页面切换。
  * 3. 协调数据在不同模块之间的流转。
  * 4. [新增] 实现了 onViewExportedFile 槽函数，在导出后自动切换到数据页并弹出配置对话框。
+ * 5. [修改] 启动时只创建项目页与数据页，图表、模型、拟合、设置页在首次导航时创建；
+ *    启动各阶段耗时由 StartupProfiler 记录并在启动完成后输出。
  */
 
 #include "mainwindow.h"
@@ -19,6 +21,7 @@
 #include "fittingpage.h"
 #include "settingswidget.h"
 #include "pressurederivativecalculator.h"
+#include "startupprofiler.h"
 
 #include <QDateTime>
 #include <QMessageBox>
@@ -29,6 +32,7 @@
 #include <QStackedWidget>
 #include <cmath>
 #include <QStatusBar>
+#include <QElapsedTimer>
 
 // 辅助函数：统一的消息框样式定义
 static QString getGlobalMessageBoxStyle()
@@ -117,7 +121,8 @@ void MainWindow::init()
                         item++;
                     }
 
-                    // 切换堆叠窗口页面
+                    // 切换堆叠窗口页面 (首次进入时创建页面)
+                    ensurePageCreated(targetIndex);
                     ui->stackedWidget->setCurrentIndex(targetIndex);
 
                     if (name == tr("图表")) {
@@ -136,6 +141,10 @@ void MainWindow::init()
         ui->labelTime->setStyleSheet("color: black;");
     });
     m_timer.start(1000);
+    StartupProfiler::mark("导航栏");
+
+    // --- 运行期设置 (性能计数器、回放日志) 不依赖设置页是否已创建 ---
+    SettingsWidget::applyRuntimeSettings();
 
     // --- 初始化子页面 ---
     m_ProjectWidget = new WT_ProjectWidget(ui->pageMonitor);
@@ -143,40 +152,85 @@ void MainWindow::init()
     connect(m_ProjectWidget, &WT_ProjectWidget::projectOpened, this, &MainWindow::onProjectOpened);
     connect(m_ProjectWidget, &WT_ProjectWidget::projectClosed, this, &MainWindow::onProjectClosed);
     connect(m_ProjectWidget, &WT_ProjectWidget::fileLoaded, this, &MainWindow::onFileLoaded);
+    StartupProfiler::mark("项目页");
 
     m_DataEditorWidget = new WT_DataWidget(ui->pageHand);
     ui->verticalLayoutHandle->addWidget(m_DataEditorWidget);
     connect(m_DataEditorWidget, &WT_DataWidget::fileChanged, this, &MainWindow::onFileLoaded);
     connect(m_DataEditorWidget, &WT_DataWidget::dataChanged, this, &MainWindow::onDataEditorDataChanged);
+    StartupProfiler::mark("数据页");
+
+    // 模型管理器本身很轻，先创建以便拟合随时可用；其界面与求解器均延迟创建
+    m_ModelManager = new ModelManager(this);
+    connect(m_ModelManager, &ModelManager::calculationCompleted, this, &MainWindow::onModelCalculationCompleted);
+
+    // 图表 / 模型 / 拟合 / 设置页在首次导航时由 ensurePageCreated 创建
 
+    initProjectForm();
+    initDataEditorForm();
+    initPredictionForm();
+}
+
+void MainWindow::ensurePageCreated(int index)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QString name;
+
+    switch (index) {
+    case 2: if (!m_PlottingWidget) { createPlottingPage(); name = "图表页"; } break;
+    case 3: if (!m_isModelPageCreated) { createModelPage(); name = "模型页"; } break;
+    case 4: if (!m_FittingPage) { createFittingPage(); name = "拟合页"; } break;
+    case 6: if (!m_SettingsWidget) { createSettingsPage(); name = "设置页"; } break;
+    default: break;
+    }
+
+    if (!name.isEmpty()) StartupProfiler::recordLazyInit(name, timer.nsecsElapsed());
+}
+
+void MainWindow::createPlottingPage()
+{
     m_PlottingWidget = new WT_PlottingWidget(ui->pageData);
     ui->verticalLayout_2->addWidget(m_PlottingWidget);
     // [新增] 连接导出的文件查看信号
     connect(m_PlottingWidget, &WT_PlottingWidget::viewExportedFile, this, &MainWindow::onViewExportedFile);
 
-    m_ModelManager = new ModelManager(this);
+    // 项目已加载时补做 onProjectOpened 中的同步
+    if (m_isProjectLoaded) m_PlottingWidget->loadProjectData();
+    initPlottingForm();
+}
+
+void MainWindow::createModelPage()
+{
     m_ModelManager->initializeModels(ui->pageParamter);
-    connect(m_ModelManager, &ModelManager::calculationCompleted, this, &MainWindow::onModelCalculationCompleted);
+    m_isModelPageCreated = true;
+    initModelForm();
+}
 
-    if (ui->pageFitting && ui->verticalLayoutFitting) {
-        m_FittingPage = new FittingPage(ui->pageFitting);
-        ui->verticalLayoutFitting->addWidget(m_FittingPage);
-        m_FittingPage->setModelManager(m_ModelManager);
-    } else {
+void MainWindow::createFittingPage()
+{
+    if (!ui->pageFitting || !ui->verticalLayoutFitting) {
         qWarning() << "MainWindow: 拟合界面容器初始化失败";
-        m_FittingPage = nullptr;
+        return;
+    }
+    m_FittingPage = new FittingPage(ui->pageFitting);
+    ui->verticalLayoutFitting->addWidget(m_FittingPage);
+    m_FittingPage->setModelManager(m_ModelManager);
+
+    // 项目已加载时补做 onProjectOpened 中的同步
+    if (m_isProjectLoaded) {
+        if (m_DataEditorWidget) m_FittingPage->setProjectDataModels(m_DataEditorWidget->getAllDataModels());
+        m_FittingPage->updateBasicParameters();
+        m_FittingPage->loadAllFittingStates();
     }
+    initFittingForm();
+}
 
+void MainWindow::createSettingsPage()
+{
     m_SettingsWidget = new SettingsWidget(ui->pageAlarm);
     ui->verticalLayout_3->addWidget(m_SettingsWidget);
     connect(m_SettingsWidget, &SettingsWidget::settingsChanged, this, &MainWindow::onSystemSettingsChanged);
-
-    initProjectForm();
-    initDataEditorForm();
-    initModelForm();
-    initPlottingForm();
-    initFittingForm();
-    initPredictionForm();
 }
 
 void MainWindow::initProjectForm() { qDebug() << "初始化项目界面"; }
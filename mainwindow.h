@@ -6,6 +6,7 @@
  * 2. 引入 ModelManager 头文件以访问模型系统。
  * 3. 定义主窗口与各个子模块（项目、数据、绘图、拟合）之间的交互接口。
  * 4. [新增] 增加了 onViewExportedFile 槽函数，处理从图表导出的文件跳转。
+ * 5. [修改] 图表、模型、拟合、设置页改为首次进入时创建 (ensurePageCreated)，缩短启动时间。
  */
 
 #ifndef MAINWINDOW_H
@@ -72,13 +73,14 @@ private slots:
 private:
     Ui::MainWindow *ui;
 
-    // 各个功能页面的指针成员变量
-    WT_ProjectWidget* m_ProjectWidget;      // 项目管理页
-    WT_DataWidget* m_DataEditorWidget;      // 数据编辑页 (支持多标签)
-    ModelManager* m_ModelManager;           // 模型参数页
-    WT_PlottingWidget* m_PlottingWidget;    // 图表分析页
-    FittingPage* m_FittingPage;             // 拟合分析页
-    SettingsWidget* m_SettingsWidget;       // 系统设置页
+    // 各个功能页面的指针成员变量 (图表/拟合/设置页延迟创建，未创建时为 nullptr)
+    WT_ProjectWidget* m_ProjectWidget = nullptr;      // 项目管理页
+    WT_DataWidget* m_DataEditorWidget = nullptr;      // 数据编辑页 (支持多标签)
+    ModelManager* m_ModelManager = nullptr;           // 模型参数页 (求解器随时可用，界面延迟创建)
+    WT_PlottingWidget* m_PlottingWidget = nullptr;    // 图表分析页
+    FittingPage* m_FittingPage = nullptr;             // 拟合分析页
+    SettingsWidget* m_SettingsWidget = nullptr;       // 系统设置页
+    bool m_isModelPageCreated = false;                // 模型页界面是否已创建
 
     QMap<QString, NavBtn*> m_NavBtnMap;     // 左侧导航按钮映射表
     QTimer m_timer;                         // 系统时间显示定时器
@@ -87,6 +89,13 @@ private:
 
     // --- 内部辅助函数 ---
 
+    // 确保指定索引的页面已创建 (首次进入时构建，并补做项目已加载时的同步)
+    void ensurePageCreated(int index);
+    void createPlottingPage();
+    void createModelPage();
+    void createFittingPage();
+    void createSettingsPage();
+
     // 将数据编辑器中的所有数据传输给绘图模块 (Plotting)
     void transferDataFromEditorToPlotting();
 
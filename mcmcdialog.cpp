@@ -0,0 +1,362 @@
+/*
+ * 文件名: mcmcdialog.cpp
+ * 文件作用: MCMC 后验采样的设置与结果对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建。
+ * 2. 角图以采样空间绘制 (对数更新的参数显示为 log10)，每个子图为一个轻量 QCustomPlot，
+ *    散点最多绘制约 1500 个样本，直方图 30 个分箱；只有最下一行与最左一列显示刻度标签。
+ * 3. R-hat > 1.1 或 τ 使链长不足 50τ 的参数在统计表中以红色标出。
+ */
+
+#include "mcmcdialog.h"
+#include "qcustomplot.h"
+
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QTabWidget>
+#include <QScrollArea>
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <QThread>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+QString fmt(double v)
+{
+    return QString::number(v, 'g', 5);
+}
+
+// 参数是否需要警示：R-hat 过大或链长不足
+bool isSuspicious(const McmcResult& r, int p)
+{
+    bool badRhat = p < r.rhat.size() && r.rhat[p] > 1.1;
+    bool shortChain = p < r.tau.size() && r.state.step < 50.0 * r.tau[p];
+    return badRhat || shortChain;
+}
+
+QString axisLabel(const McmcState& state, int p)
+{
+    return state.logScale.value(p) ? QString("log10(%1)").arg(state.names[p]) : state.names[p];
+}
+
+} // namespace
+
+// ============================================================================
+// McmcSettingsDialog
+// ============================================================================
+
+McmcSettingsDialog::McmcSettingsDialog(const McmcOptions& options, int fitParamCount, int checkpointSteps, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("MCMC 后验采样");
+    resize(440, 300);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QLabel* hint = new QLabel(QString("以参数上下限为均匀先验，对 %1 个拟合参数做集合 MCMC 采样。\n"
+                                      "walker 按两组并行计算 (本机 %2 个线程)，自相关时间稳定且链长足够时自动结束。")
+                                  .arg(fitParamCount).arg(QThread::idealThreadCount()), this);
+    hint->setWordWrap(true);
+    layout->addWidget(hint);
+
+    QFormLayout* form = new QFormLayout();
+    m_walkers = new QSpinBox(this);
+    m_walkers->setRange(0, 512);
+    m_walkers->setSpecialValueText("自动");
+    m_walkers->setValue(options.walkers);
+    form->addRow("walker 数:", m_walkers);
+
+    m_maxSteps = new QSpinBox(this);
+    m_maxSteps->setRange(100, 100000);
+    m_maxSteps->setSingleStep(500);
+    m_maxSteps->setValue(options.maxSteps);
+    form->addRow("最大步数:", m_maxSteps);
+
+    m_tauFactor = new QDoubleSpinBox(this);
+    m_tauFactor->setRange(10.0, 200.0);
+    m_tauFactor->setDecimals(0);
+    m_tauFactor->setValue(options.tauFactor);
+    m_tauFactor->setToolTip("步数超过该倍数的自相关时间且 τ 估计稳定时结束采样");
+    form->addRow("收敛判据 (倍 τ):", m_tauFactor);
+
+    m_seed = new QSpinBox(this);
+    m_seed->setRange(0, 2147483647);
+    m_seed->setValue(static_cast<int>(options.seed & 0x7FFFFFFF));
+    form->addRow("随机种子:", m_seed);
+    layout->addLayout(form);
+
+    m_resume = new QCheckBox(checkpointSteps > 0 ? QString("从检查点继续 (已完成 %1 步)").arg(checkpointSteps)
+                                                 : QString("从检查点继续 (无可用检查点)"), this);
+    m_resume->setEnabled(checkpointSteps > 0);
+    m_resume->setChecked(checkpointSteps > 0);
+    m_resume->setToolTip("检查点随分析状态保存；模型、拟合参数设置或数据变化后检查点失效");
+    layout->addWidget(m_resume);
+    layout->addStretch();
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Ok)->setText("开始采样");
+    buttons->button(QDialogButtonBox::Cancel)->setText("取消");
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttons);
+}
+
+McmcOptions McmcSettingsDialog::options() const
+{
+    McmcOptions o;
+    o.walkers = m_walkers->value();
+    o.maxSteps = m_maxSteps->value();
+    o.tauFactor = m_tauFactor->value();
+    o.seed = static_cast<quint64>(m_seed->value());
+    return o;
+}
+
+bool McmcSettingsDialog::resumeFromCheckpoint() const
+{
+    return m_resume->isEnabled() && m_resume->isChecked();
+}
+
+// ============================================================================
+// McmcResultDialog
+// ============================================================================
+
+McmcResultDialog::McmcResultDialog(const McmcResult& result, QWidget* parent)
+    : QDialog(parent), m_result(result)
+{
+    setWindowTitle("MCMC 后验采样结果");
+    resize(900, 720);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QTabWidget* tabs = new QTabWidget(this);
+    tabs->addTab(buildStatisticsPage(), "后验统计");
+    tabs->addTab(buildCornerPage(), "角图");
+    layout->addWidget(tabs);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    QPushButton* btnExport = new QPushButton("导出CSV", this);
+    QPushButton* btnClose = new QPushButton("关闭", this);
+    btnLayout->addWidget(btnExport);
+    btnLayout->addWidget(btnClose);
+    layout->addLayout(btnLayout);
+    connect(btnExport, &QPushButton::clicked, this, &McmcResultDialog::onExportCsv);
+    connect(btnClose, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+QWidget* McmcResultDialog::buildStatisticsPage()
+{
+    const McmcResult& r = m_result;
+    QWidget* page = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(page);
+
+    QString status = r.converged ? "已满足收敛判据" : "未满足收敛判据 (结果仅供参考)";
+    QLabel* summary = new QLabel(QString("walker: %1    步数: %2 (预热 %3，抽稀 %4)    后验样本: %5    接受率: %6%    %7    耗时: %8 s")
+                                     .arg(r.state.walkers).arg(r.state.step).arg(r.burnIn).arg(r.thin)
+                                     .arg(r.samples.size()).arg(r.acceptance * 100.0, 0, 'f', 1)
+                                     .arg(status).arg(r.elapsedMs / 1000.0, 0, 'f', 1), page);
+    summary->setWordWrap(true);
+    layout->addWidget(summary);
+
+    QTableWidget* table = new QTableWidget(r.intervals.size(), 9, page);
+    table->setHorizontalHeaderLabels({"参数", "起始值", "P10", "P50", "P90", "均值", "标准差", "τ (步)", "R-hat"});
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int i = 0; i < r.intervals.size(); ++i) {
+        const ParameterInterval& iv = r.intervals[i];
+        QStringList cells = {QString("%1 (%2)").arg(iv.displayName, iv.name), fmt(iv.fitted), fmt(iv.p10), fmt(iv.p50),
+                             fmt(iv.p90), fmt(iv.mean), fmt(iv.stdDev),
+                             QString::number(r.tau.value(i), 'f', 1), QString::number(r.rhat.value(i), 'f', 3)};
+        for (int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            if (c > 0) item->setTextAlignment(Qt::AlignCenter);
+            if (c >= 7 && isSuspicious(r, i)) item->setForeground(Qt::red);
+            table->setItem(i, c, item);
+        }
+    }
+    layout->addWidget(table);
+
+    QLabel* note = new QLabel("τ 为积分自相关时间；R-hat 以各 walker 为独立链计算，接近 1 表示混合良好 (红色: R-hat > 1.1 或链长不足 50τ)。", page);
+    note->setWordWrap(true);
+    note->setStyleSheet("color: #666;");
+    layout->addWidget(note);
+    return page;
+}
+
+QWidget* McmcResultDialog::buildCornerPage()
+{
+    const McmcResult& r = m_result;
+    const McmcState& st = r.state;
+    const int d = r.intervals.size();
+
+    QScrollArea* scroll = new QScrollArea(this);
+    QWidget* grid = new QWidget(scroll);
+    QGridLayout* layout = new QGridLayout(grid);
+    layout->setSpacing(2);
+    if (d == 0 || r.samples.isEmpty()) {
+        layout->addWidget(new QLabel("没有后验样本。", grid), 0, 0);
+        scroll->setWidget(grid);
+        return scroll;
+    }
+
+    // 采样空间的样本列
+    const int m = r.samples.size();
+    QVector<QVector<double>> cols(d, QVector<double>(m));
+    for (int k = 0; k < m; ++k) {
+        for (int p = 0; p < d; ++p) {
+            double v = r.samples[k][p];
+            cols[p][k] = st.logScale.value(p) && v > 0.0 ? std::log10(v) : v;
+        }
+    }
+    QVector<double> lo(d), hi(d);
+    for (int p = 0; p < d; ++p) {
+        auto mm = std::minmax_element(cols[p].begin(), cols[p].end());
+        double pad = (*mm.second - *mm.first) * 0.05;
+        if (pad <= 0.0) pad = std::max(std::abs(*mm.first) * 0.01, 1e-9);
+        lo[p] = *mm.first - pad;
+        hi[p] = *mm.second + pad;
+    }
+    const int stride = std::max(1, m / 1500);
+    const int cell = d > 6 ? 130 : 170;
+
+    for (int i = 0; i < d; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            QCustomPlot* plot = new QCustomPlot(grid);
+            plot->setMinimumSize(cell, cell);
+            plot->setNoAntialiasingOnDrag(true);
+            plot->axisRect()->setAutoMargins(QCP::msNone);
+            plot->axisRect()->setMargins(QMargins(j == 0 ? 48 : 6, 6, 6, i == d - 1 ? 36 : 6));
+            QFont tickFont = plot->font();
+            tickFont.setPointSize(7);
+            plot->xAxis->setTickLabelFont(tickFont);
+            plot->yAxis->setTickLabelFont(tickFont);
+            plot->xAxis->setTickLabels(i == d - 1);
+            if (i == d - 1) plot->xAxis->setLabel(axisLabel(st, j));
+
+            if (i == j) {
+                // 对角线：直方图
+                const int bins = 30;
+                QVector<double> centers(bins), counts(bins, 0.0);
+                double width = (hi[i] - lo[i]) / bins;
+                for (int b = 0; b < bins; ++b) centers[b] = lo[i] + (b + 0.5) * width;
+                for (double v : cols[i]) {
+                    int b = qBound(0, static_cast<int>((v - lo[i]) / width), bins - 1);
+                    counts[b] += 1.0;
+                }
+                QCPBars* bars = new QCPBars(plot->xAxis, plot->yAxis);
+                bars->setWidth(width);
+                bars->setData(centers, counts);
+                bars->setPen(QPen(QColor(40, 90, 160)));
+                bars->setBrush(QColor(70, 130, 200, 160));
+                plot->xAxis->setRange(lo[i], hi[i]);
+                plot->yAxis->setRange(0, *std::max_element(counts.begin(), counts.end()) * 1.1);
+                plot->yAxis->setTickLabels(false);
+
+                // P10/P50/P90 竖线
+                const ParameterInterval& iv = r.intervals[i];
+                for (double q : {iv.p10, iv.p50, iv.p90}) {
+                    double x = st.logScale.value(i) && q > 0.0 ? std::log10(q) : q;
+                    QCPItemStraightLine* line = new QCPItemStraightLine(plot);
+                    line->point1->setCoords(x, 0);
+                    line->point2->setCoords(x, 1);
+                    line->setPen(QPen(Qt::red, 1, q == iv.p50 ? Qt::SolidLine : Qt::DashLine));
+                }
+            } else {
+                // 下三角：两两散点
+                QVector<double> xs, ys;
+                xs.reserve(m / stride + 1);
+                ys.reserve(m / stride + 1);
+                for (int k = 0; k < m; k += stride) {
+                    xs.append(cols[j][k]);
+                    ys.append(cols[i][k]);
+                }
+                QCPGraph* g = plot->addGraph();
+                g->setData(xs, ys);
+                g->setLineStyle(QCPGraph::lsNone);
+                g->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, QColor(40, 90, 160, 70), 2.5));
+                g->setAdaptiveSampling(true);
+                plot->xAxis->setRange(lo[j], hi[j]);
+                plot->yAxis->setRange(lo[i], hi[i]);
+                plot->yAxis->setTickLabels(j == 0);
+                if (j == 0) plot->yAxis->setLabel(axisLabel(st, i));
+            }
+            layout->addWidget(plot, i, j);
+        }
+    }
+
+    scroll->setWidget(grid);
+    scroll->setWidgetResizable(true);
+    return scroll;
+}
+
+void McmcResultDialog::onExportCsv()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "导出 MCMC 结果", "MCMC后验统计.csv", "CSV 文件 (*.csv)");
+    if (fileName.isEmpty()) return;
+
+    QFileInfo info(fileName);
+    QString samplesName = info.absolutePath() + "/" + info.completeBaseName() + "_后验样本.csv";
+
+    QFile file(fileName);
+    QFile samplesFile(samplesName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || !samplesFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", "无法写入文件:\n" + (file.isOpen() ? samplesFile.errorString() : file.errorString()));
+        return;
+    }
+
+    QTextStream out(&file);
+    out.setGenerateByteOrderMark(true);
+    out << "参数,起始值,P10,P50,P90,均值,标准差,tau,R-hat\n";
+    for (int i = 0; i < m_result.intervals.size(); ++i) {
+        const ParameterInterval& iv = m_result.intervals[i];
+        out << iv.name << "," << fmt(iv.fitted) << "," << fmt(iv.p10) << "," << fmt(iv.p50) << "," << fmt(iv.p90) << ","
+            << fmt(iv.mean) << "," << fmt(iv.stdDev) << "," << QString::number(m_result.tau.value(i), 'f', 2) << ","
+            << QString::number(m_result.rhat.value(i), 'f', 4) << "\n";
+    }
+
+    QTextStream samplesOut(&samplesFile);
+    samplesOut.setGenerateByteOrderMark(true);
+    samplesOut << "序号";
+    for (const ParameterInterval& iv : m_result.intervals) samplesOut << "," << iv.name;
+    samplesOut << "\n";
+    for (int k = 0; k < m_result.samples.size(); ++k) {
+        samplesOut << (k + 1);
+        for (double v : m_result.samples[k]) samplesOut << "," << QString::number(v, 'g', 8);
+        samplesOut << "\n";
+    }
+
+    QMessageBox::information(this, "成功", QString("后验统计已导出:\n%1\n\n后验样本:\n%2").arg(fileName, samplesName));
+}
+
+QString McmcResultDialog::toHtml(const McmcResult& r)
+{
+    QString html;
+    html += QString("<p>集合 MCMC (stretch move)：walker %1 个，%2 步 (预热 %3，抽稀 %4)，后验样本 %5 个，接受率 %6%，%7。</p>")
+                .arg(r.state.walkers).arg(r.state.step).arg(r.burnIn).arg(r.thin).arg(r.samples.size())
+                .arg(r.acceptance * 100.0, 0, 'f', 1)
+                .arg(r.converged ? "已满足收敛判据" : "未满足收敛判据");
+    html += "<table><tr><th>参数</th><th>起始值</th><th>P10</th><th>P50</th><th>P90</th><th>均值</th><th>标准差</th><th>τ</th><th>R-hat</th></tr>";
+    for (int i = 0; i < r.intervals.size(); ++i) {
+        const ParameterInterval& iv = r.intervals[i];
+        html += QString("<tr><td>%1 (%2)</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td><td>%8</td><td>%9</td>")
+                    .arg(iv.displayName.toHtmlEscaped(), iv.name.toHtmlEscaped(), fmt(iv.fitted), fmt(iv.p10), fmt(iv.p50),
+                         fmt(iv.p90), fmt(iv.mean), fmt(iv.stdDev), QString::number(r.tau.value(i), 'f', 1));
+        html += QString("<td>%1</td></tr>").arg(r.rhat.value(i), 0, 'f', 3);
+    }
+    html += "</table>";
+    return html;
+}
@@ -0,0 +1,62 @@
+/*
+ * 文件名: mcmcdialog.h
+ * 文件作用: MCMC 后验采样的设置与结果对话框头文件
+ * 功能描述:
+ * 1. McmcSettingsDialog：walker 数、最大步数、随机种子、收敛判据，以及是否从已保存的检查点继续。
+ * 2. McmcResultDialog：
+ *    - “后验统计”页：各参数 P10/P50/P90、均值、标准差、自相关时间 τ、R-hat 及采样诊断；
+ *    - “角图”页：对角线为各参数后验直方图，下三角为两两参数的样本散点；
+ *    - 可导出统计表与后验样本 (CSV)。
+ */
+
+#ifndef MCMCDIALOG_H
+#define MCMCDIALOG_H
+
+#include <QDialog>
+#include "fittingmcmc.h"
+
+class QSpinBox;
+class QDoubleSpinBox;
+class QCheckBox;
+class QWidget;
+
+class McmcSettingsDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    /**
+     * @param checkpointSteps 可继续的检查点已完成步数，0 表示没有可用检查点
+     */
+    McmcSettingsDialog(const McmcOptions& options, int fitParamCount, int checkpointSteps, QWidget* parent = nullptr);
+
+    McmcOptions options() const;
+    bool resumeFromCheckpoint() const;
+
+private:
+    QSpinBox* m_walkers = nullptr;
+    QSpinBox* m_maxSteps = nullptr;
+    QSpinBox* m_seed = nullptr;
+    QDoubleSpinBox* m_tauFactor = nullptr;
+    QCheckBox* m_resume = nullptr;
+};
+
+class McmcResultDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit McmcResultDialog(const McmcResult& result, QWidget* parent = nullptr);
+
+    // 后验统计与诊断 (HTML)，供拟合报告使用
+    static QString toHtml(const McmcResult& result);
+
+private slots:
+    void onExportCsv();
+
+private:
+    QWidget* buildStatisticsPage();
+    QWidget* buildCornerPage();
+
+    McmcResult m_result;
+};
+
+#endif // MCMCDIALOG_H
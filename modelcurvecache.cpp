@@ -0,0 +1,132 @@
+/*
+ * 文件名: modelcurvecache.cpp
+ * 文件作用: 理论曲线持久化缓存实现文件
+ * 功能描述:
+ * 1. 缓存键：按固定顺序把全部输入的二进制表示送入 SHA-1 (参数按名称有序，双精度按位参与)，
+ *    同一输入在任何平台得到相同的键。
+ * 2. 曲线以 JSON 数组保存，读取时校验三列等长，不完整的缓存视为无缓存。
+ * 3. compute() 的误差计算与拟合一致：统一抽样后按压差/导数权重与逐点密度权重计算残差。
+ * 4. [修改] 键格式版本 2 起逐点密度权重参与误差计算与缓存键，旧版本缓存全部失效。
+ */
+
+#include "modelcurvecache.h"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+
+namespace {
+
+const qint32 kCacheKeyVersion = 2;  // 键格式/误差定义变化时递增
+
+void addDouble(QCryptographicHash& hash, double v)
+{
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(&v), sizeof(v)));
+}
+
+void addInt(QCryptographicHash& hash, qint32 v)
+{
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(&v), sizeof(v)));
+}
+
+void addVector(QCryptographicHash& hash, const QVector<double>& v)
+{
+    addInt(hash, v.size());
+    if (!v.isEmpty()) hash.addData(QByteArrayView(reinterpret_cast<const char*>(v.constData()), v.size() * sizeof(double)));
+}
+
+QJsonArray toArray(const QVector<double>& v)
+{
+    QJsonArray arr;
+    for (double x : v) arr.append(x);
+    return arr;
+}
+
+QVector<double> fromArray(const QJsonArray& arr)
+{
+    QVector<double> v;
+    v.reserve(arr.size());
+    for (const QJsonValue& x : arr) v.append(x.toDouble());
+    return v;
+}
+
+} // namespace
+
+QString ModelCurveRequest::cacheKey() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addInt(hash, kCacheKeyVersion);
+    addInt(hash, ModelSolver01_06::SolverVersion);
+    addInt(hash, static_cast<qint32>(type));
+    addInt(hash, highPrecision ? 1 : 0);
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        hash.addData(it.key().toUtf8());
+        addDouble(hash, it.value());
+    }
+    addVector(hash, time);
+
+    addVector(hash, obsT);
+    addVector(hash, obsP);
+    addVector(hash, obsD);
+    addDouble(hash, weight);
+    addInt(hash, customSampling ? 1 : 0);
+    if (customSampling) {
+        for (const SamplingInterval& s : intervals) {
+            addDouble(hash, s.tStart);
+            addDouble(hash, s.tEnd);
+            addInt(hash, s.count);
+        }
+    }
+    if (!customSampling && adaptiveSampleCount > 0) {
+        addInt(hash, -1);
+        addInt(hash, adaptiveSampleCount);
+    }
+    addInt(hash, densityWeighting ? 1 : 0);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QJsonObject ModelCurveCache::toJson() const
+{
+    QJsonObject obj;
+    obj["key"] = key;
+    obj["time"] = toArray(t);
+    obj["pressure"] = toArray(p);
+    obj["derivative"] = toArray(d);
+    obj["mse"] = mse;
+    return obj;
+}
+
+ModelCurveCache ModelCurveCache::fromJson(const QJsonObject& json)
+{
+    ModelCurveCache cache;
+    if (json.isEmpty()) return cache;
+    cache.t = fromArray(json["time"].toArray());
+    cache.p = fromArray(json["pressure"].toArray());
+    cache.d = fromArray(json["derivative"].toArray());
+    cache.mse = json["mse"].toDouble(-1.0);
+    if (!cache.t.isEmpty() && cache.t.size() == cache.p.size() && cache.t.size() == cache.d.size())
+        cache.key = json["key"].toString();
+    return cache;
+}
+
+ModelCurveCache ModelCurveCache::compute(const ModelCurveRequest& request, const FittingCore::ModelEvaluator& evaluator)
+{
+    ModelCurveCache cache;
+    ModelCurveData curve = evaluator(request.type, request.params, request.time);
+    cache.t = std::get<0>(curve);
+    cache.p = std::get<1>(curve);
+    cache.d = std::get<2>(curve);
+
+    if (!request.obsT.isEmpty()) {
+        QVector<double> sampleT, sampleP, sampleD;
+        FittingCore::getLogSampledData(request.obsT, request.obsP, request.obsD,
+                                       request.customSampling, request.intervals, sampleT, sampleP, sampleD,
+                                       request.adaptiveSampleCount);
+        FittingCore core(evaluator);
+        core.setPointWeights(FittingCore::samplingPointWeights(sampleT, request.customSampling,
+                                                               request.adaptiveSampleCount, request.densityWeighting));
+        QVector<double> residuals = core.calculateResiduals(request.params, request.type, request.weight, sampleT, sampleP, sampleD);
+        if (!residuals.isEmpty()) cache.mse = FittingCore::calculateSumSquaredError(residuals) / residuals.size();
+    }
+    cache.key = request.cacheKey();
+    return cache;
+}
@@ -0,0 +1,56 @@
+/*
+ * 文件名: modelcurvecache.h
+ * 文件作用: 理论曲线持久化缓存头文件
+ * 功能描述:
+ * 1. 定义 ModelCurveRequest：计算一条理论曲线 (及其拟合误差) 所需的全部输入。
+ * 2. 缓存键为输入的 SHA-1：键格式版本、模型类型、参数、求解器算法版本、计算精度、时间网格，
+ *    以及误差计算用的观测数据、权重、抽样设置与按密度加权开关；任一项变化缓存即失效。
+ * 3. 定义 ModelCurveCache：曲线 (t, Δp, 导数) 与 MSE，随拟合分析状态一起保存到项目文件。
+ * 4. compute() 不访问界面对象，可在工作线程中执行。
+ */
+
+#ifndef MODELCURVECACHE_H
+#define MODELCURVECACHE_H
+
+#include <QMap>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QJsonObject>
+
+#include "fittingcore.h"
+
+// 一条理论曲线的计算输入
+struct ModelCurveRequest {
+    ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+    QMap<QString, double> params;       // 已应用约束的参数
+    QVector<double> time;               // 绘图时间网格
+    bool highPrecision = true;
+
+    // 误差计算输入 (观测数据为空时不计算误差)
+    QVector<double> obsT, obsP, obsD;
+    double weight = 0.5;
+    bool customSampling = false;
+    QList<SamplingInterval> intervals;
+    int adaptiveSampleCount = 0;        // 自适应抽样目标点数 (0 表示不启用)
+    bool densityWeighting = false;      // 非均匀抽样时按抽样密度加权残差 (与拟合时的逐点权重一致)
+
+    QString cacheKey() const;
+};
+
+// 理论曲线缓存
+struct ModelCurveCache {
+    QString key;                        // 为空表示无缓存
+    QVector<double> t, p, d;
+    double mse = -1.0;                  // 无观测数据时为负
+
+    bool isValid() const { return !key.isEmpty(); }
+
+    QJsonObject toJson() const;
+    static ModelCurveCache fromJson(const QJsonObject& json);
+
+    // 计算曲线与误差，返回带键的缓存
+    static ModelCurveCache compute(const ModelCurveRequest& request, const FittingCore::ModelEvaluator& evaluator);
+};
+
+#endif // MODELCURVECACHE_H
@@ -5,6 +5,10 @@
  * 1. 实例化并管理 6 个 WT_ModelWidget (用于界面显示)。
  * 2. 实例化并管理 6 个 ModelSolver01_06 (用于后台计算)。
  * 3. 处理模型选择逻辑，分发计算任务。
+ * 4. [修改] 界面与求解器延迟创建：界面在首次切换到该模型时创建，求解器在首次计算时创建。
+ * 5. [新增] 批量计算分发 calculateTheoreticalCurves。
+ * 6. [新增] generateInversionSharedTimeSteps 委托给求解器。
+ * 7. [修复] setHighPrecision 可在任意线程调用：精度为原子变量，界面精度切换排队到界面线程执行。
  */
 
 #include "modelmanager.h"
@@ -12,24 +16,32 @@
 #include "modelparameter.h"
 #include "wt_modelwidget.h"
 #include "modelsolver01-06.h"
+#include "startupprofiler.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QGroupBox>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
 #include <cmath>
 
 ModelManager::ModelManager(QWidget* parent)
     : QObject(parent), m_mainWidget(nullptr), m_modelStack(nullptr)
+    , m_highPrecision(true)
     , m_currentModelType(Model_1)
 {
+    // 6 种模型的槽位，实际对象延迟创建
+    m_modelWidgets.fill(nullptr, 6);
+    m_solvers.fill(nullptr, 6);
 }
 
 ModelManager::~ModelManager()
 {
     // 清理求解器内存 (Widget 由 Qt 父子对象机制自动清理)
-    qDeleteAll(m_solvers);
+    qDeleteAll(m_solvers); // nullptr 槽位 delete 无副作用
     m_solvers.clear();
 }
 
@@ -40,32 +52,11 @@ void ModelManager::initializeModels(QWidget* parentWidget)
 
     m_modelStack = new QStackedWidget(m_mainWidget);
 
-    m_modelWidgets.clear();
-    m_solvers.clear();
-
-    // 循环创建 6 组界面和求解器
-    // 使用 ModelSolver01_06::Model_x 枚举
-    using MT = ModelSolver01_06::ModelType;
-    QList<MT> types = { MT::Model_1, MT::Model_2, MT::Model_3, MT::Model_4, MT::Model_5, MT::Model_6 };
-
-    for(MT type : types) {
-        // 1. 创建界面对象，用于显示和交互
-        WT_ModelWidget* widget = new WT_ModelWidget(type, m_modelStack);
-        m_modelWidgets.append(widget);
-        m_modelStack->addWidget(widget);
-
-        // 连接子界面的模型选择请求信号
-        connect(widget, &WT_ModelWidget::requestModelSelection, this, &ModelManager::onSelectModelClicked);
-
-        // 2. 创建独立的求解器对象，用于后台/拟合计算
-        ModelSolver01_06* solver = new ModelSolver01_06(type);
-        m_solvers.append(solver);
-    }
-
+    // 模型界面不在此处批量创建 (每个界面含独立图表与求解器，构建开销大)，
+    // 由 switchToModel 在首次切换到该模型时创建
     m_mainWidget->layout()->addWidget(m_modelStack);
-    connectModelSignals();
 
-    switchToModel(Model_1);
+    switchToModel(m_currentModelType);
 
     if (parentWidget->layout()) parentWidget->layout()->addWidget(m_mainWidget);
     else {
@@ -84,11 +75,41 @@ void ModelManager::createMainWidget()
     m_mainWidget->setLayout(mainLayout);
 }
 
-void ModelManager::connectModelSignals()
+WT_ModelWidget* ModelManager::ensureModelWidget(ModelType type)
 {
-    for(WT_ModelWidget* w : m_modelWidgets) {
-        connect(w, &WT_ModelWidget::calculationCompleted, this, &ModelManager::onWidgetCalculationCompleted);
+    int index = (int)type;
+    if (!m_modelStack || index < 0 || index >= m_modelWidgets.size()) return nullptr;
+    if (m_modelWidgets[index]) return m_modelWidgets[index];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 创建界面对象，用于显示和交互 (构造时从全局项目参数初始化)
+    WT_ModelWidget* widget = new WT_ModelWidget(type, m_modelStack);
+    widget->setHighPrecision(m_highPrecision);
+    m_modelWidgets[index] = widget;
+    m_modelStack->addWidget(widget);
+
+    // 连接子界面的模型选择请求信号与计算完成信号
+    connect(widget, &WT_ModelWidget::requestModelSelection, this, &ModelManager::onSelectModelClicked);
+    connect(widget, &WT_ModelWidget::calculationCompleted, this, &ModelManager::onWidgetCalculationCompleted);
+
+    StartupProfiler::recordLazyInit(getModelTypeName(type) + " 界面", timer.nsecsElapsed());
+    return widget;
+}
+
+ModelSolver01_06* ModelManager::solverFor(ModelType type)
+{
+    int index = (int)type;
+    if (index < 0 || index >= m_solvers.size()) return nullptr;
+
+    QMutexLocker locker(&m_solverMutex);
+    if (!m_solvers[index]) {
+        // 创建独立的求解器对象，用于后台/拟合计算
+        m_solvers[index] = new ModelSolver01_06(type);
+        m_solvers[index]->setHighPrecision(m_highPrecision);
     }
+    return m_solvers[index];
 }
 
 void ModelManager::switchToModel(ModelType modelType)
@@ -96,10 +117,8 @@ void ModelManager::switchToModel(ModelType modelType)
     if (!m_modelStack) return;
     ModelType old = m_currentModelType;
     m_currentModelType = modelType;
-    int index = (int)modelType;
-
-    if (index >= 0 && index < m_modelWidgets.size()) {
-        m_modelStack->setCurrentIndex(index);
+    if (WT_ModelWidget* widget = ensureModelWidget(modelType)) {
+        m_modelStack->setCurrentWidget(widget);
     }
 
     emit modelSwitched(modelType, old);
@@ -133,20 +152,31 @@ void ModelManager::onWidgetCalculationCompleted(const QString &t, const QMap<QSt
 }
 
 void ModelManager::setHighPrecision(bool high) {
-    // 1. 设置界面里的求解器精度
-    for(WT_ModelWidget* w : m_modelWidgets) {
-        w->setHighPrecision(high);
-    }
-    // 2. 设置后台求解器精度 (关键：拟合时使用的是这里的求解器)
-    for(ModelSolver01_06* s : m_solvers) {
-        s->setHighPrecision(high);
+    // 1. 设置后台求解器精度 (与 solverFor 的延迟创建互斥)
+    {
+        QMutexLocker locker(&m_solverMutex);
+        m_highPrecision = high;
+        for(ModelSolver01_06* s : m_solvers) {
+            if (s) s->setHighPrecision(high);
+        }
     }
+
+    // 2. 设置界面里的求解器精度 (仅已创建的界面)：界面列表只在界面线程读写，其他线程调用时排队执行；
+    //    排队期间新建的界面已读取 m_highPrecision 的新值
+    auto applyToWidgets = [this, high]() {
+        for(WT_ModelWidget* w : m_modelWidgets) {
+            if (w) w->setHighPrecision(high);
+        }
+    };
+    if (QThread::currentThread() == thread()) applyToWidgets();
+    else QMetaObject::invokeMethod(this, applyToWidgets, Qt::QueuedConnection);
 }
 
 void ModelManager::updateAllModelsBasicParameters()
 {
+    // 未创建的界面在创建时自动读取全局参数，无需刷新
     for(WT_ModelWidget* w : m_modelWidgets) {
-        QMetaObject::invokeMethod(w, "onResetParameters");
+        if (w) QMetaObject::invokeMethod(w, "onResetParameters");
     }
     qDebug() << "所有模型的参数已从全局项目设置中刷新。";
 }
@@ -193,19 +223,34 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
 // [核心修改] 使用独立的 Solver 进行计算，不再调用 Widget 方法
 ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
-    int index = (int)type;
     // 使用 m_solvers 而不是 m_modelWidgets
-    if (index >= 0 && index < m_solvers.size()) {
-        return m_solvers[index]->calculateTheoreticalCurve(params, providedTime);
+    if (ModelSolver01_06* solver = solverFor(type)) {
+        return solver->calculateTheoreticalCurve(params, providedTime);
     }
     return ModelCurveData();
 }
 
+QVector<ModelCurveData> ModelManager::calculateTheoreticalCurves(ModelType type, const QVector<QMap<QString, double>>& paramSets, const QVector<double>& providedTime)
+{
+    if (ModelSolver01_06* solver = solverFor(type)) {
+        return solver->calculateTheoreticalCurves(paramSets, providedTime);
+    }
+    return QVector<ModelCurveData>(paramSets.size());
+}
+
 QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
     // 委托给 Solver 的静态方法
     return ModelSolver01_06::generateLogTimeSteps(count, startExp, endExp);
 }
 
+QVector<double> ModelManager::generateInversionSharedTimeSteps(int count, double startExp, double endExp) {
+    return ModelSolver01_06::generateInversionSharedTimeSteps(count, startExp, endExp);
+}
+
+QVector<double> ModelManager::generateCurveTimeSteps(int count, double startExp, double endExp) {
+    return ModelSolver01_06::generateCurveTimeSteps(count, startExp, endExp);
+}
+
 void ModelManager::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
 {
     m_cachedObsTime = t;
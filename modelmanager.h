@@ -5,6 +5,10 @@
  * 1. 管理所有试井模型界面 (WT_ModelWidget) 的显示与切换。
  * 2. 管理所有数学模型求解器 (ModelSolver01_06) 的实例与计算。
  * 3. 协调模型计算请求，实现界面与算法的解耦。
+ * 4. [修改] 模型界面与求解器均改为首次使用时创建，缩短软件启动时间。
+ * 5. [新增] 批量计算接口：同一模型、同一时间序列的多组参数一次提交给求解器。
+ * 6. [新增] 反演节点共享时间网格 generateInversionSharedTimeSteps (静态工具)。
+ * 7. [修复] 计算精度改为原子变量，界面精度切换只在界面线程执行 (界面延迟创建后可能与其他线程并发)。
  */
 
 #ifndef MODELMANAGER_H
@@ -15,6 +19,8 @@
 #include <QVector>
 #include <QStackedWidget>
 #include <QPushButton>
+#include <QMutex>
+#include <atomic>
 
 // 引入新的界面类和求解器类头文件
 #include "wt_modelwidget.h"
@@ -49,17 +55,26 @@ public:
     // 核心计算接口：代理给对应的 Solver 进行计算 (线程安全，可在拟合线程调用)
     ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
 
+    // 批量计算接口：多组参数共用时间序列，结果顺序与 paramSets 一致 (线程安全；内部使用全局线程池)
+    QVector<ModelCurveData> calculateTheoreticalCurves(ModelType type, const QVector<QMap<QString, double>>& paramSets,
+                                                       const QVector<double>& providedTime = QVector<double>());
+
     // 获取默认参数
     QMap<QString, double> getDefaultParameters(ModelType type);
 
-    // 设置全局计算精度
+    // 设置全局计算精度 (线程安全：界面的精度切换转发到界面线程执行)
     void setHighPrecision(bool high);
+    bool isHighPrecision() const { return m_highPrecision.load(); }
 
     // 刷新所有界面模型的参数显示
     void updateAllModelsBasicParameters();
 
     // 生成对数时间步长 (静态工具)
     static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+    // 生成反演节点共享的时间步长 (按 2 的分数次幂等比，约 count 个点)，Stehfest 求值约减半
+    static QVector<double> generateInversionSharedTimeSteps(int count, double startExp, double endExp);
+    // 生成显示/报告曲线的时间步长 (默认对数均匀；设置开启时为反演节点共享网格)
+    static QVector<double> generateCurveTimeSteps(int count, double startExp, double endExp);
 
     // 观测数据缓存管理
     void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
@@ -78,17 +93,24 @@ private slots:
 
 private:
     void createMainWidget();
-    void connectModelSignals();
+
+    // 获取 (必要时创建) 指定模型的界面，仅界面线程调用
+    WT_ModelWidget* ensureModelWidget(ModelType type);
+
+    // 获取 (必要时创建) 指定模型的求解器，线程安全
+    ModelSolver01_06* solverFor(ModelType type);
 
 private:
     QWidget* m_mainWidget;
     QStackedWidget* m_modelStack;
 
-    // [修改] 界面列表使用 WT_ModelWidget
+    // [修改] 界面列表使用 WT_ModelWidget (按模型类型索引，未创建时为 nullptr)
     QVector<WT_ModelWidget*> m_modelWidgets;
 
-    // [新增] 求解器列表，用于纯数学计算 (与界面分离)
+    // [新增] 求解器列表，用于纯数学计算 (与界面分离，未创建时为 nullptr)
     QVector<ModelSolver01_06*> m_solvers;
+    QMutex m_solverMutex;       // 保护求解器的延迟创建 (拟合线程会并发调用)
+    std::atomic<bool> m_highPrecision;  // 当前计算精度，新建的界面/求解器沿用
 
     ModelType m_currentModelType;
 
@@ -4,9 +4,11 @@
  * 功能描述:
  * 1. 实现项目数据的加载与保存。
  * 2. [关键] loadProject 时强制读取 _date.json 到 m_fullProjectData["table_data"]，解决数据丢失问题。
+ * 3. 项目加载与保存记录时间线区间 (TraceRecorder)。
  */
 
 #include "modelparameter.h"
+#include "tracerecorder.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QFileInfo>
@@ -69,6 +71,8 @@ QString ModelParameter::getTableDataFilePath() const
 
 bool ModelParameter::loadProject(const QString& filePath)
 {
+    TraceSpan traceSpan("ModelParameter::loadProject", "project");
+
     // 1. 加载主项目文件 (.pwt)
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -145,6 +149,8 @@ bool ModelParameter::loadProject(const QString& filePath)
 
 bool ModelParameter::saveProject()
 {
+    TraceSpan traceSpan("ModelParameter::saveProject", "project");
+
     if (!m_hasLoaded || m_projectFilePath.isEmpty()) return false;
 
     // 更新参数到内存对象
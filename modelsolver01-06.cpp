@@ -6,16 +6,40 @@
  * 2. 包含 Stehfest 数值反演算法、自适应高斯积分、Bessel 函数调用等核心算法。
  * 3. 实现了数据处理和物理量到无因次量的转换逻辑。
  * 4. [修改] 强制在计算中执行 LfD = Lf / L 的约束逻辑，确保物理意义一致。
+ * 5. 在热点路径上记录性能计数 (拉普拉斯/Bessel 调用、积分深度、LU 求解、NaN/Inf 置零、阶段耗时)，见 perfcounters.h。
+ * 6. [修改] 沿裂缝积分由 gauss15 二分递归 (每层 3 次 15 点求积、父层结果丢弃) 改为 G7K15 嵌套求积 +
+ *    优先队列全局自适应：误差估计复用同一组节点，只细分误差最大的区间；
+ *    自身裂缝段 (i == j) 的对数奇点放在分段点上，避免在奇点处取值。
+ * 7. [新增] 批量计算 calculateTheoreticalCurves：拉普拉斯函数拆为储层解与井储/表皮两部分，
+ *    储层参数相同的参数组共用储层解；Stehfest 系数按 N 只算一次；逐点运算顺序与单组计算相同，结果逐位一致。
+ *    不做跨参数组向量化，各组的 Bessel 与代数运算仍为标量，加速来自共享储层解与线程并行。
+ * 8. [新增] 裂缝布置 fractureLayout：支持裂缝表给出的非均匀位置与半长；裂缝条数 >= HMatrixMinFractures 时
+ *    影响矩阵由 FractureHMatrix 压缩并用 GMRES 求解，未收敛时对压缩矩阵做 LU；裂缝较少时与原稠密解法逐位一致。
+ * 9. [修改] Stehfest 反演先汇总整条曲线的全部节点 z = m·ln2/tD，按相对容限 LaplaceNodeMergeTol 合并重合节点，
+ *    每个节点只求一次拉普拉斯函数再分发回各时间点 (可并行)；批量计算的储层解同样按节点去重。
+ *    省去的调用次数记入 LaplaceNodesShared 计数；共享节点的时间网格见 generateInversionSharedTimeSteps。
+ *    [修复] 共享网格末点固定为 10^endExp，仅在设置开启时由 generateCurveTimeSteps 采用。
+ * 10. [修复] 沿裂缝积分容限由相对误差改为绝对误差 QuadraturePdError / Σ|Vi| (原 gauss15 的 1e-5 即为绝对容限)；
+ *     Stehfest 系数与该容限按 N 缓存在 stehfestTable 中，拉普拉斯函数每次调用不再重算阶乘。
+ *     [修复] stehfestTable 改为首次使用时建好的只读数组 (按 N 下标)，热点路径与并行任务查表不再加锁。
+ * 11. [修复] 线程池任务挂接调用线程的性能累加器 (PerfAccumulatorScope)，单次拟合的计数包含其并行求值。
  */
 
 #include "modelsolver01-06.h"
 #include "pressurederivativecalculator.h"
+#include "perfcounters.h"
+#include "tracerecorder.h"
+#include "fracturehmatrix.h"
 
 #include <Eigen/Dense>
 #include <boost/math/special_functions/bessel.hpp>
 #include <cmath>
 #include <algorithm>
+#include <queue>
+#include <vector>
+#include <atomic>
 #include <QDebug>
+#include <QtConcurrent>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -25,6 +49,7 @@
 ModelSolver01_06::ModelSolver01_06(ModelType type)
     : m_type(type)
     , m_highPrecision(true)
+    , m_parallelInversion(false)
 {
 }
 
@@ -39,6 +64,12 @@ void ModelSolver01_06::setHighPrecision(bool high)
     m_highPrecision = high;
 }
 
+// 设置单条曲线反演节点是否并行求值
+void ModelSolver01_06::setParallelInversion(bool parallel)
+{
+    m_parallelInversion = parallel;
+}
+
 // 获取模型名称
 QString ModelSolver01_06::getModelName(ModelType type)
 {
@@ -66,30 +97,93 @@ QVector<double> ModelSolver01_06::generateLogTimeSteps(int count, double startEx
     return t;
 }
 
+// 生成反演节点共享的时间序列 (按 2 的分数次幂等比)
+QVector<double> ModelSolver01_06::generateInversionSharedTimeSteps(int count, double startExp, double endExp)
+{
+    if (count <= 2 || endExp <= startExp) return generateLogTimeSteps(count, startExp, endExp);
+
+    // 每倍频程 q 个点：t_{j+q} = 2·t_j，于是第 j 点的第 m 项与第 j+q 点的第 2m 项节点相同
+    const double octaves = (endExp - startExp) / log10(2.0);
+    const int q = std::max(1, int(std::lround((count - 1) / octaves)));
+    const int steps = int(std::floor(octaves * q + 1e-9)); // 不超过终点的最后一个格点
+
+    QVector<double> t;
+    t.reserve(steps + 2);
+    const double t0 = pow(10.0, startExp);
+    const double tEnd = pow(10.0, endExp);
+    for (int j = 0; j <= steps; ++j) {
+        t.append(std::min(t0 * pow(2.0, double(j) / q), tEnd));
+    }
+    // 末点固定为观测终点：最后一个格点落在终点上时直接替换，否则补上终点
+    if (t.last() < tEnd * (1.0 - 1e-9)) t.append(tEnd);
+    else t.last() = tEnd;
+    return t;
+}
+
+static std::atomic<bool> s_sharedInversionGrid(false);
+
+void ModelSolver01_06::setSharedInversionGrid(bool enabled)
+{
+    s_sharedInversionGrid.store(enabled, std::memory_order_relaxed);
+}
+
+bool ModelSolver01_06::isSharedInversionGrid()
+{
+    return s_sharedInversionGrid.load(std::memory_order_relaxed);
+}
+
+// 显示/报告曲线的时间序列：按设置选择对数均匀网格或反演节点共享网格
+QVector<double> ModelSolver01_06::generateCurveTimeSteps(int count, double startExp, double endExp)
+{
+    if (isSharedInversionGrid()) return generateInversionSharedTimeSteps(count, startExp, endExp);
+    return generateLogTimeSteps(count, startExp, endExp);
+}
+
+// 汇总整条曲线的反演节点并合并重合节点
+ModelSolver01_06::LaplaceNodes ModelSolver01_06::collectLaplaceNodes(const QVector<double>& tD, int N)
+{
+    const double ln2 = log(2.0);
+    const int numPoints = tD.size();
+
+    // (z, 项下标) 按 z 排序，相对差不超过容限的连续节点归并到该段第一个 (最小) 节点
+    std::vector<std::pair<double, int>> entries;
+    entries.reserve(size_t(numPoints) * N);
+    for (int k = 0; k < numPoints; ++k) {
+        double t = tD[k];
+        if (t <= 1e-12) continue;
+        for (int m = 1; m <= N; ++m) entries.emplace_back(m * ln2 / t, k * N + (m - 1));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    LaplaceNodes nodes;
+    nodes.nodeOf.assign(size_t(numPoints) * N, -1);
+    for (const auto& entry : entries) {
+        if (nodes.z.empty() || entry.first - nodes.z.back() > LaplaceNodeMergeTol * nodes.z.back()) {
+            nodes.z.push_back(entry.first);
+        }
+        nodes.nodeOf[entry.second] = int(nodes.z.size()) - 1;
+    }
+    return nodes;
+}
+
 // 核心计算函数
 ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
+    PerfStageTimer perfTimer(PerfCounters::Stage_TheoreticalCurve);
+    PerfCounters::add(PerfCounters::CurveEvaluations);
+    TraceSpan traceSpan("ModelSolver01_06::calculateTheoreticalCurve", "model", static_cast<int>(m_type) + 1);
+
     // 1. 准备时间序列
     QVector<double> tPoints = providedTime;
     if (tPoints.isEmpty()) {
         tPoints = generateLogTimeSteps(100, -3.0, 3.0);
     }
 
-    // 2. 提取物理参数
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
+    // 2. 无因次时间系数与压力系数
+    double td_coeff = 0.0, p_coeff = 0.0;
+    dimensionlessCoefficients(params, td_coeff, p_coeff);
 
     // 3. 计算无因次时间 tD
-    // 注意：这里的系数 14.4 是基于特定单位制的工程常数
-    // 公式: tD = C * k * t / (phi * mu * Ct * L^2)
-    double td_coeff = 14.4 * kf / (phi * mu * Ct * pow(L, 2));
-
     QVector<double> tD_vec;
     tD_vec.reserve(tPoints.size());
     for(double t : tPoints) {
@@ -103,9 +197,6 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
 
     // 5. 将无因次量转换为物理量 (压差 dp)
-    // dp = 1.842e-3 * q * mu * B / (k * h) * pD
-    double p_coeff = 1.842e-3 * q * mu * B / (kf * h);
-
     QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
 
     for(int i=0; i<tPoints.size(); ++i) {
@@ -116,6 +207,173 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     return std::make_tuple(tPoints, finalP, finalDP);
 }
 
+// 无因次时间系数与压力系数
+void ModelSolver01_06::dimensionlessCoefficients(const QMap<QString, double>& params, double& tdCoeff, double& pCoeff)
+{
+    double phi = params.value("phi", 0.05);
+    double mu = params.value("mu", 0.5);
+    double B = params.value("B", 1.05);
+    double Ct = params.value("Ct", 5e-4);
+    double q = params.value("q", 5.0);
+    double h = params.value("h", 20.0);
+    double kf = params.value("kf", 1e-3);
+    double L = params.value("L", 1000.0);
+
+    // 注意：这里的系数 14.4 是基于特定单位制的工程常数
+    // 公式: tD = C * k * t / (phi * mu * Ct * L^2)
+    tdCoeff = 14.4 * kf / (phi * mu * Ct * pow(L, 2));
+    // dp = 1.842e-3 * q * mu * B / (k * h) * pD
+    pCoeff = 1.842e-3 * q * mu * B / (kf * h);
+}
+
+// 批量计算多组参数的理论曲线
+QVector<ModelCurveData> ModelSolver01_06::calculateTheoreticalCurves(const QVector<QMap<QString, double>>& paramSets,
+                                                                     const QVector<double>& providedTime, bool parallel)
+{
+    const int setCount = paramSets.size();
+    if (setCount == 0) return QVector<ModelCurveData>();
+
+    PerfStageTimer perfTimer(PerfCounters::Stage_TheoreticalCurve);
+    PerfCounters::add(PerfCounters::CurveEvaluations, setCount);
+    TraceSpan traceSpan("ModelSolver01_06::calculateTheoreticalCurves", "model", setCount);
+
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+    const int numPoints = tPoints.size();
+    const double ln2 = log(2.0);
+
+    // 1. 按储层解的全部输入 (tD 系数、反演项数、储层/裂缝参数) 分组，同组共用拉普拉斯空间储层解
+    struct ReservoirGroup {
+        std::vector<double> key;
+        int leader = 0;                 // 代表参数组
+        int N = 4;
+        QVector<double> tD;
+        LaplaceNodes nodes;             // 去重后的反演节点
+        std::vector<double> values;     // values[i]：第 i 个节点上的储层解
+    };
+    std::vector<ReservoirGroup> groups;
+    QVector<int> groupOf(setCount);
+    QVector<double> pCoeffs(setCount);
+    for (int s = 0; s < setCount; ++s) {
+        const QMap<QString, double>& p = paramSets[s];
+        double tdCoeff = 0.0;
+        dimensionlessCoefficients(p, tdCoeff, pCoeffs[s]);
+        int N = stehfestTermCount(p);
+        QVector<double> xwD, halfLengthD;
+        fractureLayout(p, xwD, halfLengthD);
+        std::vector<double> key = { tdCoeff, double(N), p.value("kf"), p.value("km"), p.value("rmD"),
+                                    p.value("reD", 0.0), p.value("omega1"), p.value("omega2"), p.value("lambda1") };
+        key.insert(key.end(), xwD.begin(), xwD.end());
+        key.insert(key.end(), halfLengthD.begin(), halfLengthD.end());
+
+        int g = 0;
+        while (g < (int)groups.size() && groups[g].key != key) ++g;
+        if (g == (int)groups.size()) {
+            ReservoirGroup group;
+            group.key = key;
+            group.leader = s;
+            group.N = N;
+            group.tD.reserve(numPoints);
+            for (double t : tPoints) group.tD.append(tdCoeff * t);
+            group.nodes = collectLaplaceNodes(group.tD, N);
+            group.values.assign(group.nodes.z.size(), 0.0);
+            int entryCount = 0;
+            for (int node : group.nodes.nodeOf) if (node >= 0) ++entryCount;
+            PerfCounters::add(PerfCounters::LaplaceNodesShared, entryCount - int(group.nodes.z.size()));
+            groups.push_back(std::move(group));
+        }
+        groupOf[s] = g;
+    }
+
+    // 2. 储层解：工作项为 (组, 去重节点)
+    {
+        PerfStageTimer inversionTimer(PerfCounters::Stage_LaplaceInversion);
+        QVector<QPair<int, int>> items;
+        for (int g = 0; g < (int)groups.size(); ++g) {
+            for (int i = 0; i < (int)groups[g].nodes.z.size(); ++i) items.append(qMakePair(g, i));
+        }
+        auto evaluateReservoir = [&](const QPair<int, int>& item) {
+            ReservoirGroup& group = groups[item.first];
+            group.values[item.second] = laplaceReservoir(group.nodes.z[item.second], paramSets[group.leader]);
+        };
+        if (parallel && items.size() > 1) {
+            PerfAccumulator* perf = PerfCounters::currentAccumulator();
+            QtConcurrent::blockingMap(items, [&](const QPair<int, int>& item) {
+                PerfAccumulatorScope perfScope(perf);
+                evaluateReservoir(item);
+            });
+        } else {
+            for (const QPair<int, int>& item : items) evaluateReservoir(item);
+        }
+    }
+
+    // 3. 逐组叠加井储/表皮、反演、压敏修正、求导并转换为物理量
+    std::vector<ModelCurveData> results(setCount);
+    auto assemble = [&](int s) {
+        const QMap<QString, double>& p = paramSets[s];
+        const ReservoirGroup& group = groups[groupOf.at(s)];
+        const QVector<double>& w = stehfestTable(group.N).weights;
+        const double pCoeff = pCoeffs.at(s);
+        const bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
+        const double gamaD = p.value("gamaD", 0.0);
+
+        QVector<double> PD(numPoints), deriv(numPoints);
+        for (int k = 0; k < numPoints; ++k) {
+            double t = group.tD.at(k);
+            if (t <= 1e-12) { PD[k] = 0; continue; }
+
+            double pd_val = 0.0;
+            for (int m = 1; m <= group.N; ++m) {
+                int node = group.nodes.nodeOf[size_t(k) * group.N + (m - 1)];
+                double pf = group.values[node];
+                if (hasStorage) pf = applyWellboreStorage(group.nodes.z[node], pf, p);
+                if (std::isnan(pf) || std::isinf(pf)) {
+                    PerfCounters::add(PerfCounters::NanInfReplacements);
+                    pf = 0.0;
+                }
+                pd_val += w[m - 1] * pf;
+            }
+            PD[k] = pd_val * ln2 / t;
+
+            if (std::abs(gamaD) > 1e-9) {
+                double arg = 1.0 - gamaD * PD[k];
+                if (arg > 1e-12) {
+                    PD[k] = -1.0 / gamaD * std::log(arg);
+                }
+            }
+        }
+
+        if (numPoints > 2) {
+            PerfStageTimer derivTimer(PerfCounters::Stage_Derivative);
+            deriv = PressureDerivativeCalculator::calculateBourdetDerivative(group.tD, PD, 0.1);
+        } else {
+            deriv.fill(0.0);
+        }
+
+        QVector<double> finalP(numPoints), finalDP(numPoints);
+        for (int i = 0; i < numPoints; ++i) {
+            finalP[i] = pCoeff * PD[i];
+            finalDP[i] = pCoeff * deriv[i];
+        }
+        results[s] = std::make_tuple(tPoints, finalP, finalDP);
+    };
+
+    QVector<int> indices(setCount);
+    for (int s = 0; s < setCount; ++s) indices[s] = s;
+    if (parallel && setCount > 1) {
+        PerfAccumulator* perf = PerfCounters::currentAccumulator();
+        QtConcurrent::blockingMap(indices, [&](const int& s) {
+            PerfAccumulatorScope perfScope(perf);
+            assemble(s);
+        });
+    } else {
+        for (int s : indices) assemble(s);
+    }
+    return QVector<ModelCurveData>(results.begin(), results.end());
+}
+
 // Stehfest 数值反演计算 PD 和导数
 void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
                                            std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
@@ -125,37 +383,65 @@ void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap
     outPD.resize(numPoints);
     outDeriv.resize(numPoints);
 
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
+    int N = stehfestTermCount(params);
     double ln2 = log(2.0);
 
     double gamaD = params.value("gamaD", 0.0);
 
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
-
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
+    // Stehfest 反演 (单独计时)
+    {
+        PerfStageTimer inversionTimer(PerfCounters::Stage_LaplaceInversion);
+
+        // 1. 汇总并去重整条曲线的反演节点，每个节点只求一次拉普拉斯函数
+        const LaplaceNodes nodes = collectLaplaceNodes(tD, N);
+        const int nodeCount = int(nodes.z.size());
+        int entryCount = 0;
+        for (int node : nodes.nodeOf) if (node >= 0) ++entryCount;
+        PerfCounters::add(PerfCounters::LaplaceNodesShared, entryCount - nodeCount);
+
+        std::vector<double> values(nodeCount, 0.0);
+        if (m_parallelInversion && nodeCount > 1) {
+            QVector<int> indices(nodeCount);
+            for (int i = 0; i < nodeCount; ++i) indices[i] = i;
+            PerfAccumulator* perf = PerfCounters::currentAccumulator();
+            QtConcurrent::blockingMap(indices, [&](const int& i) {
+                PerfAccumulatorScope perfScope(perf);
+                values[i] = laplaceFunc(nodes.z[i], params);
+            });
+        } else {
+            for (int i = 0; i < nodeCount; ++i) values[i] = laplaceFunc(nodes.z[i], params);
         }
-        outPD[k] = pd_val * ln2 / t;
 
-        // 考虑压敏效应修正
-        if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
-            if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
+        // 2. 分发回各时间点，按原顺序累加 Stehfest 求和
+        const QVector<double>& w = stehfestTable(N).weights;
+        for (int k = 0; k < numPoints; ++k) {
+            double t = tD[k];
+            if (t <= 1e-12) { outPD[k] = 0; continue; }
+
+            double pd_val = 0.0;
+            for (int m = 1; m <= N; ++m) {
+                double pf = values[nodes.nodeOf[size_t(k) * N + (m - 1)]];
+                if (std::isnan(pf) || std::isinf(pf)) {
+                    PerfCounters::add(PerfCounters::NanInfReplacements);
+                    pf = 0.0;
+                }
+                pd_val += w[m - 1] * pf;
+            }
+            outPD[k] = pd_val * ln2 / t;
+
+            // 考虑压敏效应修正
+            if (std::abs(gamaD) > 1e-9) {
+                double arg = 1.0 - gamaD * outPD[k];
+                if (arg > 1e-12) {
+                    outPD[k] = -1.0 / gamaD * std::log(arg);
+                }
             }
         }
     }
 
     // 计算导数 (Bourdet 导数)
     if (numPoints > 2) {
+        PerfStageTimer derivTimer(PerfCounters::Stage_Derivative);
         outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
     } else {
         outDeriv.fill(0.0);
@@ -164,9 +450,50 @@ void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap
 
 // 拉普拉斯空间下的复合模型总函数 (包含井储和表皮)
 double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
+    double pf = laplaceReservoir(z, p);
+
+    // 加入井储和表皮效应
+    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
+    if (hasStorage) {
+        pf = applyWellboreStorage(z, pf, p);
+    }
+    return pf;
+}
+
+// 拉普拉斯空间储层解 (不含井储和表皮)
+double ModelSolver01_06::laplaceReservoir(double z, const QMap<QString, double>& p) {
+    PerfCounters::add(PerfCounters::LaplaceEvaluations);
+
     double kf = p.value("kf");
     double km = p.value("km");
 
+    double rmD = p.value("rmD");
+    double reD = p.value("reD", 0.0);
+    double omga1 = p.value("omega1");
+    double omga2 = p.value("omega2");
+    double remda1 = p.value("lambda1");
+
+    double M12 = kf / km;
+
+    // 裂缝位置 xwD 与各裂缝无因次半长
+    QVector<double> xwD, halfLengthD;
+    fractureLayout(p, xwD, halfLengthD);
+
+    double temp = omga2;
+    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
+    double fs2 = M12 * temp;
+
+    // 计算不含井储的拉普拉斯空间压力
+    double quadTol = stehfestTable(stehfestTermCount(p)).quadTol;
+    return PWD_composite(z, fs1, fs2, M12, rmD, reD, xwD, halfLengthD, m_type, quadTol);
+}
+
+// 裂缝布置：裂缝表有效时按表，否则 nf 条等长裂缝均匀分布在 [-0.9, 0.9]
+int ModelSolver01_06::fractureLayout(const QMap<QString, double>& p, QVector<double>& xwD, QVector<double>& halfLengthD)
+{
+    xwD.clear();
+    halfLengthD.clear();
+
     // 强制计算无因次缝长 LfD = Lf / L
     // 即使传入了参数 map，也优先使用 Lf 和 L 计算 LfD，确保数据一致性
     double L = p.value("L");
@@ -178,18 +505,25 @@ double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double
         LfD = p.value("LfD"); // 如果 L 无效，回退到参数值
     }
 
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0);
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
     int nf = (int)p.value("nf", 4);
     if(nf < 1) nf = 1;
 
-    double M12 = kf / km;
+    // 裂缝表：条数与 nf 一致且 L 有效时使用 (位置与半长为米，按 L 无因次化)
+    if (L > 1e-9 && (int)p.value(FractureCountKey, 0.0) == nf) {
+        bool complete = true;
+        for (int i = 1; i <= nf && complete; ++i) {
+            double half = p.value(fractureLfKey(i), 0.0);
+            complete = p.contains(fractureXKey(i)) && half > 0.0;
+            if (complete) {
+                xwD.append(p.value(fractureXKey(i)) / L);
+                halfLengthD.append(half / L);
+            }
+        }
+        if (complete) return nf;
+        xwD.clear();
+        halfLengthD.clear();
+    }
 
-    // 生成裂缝位置 xwD
-    QVector<double> xwD;
     if (nf == 1) {
         xwD.append(0.0);
     } else {
@@ -198,40 +532,35 @@ double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double
         double step = (end - start) / (nf - 1);
         for(int i=0; i<nf; ++i) xwD.append(start + i * step);
     }
+    halfLengthD.fill(LfD, nf);
+    return nf;
+}
 
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
-
-    // 计算不含井储的拉普拉斯空间压力
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
-
-    // 加入井储和表皮效应
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
-        }
+// 井储和表皮效应 (变井储模型)
+double ModelSolver01_06::applyWellboreStorage(double z, double pf, const QMap<QString, double>& p) const {
+    double CD = p.value("cD", 0.0);
+    double S = p.value("S", 0.0);
+    if (CD > 1e-12 || std::abs(S) > 1e-12) {
+        pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
     }
-
     return pf;
 }
 
 // 核心点源解叠加计算
-double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
+double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12, double rmD, double reD,
+                                       const QVector<double>& xwD, const QVector<double>& halfLengthD, ModelType type, double quadTol) {
     using namespace boost::math;
+    const int nf = xwD.size();
     QVector<double> ywD(nf, 0.0); // 假设裂缝在y方向无偏移
     double gama1 = sqrt(z * fs1);
     double gama2 = sqrt(z * fs2);
     double arg_g2_rm = gama2 * rmD;
     double arg_g1_rm = gama1 * rmD;
 
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k0_g1 = cyl_bessel_k(0, arg_g1_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
+    double k0_g2 = besselK(0, arg_g2_rm);
+    double k1_g2 = besselK(1, arg_g2_rm);
+    double k0_g1 = besselK(0, arg_g1_rm);
+    double k1_g1 = besselK(1, arg_g1_rm);
 
     double term_mAB_i0 = 0.0;
     double term_mAB_i1 = 0.0;
@@ -248,8 +577,8 @@ double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double
         double arg_re = gama2 * reD;
         double i1_re_s = scaled_besseli(1, arg_re);
         double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
+        double k1_re = besselK(1, arg_re);
+        double k0_re = besselK(0, arg_re);
         double i0_g2_s = scaled_besseli(0, arg_g2_rm);
         double i1_g2_s = scaled_besseli(1, arg_g2_rm);
 
@@ -280,31 +609,61 @@ double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double
 
     double Ac_prefactor = Acup / Acdown_scaled;
 
-    // 建立线性方程组求解裂缝各段流量分布
+    // 影响系数：裂缝 j 单位流量 (沿其半长 LfD_j 均匀分布) 在裂缝 i 中心处产生的压力
+    auto influence = [&](int i, int j) -> double {
+        const double LfD = halfLengthD[j];
+        auto integrand = [&](double a) -> double {
+            double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
+            double arg_dist = gama1 * dist;
+            if (arg_dist < 1e-10) arg_dist = 1e-10;
+
+            double term2 = 0.0;
+            double exponent = arg_dist - arg_g1_rm;
+            if (exponent > -700.0) {
+                term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
+            }
+            return besselK(0, arg_dist) + term2;
+        };
+        // 沿裂缝积分：距离为零处 (K0 对数奇点) 若落在区间内部则作为分段点
+        QVector<double> breakpoints;
+        breakpoints << -LfD;
+        double singular = xwD[i] - xwD[j];
+        if (ywD[i] == ywD[j] && singular > -LfD && singular < LfD) breakpoints << singular;
+        breakpoints << LfD;
+        double val = adaptiveGaussKronrod(integrand, breakpoints, quadTol, 200);
+        return z * val / (M12 * z * 2 * LfD);
+    };
+
+    // 建立线性方程组求解裂缝各段流量分布：
+    // A·q - p·1 = 0 (各裂缝压力相等)，z·Σq = 1 (定产)；返回井底压力 p
     int size = nf + 1;
     Eigen::MatrixXd A_mat(size, size);
     Eigen::VectorXd b_vec(size);
     b_vec.setZero();
     b_vec(nf) = 1.0; // 定产条件
 
-    for (int i = 0; i < nf; ++i) {
-        for (int j = 0; j < nf; ++j) {
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist;
-                if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                double term2 = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
-                }
-                return cyl_bessel_k(0, arg_dist) + term2;
-            };
-            // 沿裂缝积分
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
+    if (nf >= HMatrixMinFractures) {
+        // 裂缝较多：远场块低秩压缩 + GMRES 求 A·y = 1，则 q = p·y，p = 1 / (z·Σy)
+        FractureHMatrix::Options options;
+        options.acaTol = quadTol;
+        options.gmresTol = 1e-3 * quadTol;
+        FractureHMatrix hmatrix(xwD, halfLengthD, influence, options);
+        PerfCounters::add(PerfCounters::InfluenceEntries, hmatrix.stats().entriesEvaluated);
+
+        Eigen::VectorXd y;
+        bool converged = hmatrix.solve(Eigen::VectorXd::Ones(nf), y);
+        PerfCounters::add(PerfCounters::GmresIterations, hmatrix.stats().gmresIterations);
+        if (converged) return 1.0 / (z * y.sum());
+
+        // 未收敛 (裂缝大量重叠时矩阵病态)：对压缩后的矩阵直接 LU 求解
+        A_mat.topLeftCorner(nf, nf) = hmatrix.toDense();
+    } else {
+        for (int i = 0; i < nf; ++i) {
+            for (int j = 0; j < nf; ++j) {
+                A_mat(i, j) = influence(i, j);
+            }
         }
+        PerfCounters::add(PerfCounters::InfluenceEntries, quint64(nf) * nf);
     }
     // 补充方程：各裂缝压力相等，流量和为1
     for (int i = 0; i < nf; ++i) {
@@ -313,27 +672,118 @@ double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double
     }
     A_mat(nf, nf) = 0.0;
 
+    PerfCounters::add(PerfCounters::LuSolves);
     return A_mat.fullPivLu().solve(b_vec)(nf);
 }
 
+double ModelSolver01_06::besselK(int v, double x) {
+    PerfCounters::add(PerfCounters::BesselCalls);
+    return boost::math::cyl_bessel_k(v, x);
+}
+
 double ModelSolver01_06::scaled_besseli(int v, double x) {
+    PerfCounters::add(PerfCounters::BesselCalls);
     if (x < 0) x = -x;
     if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
     return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
 }
 
-double ModelSolver01_06::gauss15(std::function<double(double)> f, double a, double b) {
-    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
-    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
-    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
-    return s * h;
+double ModelSolver01_06::gaussKronrod15(const std::function<double(double)>& f, double a, double b, double& error) {
+    PerfCounters::add(PerfCounters::GaussPanels);
+    // Kronrod 节点 (降序，最后为中点)；奇数下标节点同时是 7 点 Gauss 节点
+    static const double XK[8] = { 0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+                                  0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+                                  0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+                                  0.207784955007898467600689403773245, 0.0 };
+    static const double WK[8] = { 0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+                                  0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+                                  0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+                                  0.204432940075298892414161999234649, 0.209482141084727828012999174891714 };
+    static const double WG[4] = { 0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+                                  0.381830050505118944950369775488975, 0.417959183673469387755102040816327 };
+    double h = 0.5 * (b - a); double c = 0.5 * (a + b);
+    double fc = f(c);
+    double resK = WK[7] * fc; double resG = WG[3] * fc;
+    for (int j = 0; j < 7; ++j) {
+        double dx = h * XK[j];
+        double pair = f(c - dx) + f(c + dx);
+        resK += WK[j] * pair;
+        if (j % 2 == 1) resG += WG[j / 2] * pair;
+    }
+    error = std::abs((resK - resG) * h);
+    return resK * h;
+}
+
+double ModelSolver01_06::adaptiveGaussKronrod(const std::function<double(double)>& f, const QVector<double>& breakpoints, double absTol, int maxPanels) {
+    struct Panel {
+        double a, b, value, error;
+        int depth;
+        bool operator<(const Panel& o) const { return error < o.error; }
+    };
+    std::priority_queue<Panel> queue;
+    double total = 0.0, totalError = 0.0;
+    int panels = 0;
+    for (int i = 0; i + 1 < breakpoints.size(); ++i) {
+        Panel p{breakpoints[i], breakpoints[i + 1], 0.0, 0.0, 0};
+        p.value = gaussKronrod15(f, p.a, p.b, p.error);
+        total += p.value; totalError += p.error;
+        queue.push(p); ++panels;
+    }
+
+    while (!queue.empty() && totalError > absTol && panels < maxPanels) {
+        Panel p = queue.top(); queue.pop();
+        double m = 0.5 * (p.a + p.b);
+        Panel left{p.a, m, 0.0, 0.0, p.depth + 1};
+        Panel right{m, p.b, 0.0, 0.0, p.depth + 1};
+        left.value = gaussKronrod15(f, left.a, left.b, left.error);
+        right.value = gaussKronrod15(f, right.a, right.b, right.error);
+        total += left.value + right.value - p.value;
+        totalError += left.error + right.error - p.error;
+        queue.push(left); queue.push(right); panels += 2;
+    }
+
+    if (PerfCounters::isEnabled()) {
+        while (!queue.empty()) { PerfCounters::recordGaussDepth(queue.top().depth); queue.pop(); }
+    }
+    return total;
+}
+
+int ModelSolver01_06::stehfestTermCount(const QMap<QString, double>& params) const {
+    return validTermCount(m_highPrecision ? (int)params.value("N", 4) : 4);
+}
+
+int ModelSolver01_06::validTermCount(int N) {
+    if (N % 2 != 0 || N < 2) N = 4;
+    return qMin(N, MaxStehfestTerms);
 }
 
-double ModelSolver01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0; double v1 = gauss15(f, a, b); double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
-    return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
+double ModelSolver01_06::quadratureTolerance(int N) {
+    return stehfestTable(validTermCount(N)).quadTol;
+}
+
+const ModelSolver01_06::StehfestTable& ModelSolver01_06::stehfestTable(int N) {
+    // 所有偶数 N 的表在首次使用时一次建好，之后只读，拉普拉斯函数与线程池任务查表无需加锁
+    static const std::vector<StehfestTable> tables = [] {
+        std::vector<StehfestTable> t(MaxStehfestTerms + 1);
+        for (int n = 2; n <= MaxStehfestTerms; n += 2) t[n] = buildStehfestTable(n);
+        return t;
+    }();
+    Q_ASSERT(N >= 2 && N <= MaxStehfestTerms && N % 2 == 0);
+    return tables[N];
+}
+
+ModelSolver01_06::StehfestTable ModelSolver01_06::buildStehfestTable(int N) {
+    StehfestTable table;
+    table.weights.resize(N);
+    double amplification = 0.0;
+    for (int m = 1; m <= N; ++m) {
+        table.weights[m - 1] = stefestCoefficient(m, N);
+        amplification += std::abs(table.weights[m - 1]);
+    }
+    // PD = ln2/tD · Σ Vi·f(zi)：各节点上 f 的绝对误差经反演至多放大 Σ|Vi| 倍
+    // N=4 时 Σ|Vi| = 100，容限 1e-5 与原 gauss15 相同；高阶反演时相应收紧，下限防止细分到区间上限
+    table.quadTol = qMax(QuadraturePdError / qMax(amplification, 1.0), 1e-14);
+    return table;
 }
 
 double ModelSolver01_06::stefestCoefficient(int i, int N) {
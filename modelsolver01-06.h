@@ -5,6 +5,15 @@
  * 1. 定义模型类型枚举 (ModelType) 和曲线数据类型 (ModelCurveData)。
  * 2. 声明纯数学计算逻辑，包括拉普拉斯变换、贝塞尔函数计算、Stehfest 数值反演等。
  * 3. 不依赖任何 UI 控件，仅负责数据输入与结果输出。
+ * 4. [新增] SolverVersion：求解算法版本号，参与持久化理论曲线缓存的键。
+ * 5. [修改] 沿裂缝积分改为全局自适应 Gauss-Kronrod (G7K15) 积分，误差容限随 Stehfest 项数确定。
+ *    [修复] 容限改为绝对误差 QuadraturePdError / Σ|Vi|，与 Stehfest 系数一起按 N 缓存 (stehfestTable，只读数组，查表无锁)。
+ * 6. [新增] 批量计算接口 calculateTheoreticalCurves：多组参数共用时间序列、Stehfest 系数与储层解，并行计算。
+ *    各组仍逐组标量计算，不做跨参数组的 SoA/SIMD 向量化。
+ * 7. [新增] 非均匀裂缝表 (各裂缝位置与半长)；裂缝条数较多时影响矩阵改用 H-矩阵压缩 + GMRES 求解 (fracturehmatrix.h)。
+ * 8. [新增] 反演节点去重：整条曲线的 z = m·ln2/tD 先汇总合并，每个不同的 z 只求一次拉普拉斯函数；
+ *    generateInversionSharedTimeSteps 生成按 2 的分数次幂等比的时间网格，使相邻倍频程的节点重合；
+ *    [修复] 该网格仅在开启 setSharedInversionGrid 时由 generateCurveTimeSteps 采用，默认仍为对数均匀网格。
  */
 
 #ifndef MODELSOLVER01_06_H
@@ -15,6 +24,7 @@
 #include <QString>
 #include <tuple>
 #include <functional>
+#include <vector>
 
 // 类型定义: <时间, 压力, 导数>
 using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
@@ -32,44 +42,133 @@ public:
         Model_6      // 定压边界 + 恒定井储
     };
 
+    // 求解算法版本号：修改数值方法 (反演、积分、Bessel 计算等) 导致结果变化时必须递增，
+    // 使项目文件中保存的理论曲线缓存失效
+    static const int SolverVersion = 4;
+
+    // 裂缝表参数：参数 "fracCount" 等于 nf 时，第 i 条裂缝 (i 从 1 起) 的中心位置 "fracX_i"
+    // (m，相对压裂段中点) 与半长 "fracLf_i" (m) 取代均匀布置的等长裂缝
+    static constexpr const char* FractureCountKey = "fracCount";
+    static QString fractureXKey(int i) { return QString("fracX_%1").arg(i); }
+    static QString fractureLfKey(int i) { return QString("fracLf_%1").arg(i); }
+    static bool isFractureTableKey(const QString& name) { return name.startsWith("frac"); }
+
+    // 裂缝条数不少于该值时使用 H-矩阵迭代求解，较少时直接稠密 LU
+    static const int HMatrixMinFractures = 32;
+
+    // 反演节点合并的相对容限：|z1 - z2| <= 容限 × z1 的节点视为同一节点
+    static constexpr double LaplaceNodeMergeTol = 1e-12;
+
+    // 沿裂缝积分的目标 PD 误差：积分绝对容限取该值除以 Stehfest 放大倍数 Σ|Vi| (N=4 时为 1e-5)
+    static constexpr double QuadraturePdError = 1e-3;
+
+    // Stehfest 项数上限 (更高阶在双精度下已无意义)
+    static const int MaxStehfestTerms = 32;
+
     // 构造函数
     explicit ModelSolver01_06(ModelType type);
     virtual ~ModelSolver01_06();
 
     // 设置计算精度
     void setHighPrecision(bool high);
+    // 单条曲线的去重节点是否分配到全局线程池计算 (默认否；外层已并行时不应开启)
+    void setParallelInversion(bool parallel);
 
     // 核心计算接口：根据参数和时间序列计算理论曲线
     ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
 
+    /**
+     * @brief 批量计算：多组参数共用本模型与时间序列，结果与逐组调用 calculateTheoreticalCurve 完全一致
+     * * 储层/裂缝参数与无因次时间系数相同的组 (如只有井储、表皮、产量不同) 共用同一组拉普拉斯空间储层解，
+     *   Stehfest 系数整批只计算一次；parallel 为 true 时按 (储层参数组, 反演节点) 与参数组分配到全局线程池。
+     * * 加速只来自储层解共享与线程并行：Bessel 与代数运算仍按组标量执行，未按参数组 SoA 排布向量化
+     *   (沿裂缝积分按矩阵元素自适应细分，各组取值点不同；boost Bessel 函数为标量实现)。
+     * * 已在线程池任务内部调用 (外层已并行) 时应传 parallel = false。
+     */
+    QVector<ModelCurveData> calculateTheoreticalCurves(const QVector<QMap<QString, double>>& paramSets,
+                                                       const QVector<double>& providedTime = QVector<double>(),
+                                                       bool parallel = true);
+
     // 获取模型名称（静态辅助函数）
     static QString getModelName(ModelType type);
 
     // 生成对数时间步长（静态辅助函数，供内部或外部生成时间序列使用）
     static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+    // 反演节点共享的时间网格：t_j = 10^startExp · 2^(j/q)，q 取与 count 点对数均匀网格最接近的每倍频程点数，
+    // 只取不超过 10^endExp 的格点，末点固定为 10^endExp。q 取整使点数与 count 略有出入 (至多约 q/2 + 1 个)。
+    // 此时 m 与 2m 两个反演点在相隔 q 步的时间上重合，Stehfest 求值约减半
+    static QVector<double> generateInversionSharedTimeSteps(int count, double startExp, double endExp);
+    // 显示/报告曲线的时间网格：默认 generateLogTimeSteps (恰好 count 个点)；
+    // 开启 setSharedInversionGrid 后改用 generateInversionSharedTimeSteps (点数约为 count)
+    static QVector<double> generateCurveTimeSteps(int count, double startExp, double endExp);
+    // 反演节点共享网格开关 (设置 system/sharedInversionGrid，默认关闭)
+    static void setSharedInversionGrid(bool enabled);
+    static bool isSharedInversionGrid();
+
+    // 沿裂缝积分的绝对误差容限 (按 N 缓存)：反演把拉普拉斯空间误差放大至多 Σ|Vi| 倍；
+    // N 与求解时一样先经 validTermCount 规整，任意输入都不会越界
+    static double quadratureTolerance(int N);
+    // 7 点 Gauss / 15 点 Kronrod 嵌套求积：返回 Kronrod 值，error 为两者之差 (共用 15 个节点)
+    static double gaussKronrod15(const std::function<double(double)>& f, double a, double b, double& error);
+    // 全局自适应积分：breakpoints 为递增的初始分段点 (含两端)，每次二分当前误差最大的区间，
+    // 直至总误差 ≤ absTol 或区间数达到 maxPanels (基准测试直接调用以统计被积函数取值次数)
+    static double adaptiveGaussKronrod(const std::function<double(double)>& f, const QVector<double>& breakpoints, double absTol, int maxPanels);
 
 private:
+    // 整条曲线的反演节点：z 为去重后的节点，nodeOf[k * N + (m - 1)] 为第 k 个时间点第 m 项对应的节点下标
+    // (tD <= 1e-12 的时间点不参与反演，对应项为 -1)
+    struct LaplaceNodes {
+        std::vector<double> z;
+        std::vector<int> nodeOf;
+    };
+    static LaplaceNodes collectLaplaceNodes(const QVector<double>& tD, int N);
+
+    // 按 Stehfest 项数缓存的反演系数 Vi 与沿裂缝积分的绝对容限：
+    // 偶数 N ∈ [2, MaxStehfestTerms] 的表首次使用时一次建好，之后只读，查表无锁
+    struct StehfestTable {
+        QVector<double> weights;
+        double quadTol = 0.0;
+    };
+    static const StehfestTable& stehfestTable(int N);
+    static StehfestTable buildStehfestTable(int N);
+
     // 计算无因次压力和导数
     void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
                              std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
                              QVector<double>& outPD, QVector<double>& outDeriv);
 
-    // 拉普拉斯空间下的复合模型函数
+    // 拉普拉斯空间下的复合模型函数 (储层解 + 井储与表皮)
     double flaplace_composite(double z, const QMap<QString, double>& p);
+    // 拉普拉斯空间储层解 (不含井储与表皮)，只依赖储层/裂缝参数
+    double laplaceReservoir(double z, const QMap<QString, double>& p);
+    // 在储层解上叠加井储与表皮 (变井储模型)
+    double applyWellboreStorage(double z, double pf, const QMap<QString, double>& p) const;
+    // 无因次时间系数 (tD = tdCoeff * t) 与压力系数 (dp = pCoeff * pD)
+    static void dimensionlessCoefficients(const QMap<QString, double>& params, double& tdCoeff, double& pCoeff);
+
+    // 裂缝布置 (无因次中心位置与半长)，返回裂缝条数
+    static int fractureLayout(const QMap<QString, double>& p, QVector<double>& xwD, QVector<double>& halfLengthD);
 
     // 计算点源解的拉普拉斯变换值
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
+    // quadTol: 沿裂缝积分的绝对误差容限 (见 quadratureTolerance)
+    double PWD_composite(double z, double fs1, double fs2, double M12, double rmD, double reD,
+                         const QVector<double>& xwD, const QVector<double>& halfLengthD, ModelType type, double quadTol);
+
+    // 实际使用的 Stehfest 反演项数 (低精度固定为 4，奇数回退为 4，上限 MaxStehfestTerms)
+    int stehfestTermCount(const QMap<QString, double>& params) const;
+    // 规整为查表可用的项数：奇数或小于 2 回退为 4，超过 MaxStehfestTerms 取上限
+    static int validTermCount(int N);
 
     // 数学辅助函数
+    double besselK(int v, double x);          // 第二类修正 Bessel 函数 (带性能计数)
     double scaled_besseli(int v, double x);
-    double gauss15(std::function<double(double)> f, double a, double b);
-    double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
-    double stefestCoefficient(int i, int N);
-    double factorial(int n);
+    static double stefestCoefficient(int i, int N);
+    static double factorial(int n);
 
 private:
     ModelType m_type;       // 当前模型类型
     bool m_highPrecision;   // 高精度计算标志
+    bool m_parallelInversion;   // 单条曲线反演节点并行求值
 };
 
 #endif // MODELSOLVER01_06_H
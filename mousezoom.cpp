@@ -1,14 +1,28 @@
 #include "mousezoom.h"
+#include "tracerecorder.h"
 #include <QApplication>
 #include <QMenu>
 #include <QAction>
 #include <QKeyEvent>
 #include <cmath>
 
+namespace {
+// QCPLayerable 的事件/选择接口只对 QCustomPlot 开放 (友元不被继承)，经成员指针在 MouseZoom 中调用
+struct LayerableAccess : QCPLayerable {
+    using QCPLayerable::mousePressEvent;
+    using QCPLayerable::selectEvent;
+    using QCPLayerable::deselectEvent;
+    using QCPLayerable::selectionCategory;
+};
+}
+
 MouseZoom::MouseZoom(QWidget *parent)
     : QCustomPlot(parent)
+    , m_hitIndex(this)
     , m_isUpPressed(false)
     , m_isDownPressed(false)
+    , m_replotStartNs(-1)
+    , m_indexedGraphCount(0)
 {
     setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectItems);
     setContextMenuPolicy(Qt::CustomContextMenu);
@@ -16,6 +30,23 @@ MouseZoom::MouseZoom(QWidget *parent)
 
     // 确保组件能接收键盘事件
     setFocusPolicy(Qt::StrongFocus);
+
+    // 时间线追踪：以 beforeReplot/afterReplot 信号界定一次重绘
+    connect(this, &QCustomPlot::beforeReplot, this, [this]() {
+        m_replotStartNs = TraceRecorder::isEnabled() ? TraceRecorder::nowNs() : -1;
+    });
+    connect(this, &QCustomPlot::afterReplot, this, [this]() {
+        // 增删曲线时整体作废命中索引；否则只丢弃已删除曲线的索引，数据与坐标范围变化由查询时的签名比较处理
+        if (graphCount() != m_indexedGraphCount) {
+            m_indexedGraphCount = graphCount();
+            m_hitIndex.invalidate();
+        } else {
+            m_hitIndex.refresh();
+        }
+        if (m_replotStartNs >= 0 && TraceRecorder::isEnabled())
+            TraceRecorder::record("MouseZoom::replot", "plot", m_replotStartNs, TraceRecorder::nowNs());
+        m_replotStartNs = -1;
+    });
 }
 
 MouseZoom::~MouseZoom()
@@ -119,6 +150,103 @@ void MouseZoom::wheelEvent(QWheelEvent *event)
     }
 }
 
+// 逐图层自顶向下测试；曲线不调用 QCPGraph::selectTest (逐点扫描全部数据)，改为查询命中索引
+QList<QCPLayerable*> MouseZoom::hitLayerables(const QPointF& pos, bool onlySelectable, QList<QVariant>* details, bool firstOnly)
+{
+    QList<QCPLayerable*> result;
+    for (int layerIndex = mLayers.size() - 1; layerIndex >= 0; --layerIndex) {
+        const QList<QCPLayerable*> layerables = mLayers.at(layerIndex)->children();
+        for (int i = layerables.size() - 1; i >= 0; --i) {
+            QCPLayerable* layerable = layerables.at(i);
+            if (!layerable->realVisibility()) continue;
+            QVariant detail;
+            double dist = -1.0;
+            QCPGraph* graph = qobject_cast<QCPGraph*>(layerable);
+            if (graph) {
+                // 对应 QCPGraph::selectTest：只在所属坐标区内、且有连线或散点时测距
+                bool testable = !(onlySelectable && graph->selectable() == QCP::stNone)
+                                && !(graph->lineStyle() == QCPGraph::lsNone && graph->scatterStyle().isNone())
+                                && graph->keyAxis() && graph->valueAxis()
+                                && (graph->keyAxis()->axisRect()->rect().contains(pos.toPoint())
+                                    || mInteractions.testFlag(QCP::iSelectPlottablesBeyondAxisRect));
+                int dataIndex = -1;
+                if (testable) dist = m_hitIndex.graphDistance(graph, pos, selectionTolerance(), &dataIndex);
+                if (dist >= 0) detail.setValue(QCPDataSelection(QCPDataRange(dataIndex, dataIndex + 1)));
+            } else {
+                dist = layerable->selectTest(pos, onlySelectable, details ? &detail : nullptr);
+            }
+            if (dist >= 0 && dist < selectionTolerance()) {
+                result.append(layerable);
+                if (details) details->append(detail);
+                if (firstOnly) return result;
+            }
+        }
+    }
+    return result;
+}
+
+// 框选模式交给 QCustomPlot；其余流程与 QCustomPlot::mousePressEvent 相同
+void MouseZoom::mousePressEvent(QMouseEvent *event)
+{
+    if (mSelectionRect && mSelectionRectMode != QCP::srmNone) {
+        QCustomPlot::mousePressEvent(event);
+        return;
+    }
+
+    emit mousePress(event);
+    mMouseHasMoved = false;
+    mMousePressPos = event->pos();
+
+    QList<QVariant> details;
+    QList<QCPLayerable*> candidates = hitLayerables(mMousePressPos, false, &details);
+    if (!candidates.isEmpty()) {
+        mMouseSignalLayerable = candidates.first(); // 释放时发出 plottableClick/itemClick 等信号的对象
+        mMouseSignalLayerableDetails = details.first();
+    }
+    for (int i = 0; i < candidates.size(); ++i) {
+        event->accept();
+        (candidates.at(i)->*(&LayerableAccess::mousePressEvent))(event, details.at(i));
+        if (event->isAccepted()) {
+            mMouseEventLayerable = candidates.at(i);
+            mMouseEventLayerableDetails = details.at(i);
+            break;
+        }
+    }
+    event->accept();
+}
+
+// 与 QCustomPlot::processPointSelection 相同，被点击对象由 hitLayerables 确定
+void MouseZoom::processPointSelection(QMouseEvent *event)
+{
+    QList<QVariant> details;
+    QList<QCPLayerable*> hits = hitLayerables(event->pos(), true, &details, true);
+    QCPLayerable* clickedLayerable = hits.isEmpty() ? nullptr : hits.first();
+    QVariant detail = details.isEmpty() ? QVariant() : details.first();
+
+    bool selectionStateChanged = false;
+    bool additive = mInteractions.testFlag(QCP::iMultiSelect) && event->modifiers().testFlag(mMultiSelectModifier);
+    if (!additive) {
+        for (QCPLayer* layer : mLayers) {
+            for (QCPLayerable* layerable : layer->children()) {
+                if (layerable != clickedLayerable && mInteractions.testFlag((layerable->*(&LayerableAccess::selectionCategory))())) {
+                    bool selChanged = false;
+                    (layerable->*(&LayerableAccess::deselectEvent))(&selChanged);
+                    selectionStateChanged |= selChanged;
+                }
+            }
+        }
+    }
+    if (clickedLayerable && mInteractions.testFlag((clickedLayerable->*(&LayerableAccess::selectionCategory))())) {
+        bool selChanged = false;
+        (clickedLayerable->*(&LayerableAccess::selectEvent))(event, additive, detail, &selChanged);
+        selectionStateChanged |= selChanged;
+    }
+    if (selectionStateChanged) {
+        emit selectionChangedByUser();
+        replot(rpQueuedReplot);
+    }
+}
+
 double MouseZoom::distToSegment(const QPointF& p, const QPointF& s, const QPointF& e)
 {
     double l2 = (s.x()-e.x())*(s.x()-e.x()) + (s.y()-e.y())*(s.y()-e.y());
@@ -139,9 +267,12 @@ void MouseZoom::onCustomContextMenuRequested(const QPoint &pos)
     double tolerance = 8.0;
     QPointF pMouse = pos;
 
+    // 只对命中索引给出的附近图元做精确判断
+    const QList<QCPAbstractItem*> nearby = m_hitIndex.itemCandidates(pMouse, tolerance);
+
     // Check lines
-    for (int i = 0; i < itemCount(); ++i) {
-        if (auto line = qobject_cast<QCPItemLine*>(item(i))) {
+    for (QCPAbstractItem* candidate : nearby) {
+        if (auto line = qobject_cast<QCPItemLine*>(candidate)) {
             if (line->property("isCharacteristic").isValid()) {
                 double x1 = xAxis->coordToPixel(line->start->coords().x());
                 double y1 = yAxis->coordToPixel(line->start->coords().y());
@@ -157,8 +288,8 @@ void MouseZoom::onCustomContextMenuRequested(const QPoint &pos)
     }
     // Check text
     if (!hitItem) {
-        for (int i = 0; i < itemCount(); ++i) {
-            if (auto text = qobject_cast<QCPItemText*>(item(i))) {
+        for (QCPAbstractItem* candidate : nearby) {
+            if (auto text = qobject_cast<QCPItemText*>(candidate)) {
                 if (text->selectTest(pMouse, false) < tolerance) {
                     hitText = text;
                     hitItem = text;
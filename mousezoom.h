@@ -2,6 +2,7 @@
 #define MOUSEZOOM_H
 
 #include "qcustomplot.h"
+#include "plothitindex.h"
 
 class MouseZoom : public QCustomPlot
 {
@@ -11,6 +12,9 @@ public:
     explicit MouseZoom(QWidget *parent = nullptr);
     ~MouseZoom();
 
+    // 命中测试空间索引 (坐标范围或数据变化后下次查询时重建；增删曲线后整体作废)
+    PlotHitIndex* hitIndex() { return &m_hitIndex; }
+
 signals:
     // 现有信号保持不变
     void saveImageRequested();
@@ -32,15 +36,30 @@ protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
 
+    // 与 QCustomPlot 的实现相同，只是曲线的命中测试改为查询空间索引
+    void mousePressEvent(QMouseEvent *event) override;
+    void processPointSelection(QMouseEvent *event) override;
+
 private slots:
     void onCustomContextMenuRequested(const QPoint &pos);
 
 private:
     double distToSegment(const QPointF& p, const QPointF& s, const QPointF& e);
 
+    // 同 QCustomPlot::layerableListAt (firstOnly 时同 layerableAt)，QCPGraph 经 m_hitIndex 测距
+    QList<QCPLayerable*> hitLayerables(const QPointF& pos, bool onlySelectable, QList<QVariant>* details, bool firstOnly = false);
+
+    PlotHitIndex m_hitIndex;
+
     // [新增] 记录键盘状态
     bool m_isUpPressed;
     bool m_isDownPressed;
+
+    // 重绘起始时间 (时间线追踪用，-1 表示未记录)
+    qint64 m_replotStartNs;
+
+    // 上次重绘时的曲线条数 (变化时作废命中索引)
+    int m_indexedGraphCount;
 };
 
 #endif // MOUSEZOOM_H
@@ -0,0 +1,325 @@
+/*
+ * 文件名: perfcounters.cpp
+ * 文件作用: 计算核心性能计数器实现文件
+ * 功能描述:
+ * 1. 每个线程首次计数时分配一个私有计数块并登记到全局列表，之后只由该线程写入 (无锁、无竞争)。
+ * 2. 快照时汇总全部计数块，并减去清零时记录的基准值。
+ * 3. 提供计数项/阶段的中文名称以及 JSON、HTML 输出。
+ * 4. [新增] 线程挂接了 PerfAccumulator 时，计数同时原子累加到该累加器 (多个工作线程可共享同一累加器)。
+ * 5. [修复] 计数块由线程局部的持有者管理：线程结束时 (线程池空闲线程 30 秒后退出) 把累计值并入已结束线程的合计，
+ *    计数块清零后放回空闲列表供新线程复用，计数块数量不随线程更替增长。
+ */
+
+#include "perfcounters.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <vector>
+#include <algorithm>
+
+std::atomic<bool> PerfCounters::s_enabled(false);
+
+namespace {
+
+// 线程私有计数块：仅所属线程写入，快照线程只读
+struct PerfThreadBlock {
+    std::atomic<quint64> counters[PerfCounters::CounterCount];
+    std::atomic<quint64> gaussDepth[PerfCounters::GaussDepthBins];
+    std::atomic<quint64> stageNs[PerfCounters::StageCount];
+    std::atomic<quint64> stageCalls[PerfCounters::StageCount];
+
+    PerfThreadBlock() { clear(); }
+
+    void clear()
+    {
+        for (auto& v : counters) v.store(0, std::memory_order_relaxed);
+        for (auto& v : gaussDepth) v.store(0, std::memory_order_relaxed);
+        for (auto& v : stageNs) v.store(0, std::memory_order_relaxed);
+        for (auto& v : stageCalls) v.store(0, std::memory_order_relaxed);
+    }
+
+    // 把本块的累计值加到快照 s
+    void addTo(PerfSnapshot& s) const
+    {
+        for (int i = 0; i < PerfCounters::CounterCount; ++i) s.counters[i] += counters[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < PerfCounters::GaussDepthBins; ++i) s.gaussDepth[i] += gaussDepth[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < PerfCounters::StageCount; ++i) {
+            s.stageNs[i] += stageNs[i].load(std::memory_order_relaxed);
+            s.stageCalls[i] += stageCalls[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// 单写者累加：读-加-写，避免原子 RMW 指令的开销
+inline void bump(std::atomic<quint64>& v, quint64 n)
+{
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// 全局登记表：以下成员均在 mutex 保护下访问
+struct PerfRegistry {
+    QMutex mutex;
+    std::vector<PerfThreadBlock*> active;   // 存活线程的计数块
+    std::vector<PerfThreadBlock*> freeList; // 已结束线程归还的计数块 (已清零)，供新线程复用
+    PerfSnapshot retired;                   // 已结束线程的累计值合计
+
+    ~PerfRegistry() { qDeleteAll(freeList); }
+};
+
+PerfRegistry& registry()
+{
+    static PerfRegistry r;
+    return r;
+}
+
+// 当前线程挂接的作用域累加器
+thread_local PerfAccumulator* t_accumulator = nullptr;
+
+PerfSnapshot& baseline()
+{
+    static PerfSnapshot base;
+    return base;
+}
+
+// 为当前线程取一个计数块 (优先复用已结束线程归还的) 并登记
+PerfThreadBlock* acquireBlock()
+{
+    PerfRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    PerfThreadBlock* block = nullptr;
+    if (!r.freeList.empty()) {
+        block = r.freeList.back();
+        r.freeList.pop_back();
+    } else {
+        block = new PerfThreadBlock();
+    }
+    r.active.push_back(block);
+    return block;
+}
+
+// 线程结束：累计值并入合计，计数块清零后归还
+void retireBlock(PerfThreadBlock* block)
+{
+    PerfRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    block->addTo(r.retired);
+    block->clear();
+    r.active.erase(std::remove(r.active.begin(), r.active.end(), block), r.active.end());
+    r.freeList.push_back(block);
+}
+
+// 线程局部的计数块持有者：线程结束时析构，归还计数块
+struct PerfBlockOwner {
+    PerfThreadBlock* block = nullptr;
+    ~PerfBlockOwner() { if (block) retireBlock(block); }
+};
+
+PerfThreadBlock* localBlock()
+{
+    thread_local PerfBlockOwner owner;
+    if (!owner.block) owner.block = acquireBlock();
+    return owner.block;
+}
+
+// 汇总所有线程 (含已结束线程) 的原始累计值
+PerfSnapshot rawSnapshot()
+{
+    PerfRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    PerfSnapshot s = r.retired;
+    for (const PerfThreadBlock* b : r.active) b->addTo(s);
+    return s;
+}
+
+} // namespace
+
+void PerfCounters::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void PerfCounters::addImpl(Counter c, quint64 n)
+{
+    bump(localBlock()->counters[c], n);
+    if (t_accumulator) t_accumulator->m_counters[c].fetch_add(n, std::memory_order_relaxed);
+}
+
+void PerfCounters::recordGaussDepthImpl(int depth)
+{
+    if (depth < 0) depth = 0;
+    if (depth >= GaussDepthBins) depth = GaussDepthBins - 1;
+    bump(localBlock()->gaussDepth[depth], 1);
+    if (t_accumulator) t_accumulator->m_gaussDepth[depth].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::addStageTimeImpl(Stage s, qint64 nsecs)
+{
+    PerfThreadBlock* b = localBlock();
+    bump(b->stageNs[s], static_cast<quint64>(nsecs));
+    bump(b->stageCalls[s], 1);
+    if (t_accumulator) {
+        t_accumulator->m_stageNs[s].fetch_add(static_cast<quint64>(nsecs), std::memory_order_relaxed);
+        t_accumulator->m_stageCalls[s].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PerfAccumulator* PerfCounters::currentAccumulator()
+{
+    return t_accumulator;
+}
+
+PerfAccumulator* PerfCounters::attachAccumulator(PerfAccumulator* acc)
+{
+    PerfAccumulator* previous = t_accumulator;
+    t_accumulator = acc;
+    return previous;
+}
+
+PerfSnapshot PerfCounters::snapshot()
+{
+    PerfSnapshot raw = rawSnapshot();
+    QMutexLocker locker(&registry().mutex);
+    return raw - baseline();
+}
+
+void PerfCounters::reset()
+{
+    PerfSnapshot raw = rawSnapshot();
+    QMutexLocker locker(&registry().mutex);
+    baseline() = raw;
+}
+
+QString PerfCounters::counterName(Counter c)
+{
+    switch (c) {
+    case LaplaceEvaluations: return "拉普拉斯函数调用";
+    case BesselCalls: return "Bessel 函数调用";
+    case GaussPanels: return "Gauss-Kronrod 积分区间 (G7K15)";
+    case LuSolves: return "裂缝方程组 LU 求解";
+    case NanInfReplacements: return "NaN/Inf 置零";
+    case CurveEvaluations: return "理论曲线计算";
+    case ResidualEvaluations: return "残差计算";
+    case JacobianEvaluations: return "雅可比矩阵计算";
+    case LmIterations: return "LM 迭代";
+    case InfluenceEntries: return "裂缝影响系数积分";
+    case GmresIterations: return "裂缝方程组 GMRES 迭代";
+    case LaplaceNodesShared: return "拉普拉斯求值去重节省";
+    default: return "未知";
+    }
+}
+
+QString PerfCounters::stageName(Stage s)
+{
+    switch (s) {
+    case Stage_TheoreticalCurve: return "理论曲线 (整体)";
+    case Stage_LaplaceInversion: return "Stehfest 反演";
+    case Stage_Derivative: return "Bourdet 导数";
+    case Stage_Residual: return "残差计算";
+    case Stage_Jacobian: return "雅可比矩阵";
+    case Stage_LinearSolve: return "法方程求解";
+    case Stage_Sampling: return "数据抽样";
+    default: return "未知";
+    }
+}
+
+// ============================================================================
+// PerfAccumulator
+// ============================================================================
+
+PerfAccumulator::PerfAccumulator()
+{
+    for (auto& v : m_counters) v.store(0, std::memory_order_relaxed);
+    for (auto& v : m_gaussDepth) v.store(0, std::memory_order_relaxed);
+    for (auto& v : m_stageNs) v.store(0, std::memory_order_relaxed);
+    for (auto& v : m_stageCalls) v.store(0, std::memory_order_relaxed);
+}
+
+PerfSnapshot PerfAccumulator::snapshot() const
+{
+    PerfSnapshot s;
+    for (int i = 0; i < PerfCounters::CounterCount; ++i) s.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < PerfCounters::GaussDepthBins; ++i) s.gaussDepth[i] = m_gaussDepth[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        s.stageNs[i] = m_stageNs[i].load(std::memory_order_relaxed);
+        s.stageCalls[i] = m_stageCalls[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+// ============================================================================
+// PerfSnapshot
+// ============================================================================
+
+PerfSnapshot PerfSnapshot::operator-(const PerfSnapshot& other) const
+{
+    // 基准值可能在计数块登记之后才产生，做饱和减法防止下溢
+    auto sub = [](quint64 a, quint64 b) { return a > b ? a - b : 0; };
+    PerfSnapshot r;
+    for (int i = 0; i < PerfCounters::CounterCount; ++i) r.counters[i] = sub(counters[i], other.counters[i]);
+    for (int i = 0; i < PerfCounters::GaussDepthBins; ++i) r.gaussDepth[i] = sub(gaussDepth[i], other.gaussDepth[i]);
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        r.stageNs[i] = sub(stageNs[i], other.stageNs[i]);
+        r.stageCalls[i] = sub(stageCalls[i], other.stageCalls[i]);
+    }
+    return r;
+}
+
+bool PerfSnapshot::isEmpty() const
+{
+    for (quint64 v : counters) if (v) return false;
+    for (quint64 v : stageCalls) if (v) return false;
+    return true;
+}
+
+QJsonObject PerfSnapshot::toJson() const
+{
+    QJsonObject root;
+    QJsonObject c;
+    for (int i = 0; i < PerfCounters::CounterCount; ++i)
+        c[PerfCounters::counterName(static_cast<PerfCounters::Counter>(i))] = static_cast<double>(counters[i]);
+    root["counters"] = c;
+
+    QJsonArray depth;
+    for (quint64 v : gaussDepth) depth.append(static_cast<double>(v));
+    root["gaussDepthHistogram"] = depth;
+
+    QJsonObject stages;
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        QJsonObject s;
+        s["calls"] = static_cast<double>(stageCalls[i]);
+        s["ms"] = stageNs[i] / 1e6;
+        stages[PerfCounters::stageName(static_cast<PerfCounters::Stage>(i))] = s;
+    }
+    root["stages"] = stages;
+    return root;
+}
+
+QString PerfSnapshot::toHtmlTables() const
+{
+    QString html;
+    html += "<table><tr><th width='60%'>计数项</th><th width='40%'>次数</th></tr>";
+    for (int i = 0; i < PerfCounters::CounterCount; ++i) {
+        html += QString("<tr><td>%1</td><td>%2</td></tr>")
+                    .arg(PerfCounters::counterName(static_cast<PerfCounters::Counter>(i)))
+                    .arg(counters[i]);
+    }
+    html += "</table>";
+
+    html += "<table><tr><th width='40%'>计算阶段</th><th width='30%'>调用次数</th><th width='30%'>累计耗时 (ms)</th></tr>";
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        html += QString("<tr><td>%1</td><td>%2</td><td>%3</td></tr>")
+                    .arg(PerfCounters::stageName(static_cast<PerfCounters::Stage>(i)))
+                    .arg(stageCalls[i])
+                    .arg(stageNs[i] / 1e6, 0, 'f', 1);
+    }
+    html += "</table>";
+
+    QStringList depthText;
+    for (int i = 0; i < PerfCounters::GaussDepthBins; ++i) {
+        if (gaussDepth[i]) depthText << QString("%1层: %2").arg(i).arg(gaussDepth[i]);
+    }
+    if (!depthText.isEmpty())
+        html += QString("<p>自适应积分细分深度分布：%1</p>").arg(depthText.join("；"));
+    return html;
+}
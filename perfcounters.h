@@ -0,0 +1,154 @@
+/*
+ * 文件名: perfcounters.h
+ * 文件作用: 计算核心性能计数器头文件
+ * 功能描述:
+ * 1. 定义计数项 (拉普拉斯函数调用、Bessel 函数调用、高斯积分区间、LU 求解、NaN/Inf 替换、
+ *    理论曲线/残差/雅可比计算、LM 迭代、裂缝影响系数积分、GMRES 迭代、反演节点去重节省) 与耗时阶段 (理论曲线、Stehfest 反演、导数、残差、雅可比、线性求解、抽样)。
+ * 2. 定义 PerfSnapshot 快照结构，支持差值运算、JSON 与 HTML 表格输出，用于诊断面板和拟合报告。
+ * 3. 声明 PerfCounters 静态接口：关闭时每个计数点仅一次原子读取，开启时写入线程私有计数块，无锁竞争
+ *    (线程结束时计数块的累计值并入合计，计数块归还复用)。
+ * 4. 声明 PerfStageTimer，按作用域统计阶段耗时。
+ * 5. [新增] PerfAccumulator / PerfAccumulatorScope：挂接到线程的作用域累加器，只统计挂接线程上的计数
+ *    (如单次拟合及其线程池任务)，不受其他线程上并发计算的影响。
+ */
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <atomic>
+
+struct PerfSnapshot;
+class PerfAccumulator;
+
+class PerfCounters
+{
+public:
+    // 计数项
+    enum Counter {
+        LaplaceEvaluations = 0, // 拉普拉斯空间函数调用次数
+        BesselCalls,            // Bessel 函数调用次数 (K0/K1/I0/I1)
+        GaussPanels,            // G7K15 积分区间次数 (每次 15 个被积函数取值)
+        LuSolves,               // 裂缝流量方程组 LU 分解次数
+        NanInfReplacements,     // Stehfest 反演中 NaN/Inf 被置零的次数
+        CurveEvaluations,       // 理论曲线计算次数
+        ResidualEvaluations,    // 残差向量计算次数
+        JacobianEvaluations,    // 雅可比矩阵计算次数
+        LmIterations,           // LM 迭代次数
+        InfluenceEntries,       // 裂缝影响系数 (沿裂缝积分) 计算次数
+        GmresIterations,        // 裂缝方程组 GMRES 迭代次数 (H-矩阵求解)
+        LaplaceNodesShared,     // 反演节点去重后省去的拉普拉斯函数调用次数
+        CounterCount
+    };
+
+    // 耗时阶段
+    enum Stage {
+        Stage_TheoreticalCurve = 0, // 理论曲线计算 (整体)
+        Stage_LaplaceInversion,     // Stehfest 数值反演
+        Stage_Derivative,           // Bourdet 导数
+        Stage_Residual,             // 残差计算
+        Stage_Jacobian,             // 雅可比矩阵
+        Stage_LinearSolve,          // LM 法方程求解
+        Stage_Sampling,             // 拟合数据抽样
+        StageCount
+    };
+
+    // 自适应积分最终区间细分深度直方图的桶数 (超出部分计入最后一个桶)
+    static const int GaussDepthBins = 16;
+
+    // 是否启用计数 (热点路径上唯一的开销)
+    static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    // 计数与计时接口
+    static inline void add(Counter c, quint64 n = 1) { if (isEnabled()) addImpl(c, n); }
+    static inline void recordGaussDepth(int depth) { if (isEnabled()) recordGaussDepthImpl(depth); }
+    static inline void addStageTime(Stage s, qint64 nsecs) { if (isEnabled()) addStageTimeImpl(s, nsecs); }
+
+    // 获取自上次清零以来的累计值 (汇总所有线程)
+    static PerfSnapshot snapshot();
+    // 清零 (记录基准值，不影响正在写入的线程)
+    static void reset();
+
+    // 当前线程挂接的作用域累加器 (未挂接时为 nullptr)；attachAccumulator 返回原来挂接的累加器
+    static PerfAccumulator* currentAccumulator();
+    static PerfAccumulator* attachAccumulator(PerfAccumulator* acc);
+
+    // 名称
+    static QString counterName(Counter c);
+    static QString stageName(Stage s);
+
+private:
+    static void addImpl(Counter c, quint64 n);
+    static void recordGaussDepthImpl(int depth);
+    static void addStageTimeImpl(Stage s, qint64 nsecs);
+
+    static std::atomic<bool> s_enabled;
+};
+
+// 计数快照
+struct PerfSnapshot {
+    quint64 counters[PerfCounters::CounterCount] = {};
+    quint64 gaussDepth[PerfCounters::GaussDepthBins] = {};
+    quint64 stageNs[PerfCounters::StageCount] = {};
+    quint64 stageCalls[PerfCounters::StageCount] = {};
+
+    // 两个快照之差 (用于单次拟合统计)
+    PerfSnapshot operator-(const PerfSnapshot& other) const;
+    bool isEmpty() const;
+
+    QJsonObject toJson() const;
+    // 生成报告用的 HTML 表格 (计数项 + 阶段耗时)
+    QString toHtmlTables() const;
+};
+
+// 作用域累加器：线程挂接期间的计数同时累加到此处 (仅在计数器启用时)。
+// 可由多个线程同时挂接 (原子累加)；线程池任务不继承挂接，需在任务内部用 PerfAccumulatorScope 重新挂接
+class PerfAccumulator
+{
+public:
+    PerfAccumulator();
+    PerfSnapshot snapshot() const;
+
+private:
+    friend class PerfCounters;
+    std::atomic<quint64> m_counters[PerfCounters::CounterCount];
+    std::atomic<quint64> m_gaussDepth[PerfCounters::GaussDepthBins];
+    std::atomic<quint64> m_stageNs[PerfCounters::StageCount];
+    std::atomic<quint64> m_stageCalls[PerfCounters::StageCount];
+};
+
+// 挂接作用域：构造时把累加器挂接到当前线程 (nullptr 表示解除挂接)，析构时恢复原来的累加器
+class PerfAccumulatorScope
+{
+public:
+    explicit PerfAccumulatorScope(PerfAccumulator* acc) : m_previous(PerfCounters::attachAccumulator(acc)) {}
+    ~PerfAccumulatorScope() { PerfCounters::attachAccumulator(m_previous); }
+
+private:
+    PerfAccumulator* m_previous;
+};
+
+// 作用域计时器：构造时开始，析构时累加到对应阶段
+class PerfStageTimer
+{
+public:
+    explicit PerfStageTimer(PerfCounters::Stage stage)
+        : m_stage(stage), m_active(PerfCounters::isEnabled())
+    {
+        if (m_active) m_timer.start();
+    }
+    ~PerfStageTimer()
+    {
+        if (m_active) PerfCounters::addStageTime(m_stage, m_timer.nsecsElapsed());
+    }
+
+private:
+    PerfCounters::Stage m_stage;
+    bool m_active;
+    QElapsedTimer m_timer;
+};
+
+#endif // PERFCOUNTERS_H
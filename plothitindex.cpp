@@ -0,0 +1,466 @@
+/*
+ * 文件名: plothitindex.cpp
+ * 文件作用: 图表命中测试空间索引实现文件
+ * 功能描述:
+ * 1. 曲线网格覆盖坐标区外扩 16 像素 (不小于各处点击容差)，网格 8 像素；只遍历可见键范围内的数据。
+ * 2. 数据点按整数像素去重，同一像素只保留第一个点；长度不足 2 像素的连线由其端点代表，
+ *    两端都在网格内的线段按端点像素去重 (带噪密集数据的来回跳线大量重合)。
+ * 3. 线段先裁剪到网格范围，再按网格列计算该列内的纵向跨度逐格登记。
+ * 4. 图元网格覆盖整个绘图控件，线段图元按起止点、文字标注按四角锚点的外包矩形登记。
+ * 5. 曲线索引以 (数据容器、点数、首末点、坐标范围与刻度类型、绘图区、线型) 为签名，拖动、缩放时在下次查询时重建；
+ *    签名比较为常数时间，重绘 (含拖动、缩放的每一帧) 不扫描曲线数据。
+ */
+
+#include "plothitindex.h"
+#include "tracerecorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <cstring>
+
+namespace {
+
+const double kMargin = 16.0;        // 网格相对坐标区/控件的外扩 (像素)
+const double kGraphCell = 8.0;      // 曲线网格边长 (像素)
+const double kItemCell = 32.0;      // 图元网格边长 (像素)
+const double kMinSegment = 2.0;     // 短于该长度的连线只由端点代表
+
+bool isFinitePoint(const QPointF& p)
+{
+    return std::isfinite(p.x()) && std::isfinite(p.y());
+}
+
+double distSqr(const QPointF& a, const QPointF& b)
+{
+    const double dx = a.x() - b.x(), dy = a.y() - b.y();
+    return dx * dx + dy * dy;
+}
+
+double distSqrToSegment(const QPointF& p, const QLineF& line)
+{
+    const QPointF s = line.p1(), e = line.p2();
+    const double l2 = distSqr(s, e);
+    if (l2 == 0) return distSqr(p, s);
+    double t = ((p.x() - s.x()) * (e.x() - s.x()) + (p.y() - s.y()) * (e.y() - s.y())) / l2;
+    t = std::max(0.0, std::min(1.0, t));
+    return distSqr(p, s + t * (e - s));
+}
+
+// Liang-Barsky 裁剪；线段与矩形不相交时返回 false
+bool clipToRect(const QRectF& r, QPointF& a, QPointF& b)
+{
+    const double dx = b.x() - a.x(), dy = b.y() - a.y();
+    double t0 = 0.0, t1 = 1.0;
+    auto edge = [&](double p, double q) {
+        if (p == 0) return q >= 0;
+        const double t = q / p;
+        if (p < 0) { if (t > t1) return false; t0 = std::max(t0, t); }
+        else { if (t < t0) return false; t1 = std::min(t1, t); }
+        return true;
+    };
+    if (!edge(-dx, a.x() - r.left()) || !edge(dx, r.right() - a.x())
+        || !edge(-dy, a.y() - r.top()) || !edge(dy, r.bottom() - a.y()))
+        return false;
+    const QPointF start = a;
+    b = start + t1 * QPointF(dx, dy);
+    a = start + t0 * QPointF(dx, dy);
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// 均匀网格
+// ============================================================================
+
+void PlotHitIndex::CellGrid::reset(const QRectF& area, double cellSize)
+{
+    bounds = area;
+    cell = cellSize;
+    cols = std::max(1, int(std::ceil(area.width() / cell)));
+    rows = std::max(1, int(std::ceil(area.height() / cell)));
+    cellStart.assign(cols * rows + 1, 0);
+    refs.clear();
+}
+
+int PlotHitIndex::CellGrid::colOf(double x) const
+{
+    return std::min(cols - 1, std::max(0, int(std::floor((x - bounds.left()) / cell))));
+}
+
+int PlotHitIndex::CellGrid::rowOf(double y) const
+{
+    return std::min(rows - 1, std::max(0, int(std::floor((y - bounds.top()) / cell))));
+}
+
+bool PlotHitIndex::CellGrid::addPoint(std::vector<std::pair<int, int>>& pairs, const QPointF& p, int ref) const
+{
+    if (!bounds.contains(p)) return false;
+    pairs.emplace_back(rowOf(p.y()) * cols + colOf(p.x()), ref);
+    return true;
+}
+
+bool PlotHitIndex::CellGrid::addSegment(std::vector<std::pair<int, int>>& pairs, const QLineF& line, int ref) const
+{
+    QPointF a = line.p1(), b = line.p2();
+    if (!isFinitePoint(a) || !isFinitePoint(b)) return false;
+    if (a == b) return addPoint(pairs, a, ref);
+    if (!clipToRect(bounds, a, b)) return false;
+    if (a.x() > b.x()) std::swap(a, b);
+
+    // 逐列计算线段在该列内的纵向跨度
+    const double dx = b.x() - a.x();
+    const int c0 = colOf(a.x()), c1 = colOf(b.x());
+    for (int c = c0; c <= c1; ++c) {
+        const double xl = std::max(a.x(), bounds.left() + c * cell);
+        const double xr = std::min(b.x(), bounds.left() + (c + 1) * cell);
+        double yl = a.y(), yr = b.y();
+        if (dx > 1e-12) {
+            yl = a.y() + (b.y() - a.y()) * (xl - a.x()) / dx;
+            yr = a.y() + (b.y() - a.y()) * (xr - a.x()) / dx;
+        }
+        const int r0 = rowOf(std::min(yl, yr)), r1 = rowOf(std::max(yl, yr));
+        for (int r = r0; r <= r1; ++r) pairs.emplace_back(r * cols + c, ref);
+    }
+    return true;
+}
+
+bool PlotHitIndex::CellGrid::addRect(std::vector<std::pair<int, int>>& pairs, const QRectF& rect, int ref) const
+{
+    if (rect.right() < bounds.left() || rect.left() > bounds.right()
+        || rect.bottom() < bounds.top() || rect.top() > bounds.bottom())
+        return false;
+    const int c0 = colOf(rect.left()), c1 = colOf(rect.right());
+    const int r0 = rowOf(rect.top()), r1 = rowOf(rect.bottom());
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c) pairs.emplace_back(r * cols + c, ref);
+    return true;
+}
+
+// 计数排序为 CSR 布局
+void PlotHitIndex::CellGrid::finish(std::vector<std::pair<int, int>>& pairs)
+{
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const auto& pr : pairs) cellStart[pr.first + 1]++;
+    for (size_t k = 1; k < cellStart.size(); ++k) cellStart[k] += cellStart[k - 1];
+    refs.resize(pairs.size());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (const auto& pr : pairs) refs[fill[pr.first]++] = pr.second;
+}
+
+template <typename F>
+void PlotHitIndex::CellGrid::visit(const QRectF& box, F f) const
+{
+    if (refs.empty()) return;
+    if (box.right() < bounds.left() || box.left() > bounds.right()
+        || box.bottom() < bounds.top() || box.top() > bounds.bottom())
+        return;
+    const int c0 = colOf(box.left()), c1 = colOf(box.right());
+    const int r0 = rowOf(box.top()), r1 = rowOf(box.bottom());
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cellIndex = r * cols + c;
+            for (int k = cellStart[cellIndex]; k < cellStart[cellIndex + 1]; ++k) f(refs[k]);
+        }
+    }
+}
+
+// ============================================================================
+// PlotHitIndex
+// ============================================================================
+
+PlotHitIndex::PlotHitIndex(QCustomPlot* plot)
+    : m_plot(plot)
+{
+}
+
+void PlotHitIndex::invalidate()
+{
+    m_graphs.clear();
+    m_items.valid = false;
+}
+
+void PlotHitIndex::refresh()
+{
+    m_items.valid = false;  // 图元拖动不改变图元个数，图元索引重建代价小，每次重绘后作废
+    for (auto it = m_graphs.begin(); it != m_graphs.end();) {
+        QCPGraph* graph = it.value().graph.data();
+        if (!graph || !m_plot->hasPlottable(graph)) it = m_graphs.erase(it);
+        else ++it;
+    }
+}
+
+// 首末点键值 (空数据为 0)
+void PlotHitIndex::readDataEnds(const QCPGraphDataContainer& data, double ends[4])
+{
+    if (data.isEmpty()) {
+        std::fill(ends, ends + 4, 0.0);
+        return;
+    }
+    const QCPGraphData& first = *data.constBegin();
+    const QCPGraphData& last = *(data.constEnd() - 1);
+    ends[0] = first.key;
+    ends[1] = first.value;
+    ends[2] = last.key;
+    ends[3] = last.value;
+}
+
+// 数据容器、点数与首末点均未变 (按位比较，NaN 点不会导致每次重建)
+bool PlotHitIndex::sameData(const GraphIndex& index, QCPGraph* graph)
+{
+    if (index.data != graph->data().data() || index.dataSize != graph->dataCount()) return false;
+    double ends[4];
+    readDataEnds(*graph->data(), ends);
+    return std::memcmp(ends, index.dataEnds, sizeof(ends)) == 0;
+}
+
+const PlotHitIndex::GraphIndex* PlotHitIndex::graphIndex(QCPGraph* graph)
+{
+    QCPAxis* keyAxis = graph->keyAxis();
+    QCPAxis* valueAxis = graph->valueAxis();
+    auto it = m_graphs.find(graph);
+    if (it != m_graphs.end()) {
+        const GraphIndex& index = it.value();
+        if (index.graph == graph && sameData(index, graph)
+            && index.keyRange == keyAxis->range() && index.valueRange == valueAxis->range()
+            && index.keyScale == int(keyAxis->scaleType()) && index.valueScale == int(valueAxis->scaleType())
+            && index.axisRect == keyAxis->axisRect()->rect()
+            && index.lineStyle == int(graph->lineStyle()) && index.hasScatter == !graph->scatterStyle().isNone())
+            return &index;
+    }
+    GraphIndex& index = m_graphs[graph];
+    buildGraphIndex(graph, index);
+    return &index;
+}
+
+void PlotHitIndex::buildGraphIndex(QCPGraph* graph, GraphIndex& index) const
+{
+    TraceSpan span("PlotHitIndex::buildGraphIndex", "plot", graph->dataCount());
+    QCPAxis* keyAxis = graph->keyAxis();
+    QCPAxis* valueAxis = graph->valueAxis();
+    QSharedPointer<QCPGraphDataContainer> data = graph->data();
+
+    index = GraphIndex();
+    index.graph = graph;
+    index.data = data.data();
+    index.dataSize = graph->dataCount();
+    readDataEnds(*data, index.dataEnds);
+    index.keyRange = keyAxis->range();
+    index.valueRange = valueAxis->range();
+    index.keyScale = int(keyAxis->scaleType());
+    index.valueScale = int(valueAxis->scaleType());
+    index.axisRect = keyAxis->axisRect()->rect();
+    index.lineStyle = int(graph->lineStyle());
+    index.hasScatter = !graph->scatterStyle().isNone();
+
+    const QRectF area = QRectF(index.axisRect).adjusted(-kMargin, -kMargin, kMargin, kMargin);
+    index.grid.reset(area, kGraphCell);
+    std::vector<std::pair<int, int>> pairs;
+    if (data->isEmpty() || (graph->lineStyle() == QCPGraph::lsNone && !index.hasScatter)) {
+        index.grid.finish(pairs);
+        return;
+    }
+
+    // 可见键范围 (各向外扩一个点，保证跨出边界的连线也被登记)
+    double keyLo, keyHi;
+    if (keyAxis->orientation() == Qt::Horizontal) {
+        keyLo = keyAxis->pixelToCoord(area.left());
+        keyHi = keyAxis->pixelToCoord(area.right());
+    } else {
+        keyLo = keyAxis->pixelToCoord(area.bottom());
+        keyHi = keyAxis->pixelToCoord(area.top());
+    }
+    if (keyLo > keyHi) std::swap(keyLo, keyHi);
+    const QCPGraphDataContainer::const_iterator begin = data->findBegin(keyLo, true);
+    const QCPGraphDataContainer::const_iterator end = data->findEnd(keyHi, true);
+    pairs.reserve(2 * (end - begin));
+
+    const int width = int(area.width()) + 1;
+    const int height = int(area.height()) + 1;
+    std::vector<unsigned char> seenPixel(size_t(width) * height, 0);
+    std::unordered_set<quint64> seenSegment;
+
+    auto addSegment = [&](const QPointF& a, const QPointF& b, int ia, int ib) {
+        if (!isFinitePoint(a) || !isFinitePoint(b)) return;
+        if (QLineF(a, b).length() < kMinSegment) return;
+        if (area.contains(a) && area.contains(b)) {
+            quint64 ka = quint64(int(a.y() - area.top())) * width + int(a.x() - area.left());
+            quint64 kb = quint64(int(b.y() - area.top())) * width + int(b.x() - area.left());
+            if (ka > kb) std::swap(ka, kb);
+            if (!seenSegment.insert((ka << 32) | kb).second) return;
+        }
+        if (!index.grid.addSegment(pairs, QLineF(a, b), -int(index.segments.size()) - 1)) return;
+        index.segments.push_back(QLineF(a, b));
+        index.segmentStart.push_back(ia);
+        index.segmentEnd.push_back(ib);
+    };
+
+    const QCPGraph::LineStyle style = graph->lineStyle();
+    const double impulseBase = valueAxis->scaleType() == QCPAxis::stLogarithmic ? valueAxis->range().lower : 0.0;
+    QPointF prev;
+    int prevIndex = -1;
+    double prevKey = 0.0, prevValue = 0.0;
+    int i = int(begin - data->constBegin());
+    for (QCPGraphDataContainer::const_iterator it = begin; it != end; ++it, ++i) {
+        if (std::isnan(it->key) || std::isnan(it->value)) { prevIndex = -1; continue; }  // NaN 断开连线
+        const QPointF p = graph->coordsToPixels(it->key, it->value);
+
+        if (isFinitePoint(p) && area.contains(p)) {
+            unsigned char& seen = seenPixel[size_t(int(p.y() - area.top())) * width + int(p.x() - area.left())];
+            if (!seen) {
+                seen = 1;
+                index.grid.addPoint(pairs, p, int(index.points.size()));
+                index.points.push_back(p);
+                index.pointIndex.push_back(i);
+            }
+        }
+
+        if (style == QCPGraph::lsImpulse) {
+            addSegment(graph->coordsToPixels(it->key, impulseBase), p, i, i);
+        } else if (style != QCPGraph::lsNone && prevIndex >= 0) {
+            switch (style) {
+            case QCPGraph::lsStepLeft: {
+                const QPointF corner = graph->coordsToPixels(it->key, prevValue);
+                addSegment(prev, corner, prevIndex, i);
+                addSegment(corner, p, i, i);
+                break;
+            }
+            case QCPGraph::lsStepRight: {
+                const QPointF corner = graph->coordsToPixels(prevKey, it->value);
+                addSegment(prev, corner, prevIndex, prevIndex);
+                addSegment(corner, p, prevIndex, i);
+                break;
+            }
+            case QCPGraph::lsStepCenter: {
+                const double midKey = 0.5 * (prevKey + it->key);
+                const QPointF c1 = graph->coordsToPixels(midKey, prevValue);
+                const QPointF c2 = graph->coordsToPixels(midKey, it->value);
+                addSegment(prev, c1, prevIndex, prevIndex);
+                addSegment(c1, c2, prevIndex, i);
+                addSegment(c2, p, i, i);
+                break;
+            }
+            default:
+                addSegment(prev, p, prevIndex, i);
+                break;
+            }
+        }
+        prev = p;
+        prevIndex = i;
+        prevKey = it->key;
+        prevValue = it->value;
+    }
+    index.grid.finish(pairs);
+}
+
+double PlotHitIndex::query(const GraphIndex& index, const QPointF& pos, double radius, bool pointsOnly, int* dataIndex)
+{
+    const QRectF box(pos.x() - radius, pos.y() - radius, 2.0 * radius, 2.0 * radius);
+    double bestPoint = std::numeric_limits<double>::max(), bestSegment = std::numeric_limits<double>::max();
+    int pointRef = -1, segmentRef = -1;
+    index.grid.visit(box, [&](int ref) {
+        if (ref >= 0) {
+            const double d = distSqr(index.points[ref], pos);
+            if (d < bestPoint) { bestPoint = d; pointRef = ref; }
+        } else if (!pointsOnly) {
+            const int s = -ref - 1;
+            const double d = distSqrToSegment(pos, index.segments[s]);
+            if (d < bestSegment) { bestSegment = d; segmentRef = s; }
+        }
+    });
+
+    const double r2 = radius * radius;
+    const double best = std::min(bestPoint, bestSegment);
+    if (best > r2) return -1.0;
+    if (dataIndex) {
+        if (bestPoint <= r2) {
+            *dataIndex = index.pointIndex[pointRef];
+        } else {
+            const QLineF& line = index.segments[segmentRef];
+            *dataIndex = distSqr(pos, line.p1()) <= distSqr(pos, line.p2()) ? index.segmentStart[segmentRef]
+                                                                            : index.segmentEnd[segmentRef];
+        }
+    }
+    return std::sqrt(best);
+}
+
+double PlotHitIndex::graphDistance(QCPGraph* graph, const QPointF& pos, double radius, int* dataIndex)
+{
+    if (!graph || !graph->keyAxis() || !graph->valueAxis() || graph->data()->isEmpty()) return -1.0;
+    return query(*graphIndex(graph), pos, radius, false, dataIndex);
+}
+
+PlotHitIndex::GraphHit PlotHitIndex::nearestDataPoint(const QPointF& pos, double radius)
+{
+    GraphHit hit;
+    for (int g = 0; g < m_plot->graphCount(); ++g) {
+        QCPGraph* graph = m_plot->graph(g);
+        if (!graph->realVisibility() || !graph->keyAxis() || !graph->valueAxis() || graph->data()->isEmpty()) continue;
+        if (!graph->keyAxis()->axisRect()->rect().contains(pos.toPoint())) continue;
+        int dataIndex = -1;
+        const double d = query(*graphIndex(graph), pos, radius, true, &dataIndex);
+        if (d >= 0 && (!hit.graph || d < hit.distance)) {
+            hit.graph = graph;
+            hit.dataIndex = dataIndex;
+            hit.distance = d;
+        }
+    }
+    return hit;
+}
+
+// ============================================================================
+// 图元索引
+// ============================================================================
+
+void PlotHitIndex::buildItemIndex()
+{
+    m_items = ItemIndex();
+    m_items.valid = true;
+    m_items.itemCount = m_plot->itemCount();
+    m_items.viewport = m_plot->viewport();
+    m_items.grid.reset(QRectF(m_items.viewport).adjusted(-kMargin, -kMargin, kMargin, kMargin), kItemCell);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < m_items.itemCount; ++i) {
+        QCPAbstractItem* item = m_plot->item(i);
+        const int ref = int(m_items.items.size());
+        m_items.items.push_back(item);
+        if (auto line = qobject_cast<QCPItemLine*>(item)) {
+            m_items.grid.addSegment(pairs, QLineF(line->start->pixelPosition(), line->end->pixelPosition()), ref);
+        } else if (auto text = qobject_cast<QCPItemText*>(item)) {
+            // 四角锚点已计入旋转与对齐方式
+            const QPointF corners[] = {text->topLeft->pixelPosition(), text->topRight->pixelPosition(),
+                                       text->bottomLeft->pixelPosition(), text->bottomRight->pixelPosition()};
+            double left = corners[0].x(), right = left, top = corners[0].y(), bottom = top;
+            for (const QPointF& p : corners) {
+                left = std::min(left, p.x()); right = std::max(right, p.x());
+                top = std::min(top, p.y()); bottom = std::max(bottom, p.y());
+            }
+            const QRectF rect(QPointF(left, top), QPointF(right, bottom));
+            if (isFinitePoint(rect.topLeft()) && isFinitePoint(rect.bottomRight()))
+                m_items.grid.addRect(pairs, rect, ref);
+        } else {
+            m_items.unindexed.push_back(ref);
+        }
+    }
+    m_items.grid.finish(pairs);
+}
+
+QList<QCPAbstractItem*> PlotHitIndex::itemCandidates(const QPointF& pos, double radius)
+{
+    if (!m_items.valid || m_items.itemCount != m_plot->itemCount() || m_items.viewport != m_plot->viewport())
+        buildItemIndex();
+
+    std::vector<int> hits(m_items.unindexed);
+    const QRectF box(pos.x() - radius, pos.y() - radius, 2.0 * radius, 2.0 * radius);
+    m_items.grid.visit(box, [&](int ref) { hits.push_back(ref); });
+    std::sort(hits.begin(), hits.end());
+    hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+
+    QList<QCPAbstractItem*> result;
+    result.reserve(int(hits.size()));
+    for (int ref : hits) result.append(m_items.items[ref]);
+    return result;
+}
@@ -0,0 +1,122 @@
+/*
+ * 文件名: plothitindex.h
+ * 文件作用: 图表命中测试空间索引头文件
+ * 功能描述:
+ * 1. PlotHitIndex 在屏幕像素坐标 (对数坐标轴即为对数变换后的坐标) 上为每条曲线建立均匀网格：
+ *    可见数据点按像素去重后入格，连线 (含台阶线、脉冲线) 按所经过的网格列逐格登记。
+ * 2. 图元 (线段、文字标注) 另建一张网格，查询只返回附近的候选图元，精确判断仍由调用方完成。
+ * 3. 网格在首次查询时建立，坐标范围、绘图区大小或数据变化后再次查询时重建 (按签名判断，不随每次重绘作废)；
+ *    重绘后 refresh() 只丢弃已删除曲线的索引并作废图元索引，不扫描曲线数据。
+ *    点击选择、悬停读数与导出范围拾取都只查询鼠标附近的几个网格，不再逐点扫描百万点曲线。
+ */
+
+#ifndef PLOTHITINDEX_H
+#define PLOTHITINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QLineF>
+#include <QPointF>
+#include <QPointer>
+#include <QRectF>
+#include <vector>
+
+#include "qcustomplot.h"
+
+class PlotHitIndex
+{
+public:
+    explicit PlotHitIndex(QCustomPlot* plot);
+
+    // 曲线命中结果
+    struct GraphHit {
+        QCPGraph* graph = nullptr;
+        int dataIndex = -1;         // 最近数据点下标
+        double distance = -1.0;     // 像素距离
+    };
+
+    /**
+     * @brief 与 QCPGraph::selectTest 含义相同的像素距离：数据点与连线中较近者
+     * @param radius    查询半径 (像素)，超出时返回 -1
+     * @param dataIndex 输出最近数据点的下标 (只命中连线时取线段较近的端点)
+     */
+    double graphDistance(QCPGraph* graph, const QPointF& pos, double radius, int* dataIndex = nullptr);
+
+    // 所有可见曲线中离 pos 最近的数据点 (只比较数据点，供悬停读数)，radius 内没有时 graph 为空
+    GraphHit nearestDataPoint(const QPointF& pos, double radius);
+
+    // pos 附近 radius 内可能命中的图元 (按 QCustomPlot 中的图元顺序)；未建索引的图元类型总是返回
+    QList<QCPAbstractItem*> itemCandidates(const QPointF& pos, double radius);
+
+    // 作废全部网格 (增删曲线后调用)，下次查询时重建
+    void invalidate();
+
+    // 重绘后调用：丢弃已删除曲线的索引，并作废图元索引；
+    // 数据、坐标范围等其余变化由查询时的签名比较发现 (常数时间，不随点数增长)
+    void refresh();
+
+private:
+    // 均匀网格：按网格号排序的引用表 (CSR 布局)
+    struct CellGrid {
+        QRectF bounds;
+        double cell = 8.0;
+        int cols = 0;
+        int rows = 0;
+        std::vector<int> cellStart;
+        std::vector<int> refs;
+
+        void reset(const QRectF& area, double cellSize);
+        // 以下返回是否登记到了至少一个网格 (完全在网格范围外时为 false)
+        bool addPoint(std::vector<std::pair<int, int>>& pairs, const QPointF& p, int ref) const;
+        bool addSegment(std::vector<std::pair<int, int>>& pairs, const QLineF& line, int ref) const;
+        bool addRect(std::vector<std::pair<int, int>>& pairs, const QRectF& rect, int ref) const;
+        void finish(std::vector<std::pair<int, int>>& pairs);
+        int colOf(double x) const;
+        int rowOf(double y) const;
+        template <typename F> void visit(const QRectF& box, F f) const;
+    };
+
+    // 一条曲线的索引；签名用于识别已删除/替换的曲线与范围变化
+    struct GraphIndex {
+        QPointer<QCPGraph> graph;           // 曲线删除后为空 (防止新曲线复用同一地址)
+        const void* data = nullptr;
+        int dataSize = 0;
+        double dataEnds[4] = {0, 0, 0, 0};  // 首末点键值 (setData 复用同一数据容器时识别数据替换)
+        QCPRange keyRange;
+        QCPRange valueRange;
+        int keyScale = 0;
+        int valueScale = 0;
+        QRect axisRect;
+        int lineStyle = 0;
+        bool hasScatter = false;
+
+        CellGrid grid;
+        std::vector<QPointF> points;        // 去重后的数据点像素坐标
+        std::vector<int> pointIndex;        // 对应的数据下标
+        std::vector<QLineF> segments;       // 连线像素线段
+        std::vector<int> segmentStart;      // 线段起点数据下标
+        std::vector<int> segmentEnd;        // 线段终点数据下标
+    };
+
+    struct ItemIndex {
+        bool valid = false;
+        int itemCount = 0;
+        QRect viewport;
+        CellGrid grid;
+        std::vector<QCPAbstractItem*> items;    // 全部图元 (按 QCustomPlot 中的顺序)
+        std::vector<int> unindexed;             // 未入格的图元类型 (items 中的序号)，查询时总是返回
+    };
+
+    const GraphIndex* graphIndex(QCPGraph* graph);
+    void buildGraphIndex(QCPGraph* graph, GraphIndex& index) const;
+    void buildItemIndex();
+    static void readDataEnds(const QCPGraphDataContainer& data, double ends[4]);
+    static bool sameData(const GraphIndex& index, QCPGraph* graph);
+    static double query(const GraphIndex& index, const QPointF& pos, double radius, bool pointsOnly, int* dataIndex);
+
+    QCustomPlot* m_plot;
+    QHash<QCPGraph*, GraphIndex> m_graphs;
+    ItemIndex m_items;
+};
+
+#endif // PLOTHITINDEX_H
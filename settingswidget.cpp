@@ -6,12 +6,28 @@
  * 2. 实现五个功能模块（通用、单位、绘图、路径、系统）的具体的加载与保存逻辑
  * 3. 实现路径选择对话框的弹出与回填
  * 4. 实现“恢复默认值”逻辑，重置所有控件状态
+ * 5. 实现“性能诊断”页：开关性能计数器 (system/perfCounters)，每秒刷新热点计数、阶段耗时和积分深度分布
+ * 6. 实现操作时间线 (TraceRecorder) 的开关、清空与 Chrome Trace JSON 导出
+ * 7. 实现拟合回放日志开关 (system/fitReplayLog)，日志目录随数据路径 (paths/data) 更新
+ * 8. 实现反演节点共享时间网格开关 (system/sharedInversionGrid)，开启后曲线时间网格改用 generateInversionSharedTimeSteps
+ * 9. 实现 applyRuntimeSettings()，启动时不创建设置页也能应用上述运行期设置
  */
 
 #include "settingswidget.h"
 #include "ui_settingswidget.h"
+#include "perfcounters.h"
+#include "tracerecorder.h"
+#include "fitreplaylog.h"
+#include "modelsolver01-06.h"
 #include <QDebug>
 #include <QDate>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <QPushButton>
+#include <QHeaderView>
+#include <QLabel>
+#include <QDateTime>
 
 // 默认常量定义
 const int SettingsWidget::DEFAULT_AUTO_SAVE = 10;
@@ -21,7 +37,17 @@ SettingsWidget::SettingsWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::SettingsWidget),
     m_settings(nullptr),
-    m_isModified(false)
+    m_isModified(false),
+    m_pageDiagnostics(nullptr),
+    m_chkPerfCounters(nullptr),
+    m_tablePerfCounters(nullptr),
+    m_tablePerfStages(nullptr),
+    m_tableGaussDepth(nullptr),
+    m_diagRefreshTimer(nullptr),
+    m_chkTrace(nullptr),
+    m_chkFitReplay(nullptr),
+    m_chkSharedGrid(nullptr),
+    m_lblTraceEvents(nullptr)
 {
     ui->setupUi(this);
 
@@ -74,6 +100,139 @@ void SettingsWidget::initInterface()
     // 4. 初始化日志级别
     ui->cmbLogLevel->clear();
     ui->cmbLogLevel->addItems({"仅错误 (Error)", "警告与错误 (Warning)", "一般信息 (Info)", "详细调试 (Debug)"});
+
+    // 5. 性能诊断页
+    initDiagnosticsPage();
+}
+
+void SettingsWidget::initDiagnosticsPage()
+{
+    // 导航栏增加一项，页面追加到 stackedContent 末尾 (索引与行号一一对应)
+    ui->navTupleList->addItem("性能诊断");
+
+    m_pageDiagnostics = new QWidget(this);
+    QVBoxLayout *mainLayout = new QVBoxLayout(m_pageDiagnostics);
+
+    // --- 开关与操作按钮 ---
+    QGroupBox *grpSwitch = new QGroupBox("性能计数器", m_pageDiagnostics);
+    QHBoxLayout *switchLayout = new QHBoxLayout(grpSwitch);
+    m_chkPerfCounters = new QCheckBox("启用计算热点计数 (关闭时几乎无开销)", grpSwitch);
+    QPushButton *btnRefresh = new QPushButton("刷新", grpSwitch);
+    QPushButton *btnReset = new QPushButton("清零", grpSwitch);
+    switchLayout->addWidget(m_chkPerfCounters);
+    switchLayout->addStretch();
+    switchLayout->addWidget(btnRefresh);
+    switchLayout->addWidget(btnReset);
+    mainLayout->addWidget(grpSwitch);
+
+    // --- 操作时间线 (Chrome Trace) ---
+    QGroupBox *grpTrace = new QGroupBox("操作时间线", m_pageDiagnostics);
+    QHBoxLayout *traceLayout = new QHBoxLayout(grpTrace);
+    m_chkTrace = new QCheckBox("记录操作时间线 (导入、项目读写、拟合迭代、曲线计算、重绘)", grpTrace);
+    m_chkTrace->setChecked(TraceRecorder::isEnabled()); // 可能已由命令行 --trace 开启
+    m_lblTraceEvents = new QLabel("已记录 0 个事件", grpTrace);
+    QPushButton *btnExportTrace = new QPushButton("导出时间线...", grpTrace);
+    QPushButton *btnClearTrace = new QPushButton("清空", grpTrace);
+    traceLayout->addWidget(m_chkTrace);
+    traceLayout->addStretch();
+    traceLayout->addWidget(m_lblTraceEvents);
+    traceLayout->addWidget(btnExportTrace);
+    traceLayout->addWidget(btnClearTrace);
+    mainLayout->addWidget(grpTrace);
+
+    // --- 拟合回放日志 ---
+    QGroupBox *grpReplay = new QGroupBox("拟合回放日志", m_pageDiagnostics);
+    QHBoxLayout *replayLayout = new QHBoxLayout(grpReplay);
+    m_chkFitReplay = new QCheckBox("记录每次拟合的输入与迭代轨迹 (.wtfr，保存在数据目录 FitReplay 下)", grpReplay);
+    replayLayout->addWidget(m_chkFitReplay);
+    replayLayout->addStretch();
+    mainLayout->addWidget(grpReplay);
+
+    // --- 曲线时间网格 ---
+    QGroupBox *grpGrid = new QGroupBox("曲线时间网格", m_pageDiagnostics);
+    QHBoxLayout *gridLayout = new QHBoxLayout(grpGrid);
+    m_chkSharedGrid = new QCheckBox("使用反演节点共享网格 (按 2 的分数次幂等比，Stehfest 求值约减半，点数与设定值略有出入)", grpGrid);
+    gridLayout->addWidget(m_chkSharedGrid);
+    gridLayout->addStretch();
+    mainLayout->addWidget(grpGrid);
+
+    // 辅助：创建只读表格
+    auto makeTable = [this](const QStringList &headers) {
+        QTableWidget *table = new QTableWidget(m_pageDiagnostics);
+        table->setColumnCount(headers.size());
+        table->setHorizontalHeaderLabels(headers);
+        table->verticalHeader()->setVisible(false);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->setSelectionMode(QAbstractItemView::NoSelection);
+        return table;
+    };
+
+    // --- 热点计数 ---
+    QGroupBox *grpCounters = new QGroupBox("计算热点计数", m_pageDiagnostics);
+    QVBoxLayout *counterLayout = new QVBoxLayout(grpCounters);
+    m_tablePerfCounters = makeTable({"计数项", "次数"});
+    m_tablePerfCounters->setRowCount(PerfCounters::CounterCount);
+    for (int i = 0; i < PerfCounters::CounterCount; ++i) {
+        m_tablePerfCounters->setItem(i, 0, new QTableWidgetItem(PerfCounters::counterName(static_cast<PerfCounters::Counter>(i))));
+        m_tablePerfCounters->setItem(i, 1, new QTableWidgetItem("0"));
+    }
+    counterLayout->addWidget(m_tablePerfCounters);
+    mainLayout->addWidget(grpCounters);
+
+    // --- 阶段耗时 ---
+    QGroupBox *grpStages = new QGroupBox("各阶段耗时", m_pageDiagnostics);
+    QVBoxLayout *stageLayout = new QVBoxLayout(grpStages);
+    m_tablePerfStages = makeTable({"计算阶段", "调用次数", "累计耗时 (ms)", "平均耗时 (ms)"});
+    m_tablePerfStages->setRowCount(PerfCounters::StageCount);
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        m_tablePerfStages->setItem(i, 0, new QTableWidgetItem(PerfCounters::stageName(static_cast<PerfCounters::Stage>(i))));
+        for (int c = 1; c < 4; ++c) m_tablePerfStages->setItem(i, c, new QTableWidgetItem("0"));
+    }
+    stageLayout->addWidget(m_tablePerfStages);
+    mainLayout->addWidget(grpStages);
+
+    // --- 自适应积分细分深度分布 ---
+    QGroupBox *grpDepth = new QGroupBox("自适应 Gauss-Kronrod 积分细分深度分布", m_pageDiagnostics);
+    QVBoxLayout *depthLayout = new QVBoxLayout(grpDepth);
+    m_tableGaussDepth = makeTable({"细分深度", "最终区间数"});
+    m_tableGaussDepth->setRowCount(PerfCounters::GaussDepthBins);
+    for (int i = 0; i < PerfCounters::GaussDepthBins; ++i) {
+        QString label = (i == PerfCounters::GaussDepthBins - 1) ? QString("≥%1").arg(i) : QString::number(i);
+        m_tableGaussDepth->setItem(i, 0, new QTableWidgetItem(label));
+        m_tableGaussDepth->setItem(i, 1, new QTableWidgetItem("0"));
+    }
+    depthLayout->addWidget(m_tableGaussDepth);
+    mainLayout->addWidget(grpDepth);
+
+    ui->stackedContent->addWidget(m_pageDiagnostics);
+
+    // 页面可见时每秒刷新一次
+    m_diagRefreshTimer = new QTimer(this);
+    m_diagRefreshTimer->setInterval(1000);
+    connect(m_diagRefreshTimer, &QTimer::timeout, this, &SettingsWidget::refreshDiagnostics);
+
+    connect(btnRefresh, &QPushButton::clicked, this, &SettingsWidget::refreshDiagnostics);
+    connect(btnReset, &QPushButton::clicked, this, &SettingsWidget::onResetPerfCounters);
+    connect(m_chkPerfCounters, &QCheckBox::toggled, this, &SettingsWidget::onPerfCountersToggled);
+    connect(m_chkTrace, &QCheckBox::toggled, this, &SettingsWidget::onTraceToggled);
+    connect(m_chkFitReplay, &QCheckBox::toggled, this, [](bool enabled) { FitReplayLog::setEnabled(enabled); });
+    connect(m_chkSharedGrid, &QCheckBox::toggled, this, [](bool enabled) { ModelSolver01_06::setSharedInversionGrid(enabled); });
+    connect(btnExportTrace, &QPushButton::clicked, this, &SettingsWidget::onExportTrace);
+    connect(btnClearTrace, &QPushButton::clicked, this, &SettingsWidget::onClearTrace);
+}
+
+// 静态函数：直接读取配置并应用运行期设置
+void SettingsWidget::applyRuntimeSettings()
+{
+    QSettings settings("WellTestPro", "WellTestAnalysis");
+    QString docPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    QString dataPath = settings.value("paths/data", docPath + "/WellTestPro/Data").toString();
+
+    PerfCounters::setEnabled(settings.value("system/perfCounters", false).toBool());
+    FitReplayLog::setEnabled(settings.value("system/fitReplayLog", false).toBool());
+    FitReplayLog::setDirectory(dataPath + "/FitReplay");
+    ModelSolver01_06::setSharedInversionGrid(settings.value("system/sharedInversionGrid", false).toBool());
 }
 
 void SettingsWidget::loadSettings()
@@ -106,6 +265,12 @@ void SettingsWidget::loadSettings()
     ui->spinLogDays->setValue(m_settings->value("system/logRetention", 30).toInt());
     ui->cmbLogLevel->setCurrentIndex(m_settings->value("system/logLevel", 2).toInt());
 
+    // --- 6. 性能诊断 (加载即生效) ---
+    m_chkPerfCounters->setChecked(m_settings->value("system/perfCounters", false).toBool());
+    m_chkFitReplay->setChecked(m_settings->value("system/fitReplayLog", false).toBool());
+    m_chkSharedGrid->setChecked(m_settings->value("system/sharedInversionGrid", false).toBool());
+    applyRuntimeSettings();
+
     m_isModified = false;
 }
 
@@ -138,8 +303,12 @@ void SettingsWidget::applySettings()
     m_settings->setValue("system/cleanupLogs", ui->chkCleanupLogs->isChecked());
     m_settings->setValue("system/logRetention", ui->spinLogDays->value());
     m_settings->setValue("system/logLevel", ui->cmbLogLevel->currentIndex());
+    m_settings->setValue("system/perfCounters", m_chkPerfCounters->isChecked());
+    m_settings->setValue("system/fitReplayLog", m_chkFitReplay->isChecked());
+    m_settings->setValue("system/sharedInversionGrid", m_chkSharedGrid->isChecked());
 
     m_settings->sync(); // 强制写入磁盘
+    applyRuntimeSettings();
 
     // 发射信号通知系统其他部分
     emit settingsChanged();
@@ -199,10 +368,22 @@ void SettingsWidget::on_navTupleList_currentRowChanged(int currentRow)
         "单位与精度 - 物理量单位配置",
         "绘图设置 - 图表默认风格",
         "路径配置 - 文件存储位置",
-        "系统与日志 - 运行维护设置"
+        "系统与日志 - 运行维护设置",
+        "性能诊断 - 计算热点计数与耗时"
     };
     if(currentRow >= 0 && currentRow < titles.size())
         ui->lblPageTitle->setText(titles[currentRow]);
+
+    // 仅在诊断页可见时定时刷新
+    if (m_diagRefreshTimer) {
+        bool onDiagPage = (ui->stackedContent->currentWidget() == m_pageDiagnostics);
+        if (onDiagPage) {
+            refreshDiagnostics();
+            m_diagRefreshTimer->start();
+        } else {
+            m_diagRefreshTimer->stop();
+        }
+    }
 }
 
 // 槽函数：浏览按钮
@@ -234,6 +415,72 @@ void SettingsWidget::onSettingModified() {
     m_isModified = true;
 }
 
+// 槽函数：刷新性能诊断页显示
+void SettingsWidget::refreshDiagnostics()
+{
+    if (!m_tablePerfCounters) return;
+    PerfSnapshot snap = PerfCounters::snapshot();
+
+    for (int i = 0; i < PerfCounters::CounterCount; ++i)
+        m_tablePerfCounters->item(i, 1)->setText(QString::number(snap.counters[i]));
+
+    for (int i = 0; i < PerfCounters::StageCount; ++i) {
+        double totalMs = snap.stageNs[i] / 1e6;
+        double avgMs = snap.stageCalls[i] > 0 ? totalMs / snap.stageCalls[i] : 0.0;
+        m_tablePerfStages->item(i, 1)->setText(QString::number(snap.stageCalls[i]));
+        m_tablePerfStages->item(i, 2)->setText(QString::number(totalMs, 'f', 1));
+        m_tablePerfStages->item(i, 3)->setText(QString::number(avgMs, 'f', 3));
+    }
+
+    for (int i = 0; i < PerfCounters::GaussDepthBins; ++i)
+        m_tableGaussDepth->item(i, 1)->setText(QString::number(snap.gaussDepth[i]));
+
+    m_lblTraceEvents->setText(QString("已记录 %1 个事件").arg(TraceRecorder::eventCount()));
+}
+
+// 槽函数：清零性能计数
+void SettingsWidget::onResetPerfCounters()
+{
+    PerfCounters::reset();
+    refreshDiagnostics();
+}
+
+// 槽函数：开关时间线记录 (仅本次运行有效，不写入配置)
+void SettingsWidget::onTraceToggled(bool enabled)
+{
+    TraceRecorder::setEnabled(enabled);
+}
+
+// 槽函数：导出 Chrome Trace JSON
+void SettingsWidget::onExportTrace()
+{
+    QString defaultName = QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QString path = QFileDialog::getSaveFileName(this, "导出时间线", defaultName, "Chrome Trace (*.json)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    if (TraceRecorder::exportChromeTrace(path, &error)) {
+        QMessageBox::information(this, "导出时间线",
+                                 QString("已导出 %1 个事件。\n可在 Chrome 的 chrome://tracing 或 ui.perfetto.dev 中打开。")
+                                     .arg(TraceRecorder::eventCount()));
+    } else {
+        QMessageBox::warning(this, "导出时间线", error);
+    }
+}
+
+// 槽函数：清空已记录的时间线事件
+void SettingsWidget::onClearTrace()
+{
+    TraceRecorder::clear();
+    refreshDiagnostics();
+}
+
+// 槽函数：开关性能计数器 (立即生效，点击“应用”后持久化)
+void SettingsWidget::onPerfCountersToggled(bool enabled)
+{
+    PerfCounters::setEnabled(enabled);
+}
+
 // Getters implementation
 QString SettingsWidget::getDataPath() const { return ui->lineDataPath->text(); }
 QString SettingsWidget::getReportPath() const { return ui->lineReportPath->text(); }
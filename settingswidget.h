@@ -6,6 +6,11 @@
  * 2. 声明各个设置模块（通用、单位、绘图、路径、系统）的 UI 组件交互逻辑
  * 3. 声明配置数据的加载 (load)、保存 (apply) 和恢复默认 (restoreDefaults) 方法
  * 4. 定义配置变更的信号，供主程序响应（如切换单位、修改绘图风格）
+ * 5. 声明“性能诊断”页：性能计数器开关、热点计数表、阶段耗时表、高斯积分深度分布，定时刷新
+ * 6. 性能诊断页增加操作时间线记录开关与 Chrome Trace 导出
+ * 7. 性能诊断页增加拟合回放日志开关 (日志写入数据目录下的 FitReplay 子目录)
+ * 8. 性能诊断页增加反演节点共享时间网格开关 (system/sharedInversionGrid，默认关闭)
+ * 9. 提供静态 applyRuntimeSettings()，设置页延迟创建时由主窗口在启动时应用运行期设置
  */
 
 #ifndef SETTINGSWIDGET_H
@@ -18,6 +23,9 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QTimer>
+#include <QCheckBox>
+#include <QTableWidget>
+#include <QLabel>
 
 namespace Ui {
 class SettingsWidget;
@@ -51,6 +59,9 @@ public:
     int getPlotBackgroundStyle() const; // 0: 白色, 1: 深色
     bool isGridVisibleDefault() const;
 
+    // 直接从配置文件应用运行期设置 (性能计数器、拟合回放日志、反演节点共享网格)，无需创建设置页
+    static void applyRuntimeSettings();
+
 signals:
     // 配置变更信号
     void settingsChanged();           // 通用变更信号
@@ -75,16 +86,41 @@ private slots:
     // 监听部分控件变化（用于激活"应用"按钮状态等）
     void onSettingModified();
 
+    // 性能诊断页：刷新显示 / 清零计数 / 开关计数器
+    void refreshDiagnostics();
+    void onResetPerfCounters();
+    void onPerfCountersToggled(bool enabled);
+
+    // 时间线追踪：开关 / 导出 / 清空
+    void onTraceToggled(bool enabled);
+    void onExportTrace();
+    void onClearTrace();
+
 private:
     Ui::SettingsWidget *ui;
     QSettings *m_settings;
     bool m_isModified; // 记录是否有未保存的修改
 
+    // 性能诊断页控件 (代码创建，不修改 .ui 文件)
+    QWidget *m_pageDiagnostics;
+    QCheckBox *m_chkPerfCounters;
+    QTableWidget *m_tablePerfCounters;
+    QTableWidget *m_tablePerfStages;
+    QTableWidget *m_tableGaussDepth;
+    QTimer *m_diagRefreshTimer;
+    QCheckBox *m_chkTrace;
+    QCheckBox *m_chkFitReplay;
+    QCheckBox *m_chkSharedGrid;
+    QLabel *m_lblTraceEvents;
+
     // --- 核心逻辑方法 ---
 
     // 初始化界面控件（设置下拉框选项、默认值等）
     void initInterface();
 
+    // 创建性能诊断页并加入导航栏
+    void initDiagnosticsPage();
+
     // 加载所有设置到 UI
     void loadSettings();
 
@@ -0,0 +1,79 @@
+/*
+ * 文件名: startupprofiler.cpp
+ * 文件作用: 启动耗时统计实现文件
+ * 功能描述:
+ * 1. 以进程内单一 QElapsedTimer 为基准记录阶段耗时，所有调用均在界面线程。
+ * 2. finish() 通过 qDebug 输出“启动耗时分解”，包括各阶段耗时、占比与总耗时。
+ */
+
+#include "startupprofiler.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QPair>
+#include <QStringList>
+#include <QDebug>
+
+namespace {
+
+struct ProfilerState {
+    QElapsedTimer timer;
+    qint64 lastNs = 0;
+    bool finished = false;
+    QVector<QPair<QString, qint64>> stages; // (阶段名, 耗时 ns)
+};
+
+ProfilerState& state()
+{
+    static ProfilerState s;
+    return s;
+}
+
+} // namespace
+
+void StartupProfiler::start()
+{
+    ProfilerState& s = state();
+    s.timer.start();
+    s.lastNs = 0;
+    s.finished = false;
+    s.stages.clear();
+}
+
+void StartupProfiler::mark(const QString& stage)
+{
+    ProfilerState& s = state();
+    if (!s.timer.isValid() || s.finished) return;
+    qint64 now = s.timer.nsecsElapsed();
+    s.stages.append(qMakePair(stage, now - s.lastNs));
+    s.lastNs = now;
+}
+
+void StartupProfiler::finish()
+{
+    ProfilerState& s = state();
+    if (!s.timer.isValid() || s.finished) return;
+    s.finished = true;
+    qDebug().noquote() << summary();
+}
+
+void StartupProfiler::recordLazyInit(const QString& name, qint64 nsecs)
+{
+    qDebug().noquote() << QString("[启动] 延迟创建 %1: %2 ms").arg(name).arg(nsecs / 1e6, 0, 'f', 1);
+}
+
+QString StartupProfiler::summary()
+{
+    const ProfilerState& s = state();
+    qint64 total = s.lastNs;
+    QStringList lines;
+    lines << QString("[启动] 启动耗时分解 (总计 %1 ms):").arg(total / 1e6, 0, 'f', 1);
+    for (const auto& stage : s.stages) {
+        double pct = total > 0 ? 100.0 * stage.second / total : 0.0;
+        lines << QString("    %1: %2 ms (%3%)")
+                     .arg(stage.first, -16)
+                     .arg(stage.second / 1e6, 8, 'f', 1)
+                     .arg(pct, 0, 'f', 1);
+    }
+    return lines.join("\n");
+}
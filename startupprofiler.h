@@ -0,0 +1,35 @@
+/*
+ * 文件名: startupprofiler.h
+ * 文件作用: 启动耗时统计头文件
+ * 功能描述:
+ * 1. 声明 StartupProfiler 静态接口，按顺序记录启动各阶段 (应用对象、样式表、主窗口各页面、首次事件循环) 的耗时。
+ * 2. 启动完成后输出一次耗时分解日志。
+ * 3. 记录延迟创建页面 (首次进入时才构建) 的构建耗时，便于确认延迟加载的效果。
+ */
+
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QString>
+#include <QtGlobal>
+
+class StartupProfiler
+{
+public:
+    // 开始计时 (应在 main 入口处调用)
+    static void start();
+
+    // 记录一个阶段：耗时为距上一次 mark (或 start) 的时间
+    static void mark(const QString& stage);
+
+    // 启动结束：输出耗时分解日志 (只输出一次)
+    static void finish();
+
+    // 记录延迟创建页面的构建耗时
+    static void recordLazyInit(const QString& name, qint64 nsecs);
+
+    // 启动耗时分解文本
+    static QString summary();
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,237 @@
+/*
+ * 文件名: timeparser.cpp
+ * 文件作用: 快速日期/时刻文本解析器实现文件
+ * 功能描述:
+ * 1. 数字组扫描：一次遍历取出各段数字的位置、位数与数值，不分配内存。
+ * 2. 定宽解析：按检测时记录的字段位置读取，遇到非数字字符则退回数字组解析。
+ * 3. 日期换算采用公历天数公式 (days_from_civil)，与时区、夏令时无关。
+ * 4. [修复] 日按当月天数 (含闰年二月) 校验，2024-02-31 之类的日期解析失败；
+ *    日期后只跟一个数字组 (只有时、没有分) 时两种解析方式都判为失败，不再一种忽略小时、一种读入小时。
+ */
+
+#include "timeparser.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const int kMaxGroups = 8;
+
+struct DigitGroup {
+    int pos = 0;
+    int len = 0;
+    qint64 value = 0;
+};
+
+// 拆分数字组，返回组数；超过上限返回 -1
+int scanGroups(const QString& text, DigitGroup* groups)
+{
+    const QChar* s = text.constData();
+    const int n = text.size();
+    int count = 0;
+    int i = 0;
+    while (i < n) {
+        ushort c = s[i].unicode();
+        if (c < '0' || c > '9') { ++i; continue; }
+        if (count == kMaxGroups) return -1;
+        DigitGroup& g = groups[count++];
+        g.pos = i;
+        g.len = 0;
+        g.value = 0;
+        while (i < n) {
+            ushort d = s[i].unicode();
+            if (d < '0' || d > '9') break;
+            if (g.len < 18) g.value = g.value * 10 + (d - '0');
+            ++g.len;
+            ++i;
+        }
+    }
+    return count;
+}
+
+// 各字段数值 (缺省为 0)
+struct TimeFields {
+    qint64 year = 1970, month = 1, day = 1;
+    qint64 hour = 0, minute = 0, second = 0;
+    double fraction = 0.0;
+};
+
+double fractionValue(qint64 digits, int len)
+{
+    return len > 0 ? digits / std::pow(10.0, len) : 0.0;
+}
+
+// 公历当月天数
+int daysInMonth(qint64 year, qint64 month)
+{
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+// 校验范围并换算为秒
+double compose(const TimeFields& v, bool hasDate)
+{
+    if (v.hour > 23 || v.minute > 59 || v.second > 60) return kNaN;
+    double seconds = v.hour * 3600.0 + v.minute * 60.0 + v.second + v.fraction;
+    if (!hasDate) return seconds;
+    if (v.month < 1 || v.month > 12 || v.day < 1 || v.day > daysInMonth(v.year, v.month)) return kNaN;
+    return FastTimeParser::daysFromCivil(static_cast<int>(v.year), static_cast<int>(v.month), static_cast<int>(v.day)) * 86400.0 + seconds;
+}
+
+double parseGeneric(const QString& text, const TimeTextFormat& f, bool dateOnly)
+{
+    DigitGroup g[kMaxGroups];
+    int n = scanGroups(text, g);
+    if (n <= 0) return kNaN;
+
+    TimeFields v;
+    int k = 0;
+    if (f.hasDate) {
+        if (n < 3) return kNaN;
+        v.year = g[0].value; v.month = g[1].value; v.day = g[2].value;
+        k = 3;
+        if (!dateOnly && n == 4) return kNaN; // 日期后只有时、没有分
+    }
+    if (f.hasTime && !dateOnly) {
+        int rest = n - k;
+        if (rest >= 2) {
+            v.hour = g[k].value;
+            v.minute = g[k + 1].value;
+            if (rest >= 3) v.second = g[k + 2].value;
+            if (rest >= 4) v.fraction = fractionValue(g[k + 3].value, g[k + 3].len);
+        } else if (!f.hasDate) {
+            return kNaN; // 纯时刻列必须至少有时、分
+        }
+    }
+    return compose(v, f.hasDate);
+}
+
+// 定宽解析；文本不符合定宽布局时 ok 置 false
+double parseFixed(const QString& text, const TimeTextFormat& f, bool dateOnly, bool& ok)
+{
+    ok = false;
+    if (text.size() != f.length) return kNaN;
+    const QChar* s = text.constData();
+
+    qint64 values[TimeTextFormat::FieldCount] = {};
+    int lastField = dateOnly ? TimeTextFormat::Day : TimeTextFormat::Fraction;
+    for (int field = 0; field <= lastField; ++field) {
+        int p = f.fieldPos[field];
+        if (p < 0) continue;
+        qint64 v = 0;
+        for (int i = 0; i < f.fieldLen[field]; ++i) {
+            ushort c = s[p + i].unicode();
+            if (c < '0' || c > '9') return kNaN;
+            v = v * 10 + (c - '0');
+        }
+        values[field] = v;
+    }
+    ok = true;
+    if (f.hasDate && !dateOnly && f.fieldPos[TimeTextFormat::Hour] >= 0 && f.fieldPos[TimeTextFormat::Minute] < 0)
+        return kNaN; // 与数字组解析一致：日期后只有时、没有分
+
+    TimeFields v;
+    if (f.hasDate) {
+        v.year = values[TimeTextFormat::Year];
+        v.month = values[TimeTextFormat::Month];
+        v.day = values[TimeTextFormat::Day];
+    }
+    if (!dateOnly) {
+        v.hour = values[TimeTextFormat::Hour];
+        v.minute = values[TimeTextFormat::Minute];
+        v.second = values[TimeTextFormat::Second];
+        v.fraction = fractionValue(values[TimeTextFormat::Fraction], f.fieldLen[TimeTextFormat::Fraction]);
+    }
+    return compose(v, f.hasDate);
+}
+
+// 两个文本的数字/非数字布局是否一致
+bool sameDigitLayout(const QString& a, const QString& b)
+{
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        bool da = a[i].unicode() >= '0' && a[i].unicode() <= '9';
+        bool db = b[i].unicode() >= '0' && b[i].unicode() <= '9';
+        if (da != db) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+QString TimeTextFormat::description() const
+{
+    if (!valid) return "未识别";
+    QString text;
+    if (hasDate) text += "日期";
+    if (hasDate && hasTime) text += "+";
+    if (hasTime) text += "时刻";
+    text += fixedWidth ? " (定宽解析)" : " (分组解析)";
+    return text;
+}
+
+TimeTextFormat FastTimeParser::detect(const QVector<QString>& column, int maxSamples)
+{
+    TimeTextFormat f;
+    QVector<QString> samples;
+    for (const QString& s : column) {
+        if (s.isEmpty()) continue;
+        samples.append(s);
+        if (samples.size() >= maxSamples) break;
+    }
+    if (samples.isEmpty()) return f;
+
+    // 由首个样本的数字组结构判断：4 位首组视为年份
+    DigitGroup g[kMaxGroups];
+    int n = scanGroups(samples.first(), g);
+    if (n <= 0) return f;
+    f.hasDate = (n >= 3 && g[0].len == 4);
+    f.hasTime = f.hasDate ? (n >= 5) : (n >= 2);
+    if (!f.hasDate && !f.hasTime) return f;
+
+    // 多数样本可解析才视为有效
+    int parsed = 0;
+    for (const QString& s : samples) {
+        if (!std::isnan(parseGeneric(s, f, false))) ++parsed;
+    }
+    f.valid = parsed * 2 >= samples.size();
+    if (!f.valid) return f;
+
+    // 定宽：全部样本长度与数字布局一致
+    bool fixed = n <= TimeTextFormat::FieldCount;
+    for (int i = 1; fixed && i < samples.size(); ++i) fixed = sameDigitLayout(samples.first(), samples[i]);
+    if (fixed) {
+        int field = f.hasDate ? TimeTextFormat::Year : TimeTextFormat::Hour;
+        for (int k = 0; k < n && field < TimeTextFormat::FieldCount; ++k, ++field) {
+            f.fieldPos[field] = g[k].pos;
+            f.fieldLen[field] = g[k].len;
+        }
+        f.fixedWidth = true;
+        f.length = samples.first().size();
+    }
+    return f;
+}
+
+double FastTimeParser::toSeconds(const QString& text, const TimeTextFormat& format, bool dateOnly)
+{
+    if (!format.valid || text.isEmpty()) return kNaN;
+    if (format.fixedWidth) {
+        bool ok = false;
+        double v = parseFixed(text, format, dateOnly, ok);
+        if (ok) return v;
+    }
+    return parseGeneric(text, format, dateOnly);
+}
+
+qint64 FastTimeParser::daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<qint64>(doe) - 719468;
+}
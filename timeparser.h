@@ -0,0 +1,57 @@
+/*
+ * 文件名: timeparser.h
+ * 文件作用: 快速日期/时刻文本解析器头文件
+ * 功能描述:
+ * 1. 由一列文本的样本一次性检测格式 (年月日顺序的日期、时:分[:秒[.小数]] 时刻，或二者组合)。
+ * 2. 样本长度一致且数字位置固定时启用定宽解析：按位置直接读取数字，不做分词与格式试探。
+ * 3. 其余情况按“数字组 + 任意分隔符”解析；两种方式都不构造 QDate/QTime/QDateTime。
+ * 4. 结果为秒：含日期时为自 1970-01-01 起的秒数，仅时刻时为当日秒数。
+ */
+
+#ifndef TIMEPARSER_H
+#define TIMEPARSER_H
+
+#include <QString>
+#include <QVector>
+
+// 检测出的文本格式
+struct TimeTextFormat {
+    enum Field { Year = 0, Month, Day, Hour, Minute, Second, Fraction, FieldCount };
+
+    bool valid = false;         // 样本中多数可解析
+    bool hasDate = false;       // 以日期 (年-月-日) 开头
+    bool hasTime = false;       // 含时刻
+    bool fixedWidth = false;    // 定宽：样本长度与数字位置一致
+    int length = 0;             // 定宽时的文本长度
+    int fieldPos[FieldCount];   // 定宽时各字段起始位置 (-1 表示无此字段)
+    int fieldLen[FieldCount];   // 定宽时各字段宽度
+
+    TimeTextFormat()
+    {
+        for (int i = 0; i < FieldCount; ++i) { fieldPos[i] = -1; fieldLen[i] = 0; }
+    }
+
+    QString description() const;
+};
+
+class FastTimeParser
+{
+public:
+    /**
+     * @brief 由列中前若干个非空文本检测格式
+     * @param maxSamples 最多检查的样本数
+     */
+    static TimeTextFormat detect(const QVector<QString>& column, int maxSamples = 200);
+
+    /**
+     * @brief 解析为秒
+     * @param dateOnly 为 true 时只取日期部分 (时刻由另一列提供)
+     * @return 失败返回 NaN
+     */
+    static double toSeconds(const QString& text, const TimeTextFormat& format, bool dateOnly = false);
+
+    // 公历日期到 1970-01-01 起的天数
+    static qint64 daysFromCivil(int y, int m, int d);
+};
+
+#endif // TIMEPARSER_H
@@ -0,0 +1,181 @@
+/*
+ * 文件名: timeseriesmerge.cpp
+ * 文件作用: 多数据源按时间合并对齐引擎实现文件
+ * 功能描述:
+ * 1. 最小堆中每个数据源只保留其下一个待归并点，弹出最小时间作为输出行时间，
+ *    再弹出容差窗口内的全部点 (各数据源游标随之推进)。
+ * 2. 命中行 (数据源在本行有实测点) 直接取实测值；未命中时用游标两侧的点按通道方式对齐。
+ * 3. 游标只前进不后退，对齐不做任何查找。
+ */
+
+#include "timeseriesmerge.h"
+
+#include <QtMath>
+#include <cmath>
+#include <queue>
+#include <vector>
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const int kCancelCheckStride = 4096;
+
+// 堆元素：数据源的下一个点
+struct HeapEntry {
+    double time;
+    int source;
+    int index;
+    bool operator>(const HeapEntry& o) const
+    {
+        return time > o.time || (time == o.time && source > o.source);
+    }
+};
+
+// 从 from 开始找下一个时间有效的点
+int nextValid(const QVector<double>& t, int from)
+{
+    while (from < t.size() && std::isnan(t[from])) ++from;
+    return from;
+}
+
+// 从 from 开始向前找时间有效的点
+int prevValid(const QVector<double>& t, int from)
+{
+    while (from >= 0 && std::isnan(t[from])) --from;
+    return from;
+}
+
+// 按通道方式计算 T 时刻的值；prev/next 为游标两侧的点 (-1 或越界表示不存在)
+double alignedValue(const MergeChannel& ch, const QVector<double>& t, int prev, int next,
+                    double T, const MergeOptions& opt)
+{
+    const bool hasPrev = prev >= 0;
+    const bool hasNext = next >= 0 && next < t.size();
+    if (!hasPrev && !hasNext) return kNaN;
+    if (!hasPrev) return opt.extrapolate ? ch.values.value(next, kNaN) : kNaN;
+    if (!hasNext && ch.mode != MergeAlignMode::StepHold) return opt.extrapolate ? ch.values.value(prev, kNaN) : kNaN;
+
+    switch (ch.mode) {
+    case MergeAlignMode::StepHold:
+        // 末点之后按保持处理，仅受 maxGap 限制 (外推时不受限)
+        return (T - t[prev] <= opt.maxGap || (!hasNext && opt.extrapolate)) ? ch.values.value(prev, kNaN) : kNaN;
+    case MergeAlignMode::Linear: {
+        const double t1 = t[prev], t2 = t[next];
+        if (t2 - t1 > opt.maxGap) return kNaN;
+        const double v1 = ch.values.value(prev, kNaN), v2 = ch.values.value(next, kNaN);
+        if (t2 - t1 <= 0.0) return v1;
+        return v1 + (T - t1) * (v2 - v1) / (t2 - t1);
+    }
+    case MergeAlignMode::Nearest: {
+        const int k = (T - t[prev] <= t[next] - T) ? prev : next;
+        return qAbs(t[k] - T) <= opt.maxGap ? ch.values.value(k, kNaN) : kNaN;
+    }
+    }
+    return kNaN;
+}
+
+} // namespace
+
+QString TimeSeriesMerger::modeName(MergeAlignMode mode)
+{
+    switch (mode) {
+    case MergeAlignMode::StepHold: return "阶梯保持";
+    case MergeAlignMode::Linear: return "线性插值";
+    case MergeAlignMode::Nearest: return "最近点";
+    }
+    return QString();
+}
+
+ColumnarTable TimeSeriesMerger::merge(const QVector<MergeSource>& sources, const MergeOptions& options,
+                                      const std::atomic<bool>* cancel)
+{
+    ColumnarTable table;
+    const int k = sources.size();
+    int channelCount = 0;
+    qint64 totalPoints = 0;
+    for (const MergeSource& s : sources) {
+        for (const MergeChannel& ch : s.channels) table.names << ch.name;
+        channelCount += s.channels.size();
+        totalPoints += s.time.size();
+    }
+    table.columns.resize(channelCount);
+    const qint64 reserveRows = options.referenceSource >= 0 && options.referenceSource < k
+                                   ? sources[options.referenceSource].time.size() : totalPoints;
+    table.time.reserve(reserveRows);
+    for (QVector<double>& col : table.columns) col.reserve(reserveRows);
+
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    QVector<int> cursor(k, 0);      // 下一个未归并点
+    QVector<int> hit(k, -1);        // 本行命中的点
+    for (int s = 0; s < k; ++s) {
+        int i = nextValid(sources[s].time, 0);
+        cursor[s] = i;
+        if (i < sources[s].time.size()) heap.push({sources[s].time[i], s, i});
+    }
+
+    qint64 rows = 0;
+    while (!heap.empty()) {
+        if ((++rows & (kCancelCheckStride - 1)) == 0 && cancel && cancel->load(std::memory_order_relaxed))
+            return ColumnarTable();
+
+        // 1. 取出容差窗口内的全部点，推进游标
+        const double T = heap.top().time;
+        hit.fill(-1);
+        while (!heap.empty() && heap.top().time <= T + options.timeTolerance) {
+            HeapEntry e = heap.top();
+            heap.pop();
+            if (hit[e.source] < 0) hit[e.source] = e.index;
+            const QVector<double>& t = sources[e.source].time;
+            int next = nextValid(t, e.index + 1);
+            cursor[e.source] = next;
+            if (next < t.size()) heap.push({t[next], e.source, next});
+        }
+        if (options.referenceSource >= 0 && (options.referenceSource >= k || hit[options.referenceSource] < 0))
+            continue;
+
+        // 2. 逐数据源对齐
+        table.time.append(T);
+        int col = 0;
+        for (int s = 0; s < k; ++s) {
+            const MergeSource& src = sources[s];
+            if (hit[s] >= 0) {
+                for (const MergeChannel& ch : src.channels) table.columns[col++].append(ch.values.value(hit[s], kNaN));
+                continue;
+            }
+            const int prev = prevValid(src.time, cursor[s] - 1);
+            const int next = cursor[s];
+            for (const MergeChannel& ch : src.channels)
+                table.columns[col++].append(alignedValue(ch, src.time, prev, next, T, options));
+        }
+    }
+    return table;
+}
+
+QVector<double> TimeSeriesMerger::alignTo(const QVector<double>& targetTime, const QVector<double>& sourceTime,
+                                          const QVector<double>& sourceValue, MergeAlignMode mode,
+                                          bool extrapolate, double maxGap)
+{
+    QVector<MergeSource> sources(2);
+    sources[0].time = targetTime;
+    sources[1].time = sourceTime.mid(0, qMin(sourceTime.size(), sourceValue.size()));
+    MergeChannel ch;
+    ch.mode = mode;
+    ch.values = sourceValue.mid(0, sources[1].time.size());
+    sources[1].channels.append(ch);
+
+    MergeOptions options;
+    options.referenceSource = 0;
+    options.extrapolate = extrapolate;
+    options.maxGap = maxGap;
+    ColumnarTable table = merge(sources, options);
+
+    // 目标时间中的 NaN 与重复时间在归并时被跳过/合并，这里按目标点逐一回填
+    QVector<double> out(targetTime.size(), kNaN);
+    int row = 0;
+    for (int i = 0; i < targetTime.size(); ++i) {
+        if (std::isnan(targetTime[i])) continue;
+        while (row + 1 < table.rowCount() && table.time[row + 1] <= targetTime[i]) ++row;
+        if (row < table.rowCount()) out[i] = table.columns[0][row];
+    }
+    return out;
+}
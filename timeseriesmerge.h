@@ -0,0 +1,85 @@
+/*
+ * 文件名: timeseriesmerge.h
+ * 文件作用: 多数据源按时间合并对齐引擎头文件
+ * 功能描述:
+ * 1. 定义 MergeSource：一个按时间升序的数据源 (一个压力计/产量文件)，含若干数值通道。
+ * 2. 每个通道可单独指定对齐方式：阶梯保持 (产量)、线性插值 (压力)、最近点。
+ * 3. 声明 TimeSeriesMerger：以最小堆对 N 个数据源做单遍 K 路归并，容差窗口内的时间合并为一行，
+ *    归并过程中各数据源游标同步推进，直接得到对齐值，总复杂度 O(N log k)。
+ * 4. 输出 ColumnarTable：按列存储的 double 表，不创建任何单元格对象。
+ */
+
+#ifndef TIMESERIESMERGE_H
+#define TIMESERIESMERGE_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <limits>
+
+// 通道对齐方式
+enum class MergeAlignMode {
+    StepHold,   // 阶梯保持：取不晚于该时刻的最后一个值 (产量)
+    Linear,     // 线性插值 (压力、温度)
+    Nearest     // 最近点
+};
+
+// 数据源中的一个数值通道
+struct MergeChannel {
+    QString name;
+    MergeAlignMode mode = MergeAlignMode::Linear;
+    QVector<double> values;     // 与数据源时间等长，缺失值为 NaN
+};
+
+// 一个按时间升序的数据源 (时间为 NaN 的点被跳过)
+struct MergeSource {
+    QString name;
+    QVector<double> time;
+    QVector<MergeChannel> channels;
+};
+
+// 合并参数
+struct MergeOptions {
+    double timeTolerance = 0.0;     // 相距不超过该值的时间合并为一行 (与时间同单位)
+    double maxGap = std::numeric_limits<double>::infinity();   // 插值/保持跨越的最大时间间隔，超出时为 NaN
+    bool extrapolate = false;       // 数据源时间范围之外是否沿用首/末值
+    int referenceSource = -1;       // -1：输出所有数据源时间的并集；否则只在该数据源的时间点输出
+};
+
+// 按列存储的合并结果
+struct ColumnarTable {
+    QVector<double> time;
+    QStringList names;                  // 各数值列名称
+    QVector<QVector<double>> columns;   // 与 names 一一对应，长度均为 rowCount()
+
+    int rowCount() const { return time.size(); }
+    int columnCount() const { return columns.size(); }
+};
+
+class TimeSeriesMerger
+{
+public:
+    /**
+     * @brief K 路归并并对齐全部数据源的全部通道 (可在工作线程中调用)
+     * @param cancel 非空时定期检查，置位则返回空表
+     */
+    static ColumnarTable merge(const QVector<MergeSource>& sources,
+                               const MergeOptions& options = MergeOptions(),
+                               const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief 单通道对齐到目标时间轴 (两路归并的便捷形式)
+     * 目标时间需升序；结果与 targetTime 等长。
+     */
+    static QVector<double> alignTo(const QVector<double>& targetTime,
+                                   const QVector<double>& sourceTime,
+                                   const QVector<double>& sourceValue,
+                                   MergeAlignMode mode,
+                                   bool extrapolate = true,
+                                   double maxGap = std::numeric_limits<double>::infinity());
+
+    static QString modeName(MergeAlignMode mode);
+};
+
+#endif // TIMESERIESMERGE_H
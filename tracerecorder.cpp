@@ -0,0 +1,275 @@
+/*
+ * 文件名: tracerecorder.cpp
+ * 文件作用: 时间线追踪记录器实现文件
+ * 功能描述:
+ * 1. 每个线程首次记录时分配环形缓冲区并登记到全局列表；之后只有所属线程写入，
+ *    写入顺序为“先写槽位、再以 release 语义推进写指针”，无需加锁。
+ * 2. 导出时以 acquire 语义读取写指针并复制事件，复制完成后再次检查写指针，
+ *    丢弃复制期间可能被覆盖的槽位，保证导出的事件完整。
+ * 3. 生成 Chrome Trace 格式："X" 完整事件 + "M" 线程名元数据，时间单位为微秒。
+ * 4. [修复] 缓冲区由线程局部的持有者管理：线程结束时 (线程池空闲线程 30 秒后退出) 把有效事件转存到
+ *    已结束线程记录 (总量上限 RetiredCapacity) 并把缓冲区放回空闲列表，新线程优先复用，内存不随线程更替增长。
+ */
+
+#include "tracerecorder.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <vector>
+#include <deque>
+#include <algorithm>
+
+std::atomic<bool> TraceRecorder::s_enabled(false);
+
+namespace {
+
+struct TraceEvent {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    qint64 startNs = 0;
+    qint64 durNs = 0;
+    qint64 arg = -1;
+};
+
+// 线程私有环形缓冲区
+struct TraceThreadBuffer {
+    TraceEvent events[TraceRecorder::RingCapacity];
+    std::atomic<quint64> head{0};       // 已写入事件总数 (只由所属线程推进)
+    std::atomic<quint64> clearedAt{0};  // 清空时的写指针位置
+    int tid = 0;
+    QString threadName;
+};
+
+// 已结束线程的事件 (线程结束时从其缓冲区复制)
+struct TraceRetiredThread {
+    int tid = 0;
+    QString threadName;
+    std::vector<TraceEvent> events;
+};
+
+// 全局登记表：以下成员均在 mutex 保护下访问
+struct TraceRegistry {
+    QMutex mutex;
+    std::vector<TraceThreadBuffer*> active;     // 存活线程的缓冲区
+    std::vector<TraceThreadBuffer*> freeList;   // 已结束线程归还的缓冲区，供新线程复用
+    std::deque<TraceRetiredThread> retired;
+    size_t retiredEvents = 0;
+    int nextTid = 1;
+
+    ~TraceRegistry() { qDeleteAll(freeList); }
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry r;
+    return r;
+}
+
+const QElapsedTimer& clockBase()
+{
+    static QElapsedTimer timer = [] { QElapsedTimer t; t.start(); return t; }();
+    return timer;
+}
+
+// 复制一个缓冲区中仍然有效的事件
+void collectEvents(const TraceThreadBuffer* b, std::vector<TraceEvent>& out)
+{
+    const quint64 cap = TraceRecorder::RingCapacity;
+    quint64 head = b->head.load(std::memory_order_acquire);
+    quint64 first = b->clearedAt.load(std::memory_order_relaxed);
+    // 写线程先写槽位 head % cap 再推进 head，该槽位 (即 head - cap 处) 可能正被改写，不读取
+    if (head > cap - 1 && head + 1 - cap > first) first = head + 1 - cap;
+
+    std::vector<TraceEvent> copy;
+    copy.reserve(static_cast<size_t>(head - first));
+    for (quint64 i = first; i < head; ++i) copy.push_back(b->events[i % cap]);
+
+    // 复制期间被写线程覆盖的槽位不可信，丢弃
+    quint64 headAfter = b->head.load(std::memory_order_acquire);
+    quint64 validFrom = headAfter > cap - 1 ? headAfter + 1 - cap : 0;
+    size_t skip = validFrom > first ? static_cast<size_t>(validFrom - first) : 0;
+    if (skip > copy.size()) skip = copy.size();
+    out.insert(out.end(), copy.begin() + skip, copy.end());
+}
+
+// 为当前线程取一个缓冲区 (优先复用已结束线程归还的) 并登记
+TraceThreadBuffer* acquireBuffer()
+{
+    QString threadName;
+    QThread* thread = QThread::currentThread();
+    bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+    if (isMain) threadName = "主线程";
+    else if (thread && !thread->objectName().isEmpty()) threadName = thread->objectName();
+
+    TraceRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    TraceThreadBuffer* buffer = nullptr;
+    if (!r.freeList.empty()) {
+        buffer = r.freeList.back();
+        r.freeList.pop_back();
+    } else {
+        buffer = new TraceThreadBuffer();
+    }
+    buffer->head.store(0, std::memory_order_relaxed);
+    buffer->clearedAt.store(0, std::memory_order_relaxed);
+    buffer->tid = r.nextTid++;
+    buffer->threadName = threadName.isEmpty() ? QString("工作线程 %1").arg(buffer->tid) : threadName;
+    r.active.push_back(buffer);
+    return buffer;
+}
+
+// 线程结束：转存有效事件并归还缓冲区
+void retireBuffer(TraceThreadBuffer* buffer)
+{
+    TraceRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    TraceRetiredThread retired;
+    retired.tid = buffer->tid;
+    retired.threadName = buffer->threadName;
+    collectEvents(buffer, retired.events);
+    if (!retired.events.empty()) {
+        r.retiredEvents += retired.events.size();
+        r.retired.push_back(std::move(retired));
+        while (r.retiredEvents > size_t(TraceRecorder::RetiredCapacity)) {
+            r.retiredEvents -= r.retired.front().events.size();
+            r.retired.pop_front();
+        }
+    }
+
+    r.active.erase(std::remove(r.active.begin(), r.active.end(), buffer), r.active.end());
+    r.freeList.push_back(buffer);
+}
+
+// 线程局部的缓冲区持有者：线程结束时析构，归还缓冲区
+struct TraceBufferOwner {
+    TraceThreadBuffer* buffer = nullptr;
+    ~TraceBufferOwner() { if (buffer) retireBuffer(buffer); }
+};
+
+TraceThreadBuffer* localBuffer()
+{
+    thread_local TraceBufferOwner owner;
+    if (!owner.buffer) owner.buffer = acquireBuffer();
+    return owner.buffer;
+}
+
+// 写入一个线程的 Chrome Trace 事件 (线程名元数据 + 完整事件)
+void appendThreadEvents(QJsonArray& traceEvents, qint64 pid, int tid, const QString& threadName,
+                        const std::vector<TraceEvent>& events)
+{
+    QJsonObject meta;
+    meta["name"] = "thread_name";
+    meta["ph"] = "M";
+    meta["pid"] = pid;
+    meta["tid"] = tid;
+    QJsonObject metaArgs;
+    metaArgs["name"] = threadName;
+    meta["args"] = metaArgs;
+    traceEvents.append(meta);
+
+    for (const TraceEvent& e : events) {
+        QJsonObject obj;
+        obj["name"] = QString::fromUtf8(e.name ? e.name : "?");
+        obj["cat"] = QString::fromUtf8(e.category ? e.category : "");
+        obj["ph"] = "X";
+        obj["ts"] = e.startNs / 1000.0;
+        obj["dur"] = e.durNs / 1000.0;
+        obj["pid"] = pid;
+        obj["tid"] = tid;
+        if (e.arg >= 0) {
+            QJsonObject args;
+            args["arg"] = static_cast<double>(e.arg);
+            obj["args"] = args;
+        }
+        traceEvents.append(obj);
+    }
+}
+
+} // namespace
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    clockBase();
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 TraceRecorder::nowNs()
+{
+    return clockBase().nsecsElapsed();
+}
+
+void TraceRecorder::record(const char* name, const char* category, qint64 startNs, qint64 endNs, qint64 arg)
+{
+    TraceThreadBuffer* b = localBuffer();
+    quint64 h = b->head.load(std::memory_order_relaxed);
+    TraceEvent& e = b->events[h % RingCapacity];
+    e.name = name;
+    e.category = category;
+    e.startNs = startNs;
+    e.durNs = endNs > startNs ? endNs - startNs : 0;
+    e.arg = arg;
+    b->head.store(h + 1, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    TraceRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (TraceThreadBuffer* b : r.active)
+        b->clearedAt.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    r.retired.clear();
+    r.retiredEvents = 0;
+}
+
+int TraceRecorder::eventCount()
+{
+    TraceRegistry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    quint64 total = r.retiredEvents;
+    for (const TraceThreadBuffer* b : r.active) {
+        quint64 head = b->head.load(std::memory_order_acquire);
+        quint64 first = b->clearedAt.load(std::memory_order_relaxed);
+        quint64 n = head > first ? head - first : 0;
+        total += qMin<quint64>(n, RingCapacity - 1);
+    }
+    return static_cast<int>(total);
+}
+
+bool TraceRecorder::exportChromeTrace(const QString& filePath, QString* errorMessage)
+{
+    QJsonArray traceEvents;
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    {
+        TraceRegistry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        for (const TraceRetiredThread& t : r.retired)
+            appendThreadEvents(traceEvents, pid, t.tid, t.threadName, t.events);
+        for (const TraceThreadBuffer* b : r.active) {
+            std::vector<TraceEvent> events;
+            collectEvents(b, events);
+            appendThreadEvents(traceEvents, pid, b->tid, b->threadName, events);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = "无法写入文件: " + file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * 文件名: tracerecorder.h
+ * 文件作用: 时间线追踪记录器头文件
+ * 功能描述:
+ * 1. 声明 TraceRecorder 静态接口：按作用域记录操作区间 (数据导入、项目读写、LM 迭代、雅可比列、理论曲线、图表重绘)。
+ * 2. 每个线程一个固定容量的环形缓冲区，写入端无锁，满后覆盖最早的事件。
+ *    [修复] 缓冲区随线程结束归还复用，其事件转存到容量有限的已结束线程记录中。
+ * 3. 导出为 Chrome Trace JSON (chrome://tracing、Perfetto 均可打开)，用于观察线程利用率与卡顿。
+ * 4. 声明 TraceSpan，构造时记录起点，析构时写入一个完整区间事件。
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+class TraceRecorder
+{
+public:
+    // 每个线程环形缓冲区容量 (事件数)
+    static const int RingCapacity = 32768;
+    // 已结束线程的事件总容量 (超出时丢弃最早结束线程的事件)
+    static const int RetiredCapacity = RingCapacity * 4;
+
+    // 是否记录 (关闭时每个追踪点仅一次原子读取)
+    static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    // 当前时间 (纳秒，相对进程内统一时间基准)
+    static qint64 nowNs();
+
+    /**
+     * @brief 写入一个完整区间事件
+     * @param name 事件名 (须为静态字符串，记录时只保存指针)
+     * @param category 分类 (同上)
+     * @param startNs/endNs 起止时间，取自 nowNs()
+     * @param arg 附加整数参数 (如迭代序号、列号)，小于 0 表示无
+     */
+    static void record(const char* name, const char* category, qint64 startNs, qint64 endNs, qint64 arg = -1);
+
+    // 丢弃已记录的事件
+    static void clear();
+
+    // 已记录 (未被覆盖) 的事件数
+    static int eventCount();
+
+    /**
+     * @brief 导出为 Chrome Trace JSON 文件
+     * @param errorMessage 失败时写入错误信息，可为空
+     */
+    static bool exportChromeTrace(const QString& filePath, QString* errorMessage = nullptr);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// 作用域追踪：构造时记录起点，析构时写入区间
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category, qint64 arg = -1)
+        : m_name(name), m_category(category), m_arg(arg),
+          m_startNs(TraceRecorder::isEnabled() ? TraceRecorder::nowNs() : -1)
+    {
+    }
+    ~TraceSpan()
+    {
+        if (m_startNs >= 0 && TraceRecorder::isEnabled())
+            TraceRecorder::record(m_name, m_category, m_startNs, TraceRecorder::nowNs(), m_arg);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    qint64 m_arg;
+    qint64 m_startNs;
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,261 @@
+/*
+ * 文件名: uncertaintydialog.cpp
+ * 文件作用: 拟合参数不确定性分析的设置与结果对话框实现文件
+ * 功能描述:
+ * 1. 界面全部由代码构建。
+ * 2. 相关系数矩阵按绝对值着色 (|r| ≥ 0.8 红色，≥ 0.5 橙色)，便于发现强相关参数。
+ * 3. 导出 CSV 时统计表与重复拟合明细分别写入两个文件 (UTF-8 BOM，Excel 可直接打开)。
+ */
+
+#include "uncertaintydialog.h"
+
+#include <QComboBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <cmath>
+
+namespace {
+
+QString fmt(double v)
+{
+    return QString::number(v, 'g', 5);
+}
+
+QColor correlationColor(double r)
+{
+    double a = std::abs(r);
+    if (a >= 0.8) return QColor(255, 200, 200);
+    if (a >= 0.5) return QColor(255, 230, 190);
+    return QColor(Qt::white);
+}
+
+QString paramLabel(const ParameterInterval& iv)
+{
+    return iv.displayName.isEmpty() ? iv.name : QString("%1 (%2)").arg(iv.displayName, iv.name);
+}
+
+} // namespace
+
+// ============================================================================
+// UncertaintySettingsDialog
+// ============================================================================
+
+UncertaintySettingsDialog::UncertaintySettingsDialog(const UncertaintyOptions& options, int fitParamCount, int dataPoints, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("参数不确定性分析");
+    resize(420, 260);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QLabel* hint = new QLabel(QString("以当前参数为中心生成合成数据并重复拟合，统计参数分布。\n"
+                                      "拟合参数 %1 个，抽样数据点 %2 个；重复拟合在全部 CPU 核心上并行执行。")
+                                  .arg(fitParamCount).arg(dataPoints), this);
+    hint->setWordWrap(true);
+    layout->addWidget(hint);
+
+    QFormLayout* form = new QFormLayout();
+    m_method = new QComboBox(this);
+    m_method->addItem(ParameterUncertainty::methodName(UncertaintyMethod::ResidualBootstrap), static_cast<int>(UncertaintyMethod::ResidualBootstrap));
+    m_method->addItem(ParameterUncertainty::methodName(UncertaintyMethod::NoisePerturbation), static_cast<int>(UncertaintyMethod::NoisePerturbation));
+    m_method->setCurrentIndex(m_method->findData(static_cast<int>(options.method)));
+    form->addRow("合成数据方式:", m_method);
+
+    m_replicates = new QSpinBox(this);
+    m_replicates->setRange(20, 5000);
+    m_replicates->setSingleStep(50);
+    m_replicates->setValue(options.replicates);
+    form->addRow("重复拟合次数:", m_replicates);
+
+    m_maxIterations = new QSpinBox(this);
+    m_maxIterations->setRange(5, 100);
+    m_maxIterations->setValue(options.maxIterations);
+    form->addRow("单次最大迭代:", m_maxIterations);
+
+    m_seed = new QSpinBox(this);
+    m_seed->setRange(0, 2147483647);
+    m_seed->setValue(static_cast<int>(options.seed & 0x7FFFFFFF));
+    m_seed->setToolTip("相同的种子、参数与数据得到完全相同的结果");
+    form->addRow("随机种子:", m_seed);
+    layout->addLayout(form);
+    layout->addStretch();
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Ok)->setText("开始分析");
+    buttons->button(QDialogButtonBox::Cancel)->setText("取消");
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttons);
+}
+
+UncertaintyOptions UncertaintySettingsDialog::options() const
+{
+    UncertaintyOptions o;
+    o.method = static_cast<UncertaintyMethod>(m_method->currentData().toInt());
+    o.replicates = m_replicates->value();
+    o.maxIterations = m_maxIterations->value();
+    o.seed = static_cast<quint64>(m_seed->value());
+    return o;
+}
+
+// ============================================================================
+// UncertaintyResultDialog
+// ============================================================================
+
+UncertaintyResultDialog::UncertaintyResultDialog(const UncertaintyResult& result, QWidget* parent)
+    : QDialog(parent), m_result(result)
+{
+    setWindowTitle("参数不确定性分析结果");
+    resize(760, 560);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QLabel* summary = new QLabel(QString("方式: %1    有效重复拟合: %2 / %3    噪声水平 (对数标准差): 压差 %4, 导数 %5    耗时: %6 s")
+                                     .arg(ParameterUncertainty::methodName(result.options.method))
+                                     .arg(result.completed)
+                                     .arg(result.completed + result.failed)
+                                     .arg(result.noiseP, 0, 'f', 4)
+                                     .arg(result.noiseD, 0, 'f', 4)
+                                     .arg(result.elapsedMs / 1000.0, 0, 'f', 1), this);
+    summary->setWordWrap(true);
+    layout->addWidget(summary);
+
+    // 参数统计表
+    QTableWidget* table = new QTableWidget(result.intervals.size(), 7, this);
+    table->setHorizontalHeaderLabels({"参数", "拟合值", "P10", "P50", "P90", "均值", "标准差"});
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int i = 0; i < result.intervals.size(); ++i) {
+        const ParameterInterval& iv = result.intervals[i];
+        QStringList cells = {paramLabel(iv), fmt(iv.fitted), fmt(iv.p10), fmt(iv.p50), fmt(iv.p90), fmt(iv.mean), fmt(iv.stdDev)};
+        for (int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            if (c > 0) item->setTextAlignment(Qt::AlignCenter);
+            table->setItem(i, c, item);
+        }
+    }
+    layout->addWidget(new QLabel("参数分布 (分位数按重复拟合结果统计):", this));
+    layout->addWidget(table);
+
+    // 相关系数矩阵
+    const int n = result.intervals.size();
+    QTableWidget* corr = new QTableWidget(n, n, this);
+    QStringList names;
+    for (const ParameterInterval& iv : result.intervals) names << iv.name;
+    corr->setHorizontalHeaderLabels(names);
+    corr->setVerticalHeaderLabels(names);
+    corr->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    corr->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int a = 0; a < n; ++a) {
+        for (int b = 0; b < n; ++b) {
+            double r = result.correlation[a][b];
+            QTableWidgetItem* item = new QTableWidgetItem(QString::number(r, 'f', 3));
+            item->setTextAlignment(Qt::AlignCenter);
+            item->setBackground(a == b ? QColor(235, 235, 235) : correlationColor(r));
+            corr->setItem(a, b, item);
+        }
+    }
+    layout->addWidget(new QLabel("参数相关系数矩阵 (对数更新的参数按 log10 计算):", this));
+    layout->addWidget(corr);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    QPushButton* btnExport = new QPushButton("导出CSV", this);
+    QPushButton* btnClose = new QPushButton("关闭", this);
+    btnLayout->addWidget(btnExport);
+    btnLayout->addWidget(btnClose);
+    layout->addLayout(btnLayout);
+    connect(btnExport, &QPushButton::clicked, this, &UncertaintyResultDialog::onExportCsv);
+    connect(btnClose, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void UncertaintyResultDialog::onExportCsv()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "导出不确定性分析结果", "参数不确定性.csv", "CSV 文件 (*.csv)");
+    if (fileName.isEmpty()) return;
+
+    QFileInfo info(fileName);
+    QString samplesName = info.absolutePath() + "/" + info.completeBaseName() + "_重复拟合.csv";
+
+    QFile file(fileName);
+    QFile samplesFile(samplesName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || !samplesFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", "无法写入文件:\n" + (file.isOpen() ? samplesFile.errorString() : file.errorString()));
+        return;
+    }
+
+    QTextStream out(&file);
+    out.setGenerateByteOrderMark(true);
+    out << "参数,拟合值,P10,P50,P90,均值,标准差\n";
+    for (const ParameterInterval& iv : m_result.intervals) {
+        out << iv.name << "," << fmt(iv.fitted) << "," << fmt(iv.p10) << "," << fmt(iv.p50) << ","
+            << fmt(iv.p90) << "," << fmt(iv.mean) << "," << fmt(iv.stdDev) << "\n";
+    }
+    out << "\n相关系数";
+    for (const ParameterInterval& iv : m_result.intervals) out << "," << iv.name;
+    out << "\n";
+    for (int a = 0; a < m_result.intervals.size(); ++a) {
+        out << m_result.intervals[a].name;
+        for (int b = 0; b < m_result.intervals.size(); ++b) out << "," << QString::number(m_result.correlation[a][b], 'f', 4);
+        out << "\n";
+    }
+
+    QTextStream samplesOut(&samplesFile);
+    samplesOut.setGenerateByteOrderMark(true);
+    samplesOut << "序号";
+    for (const ParameterInterval& iv : m_result.intervals) samplesOut << "," << iv.name;
+    samplesOut << "\n";
+    for (int k = 0; k < m_result.samples.size(); ++k) {
+        samplesOut << (k + 1);
+        for (double v : m_result.samples[k]) samplesOut << "," << QString::number(v, 'g', 8);
+        samplesOut << "\n";
+    }
+
+    QMessageBox::information(this, "成功", QString("统计表已导出:\n%1\n\n重复拟合明细:\n%2").arg(fileName, samplesName));
+}
+
+QString UncertaintyResultDialog::toHtml(const UncertaintyResult& result)
+{
+    QString html;
+    html += QString("<p>方式：%1；有效重复拟合 %2 / %3 次；随机种子 %4；噪声水平 (对数标准差)：压差 %5，导数 %6。</p>")
+                .arg(ParameterUncertainty::methodName(result.options.method))
+                .arg(result.completed)
+                .arg(result.completed + result.failed)
+                .arg(result.options.seed)
+                .arg(result.noiseP, 0, 'f', 4)
+                .arg(result.noiseD, 0, 'f', 4);
+
+    html += "<table><tr><th>参数</th><th>拟合值</th><th>P10</th><th>P50</th><th>P90</th><th>均值</th><th>标准差</th></tr>";
+    for (const ParameterInterval& iv : result.intervals) {
+        html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td></tr>")
+                    .arg(paramLabel(iv).toHtmlEscaped(), fmt(iv.fitted), fmt(iv.p10), fmt(iv.p50),
+                         fmt(iv.p90), fmt(iv.mean), fmt(iv.stdDev));
+    }
+    html += "</table>";
+
+    html += "<p><b>参数相关系数矩阵：</b></p><table><tr><th></th>";
+    for (const ParameterInterval& iv : result.intervals) html += "<th>" + iv.name.toHtmlEscaped() + "</th>";
+    html += "</tr>";
+    for (int a = 0; a < result.intervals.size(); ++a) {
+        html += "<tr><td><b>" + result.intervals[a].name.toHtmlEscaped() + "</b></td>";
+        for (int b = 0; b < result.intervals.size(); ++b) {
+            double r = result.correlation[a][b];
+            html += QString("<td style='background-color:%1'>%2</td>")
+                        .arg(a == b ? QString("#ebebeb") : correlationColor(r).name(), QString::number(r, 'f', 3));
+        }
+        html += "</tr>";
+    }
+    html += "</table>";
+    return html;
+}
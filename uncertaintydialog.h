@@ -0,0 +1,50 @@
+/*
+ * 文件名: uncertaintydialog.h
+ * 文件作用: 拟合参数不确定性分析的设置与结果对话框头文件
+ * 功能描述:
+ * 1. UncertaintySettingsDialog：选择合成数据方式 (残差重抽样/噪声扰动)、重复拟合次数与随机种子。
+ * 2. UncertaintyResultDialog：显示各拟合参数的 P10/P50/P90、均值、标准差及参数相关系数矩阵，
+ *    可导出统计表与全部重复拟合结果 (CSV)。
+ */
+
+#ifndef UNCERTAINTYDIALOG_H
+#define UNCERTAINTYDIALOG_H
+
+#include <QDialog>
+#include "fittinguncertainty.h"
+
+class QComboBox;
+class QSpinBox;
+
+class UncertaintySettingsDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit UncertaintySettingsDialog(const UncertaintyOptions& options, int fitParamCount, int dataPoints, QWidget* parent = nullptr);
+
+    UncertaintyOptions options() const;
+
+private:
+    QComboBox* m_method = nullptr;
+    QSpinBox* m_replicates = nullptr;
+    QSpinBox* m_seed = nullptr;
+    QSpinBox* m_maxIterations = nullptr;
+};
+
+class UncertaintyResultDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit UncertaintyResultDialog(const UncertaintyResult& result, QWidget* parent = nullptr);
+
+    // 统计表与相关系数矩阵 (HTML)，供拟合报告使用
+    static QString toHtml(const UncertaintyResult& result);
+
+private slots:
+    void onExportCsv();
+
+private:
+    UncertaintyResult m_result;
+};
+
+#endif // UNCERTAINTYDIALOG_H
@@ -7,12 +7,17 @@
  * 3. 实现了数据的同步保存与恢复。
  * 4. [保留优化] 实现了 getAllDataModels，遍历所有页签收集数据模型。
  * 5. [新增] 增加了 applyDataDialogStyle 函数，统一数据界面弹窗的按钮样式为“灰底黑字”，解决看不清的问题。
+ * 6. 数据文件导入与项目数据恢复记录时间线区间 (TraceRecorder)。
+ * 7. [新增] 工具栏“多文件合并”：DataMergeDialog 配置列用途，TimeSeriesMerger 在线程池中归并，
+ *    结果按列建成新页签 (DataSingleSheet::loadFromTable)。
  */
 
 #include "wt_datawidget.h"
 #include "ui_wt_datawidget.h"
 #include "modelparameter.h"
 #include "dataimportdialog.h"
+#include "tracerecorder.h"
+#include "datamergedialog.h"
 
 #include <QFileDialog>
 #include <QMessageBox>
@@ -21,6 +26,8 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QPushButton>
+#include <QtConcurrent>
 
 // [新增] 静态辅助函数：强制应用“灰底黑字”的按钮样式
 // 解决某些弹窗按钮背景为白色导致看不清文字的问题
@@ -51,11 +58,20 @@ WT_DataWidget::WT_DataWidget(QWidget *parent) :
 
 WT_DataWidget::~WT_DataWidget()
 {
+    m_mergeWatcher.waitForFinished();
     delete ui;
 }
 
 void WT_DataWidget::initUI()
 {
+    // [新增] 多文件合并按钮，与“错误检查”同样式，放在其后
+    m_btnMerge = new QPushButton("多文件合并", this);
+    m_btnMerge->setMinimumSize(ui->btnErrorCheck->minimumSize());
+    m_btnMerge->setMaximumSize(ui->btnErrorCheck->maximumSize());
+    m_btnMerge->setCursor(Qt::PointingHandCursor);
+    m_btnMerge->setToolTip("将多个压力计/产量文件按时间合并对齐为一个数据表");
+    ui->horizontalLayout_DataTools->insertWidget(ui->horizontalLayout_DataTools->indexOf(ui->btnErrorCheck) + 1, m_btnMerge);
+
     updateButtonsState();
 }
 
@@ -71,6 +87,8 @@ void WT_DataWidget::setupConnections()
     connect(ui->btnPressureDropCalc, &QPushButton::clicked, this, &WT_DataWidget::onPressureDropCalc);
     connect(ui->btnCalcPwf, &QPushButton::clicked, this, &WT_DataWidget::onCalcPwf);
     connect(ui->btnErrorCheck, &QPushButton::clicked, this, &WT_DataWidget::onHighlightErrors);
+    connect(m_btnMerge, &QPushButton::clicked, this, &WT_DataWidget::onMergeSheets);
+    connect(&m_mergeWatcher, &QFutureWatcher<ColumnarTable>::finished, this, &WT_DataWidget::onMergeFinished);
 
     // TabWidget 信号连接
     connect(ui->tabWidget, &QTabWidget::currentChanged, this, &WT_DataWidget::onTabChanged);
@@ -127,6 +145,7 @@ void WT_DataWidget::updateButtonsState()
     ui->btnPressureDropCalc->setEnabled(hasSheet);
     ui->btnCalcPwf->setEnabled(hasSheet);
     ui->btnErrorCheck->setEnabled(hasSheet);
+    m_btnMerge->setEnabled(ui->tabWidget->count() >= 2 && !m_mergeWatcher.isRunning());
 
     if (auto sheet = currentSheet()) {
         ui->filePathLabel->setText(sheet->getFilePath());
@@ -159,6 +178,7 @@ void WT_DataWidget::onOpenFile()
 }
 
 void WT_DataWidget::createNewTab(const QString& filePath, const DataImportSettings& settings) {
+    TraceSpan importSpan("WT_DataWidget::import", "import");
     DataSingleSheet* sheet = new DataSingleSheet(this);
     if (sheet->loadData(filePath, settings)) {
         QFileInfo fi(filePath);
@@ -214,6 +234,7 @@ void WT_DataWidget::onSave() {
 }
 
 void WT_DataWidget::loadFromProjectData() {
+    TraceSpan restoreSpan("WT_DataWidget::loadFromProjectData", "import");
     clearAllData();
     QJsonArray dataArray = ModelParameter::instance()->getTableData();
     if (dataArray.isEmpty()) {
@@ -282,6 +303,71 @@ void WT_DataWidget::onPressureDropCalc() { if (auto s = currentSheet()) s->onPre
 void WT_DataWidget::onCalcPwf() { if (auto s = currentSheet()) s->onCalcPwf(); }
 void WT_DataWidget::onHighlightErrors() { if (auto s = currentSheet()) s->onHighlightErrors(); }
 
+// [新增] 多文件按时间合并
+void WT_DataWidget::onMergeSheets()
+{
+    if (m_mergeWatcher.isRunning()) return;
+
+    QList<DataMergeSheetInfo> sheets;
+    for (int i = 0; i < ui->tabWidget->count(); ++i) {
+        DataSingleSheet* sheet = qobject_cast<DataSingleSheet*>(ui->tabWidget->widget(i));
+        if (!sheet) continue;
+        DataMergeSheetInfo info;
+        info.title = ui->tabWidget->tabText(i);
+        info.model = sheet->getDataModel();
+        info.definitions = sheet->getColumnDefinitions();
+        sheets.append(info);
+    }
+
+    DataMergeDialog dlg(sheets, this);
+    applyDataDialogStyle(&dlg);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    DataMergeRequest request;
+    QString error;
+    if (!dlg.buildRequest(request, error)) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("多文件合并");
+        msgBox.setText(error);
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.addButton(QMessageBox::Ok);
+        applyDataDialogStyle(&msgBox);
+        msgBox.exec();
+        return;
+    }
+
+    m_mergeTimeDefinition = request.timeDefinition;
+    m_mergeChannelDefinitions = request.channelDefinitions;
+    m_btnMerge->setEnabled(false);
+    ui->statusLabel->setText(QString("正在合并 %1 个文件...").arg(request.sources.size()));
+    m_mergeWatcher.setFuture(QtConcurrent::run([request]() {
+        TraceSpan span("TimeSeriesMerger::merge", "import");
+        return TimeSeriesMerger::merge(request.sources, request.options);
+    }));
+}
+
+void WT_DataWidget::onMergeFinished()
+{
+    ColumnarTable table = m_mergeWatcher.result();
+    updateButtonsState();
+    if (table.rowCount() == 0) {
+        ui->statusLabel->setText("合并结果为空");
+        return;
+    }
+
+    TraceSpan buildSpan("WT_DataWidget::buildMergedSheet", "import");
+    DataSingleSheet* sheet = new DataSingleSheet(this);
+    const QString title = QString("合并数据%1").arg(++m_mergeCount);
+    sheet->loadFromTable(title, table, m_mergeTimeDefinition, m_mergeChannelDefinitions);
+    ui->tabWidget->addTab(sheet, title);
+    ui->tabWidget->setCurrentWidget(sheet);
+    connect(sheet, &DataSingleSheet::dataChanged, this, &WT_DataWidget::onSheetDataChanged);
+
+    ui->statusLabel->setText(QString("合并完成：%1 行，%2 列").arg(table.rowCount()).arg(table.columnCount() + 1));
+    updateButtonsState();
+    emit dataChanged();
+}
+
 void WT_DataWidget::onTabChanged(int index) {
     Q_UNUSED(index);
     updateButtonsState();
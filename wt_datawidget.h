@@ -7,6 +7,7 @@
  * 3. 协调顶部工具栏与当前活动页签的交互。
  * 4. 负责将所有页签数据同步保存到项目文件中。
  * 5. [保留优化] 提供了 getAllDataModels 接口，支持多文件数据传递。
+ * 6. [新增] 多文件按时间合并：各页签的压力计/产量数据经 K 路归并对齐后生成新的合并页签。
  */
 
 #ifndef WT_DATAWIDGET_H
@@ -16,7 +17,11 @@
 #include <QStandardItemModel>
 #include <QJsonArray>
 #include <QMap>
+#include <QFutureWatcher>
 #include "datasinglesheet.h" // 包含单页类
+#include "timeseriesmerge.h"
+
+class QPushButton;
 
 namespace Ui {
 class WT_DataWidget;
@@ -67,6 +72,9 @@ private slots:
     void onPressureDropCalc();
     void onCalcPwf();
     void onHighlightErrors();
+    // [新增] 多文件按时间合并
+    void onMergeSheets();
+    void onMergeFinished();
 
     // 状态
     void onTabChanged(int index);
@@ -84,6 +92,13 @@ private:
     void createNewTab(const QString& filePath, const DataImportSettings& settings);
     // 辅助函数：获取当前活动页签
     DataSingleSheet* currentSheet() const;
+
+    // [新增] 多文件合并状态
+    QPushButton* m_btnMerge = nullptr;
+    QFutureWatcher<ColumnarTable> m_mergeWatcher;
+    ColumnDefinition m_mergeTimeDefinition;             // 合并进行中：结果时间列定义
+    QList<ColumnDefinition> m_mergeChannelDefinitions;  // 合并进行中：结果数值列定义
+    int m_mergeCount = 0;                               // 已生成的合并页签数 (用于命名)
 };
 
 #endif // WT_DATAWIDGET_H
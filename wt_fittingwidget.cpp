@@ -6,10 +6,24 @@
  * 2. [主类] FittingWidget:
  * - 界面初始化与图表配置 (QCustomPlot)。
  * - 数据加载与处理 (计算压差、导数)。
- * - 拟合算法实现 (Levenberg-Marquardt)，包含物理约束(内区>外区)和多线程执行。
+ * - 拟合流程调度 (Levenberg-Marquardt 算法本体位于 FittingCore)，后台线程执行并回传进度。
  * - 绘图逻辑：包含实测数据、理论曲线、以及特定抽样点的高亮显示。
- * - 报告导出：生成包含多坐标系截图、参数分类表、数据表的 Word 兼容格式报告。
+ * - 报告导出：生成包含多坐标系截图、参数分类表、数据表、拟合性能统计的 Word 兼容格式报告。
  * - 状态管理：保存和恢复拟合进度 (.json)。
+ * - [新增] 理论曲线缓存：状态中保存曲线与误差，加载时输入一致则直接绘制，否则在页签显示时后台计算。
+ * - [新增] 参数不确定性分析：以当前参数与拟合抽样数据为输入并行重复拟合，结果写入报告。
+ * - [新增] MCMC 后验采样：检查点以 "mcmcCheckpoint" 保存在分析状态中，重新打开项目后可继续采样。
+ * - [新增] 目标函数地形：以当前参数表与拟合抽样数据为输入打开非模态热力图对话框。
+ * - [新增] 裂缝表：编辑后写入参数表的隐藏参数；选择参数对话框中不列出裂缝表参数。
+ * - [修改] 观测点较多时绘图时间序列由 generateCurveTimeSteps 生成 (设置开启时为反演节点共享网格)。
+ * - [新增] 自定义抽样可按抽样密度加权残差，权重用于 LM 拟合、不确定性分析、MCMC、地形与联合拟合，并随状态保存。
+ * - [新增] 未启用分段抽样时可选自适应抽样 (按导数曲率与噪声分配点数)，抽样点在图中高亮，目标点数随状态保存。
+ * - [新增] 抽样设置按钮下方可选迭代算法与上下限变换，报告的拟合性能统计列出所用算法与拒绝步数。
+ * - [新增] 优化器状态以 "optimizerState" 保存，微调参数或上下限后再次拟合时复用雅可比与阻尼系数。
+ * - [修复] 拟合线程使用私有低精度求解器，不再临时切换 ModelManager 的共享精度。
+ * - [修复] 理论曲线请求与缓存键固定为高精度，同步计算按请求精度使用独立求解器。
+ * - [修复] 拟合线程接收复制的迭代策略与热启动状态并返回 FittingResult，拟合统计与优化器状态只在界面线程的 onFitFinished 中写入。
+ * - [修复] 报告中的热点计数取自 FittingResult::perf，只含本次拟合 (及其并行求值) 的计算，不含其他后台任务。
  */
 
 #include "wt_fittingwidget.h"
@@ -20,6 +34,14 @@
 #include "pressurederivativecalculator.h"
 #include "pressurederivativecalculator1.h"
 #include "paramselectdialog.h"
+#include "tracerecorder.h"
+#include "fitreplaylog.h"
+#include "fittingreportjob.h"
+#include "uncertaintydialog.h"
+#include "mcmcdialog.h"
+#include "landscapedialog.h"
+#include "fracturetabledialog.h"
+#include "fittingsampler.h"
 
 #include <QtConcurrent>
 #include <QMessageBox>
@@ -39,7 +61,6 @@
 #include <QJsonArray>
 #include <QDateTime>
 #include <QBuffer>
-#include <Eigen/Dense>
 #include <QFileInfo>
 #include <algorithm>
 
@@ -52,12 +73,14 @@
  * * 初始化抽样设置对话框的界面布局，包括说明文本、启用开关、区间配置表格以及操作按钮。
  * * @param intervals 当前已有的区间列表，用于回显。
  * @param enabled 当前是否启用了自定义抽样。
+ * @param densityWeighting 当前是否按抽样密度加权残差。
+ * @param adaptiveCount 自适应抽样目标点数，0 表示未启用。
  * @param dataMinT 数据的最小时间，用于提示和默认区间生成。
  * @param dataMaxT 数据的最大时间。
  * @param parent 父窗口指针。
  */
-SamplingSettingsDialog::SamplingSettingsDialog(const QList<SamplingInterval>& intervals, bool enabled,
-                                               double dataMinT, double dataMaxT, QWidget *parent)
+SamplingSettingsDialog::SamplingSettingsDialog(const QList<SamplingInterval>& intervals, bool enabled, bool densityWeighting,
+                                               int adaptiveCount, double dataMinT, double dataMaxT, QWidget *parent)
     : QDialog(parent), m_dataMinT(dataMinT), m_dataMaxT(dataMaxT)
 {
     setWindowTitle("数据抽样策略设置");
@@ -79,6 +102,35 @@ SamplingSettingsDialog::SamplingSettingsDialog(const QList<SamplingInterval>& in
     m_chkEnable->setChecked(enabled);
     mainLayout->addWidget(m_chkEnable);
 
+    // 自适应抽样：仅在未启用分段抽样时生效
+    QHBoxLayout* adaptiveLayout = new QHBoxLayout();
+    m_chkAdaptive = new QCheckBox("未启用分段抽样时使用自适应抽样 (按导数曲率与噪声分配点数)", this);
+    m_chkAdaptive->setToolTip("流动段转换处多取点、径向流等平台段少取点，以更少的点数达到相同的拟合精度");
+    m_chkAdaptive->setChecked(adaptiveCount > 0);
+    m_spinAdaptiveCount = new QSpinBox(this);
+    m_spinAdaptiveCount->setRange(20, 500);
+    m_spinAdaptiveCount->setSuffix(" 点");
+    m_spinAdaptiveCount->setValue(adaptiveCount > 0 ? adaptiveCount : AdaptiveSamplingOptions().targetCount);
+    adaptiveLayout->addWidget(m_chkAdaptive);
+    adaptiveLayout->addWidget(m_spinAdaptiveCount);
+    adaptiveLayout->addStretch();
+    mainLayout->addLayout(adaptiveLayout);
+
+    m_chkDensityWeight = new QCheckBox("按抽样密度加权残差 (各区间点数不同时，避免点密集的时间段主导拟合)", this);
+    m_chkDensityWeight->setToolTip("每个抽样点的残差按其所代表的对数时间宽度加权，对数均匀抽样时各点权重均为 1");
+    m_chkDensityWeight->setChecked(densityWeighting);
+    mainLayout->addWidget(m_chkDensityWeight);
+
+    auto updateSamplingOptions = [this]() {
+        bool custom = m_chkEnable->isChecked();
+        m_chkAdaptive->setEnabled(!custom);
+        m_spinAdaptiveCount->setEnabled(!custom && m_chkAdaptive->isChecked());
+        m_chkDensityWeight->setEnabled(custom || m_chkAdaptive->isChecked());
+    };
+    connect(m_chkEnable, &QCheckBox::toggled, this, updateSamplingOptions);
+    connect(m_chkAdaptive, &QCheckBox::toggled, this, updateSamplingOptions);
+    updateSamplingOptions();
+
     // 3. 设置表格
     m_table = new QTableWidget(this);
     m_table->setColumnCount(3);
@@ -157,6 +209,21 @@ bool SamplingSettingsDialog::isCustomSamplingEnabled() const {
     return m_chkEnable->isChecked();
 }
 
+/**
+ * @brief 获取是否按抽样密度加权残差
+ */
+bool SamplingSettingsDialog::isDensityWeightingEnabled() const {
+    return m_chkDensityWeight->isChecked();
+}
+
+/**
+ * @brief 获取自适应抽样目标点数
+ * @return 未勾选自适应抽样时返回 0
+ */
+int SamplingSettingsDialog::adaptiveSampleCount() const {
+    return m_chkAdaptive->isChecked() ? m_spinAdaptiveCount->value() : 0;
+}
+
 /**
  * @brief 向表格中添加一行数据
  * @param start 区间起始时间
@@ -266,7 +333,19 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
     m_isFitting(false),
-    m_isCustomSamplingEnabled(false) // 初始化时不启用自定义抽样
+    m_isCustomSamplingEnabled(false), // 初始化时不启用自定义抽样
+    m_hasFitSummary(false),
+    m_hasPendingCurve(false),
+    m_curveGeneration(0),
+    m_curveJobGeneration(-1),
+    m_btnUncertainty(nullptr),
+    m_hasUncertainty(false),
+    m_btnMcmc(nullptr),
+    m_hasMcmc(false),
+    m_btnLandscape(nullptr),
+    m_btnFractureTable(nullptr),
+    m_comboStepStrategy(nullptr),
+    m_chkBoundTransform(nullptr)
 {
     ui->setupUi(this);
 
@@ -299,7 +378,36 @@ FittingWidget::FittingWidget(QWidget *parent) :
     // 连接拟合进度信号
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
-    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_watcher, &QFutureWatcher<FittingResult>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_curveWatcher, &QFutureWatcher<ModelCurveCache>::finished, this, &FittingWidget::onBackgroundCurveFinished);
+
+    // [新增] 参数不确定性分析按钮，放在“停止”之后
+    m_btnUncertainty = new QPushButton("不确定性分析", this);
+    m_btnUncertainty->setToolTip("以当前参数为中心重复拟合合成数据，统计参数 P10/P50/P90 与相关性");
+    m_btnUncertainty->setStyleSheet("padding: 6px;");
+    ui->horizontalLayout_Actions->addWidget(m_btnUncertainty);
+    connect(m_btnUncertainty, &QPushButton::clicked, this, &FittingWidget::onUncertaintyClicked);
+    connect(&m_uncertaintyWatcher, &QFutureWatcher<UncertaintyResult>::finished, this, &FittingWidget::onUncertaintyFinished);
+
+    // [新增] MCMC 后验采样按钮
+    m_btnMcmc = new QPushButton("MCMC采样", this);
+    m_btnMcmc->setToolTip("以参数上下限为先验，对拟合参数做并行集合 MCMC 采样，给出后验分布与角图");
+    m_btnMcmc->setStyleSheet("padding: 6px;");
+    ui->horizontalLayout_Actions->addWidget(m_btnMcmc);
+    connect(m_btnMcmc, &QPushButton::clicked, this, &FittingWidget::onMcmcClicked);
+    connect(&m_mcmcWatcher, &QFutureWatcher<McmcResult>::finished, this, &FittingWidget::onMcmcFinished);
+
+    // [新增] 目标函数地形按钮，放在参数工具栏
+    m_btnLandscape = new QPushButton("目标函数地形", this);
+    m_btnLandscape->setToolTip("在两个参数构成的网格上计算拟合误差热力图，查看参数相关性与多解");
+    ui->horizontalLayout_ParamTools->addWidget(m_btnLandscape);
+    connect(m_btnLandscape, &QPushButton::clicked, this, &FittingWidget::onLandscapeClicked);
+
+    // [新增] 裂缝表按钮
+    m_btnFractureTable = new QPushButton("裂缝表", this);
+    m_btnFractureTable->setToolTip("逐条设置裂缝位置与半长 (非均匀分段压裂)；不设置时为 nf 条等长均匀裂缝");
+    ui->horizontalLayout_ParamTools->addWidget(m_btnFractureTable);
+    connect(m_btnFractureTable, &QPushButton::clicked, this, &FittingWidget::onFractureTableClicked);
 
     // 权重滑块
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
@@ -307,6 +415,26 @@ FittingWidget::FittingWidget(QWidget *parent) :
     // [关键] 连接抽样设置按钮，槽函数名已避免自动连接
     connect(ui->btnSamplingSettings, &QPushButton::clicked, this, &FittingWidget::onOpenSamplingSettings);
 
+    // [新增] 迭代算法选择，放在抽样设置按钮下方
+    QHBoxLayout* strategyLayout = new QHBoxLayout();
+    m_comboStepStrategy = new QComboBox(this);
+    for (int s : {FittingCore::Step_LevenbergMarquardt, FittingCore::Step_Dogleg, FittingCore::Step_GeodesicLM})
+        m_comboStepStrategy->addItem(FittingCore::stepStrategyName(s), s);
+    m_comboStepStrategy->setToolTip("阻尼 LM：拒绝则加大阻尼重试；狗腿信赖域：按信赖域半径组合高斯-牛顿步与最速下降步，拒绝步少；\n"
+                                    "测地加速 LM：每步多算一条曲线修正步长，适合参数强相关的狭长谷底");
+    m_chkBoundTransform = new QCheckBox("上下限变换", this);
+    m_chkBoundTransform->setToolTip("以 log/logit 变换处理参数上下限，代替更新后截断，避免参数停滞在边界上");
+    strategyLayout->addWidget(new QLabel("迭代算法:", this));
+    strategyLayout->addWidget(m_comboStepStrategy, 1);
+    strategyLayout->addWidget(m_chkBoundTransform);
+    ui->verticalLayout_Left->insertLayout(ui->verticalLayout_Left->indexOf(ui->btnSamplingSettings) + 1, strategyLayout);
+    connect(m_comboStepStrategy, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_stepStrategy = m_comboStepStrategy->currentData().toInt();
+    });
+    connect(m_chkBoundTransform, &QCheckBox::toggled, this, [this](bool checked) {
+        m_boundHandling = checked ? FittingCore::Bound_Transform : FittingCore::Bound_Clamp;
+    });
+
     // 初始化权重显示
     ui->sliderWeight->setRange(0, 100);
     ui->sliderWeight->setValue(50);
@@ -318,6 +446,15 @@ FittingWidget::FittingWidget(QWidget *parent) :
  */
 FittingWidget::~FittingWidget()
 {
+    // 拟合、后台曲线、不确定性分析与 MCMC 的任务或其结果引用本对象，须等待其结束
+    m_stopRequested = true;
+    m_uncertaintyCancel = true;
+    m_mcmcCancel = true;
+    m_curveWatcher.cancel();
+    m_watcher.waitForFinished();
+    m_curveWatcher.waitForFinished();
+    m_uncertaintyWatcher.waitForFinished();
+    m_mcmcWatcher.waitForFinished();
     delete ui;
 }
 
@@ -559,9 +696,15 @@ void FittingWidget::on_btnSelectParams_clicked()
 {
     m_paramChart->updateParamsFromTable();
     QList<FitParameter> currentParams = m_paramChart->getParameters();
+    // 裂缝表参数由裂缝表对话框维护，不在此列出
+    QList<FitParameter> fractureTable;
+    for(int i = currentParams.size() - 1; i >= 0; --i) {
+        if(ModelSolver01_06::isFractureTableKey(currentParams[i].name)) fractureTable.prepend(currentParams.takeAt(i));
+    }
     ParamSelectDialog dlg(currentParams, this);
     if(dlg.exec() == QDialog::Accepted) {
         QList<FitParameter> updatedParams = dlg.getUpdatedParams();
+        updatedParams.append(fractureTable);
         // LfD 始终不作为独立拟合参数
         for(auto& p : updatedParams) {
             if(p.name == "LfD") p.isFit = false;
@@ -586,10 +729,13 @@ void FittingWidget::onOpenSamplingSettings()
     double tMin = m_obsTime.first();
     double tMax = m_obsTime.last();
 
-    SamplingSettingsDialog dlg(m_customIntervals, m_isCustomSamplingEnabled, tMin, tMax, this);
+    SamplingSettingsDialog dlg(m_customIntervals, m_isCustomSamplingEnabled, m_densityWeighting, m_adaptiveSampleCount,
+                               tMin, tMax, this);
     if (dlg.exec() == QDialog::Accepted) {
         m_customIntervals = dlg.getIntervals();
         m_isCustomSamplingEnabled = dlg.isCustomSamplingEnabled();
+        m_densityWeighting = dlg.isDensityWeightingEnabled();
+        m_adaptiveSampleCount = dlg.adaptiveSampleCount();
 
         // 设置变更后，更新显示
         updateModelCurve();
@@ -601,125 +747,24 @@ void FittingWidget::onOpenSamplingSettings()
  * * 核心函数：根据配置（默认/自定义）从原始大数据中抽取关键点。
  * * 默认策略：数据量>200时，在对数空间均匀抽取200个点。
  * * 自定义策略：在用户指定的每个区间内抽取指定数量的点。
+ * * 自适应策略：未启用自定义抽样且设置了目标点数时，按信息密度选点 (AdaptiveSampler)。
  * * @param srcT/srcP/srcD 源数据
  * @param outT/outP/outD 输出的抽样数据
  */
 void FittingWidget::getLogSampledData(const QVector<double>& srcT, const QVector<double>& srcP, const QVector<double>& srcD,
                                       QVector<double>& outT, QVector<double>& outP, QVector<double>& outD)
 {
-    outT.clear(); outP.clear(); outD.clear();
-    if (srcT.isEmpty()) return;
-
-    // 辅助结构体用于排序去重
-    struct DataPoint {
-        double t, p, d;
-        bool operator<(const DataPoint& other) const { return t < other.t; }
-        bool operator==(const DataPoint& other) const { return std::abs(t - other.t) < 1e-9; }
-    };
-    QVector<DataPoint> points;
-
-    // 模式1：默认策略
-    if (!m_isCustomSamplingEnabled) {
-        int targetCount = 200;
-        // 如果数据量很少，直接全量使用
-        if (srcT.size() <= targetCount) {
-            outT = srcT; outP = srcP; outD = srcD;
-            return;
-        }
-
-        // 对数空间均匀抽样
-        double tMin = srcT.first() <= 1e-10 ? 1e-4 : srcT.first();
-        double tMax = srcT.last();
-        double logMin = log10(tMin);
-        double logMax = log10(tMax);
-        double step = (logMax - logMin) / (targetCount - 1);
-
-        int currentIndex = 0;
-        for (int i = 0; i < targetCount; ++i) {
-            double targetT = pow(10, logMin + i * step);
-
-            // 查找最近点
-            double minDiff = 1e30;
-            int bestIdx = currentIndex;
-            while (currentIndex < srcT.size()) {
-                double diff = std::abs(srcT[currentIndex] - targetT);
-                if (diff < minDiff) { minDiff = diff; bestIdx = currentIndex; }
-                else break;
-                currentIndex++;
-            }
-            currentIndex = bestIdx;
-
-            points.append({srcT[bestIdx],
-                           (bestIdx<srcP.size()?srcP[bestIdx]:0.0),
-                           (bestIdx<srcD.size()?srcD[bestIdx]:0.0)});
-        }
-    }
-    // 模式2：自定义区间策略
-    else {
-        if (m_customIntervals.isEmpty()) {
-            outT = srcT; outP = srcP; outD = srcD;
-            return;
-        }
-
-        for (const auto& interval : m_customIntervals) {
-            double tStart = interval.tStart;
-            double tEnd = interval.tEnd;
-            int count = interval.count;
-
-            if (count <= 0) continue;
-
-            // 定位区间索引范围
-            auto itStart = std::lower_bound(srcT.begin(), srcT.end(), tStart);
-            auto itEnd = std::upper_bound(srcT.begin(), srcT.end(), tEnd);
-
-            int idxStart = std::distance(srcT.begin(), itStart);
-            int idxEnd = std::distance(srcT.begin(), itEnd);
-
-            if (idxStart >= srcT.size() || idxStart >= idxEnd) continue;
-
-            // 区间内对数抽样
-            double subMin = srcT[idxStart];
-            double subMax = srcT[idxEnd - 1];
-            if (subMin <= 1e-10) subMin = 1e-4;
-
-            double logMin = log10(subMin);
-            double logMax = log10(subMax);
-            double step = (count > 1) ? (logMax - logMin) / (count - 1) : 0;
-
-            int subCurrentIdx = idxStart;
-            for (int i = 0; i < count; ++i) {
-                double targetT = (count == 1) ? subMin : pow(10, logMin + i * step);
-
-                double minDiff = 1e30;
-                int bestIdx = subCurrentIdx;
-
-                while (subCurrentIdx < idxEnd) {
-                    double diff = std::abs(srcT[subCurrentIdx] - targetT);
-                    if (diff < minDiff) { minDiff = diff; bestIdx = subCurrentIdx; }
-                    else break;
-                    subCurrentIdx++;
-                }
-                subCurrentIdx = bestIdx;
-
-                if (bestIdx < srcT.size()) {
-                    points.append({srcT[bestIdx],
-                                   (bestIdx<srcP.size()?srcP[bestIdx]:0.0),
-                                   (bestIdx<srcD.size()?srcD[bestIdx]:0.0)});
-                }
-            }
-        }
-    }
-
-    // 整理：排序并去重
-    std::sort(points.begin(), points.end());
-    auto last = std::unique(points.begin(), points.end());
-    points.erase(last, points.end());
+    FittingCore::getLogSampledData(srcT, srcP, srcD, m_isCustomSamplingEnabled, m_customIntervals, outT, outP, outD,
+                                   m_adaptiveSampleCount);
+}
 
-    for (const auto& p : points) {
-        outT.append(p.t);
-        outP.append(p.p);
-        outD.append(p.d);
-    }
+/**
+ * @brief 抽样点的逐点残差权重
+ * * 仅在自定义分段抽样或自适应抽样且勾选按密度加权时返回按对数时间间距计算的权重，否则为空 (等权)。
+ */
+QVector<double> FittingWidget::samplingPointWeights(const QVector<double>& sampledT) const
+{
+    return FittingCore::samplingPointWeights(sampledT, m_isCustomSamplingEnabled, m_adaptiveSampleCount, m_densityWeighting);
 }
 
 /**
@@ -727,7 +772,7 @@ void FittingWidget::getLogSampledData(const QVector<double>& srcT, const QVector
  * * 检查状态，启动后台拟合线程。
  */
 void FittingWidget::on_btnRunFit_clicked() {
-    if(m_isFitting) return;
+    if(m_isFitting || m_uncertaintyWatcher.isRunning() || m_mcmcWatcher.isRunning()) return;
     if(m_obsTime.isEmpty()) {
         QMessageBox::warning(this,"错误","请先加载观测数据。");
         return;
@@ -736,15 +781,21 @@ void FittingWidget::on_btnRunFit_clicked() {
     m_paramChart->updateParamsFromTable();
     m_isFitting = true;
     m_stopRequested = false;
+    // 拟合期间曲线由迭代结果刷新，作废尚未完成的后台曲线
+    ++m_curveGeneration;
+    m_hasPendingCurve = false;
     ui->btnRunFit->setEnabled(false);
 
     ModelManager::ModelType modelType = m_currentModelType;
     QList<FitParameter> paramsCopy = m_paramChart->getParameters();
     double w = ui->sliderWeight->value() / 100.0;
 
-    // 启动异步任务
-    m_watcher.setFuture(QtConcurrent::run([this, modelType, paramsCopy, w](){
-        runOptimizationTask(modelType, paramsCopy, w);
+    // 启动异步任务 (工作线程只读取复制的设置，拟合结果在 onFitFinished 中写回)
+    const int stepStrategy = m_stepStrategy;
+    const int boundHandling = m_boundHandling;
+    const FitWarmStart warmStart = m_fitWarmStart;
+    m_watcher.setFuture(QtConcurrent::run([this, modelType, paramsCopy, w, stepStrategy, boundHandling, warmStart](){
+        return runOptimizationTask(modelType, paramsCopy, w, stepStrategy, boundHandling, warmStart);
     }));
 }
 
@@ -922,282 +973,71 @@ void FittingWidget::onExportCurveData() {
 /**
  * @brief 运行优化任务 (线程入口)
  */
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+FittingResult FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight,
+                                                 int stepStrategy, int boundHandling, FitWarmStart warmStart) {
+    return runLevenbergMarquardtOptimization(modelType, fitParams, weight, stepStrategy, boundHandling, warmStart);
 }
 
 /**
- * @brief Levenberg-Marquardt 拟合算法核心实现
- * * 实现了非线性最小二乘拟合。
+ * @brief Levenberg-Marquardt 拟合 (线程内执行)
  * * 集成了数据抽样逻辑（getLogSampledData）以提升大数据量下的性能。
- * * 集成了物理参数约束（内区>外区）以确保结果合理性。
+ * * 算法本体由 FittingCore 实现，此处负责精度切换与进度/曲线信号转发。
  */
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
-
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) {
-        if(params[i].isFit && params[i].name != "LfD") fitIndices.append(i);
+FittingResult FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight,
+                                                               int stepStrategy, int boundHandling, const FitWarmStart& warmStart) {
+    bool hasFitParam = false;
+    for(const auto& p : params) {
+        if(p.isFit && p.name != "LfD") { hasFitParam = true; break; }
     }
-    int nParams = fitIndices.size();
-
-    if(nParams == 0) {
-        QMetaObject::invokeMethod(this, "onFitFinished");
-        return;
+    if(!hasFitParam) {
+        return FittingResult();   // 参数为空：onFitFinished 不更新拟合统计
     }
 
+    TraceSpan fitSpan("FittingWidget::runLevenbergMarquardtOptimization", "fit");
+
+    // 拟合使用私有的低精度求解器，不改动 ModelManager 的共享精度 (界面线程的曲线请求不受影响)
+    ModelSolver01_06 fitSolver(modelType);
+    fitSolver.setHighPrecision(false);
+
     // [核心] 使用抽样函数获取拟合用数据点
     QVector<double> fitT, fitP, fitD;
     getLogSampledData(m_obsTime, m_obsDeltaP, m_obsDerivative, fitT, fitP, fitD);
+    QVector<double> fitWeights = samplingPointWeights(fitT);
 
-    double lambda = 0.01;
-    int maxIter = 50;
-    double currentSSE = 1e15;
-
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
-
-    // [约束] 初始参数物理约束修正 (内区 > 外区)
-    if(currentParamMap.contains("kf") && currentParamMap.contains("km")) {
-        if(currentParamMap["kf"] <= currentParamMap["km"]) currentParamMap["kf"] = currentParamMap["km"] * 1.01;
-    }
-    if(currentParamMap.contains("omega1") && currentParamMap.contains("omega2")) {
-        if(currentParamMap["omega1"] <= currentParamMap["omega2"]) currentParamMap["omega1"] = currentParamMap["omega2"] * 1.01;
-    }
-
-    // 关联参数计算
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    // 计算初始残差
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight, fitT, fitP, fitD);
-    currentSSE = calculateSumSquaredError(residuals);
-
-    // 初始迭代显示
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
-
-    // 迭代循环
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break; // 精度满足则退出
-
-        emit sigProgress(iter * 100 / maxIter);
-
-        // 计算雅可比矩阵
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight, fitT, fitP, fitD);
-        int nRes = residuals.size();
-
-        // 计算 Hessian 近似矩阵和梯度向量
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
-
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) {
-                    H[i][j] += J[k][i] * J[k][j];
-                }
-            }
-        }
-        for(int i=0; i<nParams; ++i) {
-            for(int j=i+1; j<nParams; ++j) {
-                H[i][j] = H[j][i];
-            }
-        }
-
-        bool stepAccepted = false;
-        // 阻尼调节循环
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) {
-                H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            }
-
-            QVector<double> negG(nParams);
-            for(int i=0;i<nParams;++i) negG[i] = -g[i];
-
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-            QMap<QString, double> trialMap = currentParamMap;
-
-            // 更新参数
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-
-                if(isLog) newVal = pow(10.0, log10(oldVal) + delta[i]);
-                else newVal = oldVal + delta[i];
-
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
-
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9)
-                trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            // [约束] 试探步的物理约束修正
-            if(trialMap.contains("kf") && trialMap.contains("km")) {
-                if(trialMap["kf"] <= trialMap["km"]) trialMap["kf"] = trialMap["km"] * 1.01;
-            }
-            if(trialMap.contains("omega1") && trialMap.contains("omega2")) {
-                if(trialMap["omega1"] <= trialMap["omega2"]) trialMap["omega1"] = trialMap["omega2"] * 1.01;
-            }
-
-            // 评估新位置
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight, fitT, fitP, fitD);
-            double newSSE = calculateSumSquaredError(newRes);
-
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE;
-                currentParamMap = trialMap;
-                residuals = newRes;
-                lambda /= 10.0;
-                stepAccepted = true;
-
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else {
-                lambda *= 10.0;
-            }
-        }
-        if(!stepAccepted && lambda > 1e10) break;
-    }
-
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-
-    QMetaObject::invokeMethod(this, "onFitFinished");
-}
-
-/**
- * @brief 计算残差向量
- * * 计算理论值与抽样观测值在对数空间的差异。
- * * 考虑了压差和导数的权重。
- */
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight,
-                                                  const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD) {
-    if(!m_modelManager || t.isEmpty()) return QVector<double>();
-
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, t);
-    const QVector<double>& pCal = std::get<1>(res);
-    const QVector<double>& dpCal = std::get<2>(res);
-
-    QVector<double> r;
-    double wp = weight;
-    double wd = 1.0 - weight;
-
-    int count = qMin((int)obsP.size(), (int)pCal.size());
-    for(int i=0; i<count; ++i) {
-        if(obsP[i] > 1e-10 && pCal[i] > 1e-10)
-            r.append( (log(obsP[i]) - log(pCal[i])) * wp );
-        else
-            r.append(0.0);
-    }
-
-    int dCount = qMin((int)obsD.size(), (int)dpCal.size());
-    dCount = qMin(dCount, count);
-    for(int i=0; i<dCount; ++i) {
-        if(obsD[i] > 1e-10 && dpCal[i] > 1e-10)
-            r.append( (log(obsD[i]) - log(dpCal[i])) * wd );
-        else
-            r.append(0.0);
-    }
-    return r;
-}
-
-/**
- * @brief 计算雅可比矩阵
- * * 使用有限差分法计算每个拟合参数对残差的偏导数。
- */
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals,
-                                                        const QVector<int>& fitIndices, ModelManager::ModelType modelType,
-                                                        const QList<FitParameter>& currentFitParams, double weight,
-                                                        const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD) {
-    int nRes = baseResiduals.size();
-    int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
-
-    for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j];
-        QString pName = currentFitParams[idx].name;
-        double val = params.value(pName);
-        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-
-        double h;
-        QMap<QString, double> pPlus = params;
-        QMap<QString, double> pMinus = params;
-
-        if(isLog) {
-            h = 0.01;
-            double valLog = log10(val);
-            pPlus[pName] = pow(10.0, valLog + h);
-            pMinus[pName] = pow(10.0, valLog - h);
-        } else {
-            h = 1e-4;
-            pPlus[pName] = val + h;
-            pMinus[pName] = val - h;
-        }
-
-        auto updateDeps = [](QMap<QString,double>& map) {
-            if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9)
-                map["LfD"] = map["Lf"] / map["L"];
-        };
-
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
-
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight, t, obsP, obsD);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight, t, obsP, obsD);
-
-        if(rPlus.size() == nRes && rMinus.size() == nRes) {
-            for(int i=0; i<nRes; ++i) {
-                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
-            }
-        }
-    }
-    return J;
-}
-
-/**
- * @brief 求解线性方程组
- * * 使用 Eigen 库求解 (H + lambda*I) * delta = -g。
- */
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size();
-    if (n == 0) return QVector<double>();
-
-    Eigen::MatrixXd matA(n, n);
-    Eigen::VectorXd vecB(n);
+    FittingCore core([&fitSolver](ModelManager::ModelType, const QMap<QString, double>& p, const QVector<double>& t) {
+        return fitSolver.calculateTheoreticalCurve(p, t);
+    });
+    core.setPointWeights(fitWeights);
+    core.setStepStrategy(static_cast<FittingCore::StepStrategy>(stepStrategy));
+    core.setBoundHandling(static_cast<FittingCore::BoundHandling>(boundHandling));
+    core.setWarmStart(warmStart);   // 上次拟合结束时的状态，输入不兼容时 FittingCore 自动冷启动
+    core.setBatchEvaluator([&fitSolver](ModelManager::ModelType, const QVector<QMap<QString, double>>& sets, const QVector<double>& t) {
+        return fitSolver.calculateTheoreticalCurves(sets, t);
+    });
+    core.setStopChecker([this]() { return m_stopRequested; });
+    core.setProgressCallback([this](int percent) { emit sigProgress(percent); });
+    core.setIterationCallback([this, &fitSolver](double mse, const QMap<QString, double>& p) {
+        ModelCurveData curve = fitSolver.calculateTheoreticalCurve(p);
+        emit sigIterationUpdated(mse, p, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    });
 
-    for (int i = 0; i < n; ++i) {
-        vecB(i) = b[i];
-        for (int j = 0; j < n; ++j) {
-            matA(i, j) = A[i][j];
-        }
+    FittingResult result = core.runLevenbergMarquardt(modelType, params, weight, fitT, fitP, fitD);
+
+    // 拟合回放日志 (输入为本次实际使用的抽样数据，拟合期间求解器为低精度)
+    if (FitReplayLog::isEnabled()) {
+        QString source = QFileInfo(ModelParameter::instance()->getProjectFilePath()).fileName();
+        FitReplayRecord record = FitReplayLog::makeRecord(modelType, params, weight, false, fitT, fitP, fitD, result, source);
+        record.pointWeights = fitWeights;
+        if (result.warmStarted) record.warmStart = warmStart;
+        QString error;
+        if (FitReplayLog::writeToDirectory(record, &error).isEmpty())
+            qDebug() << "拟合回放日志写入失败:" << error;
     }
 
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-
-    QVector<double> res(n);
-    for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
-}
+    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, result.params);
+    emit sigIterationUpdated(result.mse, result.params, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
 
-/**
- * @brief 计算均方误差和 (SSE)
- */
-double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
-    double sse = 0.0;
-    for(double v : residuals) sse += v*v;
-    return sse;
+    return result;
 }
 
 /**
@@ -1218,23 +1058,15 @@ QVector<double> FittingWidget::parseSensitivityValues(const QString& text) {
 }
 
 /**
- * @brief 更新模型曲线
- * * 根据当前参数计算理论曲线并更新绘图。
- * * 包含物理参数约束逻辑。
- * * 使用抽样数据计算误差以提升性能。
- * * 支持敏感性分析模式（多条曲线绘制）。
- * @param explicitParams 可选的高精度参数字典。
+ * @brief 构造理论曲线输入
+ * * 汇总参数 (含物理参数约束) 与绘图时间网格，供同步绘制、缓存校验与后台计算共用。
  */
-void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams) {
-    if(!m_modelManager) {
-        QMessageBox::critical(this, "错误", "ModelManager 未初始化！");
-        return;
-    }
-    ui->tableParams->clearFocus();
-
+ModelCurveRequest FittingWidget::buildCurveRequest(const QMap<QString, double>* explicitParams,
+                                                   QString& sensitivityKey, QVector<double>& sensitivityValues)
+{
     QMap<QString, double> baseParams;
-    QString sensitivityKey = "";
-    QVector<double> sensitivityValues;
+    sensitivityKey.clear();
+    sensitivityValues.clear();
 
     if (explicitParams) {
         baseParams = *explicitParams;
@@ -1270,20 +1102,61 @@ void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams
         if(baseParams["omega1"] <= baseParams["omega2"]) baseParams["omega1"] = baseParams["omega2"] * 1.01;
     }
 
-    ModelManager::ModelType type = m_currentModelType;
+    ModelCurveRequest request;
+    request.type = m_currentModelType;
+    request.params = baseParams;
+    request.highPrecision = true;   // 显示与缓存曲线固定为高精度，与拟合期间的求解精度无关
 
-    // 生成绘图用的时间序列 (对数均匀)
-    QVector<double> targetT;
+    // 生成绘图用的时间序列 (对数等比；开启共享网格设置时相邻倍频程共享反演节点)
     if (m_obsTime.size() > 300) {
         double tMin = m_obsTime.first() > 1e-5 ? m_obsTime.first() : 1e-5;
         double tMax = m_obsTime.last();
-        targetT = ModelManager::generateLogTimeSteps(300, log10(tMin), log10(tMax));
+        request.time = ModelManager::generateCurveTimeSteps(300, log10(tMin), log10(tMax));
     } else if (!m_obsTime.isEmpty()) {
-        targetT = m_obsTime;
+        request.time = m_obsTime;
     } else {
-        for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e));
+        for(double e = -4; e <= 4; e += 0.1) request.time.append(pow(10, e));
     }
 
+    // 误差计算输入 (与拟合时的抽样设置一致)
+    request.obsT = m_obsTime;
+    request.obsP = m_obsDeltaP;
+    request.obsD = m_obsDerivative;
+    request.weight = ui->sliderWeight->value() / 100.0;
+    request.customSampling = m_isCustomSamplingEnabled;
+    request.intervals = m_customIntervals;
+    request.adaptiveSampleCount = m_adaptiveSampleCount;
+    request.densityWeighting = m_densityWeighting;
+    return request;
+}
+
+/**
+ * @brief 更新模型曲线
+ * * 根据当前参数计算理论曲线并更新绘图。
+ * * 包含物理参数约束逻辑。
+ * * 使用抽样数据计算误差以提升性能。
+ * * 支持敏感性分析模式（多条曲线绘制）。
+ * * 输入与当前缓存一致时不重复计算。
+ * @param explicitParams 可选的高精度参数字典。
+ */
+void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams) {
+    if(!m_modelManager) {
+        QMessageBox::critical(this, "错误", "ModelManager 未初始化！");
+        return;
+    }
+    ui->tableParams->clearFocus();
+
+    QString sensitivityKey;
+    QVector<double> sensitivityValues;
+    ModelCurveRequest request = buildCurveRequest(explicitParams, sensitivityKey, sensitivityValues);
+    const QMap<QString, double>& baseParams = request.params;
+    const QVector<double>& targetT = request.time;
+    ModelManager::ModelType type = request.type;
+
+    // 曲线在此同步确定，作废尚未完成的后台计算
+    ++m_curveGeneration;
+    m_hasPendingCurve = false;
+
     bool isSensitivityMode = !sensitivityKey.isEmpty();
     ui->btnRunFit->setEnabled(!isSensitivityMode);
     if(isSensitivityMode) {
@@ -1297,8 +1170,9 @@ void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams
     QList<QColor> colors = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan, Qt::darkRed, Qt::darkBlue };
 
     if (isSensitivityMode) {
-        for(int i = 0; i < sensitivityValues.size(); ++i) {
-            double val = sensitivityValues[i];
+        // 全部取值一次批量计算 (只改变井储/表皮等参数时共用储层解)
+        QVector<QMap<QString, double>> paramSets;
+        for(double val : sensitivityValues) {
             QMap<QString, double> currentParams = baseParams;
             currentParams[sensitivityKey] = val;
 
@@ -1308,8 +1182,13 @@ void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams
             if(currentParams.contains("kf") && currentParams.contains("km")) {
                 if(currentParams["kf"] <= currentParams["km"]) currentParams["kf"] = currentParams["km"] * 1.01;
             }
+            paramSets.append(currentParams);
+        }
+        QVector<ModelCurveData> curves = m_modelManager->calculateTheoreticalCurves(type, paramSets, targetT);
 
-            ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
+        for(int i = 0; i < sensitivityValues.size(); ++i) {
+            double val = sensitivityValues[i];
+            const ModelCurveData& res = curves[i];
 
             QColor c = colors[i % colors.size()];
             QString legendSuffix = QString("%1=%2").arg(sensitivityKey).arg(val);
@@ -1326,33 +1205,91 @@ void FittingWidget::updateModelCurve(const QMap<QString, double>* explicitParams
         }
         m_plot->replot();
     } else {
-        ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, baseParams, targetT);
-        plotCurves(std::get<0>(res), std::get<1>(res), std::get<2>(res), true);
-
-        int count = m_plot->graphCount();
-        if(count >= 4) {
-            m_plot->graph(2)->setName("理论压差");
-            m_plot->graph(2)->setPen(QPen(Qt::red, 2));
-            m_plot->graph(3)->setName("理论导数");
-            m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
+        // [关键] 误差使用统一抽样函数计算（确保界面显示的误差与拟合时的一致），见 ModelCurveCache::compute
+        if (m_curveCache.key != request.cacheKey()) {
+            ModelSolver01_06 solver(request.type);
+            solver.setHighPrecision(request.highPrecision);
+            m_curveCache = ModelCurveCache::compute(request, [&solver](ModelManager::ModelType, const QMap<QString, double>& params, const QVector<double>& t) {
+                return solver.calculateTheoreticalCurve(params, t);
+            });
         }
+        applyModelCurve(m_curveCache);
+    }
+}
+
+/**
+ * @brief 绘制理论曲线
+ * * 替换图层 2/3 的理论压差与导数，更新误差显示，启用自定义抽样时绘制抽样点。
+ */
+void FittingWidget::applyModelCurve(const ModelCurveCache& curve) {
+    for (int i = m_plot->graphCount() - 1; i >= 2; --i) {
+        m_plot->removeGraph(i);
+    }
+    plotCurves(curve.t, curve.p, curve.d, true);
+
+    int count = m_plot->graphCount();
+    if(count >= 4) {
+        m_plot->graph(2)->setName("理论压差");
+        m_plot->graph(2)->setPen(QPen(Qt::red, 2));
+        m_plot->graph(3)->setName("理论导数");
+        m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
+    }
 
-        if (!m_obsTime.isEmpty()) {
-            // [关键] 使用统一抽样函数计算误差（确保界面显示的误差与拟合时的一致）
+    if (!m_obsTime.isEmpty()) {
+        if (curve.mse >= 0) {
+            ui->label_Error->setText(QString("误差(MSE): %1").arg(curve.mse, 0, 'e', 3));
+        }
+        // [修改] 仅当启用了自定义或自适应抽样时才绘制抽样点
+        if (m_isCustomSamplingEnabled || m_adaptiveSampleCount > 0) {
             QVector<double> sampleT, sampleP, sampleD;
             getLogSampledData(m_obsTime, m_obsDeltaP, m_obsDerivative, sampleT, sampleP, sampleD);
+            plotSampledPoints(sampleT, sampleP, sampleD);
+        }
+    }
+    m_plot->replot();
+}
 
-            QVector<double> residuals = calculateResiduals(baseParams, type, ui->sliderWeight->value()/100.0, sampleT, sampleP, sampleD);
-            double sse = calculateSumSquaredError(residuals);
-            ui->label_Error->setText(QString("误差(MSE): %1").arg(sse/residuals.size(), 0, 'e', 3));
+/**
+ * @brief 启动后台理论曲线计算
+ * * 使用独立的求解器实例，计算期间界面可正常操作；同一时刻只运行一个任务。
+ */
+void FittingWidget::startPendingCurve() {
+    if (!m_hasPendingCurve || m_curveWatcher.isRunning()) return;
+    m_hasPendingCurve = false;
+    m_curveJobGeneration = m_curveGeneration;
+
+    ModelCurveRequest request = m_pendingCurveRequest;
+    m_curveWatcher.setFuture(QtConcurrent::run([request]() {
+        TraceSpan span("FittingWidget::backgroundModelCurve", "fit");
+        ModelSolver01_06 solver(request.type);
+        solver.setHighPrecision(request.highPrecision);
+        FittingCore::ModelEvaluator evaluator = [&solver](ModelManager::ModelType, const QMap<QString, double>& params, const QVector<double>& t) {
+            return solver.calculateTheoreticalCurve(params, t);
+        };
+        return ModelCurveCache::compute(request, evaluator);
+    }));
+}
 
-            // [修改] 仅当启用了自定义抽样时才绘制抽样点
-            if (m_isCustomSamplingEnabled) {
-                plotSampledPoints(sampleT, sampleP, sampleD);
-            }
-        }
-        m_plot->replot();
+/**
+ * @brief 后台理论曲线计算完成
+ * * 期间曲线已被重新确定 (参数修改、开始拟合) 时丢弃结果。
+ */
+void FittingWidget::onBackgroundCurveFinished() {
+    ModelCurveCache curve = m_curveWatcher.result();
+    if (m_curveJobGeneration == m_curveGeneration && curve.isValid()) {
+        m_curveCache = curve;
+        applyModelCurve(curve);
     }
+    startPendingCurve();
+}
+
+/**
+ * @brief 显示事件
+ * * 加载的分析页签在首次显示时才计算缺失的理论曲线。
+ */
+void FittingWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    startPendingCurve();
 }
 
 /**
@@ -1383,8 +1320,8 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
     m_plot->graph(3)->setName("理论导数");
     m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
 
-    // [修改] 仅当启用了自定义抽样时才绘制抽样点
-    if (!m_obsTime.isEmpty() && m_isCustomSamplingEnabled) {
+    // [修改] 仅当启用了自定义或自适应抽样时才绘制抽样点
+    if (!m_obsTime.isEmpty() && (m_isCustomSamplingEnabled || m_adaptiveSampleCount > 0)) {
         QVector<double> st, sp, sd;
         getLogSampledData(m_obsTime, m_obsDeltaP, m_obsDerivative, st, sp, sd);
         plotSampledPoints(st, sp, sd);
@@ -1397,11 +1334,252 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
  * @brief 拟合完成槽函数
  */
 void FittingWidget::onFitFinished() {
+    // 记录本次拟合的统计信息与优化器状态 (只在界面线程写入)
+    const FittingResult result = m_watcher.result();
+    if (!result.params.isEmpty()) {
+        m_lastFitResult = result;
+        m_lastFitPerf = result.perf;
+        m_hasFitSummary = true;
+        if (result.finalState.isValid()) m_fitWarmStart = result.finalState;
+    }
+
+    // 按参数表中的值重新生成曲线缓存，使保存后重新打开时缓存命中
+    if (m_isFitting) {
+        QString sensitivityKey;
+        QVector<double> sensitivityValues;
+        ModelCurveRequest request = buildCurveRequest(nullptr, sensitivityKey, sensitivityValues);
+        ++m_curveGeneration;
+        if (sensitivityKey.isEmpty()) {
+            m_pendingCurveRequest = request;
+            m_hasPendingCurve = true;
+            startPendingCurve();
+        }
+    }
     m_isFitting = false;
     ui->btnRunFit->setEnabled(true);
     QMessageBox::information(this, "完成", "拟合完成。");
 }
 
+/**
+ * @brief 参数不确定性分析按钮槽函数
+ * * 运行中点击则取消；否则以参数表当前值 (通常为拟合结果) 与拟合抽样数据为输入，后台并行执行。
+ */
+void FittingWidget::onUncertaintyClicked() {
+    if (m_uncertaintyWatcher.isRunning()) {
+        m_uncertaintyCancel = true;
+        m_btnUncertainty->setEnabled(false);
+        return;
+    }
+    if (m_isFitting || m_mcmcWatcher.isRunning()) return;
+    if (m_obsTime.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先加载观测数据。");
+        return;
+    }
+
+    UncertaintyInput input = buildPosteriorInput();
+    int fitCount = 0;
+    for (const FitParameter& p : input.params) {
+        if (p.isFit && p.name != "LfD") ++fitCount;
+    }
+    if (fitCount == 0) {
+        QMessageBox::warning(this, "错误", "请至少选择一个拟合参数。");
+        return;
+    }
+
+    UncertaintySettingsDialog dlg(m_uncertaintyOptions, fitCount, input.fitT.size(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+    m_uncertaintyOptions = dlg.options();
+
+    m_uncertaintyCancel = false;
+    m_btnUncertainty->setText("取消分析");
+    ui->btnRunFit->setEnabled(false);
+    ui->progressBar->setValue(0);
+
+    UncertaintyOptions options = m_uncertaintyOptions;
+    m_uncertaintyWatcher.setFuture(QtConcurrent::run([this, input, options]() {
+        return ParameterUncertainty::run(input, options, &m_uncertaintyCancel, [this](int done, int total) {
+            emit sigProgress(done * 100 / total);
+        });
+    }));
+}
+
+/**
+ * @brief 参数不确定性分析完成槽函数
+ */
+void FittingWidget::onUncertaintyFinished() {
+    m_btnUncertainty->setText("不确定性分析");
+    m_btnUncertainty->setEnabled(true);
+    ui->btnRunFit->setEnabled(true);
+
+    UncertaintyResult result = m_uncertaintyWatcher.result();
+    if (!result.ok) {
+        QMessageBox::warning(this, "不确定性分析", result.message);
+        return;
+    }
+
+    m_lastUncertainty = result;
+    m_hasUncertainty = true;
+    UncertaintyResultDialog dlg(result, this);
+    dlg.exec();
+}
+
+/**
+ * @brief 当前参数表与拟合抽样数据的快照
+ */
+UncertaintyInput FittingWidget::buildPosteriorInput() {
+    m_paramChart->updateParamsFromTable();
+    UncertaintyInput input;
+    input.modelType = m_currentModelType;
+    input.params = m_paramChart->getParameters();
+    input.weight = ui->sliderWeight->value() / 100.0;
+    getLogSampledData(m_obsTime, m_obsDeltaP, m_obsDerivative, input.fitT, input.fitP, input.fitD);
+    input.fitWeights = samplingPointWeights(input.fitT);
+    return input;
+}
+
+/**
+ * @brief MCMC 采样按钮槽函数
+ * * 运行中点击则在当前步结束后停止 (检查点保留，可继续)；
+ * * 否则弹出设置对话框，检查点与当前输入一致时可选择继续采样。
+ */
+void FittingWidget::onMcmcClicked() {
+    if (m_mcmcWatcher.isRunning()) {
+        m_mcmcCancel = true;
+        m_btnMcmc->setEnabled(false);
+        return;
+    }
+    if (m_isFitting || m_uncertaintyWatcher.isRunning()) return;
+    if (m_obsTime.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先加载观测数据。");
+        return;
+    }
+
+    UncertaintyInput input = buildPosteriorInput();
+    int fitCount = 0;
+    for (const FitParameter& p : input.params) {
+        if (p.isFit && p.name != "LfD") ++fitCount;
+    }
+    if (fitCount == 0) {
+        QMessageBox::warning(this, "错误", "请至少选择一个拟合参数。");
+        return;
+    }
+
+    bool checkpointUsable = m_mcmcCheckpoint.isValid() && m_mcmcCheckpoint.inputKey == McmcSampler::inputKey(input);
+    McmcSettingsDialog dlg(m_mcmcOptions, fitCount, checkpointUsable ? m_mcmcCheckpoint.step : 0, this);
+    if (dlg.exec() != QDialog::Accepted) return;
+    m_mcmcOptions = dlg.options();
+
+    McmcState resume;
+    if (dlg.resumeFromCheckpoint()) resume = m_mcmcCheckpoint;
+
+    m_mcmcCancel = false;
+    m_btnMcmc->setText("停止采样");
+    ui->btnRunFit->setEnabled(false);
+    m_btnUncertainty->setEnabled(false);
+    ui->progressBar->setValue(0);
+
+    McmcOptions options = m_mcmcOptions;
+    m_mcmcWatcher.setFuture(QtConcurrent::run([this, input, options, resume]() {
+        return McmcSampler::run(input, options, resume.isValid() ? &resume : nullptr, &m_mcmcCancel,
+            [this](int step, int maxSteps, double) {
+                emit sigProgress(step * 100 / maxSteps);
+            },
+            [this](const McmcState& state) {
+                // 检查点交给界面线程保存，随分析状态写入项目
+                QMetaObject::invokeMethod(this, [this, state]() { m_mcmcCheckpoint = state; }, Qt::QueuedConnection);
+            });
+    }));
+}
+
+/**
+ * @brief MCMC 采样完成槽函数
+ */
+void FittingWidget::onMcmcFinished() {
+    m_btnMcmc->setText("MCMC采样");
+    m_btnMcmc->setEnabled(true);
+    m_btnUncertainty->setEnabled(true);
+    ui->btnRunFit->setEnabled(true);
+
+    McmcResult result = m_mcmcWatcher.result();
+    if (result.state.isValid()) m_mcmcCheckpoint = result.state;
+    if (!result.ok) {
+        QMessageBox::warning(this, "MCMC采样", result.message);
+        return;
+    }
+    if (!result.message.isEmpty()) {
+        QMessageBox::information(this, "MCMC采样", result.message);
+    }
+
+    m_lastMcmc = result;
+    m_hasMcmc = true;
+    McmcResultDialog dlg(result, this);
+    dlg.exec();
+}
+
+/**
+ * @brief 目标函数地形按钮槽函数
+ * * 对话框持有打开时的参数表与抽样数据快照，之后修改参数表不影响已打开的地形图。
+ */
+void FittingWidget::onLandscapeClicked() {
+    if (m_obsTime.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先加载观测数据。");
+        return;
+    }
+
+    LandscapeDialog* dlg = new LandscapeDialog(buildPosteriorInput(), this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    connect(dlg, &LandscapeDialog::pointSelected, this, &FittingWidget::onLandscapePointSelected);
+    dlg->show();
+}
+
+/**
+ * @brief 地形图选点：写入参数表并刷新理论曲线
+ */
+void FittingWidget::onLandscapePointSelected(const QString& paramX, double x, const QString& paramY, double y) {
+    if (m_isFitting) return;
+    QMap<QString, double> values;
+    values.insert(paramX, x);
+    values.insert(paramY, y);
+    applyParameterValues(values);
+}
+
+/**
+ * @brief 裂缝表按钮槽函数
+ * * 以参数表当前的 nf、L、Lf 作为“均匀布置”的依据；确定后写入隐藏参数并刷新曲线。
+ */
+void FittingWidget::onFractureTableClicked() {
+    if (m_isFitting) return;
+    m_paramChart->updateParamsFromTable();
+
+    QMap<QString, double> values;
+    for (const FitParameter& p : m_paramChart->getParameters()) values.insert(p.name, p.value);
+    QVector<double> positions, halfLengths;
+    m_paramChart->getFractureTable(positions, halfLengths);
+
+    FractureTableDialog dlg(positions, halfLengths, (int)values.value("nf", 4), values.value("L", 1000.0), values.value("Lf", 100.0), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    m_paramChart->setFractureTable(dlg.positions(), dlg.halfLengths());
+    updateModelCurve(nullptr);
+}
+
+bool FittingWidget::isBusy() const {
+    return m_isFitting || m_uncertaintyWatcher.isRunning() || m_mcmcWatcher.isRunning();
+}
+
+/**
+ * @brief 将参数值写入参数表并刷新理论曲线
+ */
+void FittingWidget::applyParameterValues(const QMap<QString, double>& values) {
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    for (FitParameter& p : params) {
+        if (values.contains(p.name)) p.value = values.value(p.name);
+    }
+    m_paramChart->setParameters(params);
+    updateModelCurve(nullptr);
+}
+
 /**
  * @brief 绘制曲线
  * * 过滤无效点并添加到 QCustomPlot 图层。
@@ -1486,35 +1664,10 @@ void FittingWidget::on_btnExportReport_clicked()
     // ---------------------------------------------------------
     // 1. 获取井名 (解析 .pwt 文件)
     // ---------------------------------------------------------
-    QString wellName = "未命名井";
+    // 与整井报告共用解析逻辑 (失败时回退到项目文件名)
+    QString wellName = FittingReportJob::wellNameFromProject();
     QString projectFilePath = ModelParameter::instance()->getProjectFilePath();
 
-    // 尝试读取 pwt 文件提取 wellName
-    QFile pwtFile(projectFilePath);
-    if (pwtFile.exists() && pwtFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QByteArray data = pwtFile.readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (!doc.isNull() && doc.isObject()) {
-            QJsonObject root = doc.object();
-            // 假设 wellName 在根节点或 basicParams 节点下，这里尝试直接查找
-            if (root.contains("wellName")) {
-                wellName = root["wellName"].toString();
-            } else if (root.contains("basicParams")) {
-                QJsonObject basic = root["basicParams"].toObject();
-                if (basic.contains("wellName")) {
-                    wellName = basic["wellName"].toString();
-                }
-            }
-        }
-        pwtFile.close();
-    }
-
-    // 如果文件读取失败，回退到使用文件名
-    if (wellName == "未命名井" || wellName.isEmpty()) {
-        QFileInfo fi(projectFilePath);
-        wellName = fi.completeBaseName();
-    }
-
     // ---------------------------------------------------------
     // 2. 准备文件路径与参数
     // ---------------------------------------------------------
@@ -1605,40 +1758,15 @@ void FittingWidget::on_btnExportReport_clicked()
     QString imgLogLogBase64 = getPlotImageBase64();
 
     // 恢复抽样点可见性
-    if (m_isCustomSamplingEnabled) {
+    if (m_isCustomSamplingEnabled || m_adaptiveSampleCount > 0) {
         for(int i=4; i<m_plot->graphCount(); ++i) m_plot->graph(i)->setVisible(true);
     }
 
     // ---------------------------------------------------------
     // 5. 构建 Word 兼容 HTML
     // ---------------------------------------------------------
-    QString html = "<html xmlns:o='urn:schemas-microsoft-com:office:office' xmlns:w='urn:schemas-microsoft-com:office:word' xmlns='http://www.w3.org/TR/REC-html40'>";
-    html += "<head><meta charset='utf-8'><title>Report</title>";
-    html += "";
-    html += "<style>";
-
-    // 字体设置：西文 Times New Roman，中文 SimSun (宋体)
-    // 字体大小：5号对应 10.5pt
-    html += "body { font-family: 'Times New Roman', 'SimSun'; font-size: 10.5pt; }";
-
-    html += "h1 { text-align: center; font-size: 16pt; font-weight: bold; margin: 20px 0; font-family: 'SimSun'; }"; // 标题可稍大
-    html += "h2 { font-size: 14pt; font-weight: bold; margin-top: 15px; font-family: 'SimSun'; }";
-
-    // 段落样式：单倍行距或固定行距
-    html += "p { margin: 3px 0; line-height: 1.5; }";
-
-    // 表格样式
-    html += "table { border-collapse: collapse; width: 100%; margin: 5px 0; font-size: 10.5pt; }";
-    html += "th, td { border: 1px solid black; padding: 2px 4px; text-align: center; }";
-    html += "th { background-color: #f2f2f2; font-family: 'SimSun'; }";
-
-    html += ".img-box { text-align: center; margin: 10px 0; }";
-    html += ".img-cap { font-size: 9pt; font-weight: bold; margin-top: 2px; font-family: 'SimSun'; }";
-
-    // [关键] 分页符样式类
-    html += ".page-break { page-break-before: always; }";
-
-    html += "</style></head><body>";
+    // 文档头与样式表 (字体 5号宋体+新罗马、表格、分页符) 与整井报告共用
+    QString html = FittingReportJob::reportHtmlHead();
 
     // --- 标题 ---
     html += QString("<h1>%1试井解释报告</h1>").arg(wellName);
@@ -1737,6 +1865,24 @@ void FittingWidget::on_btnExportReport_clicked()
         html += "<p>无默认参数。</p>";
     }
 
+    // --- 第五部分：拟合性能统计 (仅在本次会话中执行过拟合时输出) ---
+    if (m_hasFitSummary) {
+        html += "<h2>五、拟合性能统计</h2>";
+        html += buildFitPerformanceHtml();
+    }
+
+    // --- 后续部分：参数不确定性与后验采样 (仅在本次会话中执行过分析时输出) ---
+    const QStringList sectionNumbers = {"五", "六", "七"};
+    int nextSection = m_hasFitSummary ? 1 : 0;
+    if (m_hasUncertainty) {
+        html += QString("<h2>%1、参数不确定性分析</h2>").arg(sectionNumbers[nextSection++]);
+        html += UncertaintyResultDialog::toHtml(m_lastUncertainty);
+    }
+    if (m_hasMcmc) {
+        html += QString("<h2>%1、参数后验分布 (MCMC)</h2>").arg(sectionNumbers[nextSection++]);
+        html += McmcResultDialog::toHtml(m_lastMcmc);
+    }
+
     html += "<br/><hr/><p style='text-align:center; font-size:9pt; color:#888;'>报告来自PWT压力试井分析系统</p>";
     html += "</body></html>";
 
@@ -1763,6 +1909,61 @@ void FittingWidget::on_btnExportReport_clicked()
 }
 
 
+/**
+ * @brief 生成拟合性能统计章节
+ * * 包含拟合总览 (迭代次数、模型调用次数、耗时)、逐次迭代明细，
+ * * 以及启用性能计数器时的热点计数与阶段耗时。
+ */
+QString FittingWidget::buildFitPerformanceHtml() const
+{
+    const FittingResult& r = m_lastFitResult;
+    QString html;
+
+    html += "<table><tr><th>迭代次数</th><th>残差点数</th><th>模型曲线计算次数</th><th>最终 MSE</th><th>总耗时 (ms)</th></tr>";
+    html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>")
+                .arg(r.iterations)
+                .arg(r.residualCount)
+                .arg(r.residualEvaluations)
+                .arg(r.mse, 0, 'e', 3)
+                .arg(r.elapsedMs, 0, 'f', 1);
+    html += "</table>";
+
+    html += "<table><tr><th>迭代算法</th><th>上下限处理</th><th>热启动</th><th>雅可比计算次数</th><th>拒绝步数</th><th>截断到上下限次数</th></tr>";
+    html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td></tr>")
+                .arg(FittingCore::stepStrategyName(r.stepStrategy))
+                .arg(FittingCore::boundHandlingName(r.boundHandling))
+                .arg(r.warmStarted ? QString("是 (复用 %1 列雅可比)").arg(r.warmStartColumns) : QString("否"))
+                .arg(r.jacobianEvaluations)
+                .arg(r.rejectedSteps)
+                .arg(r.boundHits);
+    html += "</table>";
+
+    if (!r.iterationStats.isEmpty()) {
+        QString lambdaTitle = (r.stepStrategy == FittingCore::Step_Dogleg) ? "信赖域半径" : "阻尼系数";
+        html += QString("<table><tr><th>迭代</th><th>残差计算</th><th>雅可比计算</th><th>拒绝步数</th><th>%1</th><th>MSE</th><th>耗时 (ms)</th></tr>")
+                    .arg(lambdaTitle);
+        for (const LmIterationStats& s : r.iterationStats) {
+            html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td></tr>")
+                        .arg(s.iteration)
+                        .arg(s.residualEvaluations)
+                        .arg(s.jacobianEvaluations)
+                        .arg(s.rejectedSteps)
+                        .arg(s.lambda, 0, 'g', 3)
+                        .arg(s.mse, 0, 'e', 3)
+                        .arg(s.elapsedMs, 0, 'f', 1);
+        }
+        html += "</table>";
+    }
+
+    if (!m_lastFitPerf.isEmpty()) {
+        html += "<p><b>计算热点计数 (本次拟合)：</b></p>";
+        html += m_lastFitPerf.toHtmlTables();
+    } else {
+        html += "<p style='font-size:9pt; color:#888;'>* 未启用性能计数器，可在“系统设置 - 性能诊断”中开启以获得详细热点统计。</p>";
+    }
+    return html;
+}
+
 /**
  * @brief 获取图表截图 Base64
  */
@@ -1831,6 +2032,10 @@ QJsonObject FittingWidget::getJsonState() const
     root["observedData"] = obsData;
 
     root["useCustomSampling"] = m_isCustomSamplingEnabled;
+    root["densityWeighting"] = m_densityWeighting;
+    root["adaptiveSampleCount"] = m_adaptiveSampleCount;
+    root["fitStepStrategy"] = m_stepStrategy;
+    root["fitBoundTransform"] = (m_boundHandling == FittingCore::Bound_Transform);
     QJsonArray intervalArr;
     for(const auto& item : m_customIntervals) {
         QJsonObject obj;
@@ -1841,6 +2046,16 @@ QJsonObject FittingWidget::getJsonState() const
     }
     root["customIntervals"] = intervalArr;
 
+    if (m_curveCache.isValid()) {
+        root["modelCurveCache"] = m_curveCache.toJson();
+    }
+    if (m_mcmcCheckpoint.isValid()) {
+        root["mcmcCheckpoint"] = m_mcmcCheckpoint.toJson();
+    }
+    if (m_fitWarmStart.isValid()) {
+        root["optimizerState"] = m_fitWarmStart.toJson();
+    }
+
     return root;
 }
 
@@ -1914,6 +2129,11 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
     if (root.contains("useCustomSampling")) {
         m_isCustomSamplingEnabled = root["useCustomSampling"].toBool();
     }
+    m_densityWeighting = root["densityWeighting"].toBool(false);
+    m_adaptiveSampleCount = root["adaptiveSampleCount"].toInt(0);
+    int strategyIndex = m_comboStepStrategy->findData(root["fitStepStrategy"].toInt(FittingCore::Step_LevenbergMarquardt));
+    m_comboStepStrategy->setCurrentIndex(strategyIndex >= 0 ? strategyIndex : 0);
+    m_chkBoundTransform->setChecked(root["fitBoundTransform"].toBool(false));
     if (root.contains("customIntervals")) {
         m_customIntervals.clear();
         QJsonArray arr = root["customIntervals"].toArray();
@@ -1927,7 +2147,36 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         }
     }
 
-    updateModelCurve(&explicitParamsMap);
+    if (root.contains("mcmcCheckpoint")) {
+        m_mcmcCheckpoint = McmcState::fromJson(root["mcmcCheckpoint"].toObject());
+    }
+    m_fitWarmStart = FitWarmStart::fromJson(root["optimizerState"].toObject());
+
+    // 理论曲线：保存的缓存与当前输入一致时直接绘制，否则待页签显示时后台计算
+    if (m_modelManager) {
+        QString sensitivityKey;
+        QVector<double> sensitivityValues;
+        ModelCurveRequest request = buildCurveRequest(&explicitParamsMap, sensitivityKey, sensitivityValues);
+        ModelCurveCache saved = ModelCurveCache::fromJson(root["modelCurveCache"].toObject());
+        ++m_curveGeneration;
+        ui->btnRunFit->setEnabled(true);
+        if (saved.isValid() && saved.key == request.cacheKey()) {
+            m_curveCache = saved;
+            m_hasPendingCurve = false;
+            applyModelCurve(saved);
+        } else {
+            for (int i = m_plot->graphCount() - 1; i >= 2; --i) {
+                m_plot->removeGraph(i);
+            }
+            m_plot->replot();
+            ui->label_Error->setText("理论曲线计算中...");
+            m_pendingCurveRequest = request;
+            m_hasPendingCurve = true;
+            if (isVisible()) startPendingCurve();
+        }
+    } else {
+        updateModelCurve(&explicitParamsMap);
+    }
 
     if (root.contains("plotView")) {
         QJsonObject range = root["plotView"].toObject();
@@ -8,6 +8,20 @@
  * 4. 声明加载/保存状态、算法拟合、敏感性分析绘图等核心功能。
  * 5. 声明基于数据抽样优化的拟合逻辑，支持大数据量下的高效计算。
  * 6. [新增] 声明 plotSampledPoints 函数，用于在图中可视化显示参与拟合的抽样点。
+ * 7. [修改] 拟合算法、残差/雅可比计算与抽样逻辑迁移至 FittingCore (fittingcore.h)，本类仅负责界面交互。
+ * 8. 保存最近一次拟合的迭代统计与性能计数，导出报告时附加“拟合性能统计”章节。
+ * 9. 开启回放日志时，每次拟合结束后写入 .wtfr 日志 (fitreplaylog.h)，供回归测试回放。
+ * 10. [新增] 理论曲线随分析状态保存 (modelcurvecache.h)：加载时输入未变则直接绘制，
+ *     否则在页签首次显示时后台计算，不阻塞项目打开。
+ * 11. [新增] 参数不确定性分析 (fittinguncertainty.h)：后台并行重复拟合，结果附加到拟合报告。
+ * 12. [新增] MCMC 后验采样 (fittingmcmc.h)：后台并行集合采样，检查点随分析状态保存，可继续采样。
+ * 13. [新增] 双参数目标函数地形热力图 (landscapedialog.h)，可将热力图上选定的点应用到参数表。
+ * 14. [新增] 向拟合页面提供参数与抽样数据快照、写回参数值的接口，供多分析联合拟合 (fittingjoint.h) 使用。
+ * 15. [新增] 裂缝表按钮：编辑非均匀裂缝位置与半长 (fracturetabledialog.h)，以隐藏参数随分析状态保存。
+ * 16. [新增] 抽样设置中可选“按抽样密度加权”：自定义分段抽样时各点残差按对数时间间距加权 (fittingresidualkernel.h)。
+ * 17. [新增] 抽样设置中可选“自适应抽样”：未启用分段抽样时按信息密度选点 (fittingsampler.h)，点数随状态保存。
+ * 18. [新增] 迭代算法选择 (阻尼 LM / 狗腿信赖域 / 测地加速 LM) 与上下限 log/logit 变换开关，随状态保存。
+ * 19. [新增] 拟合结束时的优化器状态 (fittingwarmstart.h) 随状态保存，再次拟合时输入兼容则热启动。
  */
 
 #ifndef WT_FITTINGWIDGET_H
@@ -21,27 +35,29 @@
 #include <QDialog>
 #include <QTableWidget>
 #include <QCheckBox>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <atomic>
 
 #include "modelmanager.h"
 #include "fittingparameterchart.h"
 #include "chartwidget.h"
 #include "mousezoom.h"
+#include "fittingcore.h"
+#include "perfcounters.h"
+#include "modelcurvecache.h"
+#include "fittinguncertainty.h"
+#include "fittingmcmc.h"
 
 namespace Ui {
 class FittingWidget;
 }
 
 // ============================================================================
-// 辅助结构体与对话框类：用于数据抽样设置
+// 辅助对话框类：用于数据抽样设置 (SamplingInterval 定义于 fittingcore.h)
 // ============================================================================
 
-// 抽样区间结构体
-struct SamplingInterval {
-    double tStart; // 起始时间
-    double tEnd;   // 结束时间
-    int count;     // 该区间内的抽样点数
-};
-
 // 抽样设置对话框类
 class SamplingSettingsDialog : public QDialog
 {
@@ -51,17 +67,23 @@ public:
      * @brief 构造函数
      * @param intervals 当前已有的区间列表
      * @param enabled 当前是否启用自定义抽样
+     * @param densityWeighting 当前是否按抽样密度加权残差
+     * @param adaptiveCount 自适应抽样目标点数 (0 表示未启用)
      * @param dataMinT 数据的最小时间（用于提示或默认值）
      * @param dataMaxT 数据的最大时间
      * @param parent 父窗口指针
      */
-    explicit SamplingSettingsDialog(const QList<SamplingInterval>& intervals, bool enabled,
-                                    double dataMinT, double dataMaxT, QWidget *parent = nullptr);
+    explicit SamplingSettingsDialog(const QList<SamplingInterval>& intervals, bool enabled, bool densityWeighting,
+                                    int adaptiveCount, double dataMinT, double dataMaxT, QWidget *parent = nullptr);
 
     // 获取设置后的区间列表
     QList<SamplingInterval> getIntervals() const;
     // 获取是否启用自定义抽样
     bool isCustomSamplingEnabled() const;
+    // 获取是否按抽样密度加权
+    bool isDensityWeightingEnabled() const;
+    // 获取自适应抽样目标点数 (未启用时返回 0)
+    int adaptiveSampleCount() const;
 
 private slots:
     void onAddRow();      // 添加一行
@@ -71,6 +93,9 @@ private slots:
 private:
     QTableWidget* m_table; // 表格控件
     QCheckBox* m_chkEnable;// 启用开关
+    QCheckBox* m_chkDensityWeight; // 按抽样密度加权开关
+    QCheckBox* m_chkAdaptive;      // 自适应抽样开关
+    QSpinBox* m_spinAdaptiveCount; // 自适应抽样目标点数
     double m_dataMinT;     // 数据最小时间
     double m_dataMaxT;     // 数据最大时间
 
@@ -110,6 +135,15 @@ public:
     // 获取截图
     QString getPlotImageBase64();
 
+    // 是否已加载观测数据
+    bool hasObservedData() const { return !m_obsTime.isEmpty(); }
+    // 是否有拟合或后台分析正在运行
+    bool isBusy() const;
+    // 当前参数表与拟合抽样数据的快照 (供联合拟合使用)
+    UncertaintyInput fittingInputSnapshot() { return buildPosteriorInput(); }
+    // 将参数值写入参数表并刷新理论曲线 (表中不存在的参数忽略)
+    void applyParameterValues(const QMap<QString, double>& values);
+
 signals:
     // 拟合进度信号：更新误差、参数、曲线数据
     void sigIterationUpdated(double error, QMap<QString,double> params, QVector<double> t, QVector<double> p, QVector<double> d);
@@ -151,6 +185,29 @@ private slots:
     // 拟合迭代更新槽 (线程安全)
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
 
+    // 后台理论曲线计算完成
+    void onBackgroundCurveFinished();
+
+    // 参数不确定性分析 (运行中再次点击则取消)
+    void onUncertaintyClicked();
+    void onUncertaintyFinished();
+
+    // MCMC 后验采样 (运行中再次点击则停止，保留检查点)
+    void onMcmcClicked();
+    void onMcmcFinished();
+
+    // 打开目标函数地形对话框 (非模态)
+    void onLandscapeClicked();
+    // 地形图上选定的参数点写入参数表并刷新曲线
+    void onLandscapePointSelected(const QString& paramX, double x, const QString& paramY, double y);
+
+    // 编辑非均匀裂缝表
+    void onFractureTableClicked();
+
+protected:
+    // 首次显示时启动加载后待计算的理论曲线
+    void showEvent(QShowEvent* event) override;
+
 private:
     Ui::FittingWidget *ui;
     ModelManager* m_modelManager;
@@ -170,11 +227,57 @@ private:
     // 拟合控制
     bool m_isFitting;
     bool m_stopRequested;
-    QFutureWatcher<void> m_watcher; // 异步任务监视器
+    QFutureWatcher<FittingResult> m_watcher; // 异步任务监视器 (结果在界面线程的 onFitFinished 中写入成员)
 
     // 抽样设置相关变量
     bool m_isCustomSamplingEnabled;           // 是否启用自定义抽样
     QList<SamplingInterval> m_customIntervals;// 自定义抽样区间列表
+    bool m_densityWeighting = false;          // 自定义抽样时按抽样密度加权残差
+    int m_adaptiveSampleCount = 0;            // 自适应抽样目标点数 (0：默认对数均匀抽样)
+
+    // 最近一次拟合的统计信息 (用于报告；只在界面线程读写)
+    bool m_hasFitSummary;                     // 是否已有拟合统计
+    FittingResult m_lastFitResult;            // 拟合结果与逐次迭代统计
+    PerfSnapshot m_lastFitPerf;               // 本次拟合的性能计数 (FittingResult::perf)
+    FitWarmStart m_fitWarmStart;              // 上次拟合结束时的优化器状态 (随状态保存，用于热启动)
+
+    // 理论曲线缓存与后台计算
+    ModelCurveCache m_curveCache;             // 当前显示的理论曲线 (随状态保存)
+    ModelCurveRequest m_pendingCurveRequest;  // 等待后台计算的曲线输入
+    bool m_hasPendingCurve;
+    int m_curveGeneration;                    // 曲线每次重新确定时递增，过期的后台结果被丢弃
+    int m_curveJobGeneration;                 // 正在运行的后台任务对应的代号
+    QFutureWatcher<ModelCurveCache> m_curveWatcher;
+
+    // 参数不确定性分析
+    QPushButton* m_btnUncertainty;
+    UncertaintyOptions m_uncertaintyOptions;  // 上次使用的设置
+    QFutureWatcher<UncertaintyResult> m_uncertaintyWatcher;
+    std::atomic<bool> m_uncertaintyCancel{false};
+    bool m_hasUncertainty;                    // 是否已有分析结果 (用于报告)
+    UncertaintyResult m_lastUncertainty;
+
+    // MCMC 后验采样
+    QPushButton* m_btnMcmc;
+    McmcOptions m_mcmcOptions;                // 上次使用的设置
+    QFutureWatcher<McmcResult> m_mcmcWatcher;
+    std::atomic<bool> m_mcmcCancel{false};
+    McmcState m_mcmcCheckpoint;               // 最近的检查点 (随状态保存)
+    bool m_hasMcmc;                           // 是否已有采样结果 (用于报告)
+    McmcResult m_lastMcmc;
+
+    // 目标函数地形
+    QPushButton* m_btnLandscape;
+    // 裂缝表
+    QPushButton* m_btnFractureTable;
+    // 迭代算法与上下限处理 (控件只在界面线程访问，拟合线程读取下面两个值)
+    QComboBox* m_comboStepStrategy;
+    QCheckBox* m_chkBoundTransform;
+    int m_stepStrategy = FittingCore::Step_LevenbergMarquardt;
+    int m_boundHandling = FittingCore::Bound_Clamp;
+
+    // 当前参数表与拟合抽样数据的快照 (不确定性分析/MCMC 的输入)
+    UncertaintyInput buildPosteriorInput();
 
     // 内部初始化函数
     void setupPlot();
@@ -184,29 +287,33 @@ private:
     // [新增] 绘制抽样点：用于在图中显示实际参与拟合的数据点
     void plotSampledPoints(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
 
-    // 拟合算法相关
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
-
-    // 计算残差向量 (支持传入抽样后的数据)
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight,
-                                       const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD);
-
-    // 计算雅可比矩阵 (支持传入抽样后的数据)
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals,
-                                             const QVector<int>& fitIndices, ModelManager::ModelType modelType,
-                                             const QList<FitParameter>& currentFitParams, double weight,
-                                             const QVector<double>& t, const QVector<double>& obsP, const QVector<double>& obsD);
-
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
-    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 拟合算法相关 (算法实现位于 FittingCore)
+    // 线程入口：迭代步策略、上下限处理与热启动状态由界面线程复制传入，结果经 m_watcher 返回
+    FittingResult runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight,
+                                      int stepStrategy, int boundHandling, FitWarmStart warmStart);
+    FittingResult runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight,
+                                                    int stepStrategy, int boundHandling, const FitWarmStart& warmStart);
+
+    // 由参数表 (或显式参数) 构造理论曲线输入：应用参数约束并生成绘图时间网格；
+    // 参数表中某项填写了多个值时返回敏感性分析参数名及取值
+    ModelCurveRequest buildCurveRequest(const QMap<QString, double>* explicitParams,
+                                        QString& sensitivityKey, QVector<double>& sensitivityValues);
+    // 绘制理论曲线 (图层 2/3)、误差与抽样点
+    void applyModelCurve(const ModelCurveCache& curve);
+    // 启动待计算的理论曲线 (使用独立求解器，不占用拟合所用的求解器)
+    void startPendingCurve();
+
+    // 生成报告中的拟合性能统计章节 (HTML)
+    QString buildFitPerformanceHtml() const;
 
     // 辅助解析敏感性分析输入
     QVector<double> parseSensitivityValues(const QString& text);
 
-    // 抽样函数：根据设置（默认或自定义）获取用于拟合计算的数据点
+    // 抽样函数：根据设置（默认或自定义）获取用于拟合计算的数据点 (代理给 FittingCore)
     void getLogSampledData(const QVector<double>& srcT, const QVector<double>& srcP, const QVector<double>& srcD,
                            QVector<double>& outT, QVector<double>& outP, QVector<double>& outD);
+    // 抽样点的逐点残差权重 (未启用按密度加权时为空，即等权)
+    QVector<double> samplingPointWeights(const QVector<double>& sampledT) const;
 };
 
 #endif // WT_FITTINGWIDGET_H
@@ -6,6 +6,7 @@
  * 2. 响应用户操作，收集界面参数，调用 ModelSolver01_06 进行计算。
  * 3. 将计算结果绘制在 QCustomPlot 图表上。
  * 4. [逻辑] 实现了 LfD 随 L 和 Lf 变化的自动计算逻辑。
+ * 5. [修改] 计算时间序列由 generateCurveTimeSteps 生成 (设置开启时为反演节点共享网格)，本界面的求解器在界面线程上逐条计算，反演节点并行求值。
  */
 
 #include "wt_modelwidget.h"
@@ -31,6 +32,7 @@ WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
 
     // 初始化求解器
     m_solver = new ModelSolver01_06(m_type);
+    m_solver->setParallelInversion(true);
 
     m_colorList = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan };
 
@@ -305,8 +307,8 @@ void WT_ModelWidget::runCalculation() {
     double maxTime = baseParams.value("t", 1000.0);
     if(maxTime < 1e-3) maxTime = 1000.0;
 
-    // 调用 Solver 的静态方法生成时间
-    QVector<double> t = ModelSolver01_06::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
+    // 调用 Solver 的静态方法生成时间 (默认对数均匀 nPoints 点；开启共享网格设置时点数约为 nPoints)
+    QVector<double> t = ModelSolver01_06::generateCurveTimeSteps(nPoints, -3.0, log10(maxTime));
 
     int iterations = isSensitivity ? sensitivityValues.size() : 1;
     iterations = qMin(iterations, (int)m_colorList.size());
@@ -8,6 +8,11 @@
  * 4. [本次修改]
  * - 修复导出 CSV 时中文表头乱码的问题（添加 UTF-8 BOM）。
  * - 导出后发出的 viewExportedFile 信号将在 MainWindow 中处理跳转逻辑。
+ * 5. [新增] 流动段自动识别：左侧面板增加“流动段识别”按钮，FlowPeriodSegmenter 在线程池中分段，
+ *    结果表中所选的段导出为拟合用 CSV (段内时间、压力、压差、产量、原始时间)，并可直接在数据界面打开。
+ * 6. [修改] 导出时产量由 TimeSeriesMerger 一次归并对齐到压力时间，不再逐点查找。
+ * 7. [修改] 数据移动结束时只把变换合并进 CurveInfo 的延迟变换，不再逐点复制曲线数据；
+ *    切换显示、保存、修改、导出与流动段识别读取数据前调用 applyPendingTransform 一次性写回。
  */
 
 #include "wt_plottingwidget.h"
@@ -22,6 +27,7 @@
 #include "pressurederivativecalculator.h"
 #include "pressurederivativecalculator1.h"
 #include "xlsxdocument.h" //  QtXlsx 库
+#include "timeseriesmerge.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
@@ -34,6 +40,14 @@
 #include <QDebug>
 #include <QSplitter>
 #include <QStringConverter> // Qt6 编码支持
+#include <QDialog>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QtConcurrent>
 
 // ============================================================================
 // 辅助函数与 CurveInfo 实现
@@ -150,6 +164,59 @@ CurveInfo CurveInfo::fromJson(const QJsonObject& json) {
     return info;
 }
 
+void CurveInfo::productionSteps(QVector<double>& px, QVector<double>& py) const {
+    px.clear();
+    py.clear();
+    bool isAbsoluteTime = true;
+    if (x2Data.size() > 1) {
+        for (int i = 0; i < x2Data.size() - 1; ++i) {
+            if (x2Data[i+1] <= x2Data[i]) {
+                isAbsoluteTime = false;
+                break;
+            }
+        }
+    } else {
+        isAbsoluteTime = false;
+    }
+
+    if (isAbsoluteTime && !x2Data.isEmpty()) {
+        px = x2Data;
+        py = y2Data;
+    } else {
+        double t_cum = 0;
+        if(!x2Data.isEmpty() && !y2Data.isEmpty()) {
+            px.append(0);
+            py.append(y2Data[0]);
+        }
+        for(int i=0; i<x2Data.size(); ++i) {
+            t_cum += x2Data[i];
+            if(i+1 < y2Data.size()) {
+                px.append(t_cum);
+                py.append(y2Data[i+1]);
+            }
+            else if (i < y2Data.size()) {
+                px.append(t_cum);
+                py.append(y2Data[i]);
+            }
+        }
+    }
+}
+
+void CurveInfo::applyPendingTransform() {
+    xTransform.applyTo(xData);
+    yTransform.applyTo(yData);
+    if (!x2Transform.isIdentity() && type == 1 && prodGraphType == 0) {
+        // 阶梯图按时长记录时平移无法表示为时长的变换，按显示的绝对时间序列写回
+        QVector<double> px, py;
+        productionSteps(px, py);
+        x2Data = px;
+        y2Data = py;
+    }
+    x2Transform.applyTo(x2Data);
+    y2Transform.applyTo(y2Data);
+    xTransform = yTransform = x2Transform = y2Transform = DataTransform();
+}
+
 // ============================================================================
 // WT_PlottingWidget 主类实现
 // ============================================================================
@@ -163,7 +230,8 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
     m_exportStartIndex(0),
     m_exportEndIndex(0),
     m_graphPress(nullptr),
-    m_graphProd(nullptr)
+    m_graphProd(nullptr),
+    m_btnSegment(nullptr)
 {
     ui->setupUi(this);
 
@@ -175,8 +243,8 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
     connect(ui->customPlot, &ChartWidget::exportDataTriggered, this, &WT_PlottingWidget::onExportDataTriggered);
     connect(ui->customPlot->getPlot(), &QCustomPlot::plottableClick, this, &WT_PlottingWidget::onGraphClicked);
 
-    // 连接数据修改信号
-    connect(ui->customPlot, &ChartWidget::graphDataModified, this, &WT_PlottingWidget::onGraphDataModified);
+    // 连接数据移动信号
+    connect(ui->customPlot, &ChartWidget::graphDataMoved, this, &WT_PlottingWidget::onGraphDataMoved);
 
     // 连接标题和图例修改信号
     connect(ui->customPlot, &ChartWidget::titleChanged, this, &WT_PlottingWidget::onChartTitleChanged);
@@ -184,10 +252,19 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
 
     ui->customPlot->setChartMode(ChartWidget::Mode_Single);
     ui->customPlot->setTitle("试井分析图表");
+
+    // [新增] 流动段识别按钮，放在“压力导数分析”之后
+    m_btnSegment = new QPushButton("流动段识别", ui->leftPanel);
+    m_btnSegment->setToolTip("自动将长期压力计记录划分为压降段与压力恢复段");
+    ui->verticalLayout->insertWidget(ui->verticalLayout->indexOf(ui->btn_Derivative) + 1, m_btnSegment);
+    connect(m_btnSegment, &QPushButton::clicked, this, &WT_PlottingWidget::onSegmentFlowPeriodsClicked);
+    connect(&m_segmentWatcher, &QFutureWatcher<FlowSegmentationResult>::finished, this, &WT_PlottingWidget::onSegmentationFinished);
 }
 
 WT_PlottingWidget::~WT_PlottingWidget()
 {
+    m_segmentCancel = true;
+    m_segmentWatcher.waitForFinished();
     qDeleteAll(m_openedWindows);
     delete ui;
 }
@@ -314,6 +391,7 @@ void WT_PlottingWidget::saveProjectData() {
     if (!ModelParameter::instance()->hasLoadedProject()) return;
     QJsonArray curvesArray;
     for(auto it = m_curves.begin(); it != m_curves.end(); ++it) {
+        it.value().applyPendingTransform();
         curvesArray.append(it.value().toJson());
     }
     ModelParameter::instance()->savePlottingData(curvesArray);
@@ -396,6 +474,7 @@ void WT_PlottingWidget::on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *
         saveCurveViewState(m_currentDisplayedCurve);
     }
 
+    m_curves[name].applyPendingTransform();
     CurveInfo info = m_curves[name];
     m_currentDisplayedCurve = name;
 
@@ -491,39 +570,7 @@ void WT_PlottingWidget::drawStackedPlot(const CurveInfo& info, ChartWidget* widg
     QVector<double> px, py;
 
     if(info.prodGraphType == 0) { // 阶梯图
-        bool isAbsoluteTime = true;
-        if (info.x2Data.size() > 1) {
-            for (int i = 0; i < info.x2Data.size() - 1; ++i) {
-                if (info.x2Data[i+1] <= info.x2Data[i]) {
-                    isAbsoluteTime = false;
-                    break;
-                }
-            }
-        } else {
-            isAbsoluteTime = false;
-        }
-
-        if (isAbsoluteTime && !info.x2Data.isEmpty()) {
-            px = info.x2Data;
-            py = info.y2Data;
-        } else {
-            double t_cum = 0;
-            if(!info.x2Data.isEmpty() && !info.y2Data.isEmpty()) {
-                px.append(0);
-                py.append(info.y2Data[0]);
-            }
-            for(int i=0; i<info.x2Data.size(); ++i) {
-                t_cum += info.x2Data[i];
-                if(i+1 < info.y2Data.size()) {
-                    px.append(t_cum);
-                    py.append(info.y2Data[i+1]);
-                }
-                else if (i < info.y2Data.size()) {
-                    px.append(t_cum);
-                    py.append(info.y2Data[i]);
-                }
-            }
-        }
+        info.productionSteps(px, py);
 
         if (px.size() == py.size() && px.size() > 1) {
             for (int i = 0; i < px.size() - 1; ++i) {
@@ -596,27 +643,22 @@ void WT_PlottingWidget::drawDerivativePlot(const CurveInfo& info, ChartWidget* w
     plot->replot();
 }
 
-void WT_PlottingWidget::onGraphDataModified(QCPGraph* graph) {
+// 数据移动结束：图上曲线已就地更新，这里只合并延迟变换，数据数组在下次读取前写回
+void WT_PlottingWidget::onGraphDataMoved(QCPGraph* graph, Qt::Orientation orientation, const DataTransform& transform) {
     if (!graph || m_currentDisplayedCurve.isEmpty()) return;
     if (!m_curves.contains(m_currentDisplayedCurve)) return;
 
     CurveInfo& info = m_curves[m_currentDisplayedCurve];
+    const bool horizontal = (orientation == Qt::Horizontal);
 
     if (info.type == 1) { // 压力产量图
-        QVector<double> newX, newY;
-        auto dataPtr = graph->data();
-        for (auto it = dataPtr->begin(); it != dataPtr->end(); ++it) {
-            newX.append(it->key);
-            newY.append(it->value);
-        }
-
         if (graph == m_graphPress) {
-            info.xData = newX;
-            info.yData = newY;
+            DataTransform& t = horizontal ? info.xTransform : info.yTransform;
+            t = t.then(transform);
         }
         else if (graph == m_graphProd) {
-            info.x2Data = newX;
-            info.y2Data = newY;
+            DataTransform& t = horizontal ? info.x2Transform : info.y2Transform;
+            t = t.then(transform);
         }
     }
 }
@@ -630,6 +672,7 @@ void WT_PlottingWidget::on_btn_Manage_clicked() {
     QString name = item->text();
     if (!m_curves.contains(name)) return;
     CurveInfo& info = m_curves[name];
+    info.applyPendingTransform();
 
     DialogCurveInfo dlgInfo;
     dlgInfo.type = info.type;
@@ -1076,6 +1119,7 @@ void WT_PlottingWidget::onGraphClicked(QCPAbstractPlottable *plottable, int data
 void WT_PlottingWidget::executeExport(bool fullRange, double start, double end) {
     if (m_currentDisplayedCurve.isEmpty() || !m_curves.contains(m_currentDisplayedCurve)) return;
     CurveInfo& info = m_curves[m_currentDisplayedCurve];
+    info.applyPendingTransform();
 
     // 1. 获取保存路径
     QString dir = ModelParameter::instance()->getProjectPath();
@@ -1134,6 +1178,20 @@ void WT_PlottingWidget::executeExport(bool fullRange, double start, double end)
         // 始终保持: 时间, 压力, 产量, 原始时间
         headers << "时间" << "压力" << "产量" << "原始时间";
 
+        // 产量一次归并对齐到压力时间：阶梯图按阶梯保持，其余按线性插值
+        QVector<double> prodAligned;
+        if (m_graphProd) {
+            QVector<double> prodT, prodQ;
+            prodT.reserve(m_graphProd->data()->size());
+            prodQ.reserve(m_graphProd->data()->size());
+            for (auto it = m_graphProd->data()->constBegin(); it != m_graphProd->data()->constEnd(); ++it) {
+                prodT.append(it->key);
+                prodQ.append(it->value);
+            }
+            MergeAlignMode mode = m_graphProd->lineStyle() == QCPGraph::lsStepLeft ? MergeAlignMode::StepHold : MergeAlignMode::Linear;
+            prodAligned = TimeSeriesMerger::alignTo(info.xData, prodT, prodQ, mode);
+        }
+
         for (int i = 0; i < info.xData.size(); ++i) {
             double t = info.xData[i];
             if (!fullRange && (t < start || t > end)) continue;
@@ -1142,7 +1200,8 @@ void WT_PlottingWidget::executeExport(bool fullRange, double start, double end)
             double q = 0.0;
             // 获取产量值
             if (m_graphProd) {
-                q = getProductionValueFromGraph(t, m_graphProd);
+                q = prodAligned.value(i, 0.0);
+                if (qIsNaN(q)) q = 0.0;
             } else if (i < info.y2Data.size()) {
                 q = info.y2Data[i];
             }
@@ -1262,29 +1321,182 @@ void WT_PlottingWidget::executeExport(bool fullRange, double start, double end)
     }
 }
 
-double WT_PlottingWidget::getProductionValueFromGraph(double t, QCPGraph* graph) {
-    if (!graph) return 0.0;
+// ============================================================================
+// [新增] 流动段自动识别
+// ============================================================================
+
+void WT_PlottingWidget::onSegmentFlowPeriodsClicked()
+{
+    if (m_segmentWatcher.isRunning()) return;
+    if (m_currentDisplayedCurve.isEmpty() || !m_curves.contains(m_currentDisplayedCurve)) {
+        QMessageBox::information(this, "提示", "请先在曲线列表中选择一条压力曲线或压力产量曲线。");
+        return;
+    }
+    CurveInfo& info = m_curves[m_currentDisplayedCurve];
+    info.applyPendingTransform();
+    if (info.type == 2) {
+        QMessageBox::information(this, "提示", "压力导数曲线已是单个流动段，请选择压力曲线或压力产量曲线进行识别。");
+        return;
+    }
+
+    FlowSegmentationInput input;
+    input.time = info.xData;
+    input.pressure = info.yData;
+    if (info.type == 1) {
+        input.rateTime = info.x2Data;
+        input.rate = info.y2Data;
+    }
+    for (int i = 1; i < input.time.size(); ++i) {
+        if (input.time[i] < input.time[i - 1]) {
+            QMessageBox::warning(this, "提示", "曲线时间不是升序排列，无法识别流动段。");
+            return;
+        }
+    }
+
+    m_segmentCurveName = info.name;
+    m_segmentCancel = false;
+    m_btnSegment->setEnabled(false);
+    m_btnSegment->setText("正在识别...");
+    m_segmentWatcher.setFuture(QtConcurrent::run([input, this]() {
+        return FlowPeriodSegmenter::segment(input, FlowSegmentationOptions(), &m_segmentCancel);
+    }));
+}
+
+void WT_PlottingWidget::onSegmentationFinished()
+{
+    m_btnSegment->setEnabled(true);
+    m_btnSegment->setText("流动段识别");
+
+    FlowSegmentationResult result = m_segmentWatcher.result();
+    if (!m_curves.contains(m_segmentCurveName)) return; // 识别期间曲线已被删除
+    if (!result.ok) {
+        QMessageBox::warning(this, "流动段识别", result.message);
+        return;
+    }
+    CurveInfo& info = m_curves[m_segmentCurveName];
+    info.applyPendingTransform();
+    showFlowPeriodDialog(info, result);
+}
+
+void WT_PlottingWidget::showFlowPeriodDialog(const CurveInfo& info, const FlowSegmentationResult& result)
+{
+    QDialog dlg(this);
+    dlg.setWindowTitle("流动段识别 - " + info.name);
+    dlg.resize(760, 420);
+    applyDialogStyle(&dlg);
 
-    if (graph->lineStyle() == QCPGraph::lsStepLeft) {
-        auto data = graph->data();
-        auto it = data->findBegin(t);
-        if (it == data->end()) return 0.0;
-        return it->value;
+    QVBoxLayout* layout = new QVBoxLayout(&dlg);
+    layout->addWidget(new QLabel(result.message + "\n选择需要的流动段 (可多选)，导出为可直接拟合的数据文件。", &dlg));
+
+    QTableWidget* table = new QTableWidget(result.periods.size(), 8, &dlg);
+    table->setHorizontalHeaderLabels({"序号", "类型", "开始时间", "结束时间", "时长", "产量", "起始压力", "结束压力"});
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::MultiSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int r = 0; r < result.periods.size(); ++r) {
+        const FlowPeriod& fp = result.periods[r];
+        QStringList cells;
+        cells << QString::number(r + 1) << FlowPeriod::typeName(fp.type)
+              << QString::number(fp.startTime, 'g', 8) << QString::number(fp.endTime, 'g', 8)
+              << QString::number(fp.duration(), 'g', 6)
+              << (fp.type == FlowPeriod::Buildup ? QString("0") : QString::number(fp.rate, 'g', 6))
+              << QString::number(fp.pStart, 'f', 4) << QString::number(fp.pEnd, 'f', 4);
+        for (int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            item->setTextAlignment(Qt::AlignCenter);
+            if (fp.type == FlowPeriod::Buildup) item->setBackground(QColor(230, 242, 255));
+            table->setItem(r, c, item);
+        }
     }
+    layout->addWidget(table);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    QPushButton* btnBuildups = new QPushButton("选中全部压力恢复段", &dlg);
+    QPushButton* btnExport = new QPushButton("导出所选为拟合数据", &dlg);
+    QPushButton* btnClose = new QPushButton("关闭", &dlg);
+    btnLayout->addWidget(btnBuildups);
+    btnLayout->addStretch();
+    btnLayout->addWidget(btnExport);
+    btnLayout->addWidget(btnClose);
+    layout->addLayout(btnLayout);
+
+    connect(btnBuildups, &QPushButton::clicked, &dlg, [table, &result]() {
+        table->clearSelection();
+        for (int r = 0; r < result.periods.size(); ++r) {
+            if (result.periods[r].type == FlowPeriod::Buildup) table->selectRow(r);
+        }
+    });
+    connect(btnClose, &QPushButton::clicked, &dlg, &QDialog::reject);
+    connect(btnExport, &QPushButton::clicked, &dlg, [&]() {
+        QVector<FlowPeriod> selected;
+        const QModelIndexList rows = table->selectionModel()->selectedRows();
+        for (const QModelIndex& idx : rows) selected.append(result.periods[idx.row()]);
+        std::sort(selected.begin(), selected.end(), [](const FlowPeriod& a, const FlowPeriod& b) { return a.startIndex < b.startIndex; });
+        if (selected.isEmpty()) {
+            QMessageBox::information(&dlg, "提示", "请先选择至少一个流动段。");
+            return;
+        }
+
+        QString dir = ModelParameter::instance()->getProjectPath();
+        if (dir.isEmpty()) dir = QDir::currentPath();
+        dir = QFileDialog::getExistingDirectory(&dlg, "选择导出目录", dir);
+        if (dir.isEmpty()) return;
+
+        QStringList files = exportFlowPeriods(info, selected, dir);
+        if (files.isEmpty()) return;
+
+        QMessageBox openMsg(&dlg);
+        openMsg.setWindowTitle("导出成功");
+        openMsg.setText(QString("已导出 %1 个流动段数据文件。\n目录: %2\n\n是否在数据界面打开导出的文件？").arg(files.size()).arg(dir));
+        openMsg.setIcon(QMessageBox::Question);
+        QPushButton* btnYes = openMsg.addButton("打开文件", QMessageBox::ActionRole);
+        openMsg.addButton("关闭", QMessageBox::RejectRole);
+        applyDialogStyle(&openMsg);
+        openMsg.exec();
+        if (openMsg.clickedButton() == btnYes) {
+            dlg.accept();
+            for (const QString& file : files) emit viewExportedFile(file);
+        }
+    });
+
+    dlg.exec();
+}
+
+QStringList WT_PlottingWidget::exportFlowPeriods(const CurveInfo& info, const QVector<FlowPeriod>& periods, const QString& dir)
+{
+    // 产量一次性按阶梯保持对齐到压力时间
+    QVector<double> rate;
+    if (info.type == 1) rate = TimeSeriesMerger::alignTo(info.xData, info.x2Data, info.y2Data, MergeAlignMode::StepHold);
+
+    QStringList files;
+    for (int k = 0; k < periods.size(); ++k) {
+        const FlowPeriod& fp = periods[k];
+        QString file = QString("%1/%2_段%3_%4.csv").arg(dir, info.name).arg(k + 1).arg(FlowPeriod::typeName(fp.type));
+        QFile f(file);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QMessageBox::warning(this, "错误", "无法写入文件：" + file);
+            return files;
+        }
+        QTextStream out(&f);
+        out.setGenerateByteOrderMark(true);
+        out.setEncoding(QStringConverter::Utf8);
 
-    auto data = graph->data();
-    auto it = data->findBegin(t);
-    if (it == data->end()) return 0.0;
-    if (qAbs(it->key - t) < 1e-9) return it->value;
-    if (it == data->begin()) return it->value;
-    auto prev = it;
-    --prev;
-    double t1 = prev->key;
-    double v1 = prev->value;
-    double t2 = it->key;
-    double v2 = it->value;
-    if (qAbs(t2 - t1) < 1e-9) return v1;
-    return v1 + (t - t1) * (v2 - v1) / (t2 - t1);
+        // 时间为段内经过时间；压差取为正值 (恢复段 p - p关井，压降段 p起始 - p)
+        out << "时间,压力,压差,产量,原始时间\n";
+        for (int i = fp.startIndex; i <= fp.endIndex && i < info.xData.size(); ++i) {
+            double t = info.xData[i];
+            double p = info.yData[i];
+            double dp = fp.type == FlowPeriod::Buildup ? p - fp.pStart : fp.pStart - p;
+            double q = rate.isEmpty() ? fp.rate : rate[i];
+            out << QString::number(t - fp.startTime) << "," << QString::number(p) << ","
+                << QString::number(dp) << "," << QString::number(q) << "," << QString::number(t) << "\n";
+        }
+        f.close();
+        files << file;
+    }
+    return files;
 }
 
 double WT_PlottingWidget::getProductionValueAt(double t, const CurveInfo& info) { Q_UNUSED(t); return info.y2Data.isEmpty() ? 0 : info.y2Data.last(); }
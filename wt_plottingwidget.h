@@ -6,6 +6,8 @@
  * 2. CurveInfo 结构体支持双文件数据源（压力+产量）。
  * 3. 增加了视图状态保存功能，切换曲线时可保持上次的缩放和平移视图。
  * 4. [本次修改] 优化导出功能，支持中文表头，修正产量读取，增加导出后跳转文件的信号。
+ * 5. [新增] 流动段自动识别：后台对长期压力计记录分段 (压降/压力恢复)，各段可一键导出为拟合数据。
+ * 6. [新增] 数据移动结果以延迟变换记录在 CurveInfo 中，读取曲线数据 (显示、保存、导出等) 前才写回数据数组。
  */
 
 #ifndef WT_PLOTTINGWIDGET_H
@@ -15,8 +17,13 @@
 #include <QStandardItemModel>
 #include <QMap>
 #include <QListWidgetItem>
+#include <QFutureWatcher>
+#include <atomic>
 #include "chartwidget.h"
 #include "chartwindow.h"
+#include "flowsegmenter.h"
+
+class QPushButton;
 
 // 曲线配置结构体
 struct CurveInfo {
@@ -62,6 +69,15 @@ struct CurveInfo {
     QColor derivLineColor = Qt::red;
     int derivLineWidth = 2; // [新增] 导数曲线线宽
 
+    // [新增] 图上拖动移动数据后尚未写回的变换 (压力/主曲线与产量曲线各自的横纵向)
+    DataTransform xTransform, yTransform;
+    DataTransform x2Transform, y2Transform;
+
+    // 将延迟变换写回数据数组并复位；产量为阶梯时长数据时先转换为绝对时间
+    void applyPendingTransform();
+    // 产量阶梯图的绝对时间序列：x2Data 严格递增时视为绝对时间，否则视为各阶段时长并累加
+    void productionSteps(QVector<double>& px, QVector<double>& py) const;
+
     QJsonObject toJson() const;
     static CurveInfo fromJson(const QJsonObject& json);
 };
@@ -114,7 +130,7 @@ private slots:
     void onGraphClicked(QCPAbstractPlottable *plottable, int dataIndex, QMouseEvent *event);
 
     // [新增] 处理图表数据被交互修改后的逻辑
-    void onGraphDataModified(QCPGraph* graph);
+    void onGraphDataMoved(QCPGraph* graph, Qt::Orientation orientation, const DataTransform& transform);
 
     // [新增] 处理图表标题变更，同步更新列表和内部数据
     void onChartTitleChanged(const QString& newTitle);
@@ -122,6 +138,10 @@ private slots:
     // [新增] 处理图表图例变更
     void onChartGraphsChanged();
 
+    // [新增] 流动段识别：启动后台分段 / 分段完成后显示结果
+    void onSegmentFlowPeriodsClicked();
+    void onSegmentationFinished();
+
 private:
     Ui::WT_PlottingWidget *ui;
 
@@ -175,13 +195,22 @@ private:
 
     void executeExport(bool fullRange, double start = 0, double end = 0);
 
-    // [修改] 产量读取函数优化
-    double getProductionValueFromGraph(double t, QCPGraph* graph);
+    // [修改] 产量按时间对齐改由 TimeSeriesMerger 一次归并完成
     double getProductionValueAt(double t, const CurveInfo& info);
 
     QListWidgetItem* getCurrentSelectedItem();
 
     void applyDialogStyle(QWidget* dialog);
+
+    // [新增] 流动段结果对话框与导出
+    void showFlowPeriodDialog(const CurveInfo& info, const FlowSegmentationResult& result);
+    QStringList exportFlowPeriods(const CurveInfo& info, const QVector<FlowPeriod>& periods, const QString& dir);
+
+    // [新增] 流动段识别状态
+    QPushButton* m_btnSegment;
+    QFutureWatcher<FlowSegmentationResult> m_segmentWatcher;
+    std::atomic<bool> m_segmentCancel{false};
+    QString m_segmentCurveName;     // 正在分段的曲线
 };
 
 #endif // WT_PLOTTINGWIDGET_H